@@ -29,10 +29,6 @@ FUNC_SCOPE* NODE::Func_scope() const { return _cont->Parent_func_scope(); }
 
 GLOB_SCOPE& NODE::Glob_scope() const { return Func_scope()->Glob_scope(); }
 
-uint32_t NODE::Num_child() const {
-  uint32_t num = META_INFO::Op_num_child(Opcode());
-  return (Has_added_chld() ? num + Num_added_chld() : num);
-}
 const char* NODE::Name() const { return META_INFO::Op_name(Opcode()); }
 
 size_t NODE::Size() const {
@@ -100,14 +96,6 @@ bool NODE::Is_relational_op() const {
   return META_INFO::Has_prop<OPR_PROP::COMPARE>(Opcode());
 }
 
-bool NODE::Is_lib_call() const {
-  return META_INFO::Has_prop<OPR_PROP::LIB_CALL>(Opcode());
-}
-
-bool NODE::Has_added_chld() const {
-  return META_INFO::Has_prop<OPR_PROP::EX_CHILD>(Opcode());
-}
-
 bool NODE::Has_rtype() const {
   return META_INFO::Has_prop<OPR_PROP::EXPR>(Opcode());
 }
@@ -177,17 +165,6 @@ const ATTR_ID& NODE::Attr_id() const {
   return _data->_comm._attr;
 }
 
-NODE_ID
-NODE::Child_id(uint32_t num) const {
-  AIR_ASSERT(Num_child() > num);
-  return NODE_ID(_data->_uu._fields[Num_fld() + num]);
-}
-
-NODE_PTR
-NODE::Child(uint32_t num) const {
-  return NODE_PTR(NODE(_cont, _cont->Code_arena()->Find(Child_id(num))));
-}
-
 NODE_ID
 NODE::Last_child_id() const {
   AIR_ASSERT(Num_child() > 0);
@@ -382,18 +359,6 @@ int64_t NODE::Ofst() const {
   return reinterpret_cast<int64_t&>(_data->_uu._u4._ofst_acc._ofst);
 }
 
-uint32_t NODE::Num_fld() const {
-  OPCODE   op  = Opcode();
-  uint32_t num = META_INFO::Op_num_field(op);
-  // TODO op_array
-  return num;
-}
-
-uint32_t NODE::Num_added_chld() const {
-  AIR_ASSERT(Has_added_chld());
-  return _data->_comm._core._num_added_chld;
-}
-
 ENTRY_ID
 NODE::Entry_id() const {
   AIR_ASSERT(Has_entry());
@@ -529,8 +494,6 @@ void NODE::Set_num_arg(uint32_t num) {
   _data->_comm._core._num_added_chld = num;
 }
 
-OPCODE NODE::Opcode() const { return OPCODE(_data->_comm._core._opcode); }
-
 void NODE::Set_const(CONST_CONSTANT_PTR cst) { Set_const(cst->Id()); }
 
 void NODE::Set_const(CONSTANT_ID id) {
@@ -15,6 +15,7 @@
 #include <cstring>
 #include <iostream>
 #include <sstream>
+#include <string_view>
 
 #include "air/base/container.h"
 
@@ -351,6 +352,26 @@ std::string FUNC_SCOPE::To_str(bool rot) const {
 // class GLOB_SCOPE member functions
 //=============================================================================
 
+// hash of array constant content and element type. Array types are created
+// anew for each constant with their own names, so the type id is not hashed
+static size_t Array_const_hash(CONST_TYPE_PTR type, const void* buf,
+                               size_t byte) {
+  size_t hash = std::hash<std::string_view>()(
+      std::string_view(static_cast<const char*>(buf), byte));
+  return hash * 31 + type->Cast_to_arr()->Elem_type_id().Value();
+}
+
+// check if two array types have the same element type and shape
+static bool Same_array_layout(CONST_TYPE_PTR type0, CONST_TYPE_PTR type1) {
+  if (type0->Id() == type1->Id()) {
+    return true;
+  }
+  CONST_ARRAY_TYPE_PTR arr0 = type0->Cast_to_arr();
+  CONST_ARRAY_TYPE_PTR arr1 = type1->Cast_to_arr();
+  return arr0->Elem_type_id() == arr1->Elem_type_id() &&
+         arr0->Shape() == arr1->Shape();
+}
+
 const char* Primitive_type_names[static_cast<uint32_t>(PRIMITIVE_TYPE::END)] = {
     "int8_t",       "int16_t",    "int32_t",     "int64_t",     "uint8_t",
     "uint16_t",     "uint32_t",   "uint64_t",    "float32_t",   "float64_t",
@@ -468,6 +489,15 @@ GLOB_SCOPE::New_str(const char* str, size_t len) {
     len = strlen(str);
   }
 
+  STR_KEY                     key(str, len);
+  size_t                      hash = key.Hash();
+  std::lock_guard<std::mutex> guard(_str_const_lock);
+  STR_ID                      found = Find_str(key, hash);
+  if (found != STR_ID()) {
+    return String(found);
+  }
+
+  Check_str_const_room();
   PTR_FROM_DATA<char> ptr = Reinterpret_cast<PTR_FROM_DATA<char> >(
       _str_tab->Allocate_array<short>((sizeof(int) + len + 2) / 2));
   STR_DATA* str_data_ptr = (STR_DATA*)ptr.Addr();
@@ -476,10 +506,42 @@ GLOB_SCOPE::New_str(const char* str, size_t len) {
   const_cast<char*>(str_data_ptr->Str())[len] = '\0';
 
   STR_PTR new_str = STR_PTR(STR(*this, Reinterpret_cast<STR_DATA_PTR>(ptr)));
+  _str_map.emplace(hash, new_str->Id().Value());
 
   return new_str;
 }
 
+STR_ID
+GLOB_SCOPE::Find_str(const STR_KEY& key, size_t hash) const {
+  auto range = _str_map.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    STR_PTR str = String(STR_ID(it->second));
+    if (STR_KEY(str) == key) {
+      return str->Id();
+    }
+  }
+  return STR_ID();
+}
+
+void GLOB_SCOPE::Reserve_str_const(uint32_t num) {
+  std::lock_guard<std::mutex> guard(_str_const_lock);
+  _str_tab->Reserve(num);
+  _const_tab->Reserve(num);
+  _str_const_fixed = true;
+}
+
+void GLOB_SCOPE::Release_str_const() {
+  std::lock_guard<std::mutex> guard(_str_const_lock);
+  _str_const_fixed = false;
+}
+
+// called with _str_const_lock held before a string or constant is allocated
+void GLOB_SCOPE::Check_str_const_room() const {
+  AIR_ASSERT_MSG(!_str_const_fixed ||
+                     (_str_tab->Room() > 0 && _const_tab->Room() > 0),
+                 "string or constant table grows beyond Reserve_str_const");
+}
+
 PARAM_PTR
 GLOB_SCOPE::Param(PARAM_ID id) const { return PARAM_PTR(PARAM(*this, id)); }
 
@@ -796,7 +858,15 @@ GLOB_SCOPE::New_const(CONSTANT_KIND ck, TYPE_ID type, uint64_t val) {
 
 CONSTANT_PTR
 GLOB_SCOPE::New_const(CONSTANT_KIND ck) {
+  std::lock_guard<std::mutex> guard(_str_const_lock);
+  return Alloc_const(ck);
+}
+
+// called with _str_const_lock held
+CONSTANT_PTR
+GLOB_SCOPE::Alloc_const(CONSTANT_KIND ck) {
   CONSTANT_DATA_PTR ptr;
+  Check_str_const_room();
   switch (ck) {
     case CONSTANT_KIND::BOOLEAN: {
       PTR_FROM_DATA<BOOL_CONSTANT_DATA> data =
@@ -883,20 +953,59 @@ GLOB_SCOPE::New_const(CONSTANT_KIND ck, CONST_TYPE_PTR type, void* buf,
   if ((sz % _const_tab->Unit_size()) != 0) {
     unit += 1;
   }
+  // constant created from nullptr is filled in place later, never share it
+  size_t hash = buf != nullptr ? Array_const_hash(type, buf, byte) : 0;
+  std::lock_guard<std::mutex> guard(_str_const_lock);
+  if (buf != nullptr) {
+    CONSTANT_ID found = Find_array_const(type, buf, byte, hash);
+    if (found != CONSTANT_ID()) {
+      return Constant(found);
+    }
+  }
+  Check_str_const_room();
   PTR_FROM_DATA<void> data = _const_tab->Malloc(unit);
   new (data) ARRAY_CONSTANT_DATA(ck, type->Id(), buf, byte);
-  return CONSTANT_PTR(
-      CONSTANT(this, Reinterpret_cast<CONSTANT_DATA_PTR>(data)));
+  CONSTANT_PTR new_cst =
+      CONSTANT_PTR(CONSTANT(this, Reinterpret_cast<CONSTANT_DATA_PTR>(data)));
+  if (buf != nullptr) {
+    _array_const_map.emplace(hash, new_cst->Id().Value());
+  }
+  return new_cst;
+}
+
+CONSTANT_ID
+GLOB_SCOPE::Find_array_const(CONST_TYPE_PTR type, const void* buf, size_t byte,
+                             size_t hash) const {
+  auto range = _array_const_map.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    CONSTANT_PTR cst = Constant(CONSTANT_ID(it->second));
+    // array types of the same element type and shape are merged, the
+    // constant keeps the type it was first created with
+    if (cst->Array_byte_len() == byte && Same_array_layout(cst->Type(), type) &&
+        memcmp(cst->Array_buffer(), buf, byte) == 0) {
+      return cst->Id();
+    }
+  }
+  return CONSTANT_ID();
 }
 
 CONSTANT_PTR
 GLOB_SCOPE::New_const(CONSTANT_KIND ck, STR_ID str) {
-  CONSTANT_PTR new_const = New_const(ck);
-  // assume type is always "char*"
+  AIR_ASSERT(ck == CONSTANT_KIND::STR_ARRAY);
+  // find and add under one lock, so that concurrent calls with the same
+  // string share one constant
+  std::lock_guard<std::mutex>   guard(_str_const_lock);
+  STR_CONST_MAP::const_iterator it = _str_const_map.find(str.Value());
+  if (it != _str_const_map.end()) {
+    return Constant(CONSTANT_ID(it->second));
+  }
+  CONSTANT_PTR new_const = Alloc_const(ck);
+  // assume type is always "char*", which has no name to create
   TYPE_PTR type = New_ptr_type(Prim_type(PRIMITIVE_TYPE::INT_S8)->Id(),
                                POINTER_KIND::FLAT32);
   new_const->Set_type(type->Id());
   new_const->Set_val(str);
+  _str_const_map.emplace(str.Value(), new_const->Id().Value());
   return new_const;
 }
 
@@ -928,7 +1037,8 @@ GLOB_SCOPE::New_const(CONSTANT_KIND ck, CONST_TYPE_PTR type,
   CONSTANT_PTR new_cst = New_const(ck);
   new_cst->Set_type(type->Id());
   // Set constant offset in RDWR external file
-  ECF_MAP::iterator ecf_iter = _ecf_map.find(file->Id().Value());
+  std::lock_guard<std::mutex> guard(_str_const_lock);
+  ECF_MAP::iterator           ecf_iter = _ecf_map.find(file->Id().Value());
   AIR_ASSERT_MSG((ecf_iter != _ecf_map.end()), "%s not available\n",
                  file->File_name()->Char_str());
   EXT_CONST_FILE* ecf_ptr  = (*ecf_iter).second;
@@ -1076,6 +1186,8 @@ void GLOB_SCOPE::Clone(GLOB_SCOPE& glob, bool clone_func_scope) {
     Blk_table().Clone(glob.Blk_table());
   }
 
+  Rebuild_intern_map();
+
   // Set all functions of this global scope undefined
   FUNC_ITER iter = Begin_func();
   FUNC_ITER end  = End_func();
@@ -1087,6 +1199,30 @@ void GLOB_SCOPE::Clone(GLOB_SCOPE& glob, bool clone_func_scope) {
   }
 }
 
+void GLOB_SCOPE::Rebuild_intern_map() {
+  std::lock_guard<std::mutex> guard(_str_const_lock);
+  _str_map.clear();
+  _array_const_map.clear();
+  _str_const_map.clear();
+  for (STR_ITER it = Begin_str(); it != End_str(); ++it) {
+    STR_KEY key(*it);
+    if (Find_str(key, key.Hash()) == STR_ID()) {
+      _str_map.emplace(key.Hash(), (*it)->Id().Value());
+    }
+  }
+  for (CONSTANT_ITER it = Begin_const(); it != End_const(); ++it) {
+    CONSTANT_PTR cst = *it;
+    if (cst->Kind() == CONSTANT_KIND::ARRAY) {
+      size_t hash = Array_const_hash(cst->Type(), cst->Array_buffer(),
+                                     cst->Array_byte_len());
+      _array_const_map.emplace(hash, cst->Id().Value());
+    } else if (cst->Kind() == CONSTANT_KIND::STR_ARRAY) {
+      _str_const_map.emplace(cst->Str_val()->Id().Value(),
+                             cst->Id().Value());
+    }
+  }
+}
+
 void GLOB_SCOPE::Init_targ_info(ENDIANNESS e, ARCHITECTURE a) {
   AIR_ASSERT(_targ_info == nullptr);
   _targ_info = new TARG_INFO(this, e, a);
@@ -199,6 +199,12 @@ const char* CONSTANT::Array_buffer() const {
   return _const->Array_buffer();
 }
 
+char* CONSTANT::Array_mutable_buffer() {
+  AIR_ASSERT(Kind() == CONSTANT_KIND::ARRAY);
+  AIR_ASSERT(Type()->Is_array());
+  return _const->Array_buffer();
+}
+
 size_t CONSTANT::Array_size() const {
   // TODO: need type->Size();
   AIR_ASSERT(false);
@@ -426,6 +426,11 @@ const char* CONSTANT_DATA::Array_buffer() const {
   return ARRAY_CONSTANT_DATA::Cast_to_me(*this)._buf;
 }
 
+char* CONSTANT_DATA::Array_buffer() {
+  AIR_ASSERT(Kind() == CONSTANT_KIND::ARRAY);
+  return ARRAY_CONSTANT_DATA::Cast_to_me(*this)._buf;
+}
+
 size_t CONSTANT_DATA::Array_length() const {
   AIR_ASSERT(Kind() == CONSTANT_KIND::ARRAY);
   return ARRAY_CONSTANT_DATA::Cast_to_me(*this)._len;
@@ -7,6 +7,7 @@
 //=============================================================================
 
 #include <cstring>
+#include <string_view>
 
 #include "air/base/st.h"
 
@@ -81,5 +82,17 @@ void STR::Print(std::ostream& os, uint32_t indent) const {
 
 void STR::Print() const { Print(std::cout, 0); }
 
+//=============================================================================
+// class STR_KEY member functions
+//=============================================================================
+
+size_t STR_KEY::Hash() const {
+  return std::hash<std::string_view>()(std::string_view(_str, _len));
+}
+
+bool STR_KEY::operator==(const STR_KEY& o) const {
+  return _len == o._len && memcmp(_str, o._str, _len) == 0;
+}
+
 }  // namespace base
 }  // namespace air
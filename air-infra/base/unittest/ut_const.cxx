@@ -6,6 +6,9 @@
 //
 //=============================================================================
 
+#include <thread>
+#include <vector>
+
 #include "air/base/st.h"
 #include "gtest/gtest.h"
 
@@ -141,6 +144,75 @@ TEST(Constant, large_const_array) {
   }
 }
 
+TEST(Constant, intern_str_array_const) {
+  GLOB_SCOPE* glob  = GLOB_SCOPE::Get();
+  TYPE_PTR    etype = glob->Prim_type(PRIMITIVE_TYPE::FLOAT_32);
+  SPOS        spos  = glob->Unknown_simple_spos();
+
+  // same content returns the same string
+  STR_PTR str0 = glob->New_str("intern_mask");
+  STR_PTR str1 = glob->New_str("intern_mask");
+  STR_PTR str2 = glob->New_str("intern_mask_1");
+  EXPECT_EQ(str0->Id(), str1->Id());
+  EXPECT_NE(str0->Id(), str2->Id());
+
+  // same content of array types with the same element type and shape
+  // returns the same constant, other shapes are kept apart
+  std::vector<int64_t> dims{2, 3};
+  std::vector<int64_t> dims_t{3, 2};
+  TYPE_PTR     type0   = glob->New_arr_type("intern_mask0", etype, dims, spos);
+  TYPE_PTR     type1   = glob->New_arr_type("intern_mask1", etype, dims, spos);
+  TYPE_PTR     type2 =
+      glob->New_arr_type("intern_mask2", etype, dims_t, spos);
+  float        data[6] = {1.0, 0.0, 1.0, 0.0, 1.0, 0.0};
+  CONSTANT_PTR cst0 =
+      glob->New_const(CONSTANT_KIND::ARRAY, type0, data, sizeof(data));
+  CONSTANT_PTR cst1 =
+      glob->New_const(CONSTANT_KIND::ARRAY, type1, data, sizeof(data));
+  EXPECT_EQ(cst0->Id(), cst1->Id());
+  EXPECT_EQ(cst1->Type_id(), type0->Id());
+  CONSTANT_PTR cst_t =
+      glob->New_const(CONSTANT_KIND::ARRAY, type2, data, sizeof(data));
+  EXPECT_NE(cst0->Id(), cst_t->Id());
+  EXPECT_EQ(cst_t->Type_id(), type2->Id());
+  data[5] = 1.0;
+  CONSTANT_PTR cst2 =
+      glob->New_const(CONSTANT_KIND::ARRAY, type1, data, sizeof(data));
+  EXPECT_NE(cst0->Id(), cst2->Id());
+  // constant filled in place is never shared
+  CONSTANT_PTR cst3 =
+      glob->New_const(CONSTANT_KIND::ARRAY, type1, nullptr, sizeof(data));
+  CONSTANT_PTR cst4 =
+      glob->New_const(CONSTANT_KIND::ARRAY, type1, nullptr, sizeof(data));
+  EXPECT_NE(cst3->Id(), cst4->Id());
+
+  // string constants created concurrently are shared
+  std::vector<std::thread>  workers;
+  std::vector<CONSTANT_ID> str_cst(8);
+  for (uint32_t i = 0; i < str_cst.size(); ++i) {
+    workers.emplace_back([&, i]() {
+      str_cst[i] =
+          glob->New_const(CONSTANT_KIND::STR_ARRAY, str2->Id())->Id();
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  for (CONSTANT_ID id : str_cst) {
+    EXPECT_EQ(id, str_cst[0]);
+  }
+
+  // interned strings and constants are found in cloned scope
+  GLOB_SCOPE* new_glob = new GLOB_SCOPE(glob->Id(), true);
+  new_glob->Clone(*glob);
+  EXPECT_EQ(new_glob->New_str("intern_mask")->Id(), str0->Id());
+  EXPECT_EQ(
+      new_glob->New_const(CONSTANT_KIND::ARRAY, type1, data, sizeof(data))
+          ->Id(),
+      cst2->Id());
+  delete new_glob;
+}
+
 TEST(Constant, ext_const_file) {
   char                 cst1[]  = "Constant1";
   char                 cst2[]  = "Constant2";
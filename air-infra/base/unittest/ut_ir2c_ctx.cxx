@@ -0,0 +1,67 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "air/base/ir2c_ctx.h"
+#include "air/base/st.h"
+#include "gtest/gtest.h"
+
+using namespace air::base;
+
+TEST(IR2C_CTX, constants_blob) {
+  GLOB_SCOPE* glob  = new GLOB_SCOPE(0, true);
+  TYPE_PTR    etype = glob->Prim_type(PRIMITIVE_TYPE::FLOAT_32);
+  SPOS        spos  = glob->Unknown_simple_spos();
+  TYPE_PTR    type6 = glob->New_arr_type(glob->New_str("arr6"), etype,
+                                         glob->New_arb(0, 0, 6, 1), spos);
+  TYPE_PTR    type0 = glob->New_arr_type(glob->New_str("arr0"), etype,
+                                         glob->New_arb(0, 0, 0, 1), spos);
+
+  float        data[6]  = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+  float        other[6] = {6.0, 5.0, 4.0, 3.0, 2.0, 1.0};
+  CONSTANT_PTR unused =
+      glob->New_const(CONSTANT_KIND::ARRAY, type6, other, sizeof(other));
+  CONSTANT_PTR cst =
+      glob->New_const(CONSTANT_KIND::ARRAY, type6, data, sizeof(data));
+  CONSTANT_PTR empty = glob->New_const(CONSTANT_KIND::ARRAY, type0, data, 0);
+
+  std::ostringstream os;
+  IR2C_CTX           ctx(os);
+  ctx.Emit_constant_name(cst->Id());
+  ctx.Emit_constant_name(empty->Id());
+  os.str("");
+
+  // blob is written relative to cwd but referred by absolute path
+  const char* blob_file = "ut_ir2c_ctx.blob";
+  ctx.Emit_global_constants_blob(glob, blob_file);
+  std::string stub  = os.str();
+  std::string path  = std::filesystem::absolute(blob_file).string();
+  std::string name  = "_cst_" + std::to_string(cst->Id().Value());
+  std::string name0 = "_cst_" + std::to_string(empty->Id().Value());
+  std::string name1 = "_cst_" + std::to_string(unused->Id().Value());
+
+  EXPECT_NE(stub.find(".incbin \\\"" + path + "\\\", 0, 24"),
+            std::string::npos);
+  EXPECT_NE(stub.find(".type " + name + ", %object"), std::string::npos);
+  EXPECT_EQ(stub.find("@object"), std::string::npos);
+  EXPECT_EQ(stub.find("\"" + name1 + ":\\n\""), std::string::npos);
+  // empty array still gets a definition for its extern declaration
+  EXPECT_NE(stub.find("\"" + name0 + ":\\n\""), std::string::npos);
+  EXPECT_NE(stub.find(".size " + name0 + ", 0"), std::string::npos);
+
+  std::ifstream     ifs(blob_file, std::ios::binary);
+  std::vector<char> bytes((std::istreambuf_iterator<char>(ifs)),
+                          std::istreambuf_iterator<char>());
+  ASSERT_EQ(bytes.size(), sizeof(data));
+  EXPECT_EQ(memcmp(bytes.data(), data, sizeof(data)), 0);
+  std::filesystem::remove(blob_file);
+  delete glob;
+}
@@ -654,6 +654,25 @@ TEST_F(TEST_GLOB_SCOPE, new_entry_sym) { Run_test_new_entry_sym(); }
 TEST_F(TEST_GLOB_SCOPE, clone) { Run_test_clone(); }
 TEST_F(TEST_GLOB_SCOPE, init_targ_info) { Run_test_init_targ_info(); }
 
+// tables fixed by Reserve_str_const must not be reallocated under threads
+// looking them up, growing them is asserted until Release_str_const
+TEST_F(TEST_GLOB_SCOPE, reserve_str_const) {
+  _glob->Reserve_str_const(4);
+  STR_PTR str = _glob->New_str("reserved");
+  EXPECT_EQ(_glob->New_str("reserved")->Id(), str->Id());
+  EXPECT_DEATH(
+      {
+        for (uint32_t i = 0;; ++i) {
+          _glob->New_str(std::to_string(i).c_str());
+        }
+      },
+      "string or constant table grows beyond Reserve_str_const");
+  _glob->Release_str_const();
+  for (uint32_t i = 0; i < 10000; ++i) {
+    _glob->New_str(std::to_string(i).c_str());
+  }
+}
+
 class TEST_FUNC_SCOPE : public ::testing::Test {
 protected:
   void SetUp() override {
@@ -0,0 +1,138 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#define PROFILE
+
+#include "air/base/analyze_ctx.h"
+#include "air/base/st.h"
+#include "air/base/visitor.h"
+#include "air/core/default_handler.h"
+#include "air/core/handler.h"
+#include "air/core/opcode.h"
+#include "benchmark/benchmark.h"
+
+using namespace air::base;
+
+namespace {
+
+// context counting nodes visited
+class COUNT_CTX : public ANALYZE_CTX {
+public:
+  template <typename RETV, typename VISITOR>
+  RETV Handle_node(VISITOR* visitor, NODE_PTR node) {
+    ++_num_node;
+    return ANALYZE_CTX::Handle_node<RETV>(visitor, node);
+  }
+
+  template <typename RETV, typename VISITOR>
+  RETV Handle_block(VISITOR* visitor, NODE_PTR node) {
+    ++_num_node;
+    return ANALYZE_CTX::Handle_block<RETV>(visitor, node);
+  }
+
+  uint64_t Num_node() const { return _num_node; }
+
+private:
+  uint64_t _num_node = 0;
+};
+
+// expression tree of given depth, 2^depth - 1 operators over a and b
+NODE_PTR New_tree(CONTAINER* cntr, ADDR_DATUM_PTR a, ADDR_DATUM_PTR b,
+                  uint32_t depth, const SPOS& spos) {
+  if (depth == 0) {
+    return cntr->New_ld(a, spos);
+  }
+  return cntr->New_bin_arith(
+      (depth & 1) ? air::core::OPC_ADD : air::core::OPC_MUL,
+      New_tree(cntr, a, b, depth - 1, spos),
+      New_tree(cntr, b, a, depth - 1, spos), spos);
+}
+
+// function with num_stmt statements "x = <tree of depth>"
+FUNC_SCOPE* New_func(GLOB_SCOPE* glob, uint32_t num_stmt, uint32_t depth) {
+  SPOS     spos = glob->Unknown_simple_spos();
+  STR_PTR  name = glob->New_str("bm_visitor");
+  FUNC_PTR func = glob->New_func(name, spos);
+  func->Set_parent(glob->Comp_env_id());
+  SIGNATURE_TYPE_PTR sig  = glob->New_sig_type();
+  TYPE_PTR           s32  = glob->Prim_type(PRIMITIVE_TYPE::INT_S32);
+  glob->New_ret_param(s32, sig);
+  sig->Set_complete();
+  glob->New_entry_point(sig, func, name, spos);
+  FUNC_SCOPE* scope = &glob->New_func_scope(func);
+  CONTAINER*  cntr  = &scope->Container();
+  cntr->New_func_entry(spos);
+  ADDR_DATUM_PTR a  = scope->New_var(s32, "a", spos);
+  ADDR_DATUM_PTR b  = scope->New_var(s32, "b", spos);
+  ADDR_DATUM_PTR x  = scope->New_var(s32, "x", spos);
+  STMT_LIST      sl = cntr->Stmt_list();
+  for (uint32_t i = 0; i < num_stmt; ++i) {
+    sl.Append(cntr->New_st(New_tree(cntr, a, b, depth, spos), x, spos));
+  }
+  sl.Append(cntr->New_retv(cntr->New_ld(x, spos), spos));
+  return scope;
+}
+
+//! Visitor throughput over a function of statements with expression trees,
+//! reported as nodes visited per second
+void Bm_visitor(benchmark::State& state) {
+  air::core::Register_core();
+  GLOB_SCOPE* glob  = new GLOB_SCOPE(0, true);
+  FUNC_SCOPE* scope = New_func(glob, state.range(0), state.range(1));
+  NODE_PTR    entry = scope->Container().Entry_node();
+  uint64_t    num   = 0;
+  for (auto _ : state) {
+    COUNT_CTX                                                ctx;
+    VISITOR<COUNT_CTX, air::core::HANDLER<air::core::DEFAULT_HANDLER> > visitor(
+        ctx);
+    visitor.Visit<void>(entry);
+    num += ctx.Num_node();
+  }
+  state.counters["nodes"] =
+      benchmark::Counter(num, benchmark::Counter::kIsRate);
+  delete glob;
+  META_INFO::Remove_all();
+}
+
+//! Child walk without visitor, isolating the cost of child access
+uint64_t Walk(NODE_PTR node) {
+  uint64_t num = 1;
+  if (node->Is_block()) {
+    for (STMT_PTR stmt = node->Begin_stmt(); stmt != node->End_stmt();
+         stmt          = stmt->Next()) {
+      num += Walk(stmt->Node());
+    }
+    return num;
+  }
+  for (uint32_t i = 0; i < node->Num_child(); ++i) {
+    num += Walk(node->Child(i));
+  }
+  return num;
+}
+
+void Bm_child_walk(benchmark::State& state) {
+  air::core::Register_core();
+  GLOB_SCOPE* glob  = new GLOB_SCOPE(0, true);
+  FUNC_SCOPE* scope = New_func(glob, state.range(0), state.range(1));
+  NODE_PTR    entry = scope->Container().Entry_node();
+  uint64_t    num   = 0;
+  for (auto _ : state) {
+    num += Walk(entry);
+  }
+  state.counters["nodes"] =
+      benchmark::Counter(num, benchmark::Counter::kIsRate);
+  delete glob;
+  META_INFO::Remove_all();
+}
+
+}  // namespace
+
+BENCHMARK(Bm_visitor)->Args({1000, 4})->Args({100, 10});
+BENCHMARK(Bm_child_walk)->Args({1000, 4})->Args({100, 10});
+
+BENCHMARK_MAIN();
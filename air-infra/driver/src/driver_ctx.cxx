@@ -8,6 +8,11 @@
 
 #include "air/driver/driver_ctx.h"
 
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
 #include "air/base/meta_info.h"
 
 namespace air {
@@ -26,6 +31,47 @@ void DRIVER_CTX::Handle_global_options() {
 
 void DRIVER_CTX::Teardown(R_CODE rc) { exit((int)rc); }
 
+// 64-bit FNV-1a hash of data, continued from hash
+static uint64_t Fnv_hash(uint64_t hash, const char* data, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    hash ^= (uint8_t)data[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+std::string DRIVER_CTX::Ir_cache_file(const char* pass,
+                                      uint32_t    num_grp) const {
+  namespace fs = std::filesystem;
+  if (*_config.Ir_cache() == '\0' || _option_mgr.Ifile() == nullptr) {
+    return std::string();
+  }
+  // compiler is identified by size and time of its executable like ccache
+  std::ostringstream key;
+  std::error_code    ec;
+  fs::path           exe = fs::read_symlink("/proc/self/exe", ec);
+  if (!ec) {
+    key << exe.string() << ":" << fs::file_size(exe, ec) << ":"
+        << fs::last_write_time(exe, ec).time_since_epoch().count()
+        << std::endl;
+  }
+  key << pass << std::endl;
+  _option_mgr.Print_value(key, num_grp);
+
+  uint64_t      hash = Fnv_hash(0xcbf29ce484222325ULL, key.str().c_str(),
+                                key.str().size());
+  std::ifstream ifile(_option_mgr.Ifile(), std::ios::binary);
+  char          buf[64 * 1024];
+  while (ifile.read(buf, sizeof(buf)) || ifile.gcount() > 0) {
+    hash = Fnv_hash(hash, buf, ifile.gcount());
+  }
+
+  std::ostringstream name;
+  name << pass << "_" << std::hex << std::setw(16) << std::setfill('0')
+       << hash << ".B";
+  return (fs::path(_config.Ir_cache()) / name.str()).string();
+}
+
 }  // namespace driver
 
 }  // namespace air
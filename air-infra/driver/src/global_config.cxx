@@ -35,6 +35,10 @@ static OPTION_DESC Global_option[] = {
     {"print-meta", "",  "Print all meta information",     &Global_config._print_meta,
      K_NONE,                                                                                  0, V_NONE },
     {"o",          "",  "Set output file name",           &Global_config._ofile,      K_STR,  0, V_SPACE},
+    {"jobs",       "j", "Number of threads to run GVN/DCE/LICM on functions concurrently",
+     &Global_config._jobs,                                                                    K_UINT64, 0, V_EQUAL},
+    {"ir_cache",   "",  "Set directory to cache IR generated by cacheable passes",
+     &Global_config._ir_cache,                                                                K_STR,  0, V_EQUAL},
 };
 
 static OPTION_DESC_HANDLE Global_option_handle = {
@@ -61,6 +65,8 @@ void GLOBAL_CONFIG::Print(std::ostream& os) const {
   os << "  Print pass: " << (_print_pass ? "Yes" : "No") << std::endl;
   os << "  Print meta: " << (_print_meta ? "Yes" : "No") << std::endl;
   os << "  Output: " << _ofile << std::endl;
+  os << "  Jobs: " << Jobs() << std::endl;
+  os << "  IR cache: " << _ir_cache << std::endl;
 }
 
 }  // namespace driver
@@ -0,0 +1,108 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include <string>
+
+#include "air/core/opcode.h"
+#include "air/driver/driver.h"
+
+using namespace air::base;
+using namespace air::driver;
+
+namespace {
+
+constexpr uint32_t NUM_FUNC = 16;
+constexpr uint32_t NUM_VAR  = 200;
+
+class TEST_DRIVER;
+
+// function-local pass creating variables with new names in each function
+class VAR_PASS : public PASS<air::util::COMMON_CONFIG> {
+public:
+  R_CODE Init(TEST_DRIVER* driver) { return R_CODE::NORMAL; }
+  R_CODE Pre_run() { return R_CODE::NORMAL; }
+  R_CODE Run() { return R_CODE::INTERNAL; }
+  bool   Is_func_local() const { return true; }
+  R_CODE Run_func(FUNC_SCOPE* func) {
+    TYPE_PTR    s32  = func->Glob_scope().Prim_type(PRIMITIVE_TYPE::INT_S32);
+    std::string name = func->Owning_func()->Name()->Char_str();
+    for (uint32_t i = 0; i < NUM_VAR; ++i) {
+      func->New_var(s32, (name + "_v" + std::to_string(i)).c_str(),
+                    func->Glob_scope().Unknown_simple_spos());
+    }
+    return R_CODE::NORMAL;
+  }
+  const char* Name() const { return "VAR_PASS"; }
+};
+
+class TEST_DRIVER : public DRIVER {
+public:
+  TEST_DRIVER() : DRIVER(true) {}
+
+  R_CODE Init(int argc, char** argv) {
+    DRIVER::Init(argc, argv);
+    return _pass_mgr.Init(this);
+  }
+  R_CODE Pre_run() { return _pass_mgr.Pre_run(this); }
+  R_CODE Run() { return _pass_mgr.Run(this); }
+
+private:
+  PASS_MANAGER<VAR_PASS> _pass_mgr;
+};
+
+void Create_func(GLOB_SCOPE* glob, uint32_t idx) {
+  SPOS     spos = glob->Unknown_simple_spos();
+  STR_PTR  name = glob->New_str(("foo" + std::to_string(idx)).c_str());
+  FUNC_PTR func = glob->New_func(name, spos);
+  func->Set_parent(glob->Comp_env_id());
+  SIGNATURE_TYPE_PTR sig = glob->New_sig_type();
+  glob->New_ret_param(glob->Prim_type(PRIMITIVE_TYPE::VOID), sig);
+  sig->Set_complete();
+  glob->New_entry_point(sig, func, name, spos);
+  FUNC_SCOPE* scope = &glob->New_func_scope(func);
+  scope->Container().New_func_entry(spos);
+}
+
+// check each function owns all its variables with expected names
+int Check_var(GLOB_SCOPE* glob) {
+  uint32_t num_func = 0;
+  for (GLOB_SCOPE::FUNC_SCOPE_ITER it = glob->Begin_func_scope();
+       it != glob->End_func_scope(); ++it, ++num_func) {
+    FUNC_SCOPE* func   = &(*it);
+    std::string prefix = func->Owning_func()->Name()->Char_str();
+    uint32_t    num    = 0;
+    for (VAR_ITER var = func->Begin_var(); var != func->End_var(); ++var) {
+      if ((*var)->Name()->Char_str() != prefix + "_v" + std::to_string(num)) {
+        return 1;
+      }
+      ++num;
+    }
+    if (num != NUM_VAR) {
+      return 1;
+    }
+  }
+  return num_func == NUM_FUNC ? 0 : 1;
+}
+
+}  // namespace
+
+int main() {
+  air::core::Register_core();
+  int         argc   = 3;
+  const char* argv[] = {"driver", "-jobs=4", "/dev/null"};
+  TEST_DRIVER driver;
+  driver.Init(argc, (char**)argv);
+  for (uint32_t i = 0; i < NUM_FUNC; ++i) {
+    Create_func(driver.Glob_scope(), i);
+  }
+  if (driver.Jobs() != 4 || driver.Pre_run() != R_CODE::NORMAL ||
+      driver.Run() != R_CODE::NORMAL) {
+    return 1;
+  }
+  return Check_var(driver.Glob_scope());
+}
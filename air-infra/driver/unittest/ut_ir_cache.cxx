@@ -0,0 +1,192 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "air/core/opcode.h"
+#include "air/driver/driver.h"
+#include "gtest/gtest.h"
+
+using namespace air::base;
+using namespace air::driver;
+
+namespace {
+
+constexpr uint32_t NUM_VAR = 100;
+// constant larger than MAPPED_SIZE for the cache file to grow on demand
+constexpr uint32_t NUM_ELEM = 2 << 20;
+
+class CACHE_DRIVER;
+
+// cacheable pass creating function foo with NUM_VAR variables and a
+// constant of NUM_ELEM floats
+class FOO_PASS : public PASS<air::util::COMMON_CONFIG> {
+public:
+  R_CODE Init(CACHE_DRIVER* driver);
+  R_CODE Pre_run() { return R_CODE::NORMAL; }
+  R_CODE Run();
+  bool        Is_cacheable() const { return true; }
+  const char* Name() const { return "FOO_PASS"; }
+
+  static uint32_t Num_run;
+
+private:
+  CACHE_DRIVER* _driver = nullptr;
+};
+
+uint32_t FOO_PASS::Num_run = 0;
+
+class CACHE_DRIVER : public DRIVER {
+public:
+  CACHE_DRIVER() : DRIVER(true) {}
+
+  R_CODE Init(int argc, char** argv) {
+    DRIVER::Init(argc, argv);
+    return _pass_mgr.Init(this);
+  }
+  R_CODE Pre_run() { return _pass_mgr.Pre_run(this); }
+  R_CODE Run() { return _pass_mgr.Run(this); }
+
+private:
+  PASS_MANAGER<FOO_PASS> _pass_mgr;
+};
+
+R_CODE FOO_PASS::Init(CACHE_DRIVER* driver) {
+  _driver = driver;
+  return R_CODE::NORMAL;
+}
+
+R_CODE FOO_PASS::Run() {
+  ++Num_run;
+  GLOB_SCOPE* glob = _driver->Glob_scope();
+  SPOS        spos = glob->Unknown_simple_spos();
+  STR_PTR     name = glob->New_str("foo");
+  FUNC_PTR    func = glob->New_func(name, spos);
+  func->Set_parent(glob->Comp_env_id());
+  SIGNATURE_TYPE_PTR sig = glob->New_sig_type();
+  glob->New_ret_param(glob->Prim_type(PRIMITIVE_TYPE::VOID), sig);
+  sig->Set_complete();
+  glob->New_entry_point(sig, func, name, spos);
+  FUNC_SCOPE* scope = &glob->New_func_scope(func);
+  scope->Container().New_func_entry(spos);
+  TYPE_PTR s32 = glob->Prim_type(PRIMITIVE_TYPE::INT_S32);
+  for (uint32_t i = 0; i < NUM_VAR; ++i) {
+    scope->New_var(s32, ("v" + std::to_string(i)).c_str(), spos);
+  }
+  std::vector<float> data(NUM_ELEM);
+  for (uint32_t i = 0; i < NUM_ELEM; ++i) {
+    data[i] = i;
+  }
+  TYPE_PTR arr = glob->New_arr_type(
+      glob->New_str("arr"), glob->Prim_type(PRIMITIVE_TYPE::FLOAT_32),
+      glob->New_arb(1, 0, NUM_ELEM, 1), spos);
+  glob->New_const(CONSTANT_KIND::ARRAY, arr, data.data(),
+                  NUM_ELEM * sizeof(float));
+  return R_CODE::NORMAL;
+}
+
+class TEST_IR_CACHE : public ::testing::Test {
+protected:
+  void SetUp() override {
+    air::core::Register_core();
+    _dir   = testing::TempDir() + "ir_cache_test";
+    _ifile = testing::TempDir() + "ir_cache_test.onnx";
+    std::filesystem::remove_all(_dir);
+    Write_input("model 1");
+    FOO_PASS::Num_run = 0;
+  }
+
+  void TearDown() override {
+    std::filesystem::remove_all(_dir);
+    std::filesystem::remove(_ifile);
+    // trace files of driver are named after input in current directory
+    std::filesystem::remove("ir_cache_test.t");
+    std::filesystem::remove("ir_cache_test.json");
+    META_INFO::Remove_all();
+  }
+
+  void Write_input(const char* content) {
+    std::ofstream ofs(_ifile, std::ios::binary | std::ios::trunc);
+    ofs << content;
+  }
+
+  // run driver on input file, with -ir_cache if cache is true, return names
+  // of function and variables in the resulting IR
+  std::string Compile(bool cache = true) {
+    std::string  opt    = "-ir_cache=" + _dir;
+    const char*  argv[] = {"driver", _ifile.c_str(), opt.c_str()};
+    CACHE_DRIVER driver;
+    driver.Init(cache ? 3 : 2, (char**)argv);
+    EXPECT_EQ(driver.Pre_run(), R_CODE::NORMAL);
+    EXPECT_EQ(driver.Run(), R_CODE::NORMAL);
+    std::string var;
+    GLOB_SCOPE* glob = driver.Glob_scope();
+    for (GLOB_SCOPE::FUNC_SCOPE_ITER it = glob->Begin_func_scope();
+         it != glob->End_func_scope(); ++it) {
+      var += (*it).Owning_func()->Name()->Char_str();
+      for (VAR_ITER v = (*it).Begin_var(); v != (*it).End_var(); ++v) {
+        var += std::string(" ") + (*v)->Name()->Char_str();
+      }
+    }
+    for (CONSTANT_ITER it = glob->Begin_const(); it != glob->End_const();
+         ++it) {
+      if ((*it)->Kind() == CONSTANT_KIND::ARRAY) {
+        const float* data = (*it)->Array_ptr<float>();
+        uint32_t     num  = (*it)->Array_byte_len() / sizeof(float);
+        var += " cst " + std::to_string(num) + " " +
+               std::to_string(data[num - 1]);
+      }
+    }
+    return var;
+  }
+
+  uint32_t Num_cache_file() {
+    uint32_t        num = 0;
+    std::error_code ec;
+    for (auto& entry : std::filesystem::directory_iterator(_dir, ec)) {
+      EXPECT_EQ(entry.path().extension(), ".B");
+      // written on demand and truncated, not a sparse reserved window
+      EXPECT_GT(entry.file_size(), NUM_ELEM * sizeof(float));
+      EXPECT_LT(entry.file_size(), 2 * NUM_ELEM * sizeof(float));
+      ++num;
+    }
+    return num;
+  }
+
+  std::string _dir;
+  std::string _ifile;
+};
+
+// miss runs the pass and writes the cache, hit reads the same IR back
+TEST_F(TEST_IR_CACHE, hit_miss_round_trip) {
+  // options are global and can't be unset, so run without -ir_cache first
+  std::string expected = Compile(false);
+  EXPECT_EQ(expected.substr(0, 9), "foo v0 v1");
+  EXPECT_NE(expected.find(" cst 2097152 2097151"), std::string::npos);
+  EXPECT_EQ(FOO_PASS::Num_run, 1);
+  EXPECT_FALSE(std::filesystem::exists(_dir));
+
+  EXPECT_EQ(Compile(), expected);
+  EXPECT_EQ(FOO_PASS::Num_run, 2);
+  EXPECT_EQ(Num_cache_file(), 1);
+
+  EXPECT_EQ(Compile(), expected);
+  EXPECT_EQ(FOO_PASS::Num_run, 2);
+  EXPECT_EQ(Num_cache_file(), 1);
+
+  // another input misses and gets its own cache file
+  Write_input("model 2");
+  EXPECT_EQ(Compile(), expected);
+  EXPECT_EQ(FOO_PASS::Num_run, 3);
+  EXPECT_EQ(Num_cache_file(), 2);
+}
+
+}  // namespace
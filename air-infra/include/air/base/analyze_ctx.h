@@ -80,7 +80,9 @@ public:
   //! @brief default NODE handler
   template <typename RETV, typename VISITOR>
   RETV Handle_node(VISITOR* visitor, NODE_PTR node) {
-    for (uint32_t i = 0; i < node->Num_child(); ++i) {
+    // analysis doesn't change number of children
+    uint32_t num_child = node->Num_child();
+    for (uint32_t i = 0; i < num_child; ++i) {
       visitor->template Visit<RETV>(node->Child(i));
     }
     return RETV();
@@ -78,6 +78,13 @@ public:
 
   uint32_t Size() const { return _core.Size(); }
 
+  //! @brief Reserve ID slots for num more items, so that allocating them
+  //! doesn't move the ID to address table looked up by Find
+  void Reserve(uint32_t num) { _core.Reserve(num); }
+
+  //! @brief Number of items that can be allocated without moving the table
+  uint32_t Room() const { return _core.Room(); }
+
   void Adjust_addr(uint32_t base_id, size_t ofst) {
     _core.Adjust_addr(base_id, ofst);
   }
@@ -127,6 +134,17 @@ protected:
     return _core.Recovery_offset(addr, pos);
   }
 
+  //! @brief Size in bytes written by Archive
+  size_t Archive_size() const { return _core.Archive_size(); }
+
+  //! @brief Size in bytes written by Archive_offset
+  size_t Archive_offset_size() const { return _core.Archive_offset_size(); }
+
+  //! @brief Copy sz bytes of data read from file into memory of the arena
+  BYTE_PTR Copy_data(BYTE_PTR data, size_t sz) {
+    return _core.Copy_data(data, sz);
+  }
+
 private:
   ARENA(const MY_TYPE& o);
   MY_TYPE& operator=(const MY_TYPE&);
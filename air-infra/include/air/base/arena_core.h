@@ -44,6 +44,11 @@ private:
 
   uint32_t Compute_new_id(BYTE_PTR addr, size_t sz);
   uint32_t Size() const { return _id_array.size(); }
+  void     Reserve(uint32_t num) {
+    _id_array.reserve(_id_array.size() + num);
+    _sz_array.reserve(_sz_array.size() + num);
+  }
+  uint32_t Room() const { return _id_array.capacity() - _id_array.size(); }
 
   void* Find(uint32_t id) const {
     void* ptr = _id_array[id];
@@ -80,6 +85,14 @@ private:
     }
   }
 
+  size_t Archive_size() const {
+    size_t sz = sizeof(uint32_t) * (1 + _sz_array.size());
+    for (uint32_t item_sz : _sz_array) {
+      sz += item_sz;
+    }
+    return sz;
+  }
+
   BYTE_PTR Archive(BYTE_PTR pos) {
     uint32_t num = _id_array.size();
     memcpy(pos, reinterpret_cast<BYTE_PTR>(&num), sizeof(uint32_t));
@@ -114,6 +127,10 @@ private:
     return pos;
   }
 
+  size_t Archive_offset_size() const {
+    return sizeof(uint32_t) * (1 + _id_array.size());
+  }
+
   BYTE_PTR Archive_offset(BYTE_PTR pos, uint32_t* sz) {
     uint32_t num = _id_array.size();
     memcpy(pos, reinterpret_cast<BYTE_PTR>(&num), sizeof(uint32_t));
@@ -127,6 +144,12 @@ private:
     return pos;
   }
 
+  BYTE_PTR Copy_data(BYTE_PTR data, size_t sz) {
+    BYTE_PTR addr = (BYTE_PTR)_allocator->Allocate(sz);
+    memcpy(addr, data, sz);
+    return addr;
+  }
+
   BYTE_PTR Recovery_offset(BYTE_PTR addr, BYTE_PTR pos) {
     _id_array.clear();
     _sz_array.clear();
@@ -218,6 +241,8 @@ public:
   void     Deallocate(uint32_t id) { _item_array.Deallocate(id); }
   void*    Find(uint32_t id) const { return _item_array.Find(id); }
   uint32_t Size() const { return _item_array.Size(); }
+  void     Reserve(uint32_t num) { _item_array.Reserve(num); }
+  uint32_t Room() const { return _item_array.Room(); }
   uint32_t Compute_new_id(char* addr, size_t sz) {
     return _item_array.Compute_new_id(addr, sz);
   }
@@ -235,6 +260,13 @@ public:
 
   BYTE_PTR Archive(BYTE_PTR pos) { return _item_array.Archive(pos); }
   BYTE_PTR Recovery(BYTE_PTR pos) { return _item_array.Recovery(pos); }
+  size_t   Archive_size() const { return _item_array.Archive_size(); }
+  size_t   Archive_offset_size() const {
+    return _item_array.Archive_offset_size();
+  }
+  BYTE_PTR Copy_data(BYTE_PTR data, size_t sz) {
+    return _item_array.Copy_data(data, sz);
+  }
 
   BYTE_PTR Archive_offset(BYTE_PTR pos, uint32_t* sz) {
     return _item_array.Archive_offset(pos, sz);
@@ -308,6 +308,10 @@ private:
   GLOB_SCOPE* _glob;
 };
 
+inline NODE_PTR NODE::Child(uint32_t num) const {
+  return NODE_PTR(NODE(_cont, _cont->Code_arena()->Find(Child_id(num))));
+}
+
 }  // namespace base
 }  // namespace air
 
@@ -9,6 +9,8 @@
 #ifndef AIR_BASE_IR2C_CTX_H
 #define AIR_BASE_IR2C_CTX_H
 
+#include <filesystem>
+#include <fstream>
 #include <iomanip>
 #include <limits>
 #include <ostream>
@@ -213,6 +215,70 @@ public:
     }
   }
 
+  //! @brief Emit all used global constant arrays into binary file blob_file
+  //! instead of C array literals. Each array is bound to the same symbol as
+  //! Emit_constant_array by an assembler .incbin stub, so that compile time
+  //! of generated C code is independent of the size of constants. The stub
+  //! refers to blob_file by absolute path so that the generated C file can be
+  //! compiled from any directory.
+  void Emit_global_constants_blob(GLOB_SCOPE* glob, const char* blob_file) {
+    std::ofstream blob(blob_file, std::ios::binary | std::ios::trunc);
+    AIR_ASSERT_MSG(blob.is_open(), "failed to open blob file %s", blob_file);
+    std::string blob_path = std::filesystem::absolute(blob_file).string();
+    uint64_t    ofst      = 0;
+    for (CONSTANT_ITER it = glob->Begin_const(); it != glob->End_const();
+         ++it) {
+      CONSTANT_PTR cst = *it;
+      if (cst->Kind() != CONSTANT_KIND::ARRAY ||
+          _cst_used.find(cst->Id().Value()) == _cst_used.end()) {
+        continue;
+      }
+      uint64_t len = cst->Array_byte_len();
+      if (len == 0) {
+        // still define the symbol declared extern by Emit_constant_array
+        Emit_constant_incbin(cst->Id(), blob_path.c_str(), ofst, 0);
+        continue;
+      }
+      // keep each array cache line aligned in blob and in section
+      uint64_t pad = (BLOB_ALIGN - ofst % BLOB_ALIGN) % BLOB_ALIGN;
+      for (uint64_t i = 0; i < pad; ++i) {
+        blob.put(0);
+      }
+      ofst += pad;
+      blob.write(cst->Array_buffer(), len);
+      Emit_constant_incbin(cst->Id(), blob_path.c_str(), ofst, len);
+      ofst += len;
+    }
+    AIR_ASSERT_MSG(blob.good(), "failed to write blob file %s", blob_file);
+  }
+
+  //! @brief Emit assembler stub to define constant cst with len bytes at
+  //! ofst of blob_file in read-only data section. An empty array only gets
+  //! its label. Type is written as %object, which unlike @object is also
+  //! accepted by assemblers where @ starts a comment, e.g. ARM
+  void Emit_constant_incbin(CONSTANT_ID cst, const char* blob_file,
+                            uint64_t ofst, uint64_t len) {
+    _os << "__asm__(\".pushsection .rodata\\n\"" << std::endl;
+    _os << "        \".balign " << BLOB_ALIGN << "\\n\"" << std::endl;
+    _os << "        \".globl ";
+    Emit_constant_id(cst);
+    _os << "\\n\"" << std::endl;
+    _os << "        \".type ";
+    Emit_constant_id(cst);
+    _os << ", %object\\n\"" << std::endl;
+    _os << "        \"";
+    Emit_constant_id(cst);
+    _os << ":\\n\"" << std::endl;
+    if (len > 0) {
+      _os << "        \".incbin \\\"" << blob_file << "\\\", " << ofst << ", "
+          << len << "\\n\"" << std::endl;
+    }
+    _os << "        \".size ";
+    Emit_constant_id(cst);
+    _os << ", " << len << "\\n\"" << std::endl;
+    _os << "        \".popsection\");" << std::endl;
+  }
+
   //! @brief Emit all global type definitions
   void Emit_global_type(GLOB_SCOPE* glob) {
     _os << "// global types definition" << std::endl;
@@ -470,6 +536,8 @@ public:
   }
 
 protected:
+  static constexpr uint64_t BLOB_ALIGN = 64;
+
   std::ostream&                _os;
   std::unordered_set<uint32_t> _cst_used;
   int                          _level;
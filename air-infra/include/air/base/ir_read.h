@@ -39,6 +39,7 @@ public:
     Recovery(glob->Func_def_table(), air::util::SHDR::FUNC_DEF_TAB);
     Recovery(glob->Blk_table(), air::util::SHDR::BLK_TAB);
 
+    glob->Rebuild_intern_map();
     Set_func(glob);
   }
 
@@ -142,9 +143,9 @@ private:
     uint32_t sz     = *reinterpret_cast<uint32_t*>(pos + len);
     BYTE_PTR offset = pos + len + sizeof(uint32_t);
 
-    // Recovery node address with map address for leave out memcpy
-    pos = code->Recovery_offset(offset, pos);
-    // memcpy((BYTE_PTR)&cntr + sizeof(CONTAINER), pos, sz);
+    // Copy node data out of the read-only map, nodes are lowered in place
+    BYTE_PTR data = code->Copy_data(offset, sz);
+    pos           = code->Recovery_offset(data, pos);
 
     // position to next function
     pos += sz + sizeof(uint32_t);
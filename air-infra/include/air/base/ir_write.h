@@ -60,6 +60,7 @@ public:
 
       // hander func id and fun def id
       FUNC_ID id = func->Id();
+      _elf.Reserve(pos, 2 * sizeof(uint32_t));
       memcpy(pos, reinterpret_cast<BYTE_PTR>(&id), sizeof(uint32_t));
       pos += sizeof(uint32_t);
       uint32_t def_id = func->Owning_func()->Func_def_data().Id().Value();
@@ -67,6 +68,10 @@ public:
       pos += sizeof(uint32_t);
 
       // hander func table and data
+      _elf.Reserve(pos, func->Main_table().Archive_size() +
+                            func->Aux_table().Archive_size() +
+                            func->Attr_table().Archive_size() +
+                            func->Preg_table().Archive_size());
       pos = func->Main_table().Archive(pos);
       pos = func->Aux_table().Archive(pos);
       pos = func->Attr_table().Archive(pos);
@@ -93,6 +98,7 @@ private:
     AIR_ASSERT(unit_sz != 0);
     AIR_ASSERT(align != 0);
 
+    _elf.Reserve(offset, t.Archive_size());
     BYTE_PTR pos = t.Archive(offset);
     _elf.Set_pos(pos);
     _elf.Update_shdr(s, offset, pos - offset, align, 0);
@@ -118,8 +124,10 @@ private:
     uint32_t    sz   = 0;
 
     // Archive offsest for node and Container size
+    _elf.Reserve(pos, code->Archive_offset_size());
     pos = code->Archive_offset(pos, &sz);
     sz += 0x40;  // TODO: Length of the last node, not processed for now
+    _elf.Reserve(pos, sizeof(uint32_t) + sz);
     memcpy(pos, reinterpret_cast<BYTE_PTR>(&sz), sizeof(uint32_t));
     pos += sizeof(uint32_t);
 
@@ -232,6 +232,18 @@ public:
     return Op_name(opc.Domain(), opc.Operator());
   }
 
+  /**
+   * @brief Operator information
+   *
+   * @param opc OPCODE
+   * @return const OPR_INFO& Operator information with number of kids,
+   * fields and properties, looked up once for all of them
+   */
+  static const OPR_INFO& Op_info(OPCODE opc) {
+    AIR_ASSERT(Valid_opcode(opc));
+    return Domains[opc.Domain()]->_opr_info[opc.Operator()];
+  }
+
   /**
    * @brief Number of operator kids, -1 means no fixed number of kids
    *
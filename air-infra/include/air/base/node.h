@@ -9,6 +9,7 @@
 #ifndef AIR_BASE_NODE_H
 #define AIR_BASE_NODE_H
 
+#include "air/base/meta_info.h"
 #include "air/base/node_data.h"
 #include "air/base/st_attr.h"
 #include "air/base/st_decl.h"
@@ -209,6 +210,7 @@ private:
   bool     Is_null() const { return _data.Is_null(); }
   uint32_t Num_fld() const;
   uint32_t Num_added_chld() const;
+  uint32_t Num_child(const OPR_INFO& info) const;
 
   NODE_DATA_PTR Data() const { return _data; }
 
@@ -218,6 +220,46 @@ private:
   NODE_DATA_PTR _data;
 };
 
+// accessors used by every child access during IR traversal are inlined,
+// they read the opcode from node data and the operator table only
+
+inline OPCODE NODE::Opcode() const {
+  return OPCODE(_data->_comm._core._opcode);
+}
+
+inline bool NODE::Is_lib_call() const {
+  return META_INFO::Has_prop<OPR_PROP::LIB_CALL>(Opcode());
+}
+
+inline bool NODE::Has_added_chld() const {
+  return META_INFO::Has_prop<OPR_PROP::EX_CHILD>(Opcode());
+}
+
+inline uint32_t NODE::Num_fld() const {
+  return META_INFO::Op_info(Opcode())._nflds;
+}
+
+inline uint32_t NODE::Num_added_chld() const {
+  AIR_ASSERT(Has_added_chld());
+  return _data->_comm._core._num_added_chld;
+}
+
+inline uint32_t NODE::Num_child(const OPR_INFO& info) const {
+  uint32_t num = info._nkids;
+  return (info._prop & PROP_EX_CHILD) ? num + _data->_comm._core._num_added_chld
+                                      : num;
+}
+
+inline uint32_t NODE::Num_child() const {
+  return Num_child(META_INFO::Op_info(Opcode()));
+}
+
+inline NODE_ID NODE::Child_id(uint32_t num) const {
+  const OPR_INFO& info = META_INFO::Op_info(Opcode());
+  AIR_ASSERT(Num_child(info) > num);
+  return NODE_ID(_data->_uu._fields[info._nflds + num]);
+}
+
 class STMT {
   friend class CONTAINER;
   friend class NODE;
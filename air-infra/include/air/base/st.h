@@ -9,6 +9,7 @@
 #ifndef AIR_BASE_ST_H
 #define AIR_BASE_ST_H
 
+#include <mutex>
 #include <unordered_map>
 
 #include "air/base/container_decl.h"
@@ -319,7 +320,10 @@ public:
   CONSTANT_PTR New_const(CONSTANT_KIND ck);
   CONSTANT_PTR New_const(CONSTANT_KIND ck, CONST_CONSTANT_PTR base,
                          int64_t idx_or_ofst);
-  //! New array constant
+  //! New array constant. If buf is nullptr, the constant is zero-initialized
+  //! and can be filled in place with CONSTANT::Array_mutable_ptr().
+  //! Otherwise the constant is interned: an existing array constant with the
+  //! same element type, shape and content is returned instead of a new one
   CONSTANT_PTR New_const(CONSTANT_KIND ck, CONST_TYPE_PTR type, void* buf,
                          size_t byte);
   CONSTANT_PTR New_const(CONSTANT_KIND ck, STR_ID str);
@@ -482,9 +486,20 @@ public:
   FILE_PTR New_file(CONST_STR_PTR name, LANG lang) {
     return New_file(name->Id(), lang);
   }
-  //! New string literal
+  //! New string literal. Strings are interned, an existing string with the
+  //! same content is returned instead of a new one
   STR_PTR New_str(const char* str, size_t len = 0);
 
+  //! Reserve room for num more strings and constants and fix the tables
+  //! until Release_str_const. New_str and New_const are serialized by a lock
+  //! and may be called from functions processed concurrently, while other
+  //! threads look up the tables without the lock; running out of the
+  //! reserved room, which would reallocate the tables, is asserted.
+  void Reserve_str_const(uint32_t num);
+
+  //! Let tables fixed by Reserve_str_const grow again
+  void Release_str_const();
+
   FUNC_SCOPE& New_func_scope(FUNC_PTR func, bool open = true);
   FUNC_SCOPE& New_func_scope(FUNC_ID     func,
                              FUNC_DEF_ID def  = (FUNC_DEF_ID)Null_st_id,
@@ -522,6 +537,10 @@ public:
   //! Clone global tables, set all functions to undefined
   //! if function scopes are cloned as well
   void Clone(GLOB_SCOPE& glob, bool clone_func_scope = true);
+
+  //! Rebuild hash maps used to intern strings and constants from tables,
+  //! called after tables are cloned or read from file
+  void Rebuild_intern_map();
   void Delete_sym(SYM_PTR);
 
   void Init_targ_info(ENDIANNESS e, ARCHITECTURE a);
@@ -551,6 +570,11 @@ private:
                          int64_t idx_or_ofst);
   CONSTANT_PTR New_const(CONSTANT_KIND ck, TYPE_ID type, long double val);
   FILE_PTR     New_file(STR_ID name, LANG lang);
+  STR_ID       Find_str(const STR_KEY& key, size_t hash) const;
+  CONSTANT_ID  Find_array_const(CONST_TYPE_PTR type, const void* buf,
+                                size_t byte, size_t hash) const;
+  void         Check_str_const_room() const;
+  CONSTANT_PTR Alloc_const(CONSTANT_KIND ck);
 
   TYPE_TAB*     _type_tab;
   CONSTANT_TAB* _const_tab;
@@ -576,6 +600,17 @@ private:
 
   typedef std::map<uint32_t, EXT_CONST_FILE*> ECF_MAP;
   ECF_MAP                                     _ecf_map;
+
+  // content hash to ids of interned strings and array constants, and id of
+  // string to id of its STR_ARRAY constant
+  typedef std::unordered_multimap<size_t, uint32_t> INTERN_MAP;
+  typedef std::unordered_map<uint32_t, uint32_t>    STR_CONST_MAP;
+  INTERN_MAP                                        _str_map;
+  INTERN_MAP                                        _array_const_map;
+  STR_CONST_MAP                                     _str_const_map;
+
+  std::mutex _str_const_lock;            // serialize New_str/New_const
+  bool       _str_const_fixed = false;  // set by Reserve_str_const
 };
 
 template <SYMBOL_CLASS T>
@@ -101,7 +101,15 @@ public:
     AIR_ASSERT(index < (Array_byte_len() / sizeof(ELEM_TYPE)));
     return Array_ptr<ELEM_TYPE>()[index];
   }
+  //! Writable view of array buffer, used to fill a constant created with a
+  //! null buffer in place. Pointer is only valid until next constant is
+  //! allocated in the same GLOB_SCOPE.
+  template <typename ELEM_TYPE>
+  ELEM_TYPE* Array_mutable_ptr() {
+    return (ELEM_TYPE*)Array_mutable_buffer();
+  }
   const char* Array_buffer() const;
+  char*       Array_mutable_buffer();
   size_t      Array_size() const;
   size_t      Array_byte_len() const;
 
@@ -398,6 +398,7 @@ public:
   SPOS          Named_spos() const;
   STR_ID        Named_name() const;
   const char*   Array_buffer() const;
+  char*         Array_buffer();
   size_t        Array_length() const;
   FILE_ID       Ext_file() const;
   uint64_t      Ext_ofst() const;
@@ -581,7 +582,11 @@ public:
     AIR_ASSERT(k == CONSTANT_KIND::ARRAY);
     Set_type(type);
     _len = sz;
-    memcpy(_buf, buf, sz);
+    if (buf != nullptr) {
+      memcpy(_buf, buf, sz);
+    } else {
+      memset(_buf, 0, sz);
+    }
   }
 
   static ARRAY_CONSTANT_DATA&       Cast_to_me(CONSTANT_DATA& data);
@@ -10,8 +10,10 @@
 #define AIR_BASE_TRANSFORM_UTIL_H
 
 #include <array>
+#include <string>
 
 #include "air/base/container.h"
+#include "air/base/meta_info.h"
 #include "air/core/opcode.h"
 
 namespace air {
@@ -65,12 +67,22 @@ class TIMING_UTIL : TRANSFORM_UTIL {
 public:
   TIMING_UTIL(CONTEXT& ctx, const SPOS& spos, const char* msg, bool prepend)
       : _ctx(ctx), _spos(spos), _prepend(prepend) {
-    if (_ctx.Rt_timing()) {
-      // Prepend TM_START before node
-      _msg = _ctx.Glob_scope()->New_const(CONSTANT_KIND::STR_ARRAY, msg,
-                                          strlen(msg));
-      STMT_PTR tm_start = _ctx.Container()->New_tm_start(_msg, _spos);
-      _ctx.Prepend(tm_start);
+    Start(msg);
+  }
+
+  //! @brief Time node and tag msg with its ONNX node name so that runtime
+  //! profile can be mapped back to layers, like "Tensor::conv /conv1/Conv"
+  TIMING_UTIL(CONTEXT& ctx, NODE_PTR node, const char* msg, bool prepend)
+      : _ctx(ctx), _spos(node->Spos()), _prepend(prepend) {
+    const char* name = nullptr;
+    if (_ctx.Rt_timing() &&
+        META_INFO::Has_prop<OPR_PROP::ATTR>(node->Opcode())) {
+      name = node->Attr("name");
+    }
+    if (name != nullptr) {
+      Start((std::string(msg) + " " + name).c_str());
+    } else {
+      Start(msg);
     }
   }
 
@@ -88,8 +100,18 @@ public:
   }
 
 private:
+  void Start(const char* msg) {
+    if (_ctx.Rt_timing()) {
+      // Prepend TM_START before node
+      _msg = _ctx.Glob_scope()->New_const(CONSTANT_KIND::STR_ARRAY, msg,
+                                          strlen(msg));
+      STMT_PTR tm_start = _ctx.Container()->New_tm_start(_msg, _spos);
+      _ctx.Prepend(tm_start);
+    }
+  }
+
   CONTEXT&     _ctx;
-  const SPOS&  _spos;
+  SPOS         _spos;
   CONSTANT_PTR _msg;
   bool         _prepend;
 };
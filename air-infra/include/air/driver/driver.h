@@ -145,6 +145,10 @@ public:
   //! @brief Get Glob keep status
   bool Keep() { return _ctx->Keep(); }
 
+  //! @brief Get number of threads to optimize functions concurrently, used
+  //! by function-local passes and per-function optimizations of lowering
+  uint32_t Jobs() const { return _ctx->Jobs(); }
+
 };  // DRIVER
 
 }  // namespace driver
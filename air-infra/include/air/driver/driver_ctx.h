@@ -76,6 +76,20 @@ public:
   //! @brief Get glob keep status
   bool Keep() { return _config.Keep(); }
 
+  //! @brief Get number of threads to optimize functions concurrently, used
+  //! by function-local passes and per-function optimizations of lowering
+  uint32_t Jobs() const { return _config.Jobs(); }
+
+  //! @brief Get number of option groups registered so far
+  uint32_t Num_option_group() const { return _option_mgr.Num_group(); }
+
+  //! @brief Get the file caching IR generated by pass. The file name is a
+  //! hash of the compiler, the input file and options in the first num_grp
+  //! groups, which belong to pass and the passes before it. Top level
+  //! options like -o and -trace don't change IR and are not hashed. Return
+  //! empty string if -ir_cache is not given.
+  std::string Ir_cache_file(const char* pass, uint32_t num_grp) const;
+
   //! @brief Get global scope
   air::base::GLOB_SCOPE* Glob_scope() { return _glob; }
 
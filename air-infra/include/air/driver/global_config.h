@@ -9,6 +9,7 @@
 #ifndef AIR_DRIVER_GLOBAL_CONFIG_H
 #define AIR_DRIVER_GLOBAL_CONFIG_H
 
+#include <cstdint>
 #include <string>
 
 namespace air {
@@ -26,7 +27,8 @@ public:
         _trace(false),
         _keep(false),
         _print_pass(false),
-        _print_meta(false) {}
+        _print_meta(false),
+        _jobs(1) {}
 
   bool        Help() const { return _help; }
   bool        Show() const { return _show; }
@@ -35,7 +37,9 @@ public:
   bool        Keep() const { return _keep; }
   bool        Print_pass() const { return _print_pass; }
   bool        Print_meta() const { return _print_meta; }
+  uint32_t    Jobs() const { return _jobs > 1 ? _jobs : 1; }
   const char* Ofile() const { return _ofile.c_str(); }
+  const char* Ir_cache() const { return _ir_cache.c_str(); }
 
   void Register_options(DRIVER_CTX* ctx);
   void Update_options(const char* ifile);
@@ -48,7 +52,9 @@ public:
   bool        _keep;        // -keep
   bool        _print_pass;  // -print-pass
   bool        _print_meta;  // -print-meta
+  uint64_t    _jobs;        // -jobs=N  // threads for per-function opt loops
   std::string _ofile;       // -o <output c/c++ file>
+  std::string _ir_cache;    // -ir_cache=<dir>  // IR of cacheable passes
 };
 
 }  // namespace driver
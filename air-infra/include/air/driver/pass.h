@@ -9,6 +9,7 @@
 #ifndef AIR_DRIVER_PASS_H
 #define AIR_DRIVER_PASS_H
 
+#include "air/base/st.h"
 #include "air/driver/common_config.h"
 #include "air/util/option.h"
 
@@ -50,6 +51,29 @@ public:
   //! @return false if error occurs during run phase
   bool Run() { return true; }
 
+  //! @brief Check if the pass is function-local. A function-local pass only
+  //! changes IR and symbols of each function separately, and creates no
+  //! global objects other than strings and constants. PASS_MANAGER calls
+  //! Run_func on all functions, concurrently with -jobs=N, instead of Run.
+  //! The SIHE, CKKS and POLY lowering passes rebuild GLOB_SCOPE and are not
+  //! function-local, only their per-function GVN/DCE and LICM steps run
+  //! concurrently.
+  bool Is_func_local() const { return false; }
+
+  //! @brief Run function-local pass on a single function. Calls on different
+  //! functions may run at the same time and must not share unsynchronized
+  //! data.
+  //!
+  //! @return R_CODE::NORMAL if no error occurs on the function
+  R_CODE Run_func(air::base::FUNC_SCOPE* func) { return R_CODE::NORMAL; }
+
+  //! @brief Check if the pass is cacheable. A cacheable pass only changes
+  //! GLOB_SCOPE, which depends on nothing but the input file and options of
+  //! the pass and earlier passes. With -ir_cache=dir, PASS_MANAGER saves IR
+  //! generated by the pass to dir and reads it back instead of running the
+  //! pass when the compiler, input file and these options are unchanged.
+  bool Is_cacheable() const { return false; }
+
   //! @brief Post-run the pass. Extra clean-up or summary work
   //! can be done in Post-run phase.
   //! Post run phase shouldn't trigger any error.
@@ -9,6 +9,15 @@
 #ifndef AIR_DRIVER_PASS_MANAGER_H
 #define AIR_DRIVER_PASS_MANAGER_H
 
+#include <unistd.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "air/base/st.h"
+#include "air/util/parallel.h"
+
 namespace air {
 namespace driver {
 
@@ -51,7 +60,12 @@ public:
   template <typename DRIVER>
   R_CODE Init(DRIVER* driver) {
     return Forward<0>(
-        [](auto&& pass, auto&& arg) -> R_CODE { return pass.Init(arg); },
+        [this](auto&& pass, auto&& arg) -> R_CODE {
+          R_CODE ret_code = pass.Init(arg);
+          // options registered by the pass and passes before it
+          _num_grp.push_back(arg->Context()->Num_option_group());
+          return ret_code;
+        },
         driver);
   }
 
@@ -73,13 +87,14 @@ public:
    */
   template <typename DRIVER>
   R_CODE Run(DRIVER* driver) {
-    return Forward<0>([driver](auto&& pass) -> R_CODE {
+    uint32_t idx = 0;
+    return Forward<0>([this, driver, &idx](auto&& pass) -> R_CODE {
       if (driver->Keep() || pass.Trace_ir_before()) {
         driver->Trace() << "#### IR trace before " << pass.Name() << std::endl;
         driver->Trace_ir();
       }
       if (pass.Trace_stat()) driver->Perf_start();
-      R_CODE ret_code = pass.Run();
+      R_CODE ret_code = Run_or_read_cache(driver, pass, idx++);
       if (driver->Keep() || pass.Trace_ir_after()) {
         driver->Trace() << "#### IR trace after " << pass.Name() << std::endl;
         driver->Trace_ir();
@@ -162,8 +177,77 @@ private:
     }
   }
 
+  // run pass, or read IR generated by cacheable pass from -ir_cache if
+  // the compiler, input file and options up to the pass are unchanged
+  template <typename DRIVER, typename PASS>
+  R_CODE Run_or_read_cache(DRIVER* driver, PASS& pass, uint32_t idx) {
+    std::string cache;
+    if (pass.Is_cacheable() && idx < _num_grp.size()) {
+      cache = driver->Context()->Ir_cache_file(pass.Name(), _num_grp[idx]);
+    }
+    std::error_code ec;
+    if (!cache.empty() && std::filesystem::exists(cache, ec)) {
+      driver->Read_ir(cache);
+      if (pass.Trace_stat()) {
+        driver->Trace() << "#### " << pass.Name() << " IR read from "
+                        << cache << std::endl;
+      }
+      return R_CODE::NORMAL;
+    }
+    R_CODE ret_code =
+        pass.Is_func_local() ? Run_func_local(driver, pass) : pass.Run();
+    if (!cache.empty() && ret_code == R_CODE::NORMAL) {
+      // write a temporary file and rename it, so that concurrent compilers
+      // never read a partially written cache
+      std::filesystem::create_directories(
+          std::filesystem::path(cache).parent_path(), ec);
+      std::string tmp = cache + "." + std::to_string(getpid());
+      driver->Write_ir(tmp);
+      std::filesystem::rename(tmp, cache, ec);
+    }
+    return ret_code;
+  }
+
+  // run function-local pass on each function of glob scope on up to
+  // driver->Jobs() threads, return first abnormal code in function order.
+  // Lowering passes rebuild GLOB_SCOPE and are not function-local, so with
+  // the fhe_cmplr pipeline -jobs only takes effect in the GVN/DCE/LICM loops
+  // of opt_driver.cxx, which call Parallel_for directly
+  template <typename DRIVER, typename PASS>
+  static R_CODE Run_func_local(DRIVER* driver, PASS& pass) {
+    air::base::GLOB_SCOPE*              glob = driver->Glob_scope();
+    std::vector<air::base::FUNC_SCOPE*> func;
+    for (air::base::GLOB_SCOPE::FUNC_SCOPE_ITER it = glob->Begin_func_scope();
+         it != glob->End_func_scope(); ++it) {
+      func.push_back(&(*it));
+    }
+    if (driver->Jobs() > 1) {
+      glob->Reserve_str_const(STR_CONST_PER_FUNC * func.size());
+    }
+    std::vector<R_CODE> ret(func.size(), R_CODE::NORMAL);
+    air::util::Parallel_for(func.size(), driver->Jobs(), [&](uint32_t i) {
+      ret[i] = pass.Run_func(func[i]);
+    });
+    if (driver->Jobs() > 1) {
+      glob->Release_str_const();
+    }
+    for (R_CODE r_code : ret) {
+      if (r_code != R_CODE::NORMAL) {
+        return r_code;
+      }
+    }
+    return R_CODE::NORMAL;
+  }
+
+  // strings and constants reserved for each function before running a
+  // function-local pass concurrently, exceeding it is asserted
+  static constexpr uint32_t STR_CONST_PER_FUNC = 4096;
+
   // all passes managed by this pass manager
   std::tuple<PASSES...> _passes;
+
+  // number of option groups registered when each pass is initialized
+  std::vector<uint32_t> _num_grp;
 };
 
 }  // namespace driver
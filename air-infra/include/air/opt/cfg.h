@@ -0,0 +1,160 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef AIR_OPT_CFG_H
+#define AIR_OPT_CFG_H
+
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include "air/base/container.h"
+#include "air/base/st.h"
+
+namespace air {
+
+namespace opt {
+
+//! @brief Control flow graph on top of AIR IR
+//!
+//! Basic blocks are built from IF/DO_LOOP/RET/RETV in CORE domain. Nested
+//! statement blocks are flattened into enclosing basic block. Each basic block
+//! is a list of ITEM, which is either a whole statement or the part of a
+//! DO_LOOP/IF evaluated in the block:
+//!   - IF: condition is evaluated at the end of current block, followed by
+//!     THEN/ELSE blocks and a JOIN block with PHI of the IF
+//!   - DO_LOOP: IV-init is evaluated at the end of current block (preheader),
+//!     IV-compare in HEADER block with PHI of the DO_LOOP, IV-update at the end
+//!     of body (latch) which goes back to HEADER
+//!   - RET/RETV: goes to EXIT block. Statements after it are unreachable
+//!
+//! The operand index of PHI on JOIN/HEADER is given by the predecessor,
+//! which matches the IR: 0 for THEN/preheader and 1 for ELSE/latch.
+//! Edges from unreachable blocks are removed and dominator tree and
+//! dominance frontier are computed on reachable blocks only.
+class CFG {
+public:
+  static constexpr uint32_t NO_BB   = UINT32_MAX;
+  static constexpr uint32_t NO_OPND = UINT32_MAX;
+
+  enum ITEM_KIND : uint32_t {
+    STMT,     //!< statement other than IF/DO_LOOP
+    EXPR,     //!< expression: IF/DO_LOOP condition, formal idname
+    IV_INIT,  //!< DO_LOOP IV-init, defines IV
+    IV_STEP,  //!< DO_LOOP IV-update, defines IV
+  };
+
+  struct ITEM {
+    ITEM_KIND          _kind;
+    air::base::NODE_ID _node;  // statement or expression
+  };
+
+  class BB {
+  public:
+    uint32_t                 Id() const { return _id; }
+    const std::vector<ITEM>& Items() const { return _items; }
+    const std::vector<uint32_t>& Pred() const { return _pred; }
+    const std::vector<uint32_t>& Succ() const { return _succ; }
+    const std::vector<uint32_t>& Dom_kids() const { return _dom_kids; }
+    const std::vector<uint32_t>& Df() const { return _df; }
+    uint32_t                     Idom() const { return _idom; }
+    bool                         Reachable() const { return _reachable; }
+    //! @brief IF/DO_LOOP owning PHI at entry of this block, if any
+    air::base::NODE_ID Scf() const { return _scf; }
+    //! @brief PHI operand index this block feeds into its successor
+    uint32_t Phi_opnd() const { return _phi_opnd; }
+
+  private:
+    friend class CFG;
+
+    uint32_t              _id;
+    std::vector<ITEM>     _items;
+    std::vector<uint32_t> _pred;
+    std::vector<uint32_t> _succ;
+    std::vector<uint32_t> _dom_kids;
+    std::vector<uint32_t> _df;
+    uint32_t              _idom      = NO_BB;
+    uint32_t              _phi_opnd  = NO_OPND;
+    uint32_t              _pre       = 0;  // preorder on dominator tree
+    uint32_t              _post      = 0;  // last preorder in dom subtree
+    bool                  _reachable = false;
+    air::base::NODE_ID    _scf;
+  };
+
+  CFG(air::base::FUNC_SCOPE* func) : _func(func) {}
+
+  //! @brief Build basic blocks, dominator tree and dominance frontier
+  void Build();
+
+  uint32_t  Num_bb() const { return _bb.size(); }
+  const BB& Bb(uint32_t id) const {
+    AIR_ASSERT(id < _bb.size());
+    return _bb[id];
+  }
+  uint32_t Entry() const { return _entry; }
+  uint32_t Exit() const { return _exit; }
+
+  //! @brief Reachable blocks in reverse post order
+  const std::vector<uint32_t>& Rpo() const { return _rpo; }
+
+  //! @brief Block containing item of the node, NO_BB for other nodes
+  uint32_t Bb_of(air::base::NODE_ID node) const {
+    std::unordered_map<uint32_t, uint32_t>::const_iterator it =
+        _item_bb.find(node.Value());
+    return it != _item_bb.end() ? it->second : NO_BB;
+  }
+
+  //! @brief Block with PHI of the IF/DO_LOOP, NO_BB if not built
+  uint32_t Phi_bb(air::base::NODE_ID scf) const {
+    std::unordered_map<uint32_t, uint32_t>::const_iterator it =
+        _phi_bb.find(scf.Value());
+    return it != _phi_bb.end() ? it->second : NO_BB;
+  }
+
+  //! @brief Check if reachable block a dominates reachable block b
+  bool Dominates(uint32_t a, uint32_t b) const {
+    const BB& bb_a = Bb(a);
+    const BB& bb_b = Bb(b);
+    AIR_ASSERT(bb_a._reachable && bb_b._reachable);
+    return bb_a._pre <= bb_b._pre && bb_b._pre <= bb_a._post;
+  }
+
+  void Print(std::ostream& os, uint32_t indent = 0) const;
+  void Print() const;
+
+private:
+  // REQUIRED UNDEFINED UNWANTED methods
+  CFG(void);
+  CFG(const CFG&);
+  CFG& operator=(const CFG&);
+
+  uint32_t New_bb();
+  void     Add_item(uint32_t bb, ITEM_KIND kind, air::base::NODE_ID node);
+  void     Connect(uint32_t from, uint32_t to, uint32_t opnd = NO_OPND);
+  uint32_t Build_block(air::base::NODE_PTR blk, uint32_t cur);
+  uint32_t Build_stmt(air::base::NODE_PTR node, uint32_t cur);
+  void     Compute_rpo();
+  void     Compute_dom();
+  void     Compute_df();
+  uint32_t Intersect(uint32_t a, uint32_t b,
+                     const std::vector<uint32_t>& rpo_idx) const;
+
+  air::base::FUNC_SCOPE*                 _func;
+  std::vector<BB>                        _bb;
+  std::vector<uint32_t>                  _rpo;
+  std::unordered_map<uint32_t, uint32_t> _item_bb;  // item node -> block
+  std::unordered_map<uint32_t, uint32_t> _phi_bb;   // IF/DO_LOOP -> block
+  uint32_t                               _entry = NO_BB;
+  uint32_t                               _exit  = NO_BB;
+};
+
+}  // namespace opt
+
+}  // namespace air
+
+#endif  // AIR_OPT_CFG_H
@@ -0,0 +1,74 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef AIR_OPT_DCE_H
+#define AIR_OPT_DCE_H
+
+#include <unordered_set>
+#include <vector>
+
+#include "air/base/container.h"
+#include "air/base/st.h"
+#include "air/opt/opt_policy.h"
+#include "air/opt/ssa_container.h"
+
+namespace air {
+
+namespace opt {
+
+//! @brief Dead code elimination on top of simple SSA
+//!
+//! All statements are live except stores of a pure expression into a local
+//! variable or preg tracked by SSA. Such a store becomes live once its
+//! version is used, directly or through PHI/CHI, by a live statement. Dead
+//! stores are removed at last.
+//!
+//! SSA is out of date after Perform() and need to be rebuilt by caller.
+class DCE {
+public:
+  DCE(air::base::FUNC_SCOPE* func, SSA_CONTAINER* ssa_cntr, OPT_POLICY* policy)
+      : _cntr(&func->Container()),
+        _ssa_cntr(ssa_cntr),
+        _policy(policy),
+        _exposed(policy) {}
+
+  void Perform();
+
+  //! @brief Number of dead statements removed
+  uint32_t Num_dead() const { return _num_dead; }
+
+private:
+  // REQUIRED UNDEFINED UNWANTED methods
+  DCE(void);
+  DCE(const DCE&);
+  DCE& operator=(const DCE&);
+
+  bool Is_removable(air::base::NODE_PTR node) const;
+  bool Is_pure(air::base::NODE_PTR expr) const;
+  void Mark_block(air::base::NODE_PTR blk);
+  void Mark_use(air::base::NODE_PTR expr);
+  void Mark_ver(SSA_VER_ID ver);
+  void Propagate();
+  void Sweep_block(air::base::NODE_PTR blk);
+  void Eliminate(air::base::NODE_PTR node);
+
+  air::base::CONTAINER*        _cntr;
+  SSA_CONTAINER*               _ssa_cntr;
+  OPT_POLICY*                  _policy;
+  EXPOSED_VAR                  _exposed;
+  std::vector<bool>            _live_ver;   // version used by live statement
+  std::unordered_set<uint32_t> _live_stmt;  // removable store being live
+  std::vector<SSA_VER_ID>      _worklist;   // live versions to propagate
+  uint32_t                     _num_dead = 0;
+};
+
+}  // namespace opt
+
+}  // namespace air
+
+#endif  // AIR_OPT_DCE_H
@@ -0,0 +1,153 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef AIR_OPT_GVN_H
+#define AIR_OPT_GVN_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "air/base/container.h"
+#include "air/base/st.h"
+#include "air/opt/opt_policy.h"
+#include "air/opt/ssa_container.h"
+
+namespace air {
+
+namespace opt {
+
+//! @brief Global value numbering on top of simple SSA
+//!
+//! Expressions are numbered by (opcode, rtype, fields, attributes, value
+//! number of operands) and loads by their SSA version. IR is walked in dominator order,
+//! which is the statement order for well-formed IF/DO_LOOP, with a scoped
+//! table of available values:
+//!   - a variable stored with the value, valid while its SSA version is the
+//!     current one. Redundant expression is replaced by a load of it.
+//!   - first occurrence of an expression worth sharing. Once the expression
+//!     appears again, it's saved into a new temporary before the statement of
+//!     first occurrence and both occurrences are replaced by a load.
+//!
+//! SSA is out of date after Perform() and need to be rebuilt by caller.
+class GVN {
+public:
+  GVN(air::base::FUNC_SCOPE* func, SSA_CONTAINER* ssa_cntr, OPT_POLICY* policy)
+      : _func(func),
+        _cntr(&func->Container()),
+        _ssa_cntr(ssa_cntr),
+        _policy(policy),
+        _exposed(policy) {}
+
+  void Perform();
+
+  //! @brief Number of redundant expressions replaced
+  uint32_t Num_redundant() const { return _num_redundant; }
+  //! @brief Number of temporaries created
+  uint32_t Num_tmp() const { return _num_tmp; }
+  //! @brief Number of stores removed because variable already has the value
+  uint32_t Num_store() const { return _num_store; }
+
+private:
+  // REQUIRED UNDEFINED UNWANTED methods
+  GVN(void);
+  GVN(const GVN&);
+  GVN& operator=(const GVN&);
+
+  typedef std::vector<uint64_t> VN_KEY;
+
+  struct VN_KEY_HASH {
+    size_t operator()(const VN_KEY& key) const {
+      size_t hash = key.size();
+      for (uint64_t val : key) {
+        hash ^= std::hash<uint64_t>()(val) + 0x9e3779b9 + (hash << 6) +
+                (hash >> 2);
+      }
+      return hash;
+    }
+  };
+
+  enum AVAIL_KIND : uint32_t {
+    NONE,       //!< nothing available
+    VAR,        //!< variable holds the value with SSA version _ver
+    PREG,       //!< preg holds the value with SSA version _ver
+    TMP,        //!< temporary created by GVN, always holds the value
+    CANDIDATE,  //!< first occurrence of the expression _parent[_kid]
+  };
+
+  struct AVAIL {
+    AVAIL_KIND _kind   = NONE;
+    uint32_t   _var    = 0;  // ADDR_DATUM_ID or PREG_ID of holder
+    uint32_t   _sym    = 0;  // SSA symbol of VAR/PREG holder
+    uint32_t   _ver    = 0;  // SSA version of VAR/PREG holder
+    uint32_t   _stmt   = 0;  // statement of candidate
+    uint32_t   _parent = 0;  // parent node of candidate
+    uint32_t   _kid    = 0;  // kid index of candidate in parent
+    uint32_t   _node   = 0;  // candidate node
+  };
+
+  struct LOG_ENTRY {
+    uint32_t _vn;
+    AVAIL    _avail;
+  };
+
+  struct CUR_ENTRY {
+    uint32_t _sym;
+    uint32_t _ver;
+  };
+
+  void     Handle_block(air::base::NODE_PTR blk);
+  void     Handle_stmt(air::base::STMT_PTR stmt);
+  void     Handle_store(air::base::STMT_PTR stmt, uint32_t vn);
+  uint32_t Handle_expr(air::base::NODE_PTR parent, uint32_t kid,
+                       air::base::STMT_PTR stmt, bool share);
+  uint32_t Leaf_vn(air::base::NODE_PTR node);
+  void     Append_attr_key(air::base::NODE_PTR node, VN_KEY& key);
+  uint32_t Ver_vn(SSA_VER_ID ver);
+  uint32_t Lookup(const VN_KEY& key);
+  void     Update_phi(air::base::NODE_PTR node);
+
+  bool     Is_valid(const AVAIL& avail) const;
+  AVAIL*   Find(uint32_t vn);
+  bool     Replace(air::base::NODE_PTR parent, uint32_t kid, AVAIL* avail);
+  void     Share(AVAIL* cand);
+  void     Set_avail(uint32_t vn, const AVAIL& avail);
+  void     Set_cur(SSA_SYM_ID sym, SSA_VER_ID ver);
+  uint32_t Cur_ver(SSA_SYM_ID sym) const;
+  void     Drop_candidate(air::base::NODE_PTR node);
+  void     Eliminate(air::base::NODE_PTR node);
+
+  typedef std::unordered_map<VN_KEY, uint32_t, VN_KEY_HASH> VN_MAP;
+  typedef std::unordered_map<uint32_t, uint32_t>            U32_MAP;
+  typedef std::unordered_map<uint32_t, AVAIL>               AVAIL_MAP;
+  typedef std::unordered_map<std::string, uint32_t>         ATTR_ID_MAP;
+
+  air::base::FUNC_SCOPE* _func;
+  air::base::CONTAINER*  _cntr;
+  SSA_CONTAINER*         _ssa_cntr;
+  OPT_POLICY*            _policy;
+  EXPOSED_VAR            _exposed;
+  VN_MAP                 _vn_map;     // expression key -> value number
+  ATTR_ID_MAP            _attr_id;    // attribute content -> id in key
+  std::vector<uint32_t>  _ver_vn;     // SSA version -> value number
+  U32_MAP                _node_vn;    // node id -> value number
+  AVAIL_MAP              _avail;      // value number -> available value
+  U32_MAP                _cur;        // SSA symbol -> current version
+  std::vector<LOG_ENTRY> _avail_log;  // undo log of _avail for scopes
+  std::vector<CUR_ENTRY> _cur_log;    // undo log of _cur for scopes
+  uint32_t               _last_vn       = 0;
+  uint32_t               _num_redundant = 0;
+  uint32_t               _num_tmp       = 0;
+  uint32_t               _num_store     = 0;
+};
+
+}  // namespace opt
+
+}  // namespace air
+
+#endif  // AIR_OPT_GVN_H
@@ -0,0 +1,78 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef AIR_OPT_LICM_H
+#define AIR_OPT_LICM_H
+
+#include <unordered_set>
+
+#include "air/base/container.h"
+#include "air/base/st.h"
+#include "air/opt/opt_policy.h"
+
+namespace air {
+
+namespace opt {
+
+//! @brief Loop invariant code motion for expensive pure expressions
+//!
+//! An expression worth sharing, which is pure and only loads variables
+//! tracked as value and not stored in the DO_LOOP, is computed once into a
+//! temporary right before the loop and replaced by a load of it:
+//!   do_loop(i) { ... expr ... }  =>  tmp = expr
+//!                                    do_loop(i) { ... tmp ... }
+//! Loops are visited from outermost so that an expression is hoisted out of
+//! the outermost loop it is invariant in. Only loops with constant bounds
+//! known to run at least once are handled and expressions under IF are not
+//! hoisted, so no expression is evaluated on a path which doesn't evaluate
+//! it originally.
+class LICM {
+public:
+  LICM(air::base::FUNC_SCOPE* func, OPT_POLICY* policy)
+      : _func(func),
+        _cntr(&func->Container()),
+        _policy(policy),
+        _exposed(policy) {}
+
+  void Perform();
+
+  //! @brief Number of expressions hoisted out of loops
+  uint32_t Num_hoisted() const { return _num_hoisted; }
+
+private:
+  // REQUIRED UNDEFINED UNWANTED methods
+  LICM(void);
+  LICM(const LICM&);
+  LICM& operator=(const LICM&);
+
+  static bool Run_once(air::base::NODE_PTR loop);
+  static uint64_t Key(bool preg, uint32_t id) {
+    return ((uint64_t)preg << 32) | id;
+  }
+
+  void Handle_block(air::base::NODE_PTR blk);
+  void Handle_loop(air::base::STMT_PTR loop);
+  void Collect_def(air::base::NODE_PTR node);
+  void Hoist_block(air::base::NODE_PTR blk, air::base::STMT_PTR loop);
+  void Hoist_expr(air::base::NODE_PTR parent, uint32_t kid,
+                  air::base::STMT_PTR loop);
+  bool Is_invariant(air::base::NODE_PTR expr) const;
+
+  air::base::FUNC_SCOPE*       _func;
+  air::base::CONTAINER*        _cntr;
+  OPT_POLICY*                  _policy;
+  EXPOSED_VAR                  _exposed;
+  std::unordered_set<uint64_t> _def;  // variables and pregs stored in loop
+  uint32_t                     _num_hoisted = 0;
+};
+
+}  // namespace opt
+
+}  // namespace air
+
+#endif  // AIR_OPT_LICM_H
@@ -0,0 +1,126 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef AIR_OPT_OPT_POLICY_H
+#define AIR_OPT_OPT_POLICY_H
+
+#include <unordered_set>
+
+#include "air/base/container.h"
+#include "air/base/meta_info.h"
+#include "air/base/st.h"
+#include "air/core/opcode.h"
+
+namespace air {
+
+namespace opt {
+
+//! @brief Copy attributes like scale or level of expr src to node dst, which
+//! is a load or store created by optimizer to replace or hold src
+inline void Copy_attr(air::base::NODE_PTR dst, air::base::NODE_PTR src) {
+  if (air::base::META_INFO::Has_prop<air::base::OPR_PROP::ATTR>(
+          src->Opcode())) {
+    dst->Copy_attr(src);
+  }
+}
+
+//! @brief Domain knowledge needed by scalar optimizations (GVN/DCE) on top
+//! of SSA. Default implementation only knows CORE operators. Domains derive
+//! from it to tell which operators are free of side effect, which types have
+//! value semantic and which expressions are worth a temporary.
+class OPT_POLICY {
+public:
+  OPT_POLICY() {}
+  virtual ~OPT_POLICY() {}
+
+  //! @brief Check if expression node only depends on its operands. Loads are
+  //! handled by optimizer with SSA version and never passed in.
+  virtual bool Is_pure(air::base::NODE_PTR node) const {
+    if (node->Domain() != air::core::CORE) {
+      return false;
+    }
+    switch (node->Operator()) {
+      case air::core::OPCODE::ADD:
+      case air::core::OPCODE::SUB:
+      case air::core::OPCODE::MUL:
+      case air::core::OPCODE::SHL:
+      case air::core::OPCODE::ASHR:
+      case air::core::OPCODE::LSHR:
+      case air::core::OPCODE::EQ:
+      case air::core::OPCODE::NE:
+      case air::core::OPCODE::LT:
+      case air::core::OPCODE::LE:
+      case air::core::OPCODE::GT:
+      case air::core::OPCODE::GE:
+      case air::core::OPCODE::LDC:
+      case air::core::OPCODE::LDA:
+      case air::core::OPCODE::LDCA:
+      case air::core::OPCODE::INTCONST:
+      case air::core::OPCODE::ZERO:
+      case air::core::OPCODE::ONE:
+      case air::core::OPCODE::ARRAY:
+        return true;
+      case air::core::OPCODE::ILD:
+        // element of constant array is never modified
+        return node->Child(0)->Opcode() == air::core::OPC_ARRAY &&
+               node->Child(0)->Child(0)->Opcode() == air::core::OPC_LDCA;
+      default:
+        return false;
+    }
+  }
+
+  //! @brief Check if store to variable of type replaces the whole value,
+  //! which makes the variable trackable by SSA version
+  virtual bool Is_value_type(air::base::TYPE_PTR type) const { return true; }
+
+  //! @brief Check if value of type can be copied by a plain store
+  virtual bool Is_copyable(air::base::TYPE_PTR type) const { return true; }
+
+  //! @brief Check if a redundant expression is expensive enough to be saved
+  //! into a temporary when no variable holds its value
+  virtual bool Is_worth_sharing(air::base::NODE_PTR node) const {
+    return false;
+  }
+
+  //! @brief Name prefix of temporaries created by optimizer
+  virtual const char* Tmp_prefix() const { return "_opt_tmp_"; }
+
+  //! @brief Callback for each expression node removed by optimizer
+  virtual void Eliminate(air::base::NODE_PTR node) {}
+};
+
+//! @brief Variables and pregs which can't be tracked as a value by SSA
+//! version: global, address taken, accessed by field, passed to a call or a
+//! non-CORE statement which may update it in place, formal being stored or
+//! of a type without value semantic.
+class EXPOSED_VAR {
+public:
+  EXPOSED_VAR(const OPT_POLICY* policy) : _policy(policy) {}
+
+  //! @brief Collect exposed variables in tree rooted by node
+  void Collect(air::base::NODE_PTR node);
+
+  //! @brief Check if variable loaded or stored by node is tracked as value
+  bool Is_tracked(air::base::NODE_PTR node) const;
+
+private:
+  void Expose(air::base::NODE_PTR node);
+
+  static uint64_t Key(bool preg, uint32_t id) {
+    return ((uint64_t)preg << 32) | id;
+  }
+
+  const OPT_POLICY*            _policy;
+  std::unordered_set<uint64_t> _vars;
+};
+
+}  // namespace opt
+
+}  // namespace air
+
+#endif  // AIR_OPT_OPT_POLICY_H
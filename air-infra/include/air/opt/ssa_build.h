@@ -22,6 +22,8 @@
 //! This is a simple builder with the following assumptions:
 //!   - No pointer. No alias analyze needed.
 //!   - No irregular control flow. Only well-formed LOOP/IF are allowed
+//!   - Struct field is renamed as a standalone symbol. Overlap between the
+//!     field and the whole struct is not tracked
 //!
 //! Under these assumptions, the SSA construction can be very quick:
 //!   - Construct SSA Symbol Table by traversing IR once
@@ -32,7 +34,15 @@
 //! No alias info. No CFG/DOM/DF.
 //!
 //! @brief SSA COMPLEX BUILDER
-//! TODO: Add alias analysis and CFG/DOM/DF calculation
+//! This builder works on CFG and handles early RET/RETV inside IF/DO_LOOP and
+//! nested statement blocks:
+//!   - Construct SSA Symbol Table by traversing IR once, same as SIMPLE
+//!   - Build CFG/DOM/DF
+//!   - Insert PHI for each def on iterated dominance frontier
+//!   - Rename each def and set up U-D by walking dominator tree
+//!   - Verify each def dominates its uses
+//!
+//! PHI is still attached to IF/DO_LOOP. No alias info.
 //!
 
 namespace air {
@@ -43,6 +53,7 @@ enum SSA_TRACE_DETAIL {
   TRACE_IR_BEFORE_SSA       = 0,
   TRACE_IR_AFTER_INSERT_PHI = 1,
   TRACE_IR_AFTER_SSA        = 2,
+  TRACE_CFG                 = 3,
 };
 
 //! @brief Config for building SSA
@@ -60,10 +71,17 @@ public:
   void Set_trace_ir_after_ssa(bool val) {
     _trace_detail |= (((uint32_t)val) << TRACE_IR_AFTER_SSA);
   }
+  void Set_trace_cfg(bool val) {
+    _trace_detail |= (((uint32_t)val) << TRACE_CFG);
+  }
   bool Is_trace(uint32_t flag) const {
     return (_trace_detail & (1U << flag)) != 0;
   }
 
+  //! @brief Build SSA with CFG by complex builder
+  void Set_build_cfg(bool val) { _build_cfg = val; }
+  bool Build_cfg() const { return _build_cfg; }
+
 private:
   // REQUIRED UNDEFINED UNWANTED methods
   SSA_CONFIG(void);
@@ -71,12 +89,9 @@ private:
   SSA_CONFIG operator=(const SSA_CONFIG&);
 
   uint32_t _trace_detail = 0;
+  bool     _build_cfg    = false;
 };
 
-//
-// TODO: possible share code with complex ssa builder
-//
-
 //! @brief Build SSA on top of AIR IR
 class SSA_BUILDER {
 public:
@@ -84,7 +99,13 @@ public:
               const driver::DRIVER_CTX* driver_ctx)
       : _scope(scope), _cont(cont), _driver_ctx(driver_ctx), _config(0) {}
 
-  void Perform() { Build_simple(); }
+  void Perform() {
+    if (_config.Build_cfg()) {
+      Build_complex();
+    } else {
+      Build_simple();
+    }
+  }
 
   const SSA_CONFIG& Ssa_config() const { return _config; }
   SSA_CONFIG&       Ssa_config() { return _config; }
@@ -93,7 +114,7 @@ public:
 protected:
   void Build_simple();
 
-  void Build_complex() { AIR_ASSERT(false); }
+  void Build_complex();
 
   air::base::FUNC_SCOPE*    _scope;
   SSA_CONTAINER*            _cont;
@@ -55,6 +55,11 @@ public:
   //! @brief Set offset position to opened file
   void Set_pos(BYTE_PTR pos) { _pos = pos; }
 
+  //! @brief Make room in file to write sz bytes at pos
+  void Reserve(BYTE_PTR pos, size_t sz) {
+    _map->Expand(pos - Get_map_addr() + sz);
+  }
+
   //! @brief Address alignment according to the system bits
   uint32_t Align_pos(BYTE_PTR pos, uint32_t align) {
     uint32_t offset = (reinterpret_cast<uintptr_t>(pos) % align);
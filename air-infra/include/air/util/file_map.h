@@ -17,6 +17,10 @@ namespace util {
 // For 4K page, each kernel page maps to 4Mbytes user address space
 #define MAPPED_SIZE 0x400000
 
+// Address space reserved for file being written, which is extended on demand
+// by Expand and truncated to real size by Remap. ELF offsets are 32-bit
+#define MAPPED_MAX_SIZE 0x100000000
+
 //! @brief Encapsulate mmap and provide buffer and pos for upper-layer calls
 class FILE_MAP {
 public:
@@ -24,14 +28,8 @@ public:
   //! @param op: false is read, true is write
   FILE_MAP(const char* name, bool op);
 
-  //! @brief Destruct mmap object
-  ~FILE_MAP() {
-    // Don't release map objects for reduce memcpy when Recovery function
-    // Code_arena
-    if (_op) {
-      Unmap();
-    }
-  }
+  //! @brief Destruct mmap object, data read is copied out by IR_READ
+  ~FILE_MAP() { Unmap(); }
 
   //! @brief Get map address of a opened file
   char* Get_map_addr() { return _map; }
@@ -45,15 +43,21 @@ public:
   //! @brief Set map size of a opened file
   void Set_map_size(off_t size) { _map_size = size; }
 
-  //! @brief remap a opened file
+  //! @brief Extend file being written to at least sz bytes, map address
+  //! doesn't change
+  void Expand(off_t sz);
+
+  //! @brief Truncate file being written to its final size sz
   void Remap(uint32_t sz);
 
 private:
   const char* _file;
   int32_t     _fd;
   char*       _map;
-  uint32_t    _file_size;
+  off_t       _file_size;
   off_t       _map_size;
+  uint32_t    _prot;   // protection of file being written
+  uint32_t    _flags;  // map flags of file being written
   bool        _op;
 
   //! @brief Open a file for read | write
@@ -89,7 +93,7 @@ private:
   void Set_file_id(int32_t id) { _fd = id; }
 
   //! @brief Set file size
-  void Set_file_size(uint32_t size) { _file_size = size; }
+  void Set_file_size(off_t size) { _file_size = size; }
 };
 
 }  // namespace util
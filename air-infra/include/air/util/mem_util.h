@@ -184,6 +184,15 @@ static inline void Air_free(void* p, size_t n) {
   free(p);
 }  // air_free
 
+/**
+ * @brief Get resident set size of current process from /proc/self/status.
+ *
+ * @param rss_kb Current resident set size in KB
+ * @param peak_kb Peak resident set size in KB
+ * @return true if /proc is available and both values are read
+ */
+bool Proc_mem_usage(uint64_t& rss_kb, uint64_t& peak_kb);
+
 }  // namespace util
 
 }  // namespace air
@@ -125,6 +125,15 @@ public:
   //! @brief show the available command line options
   void Print();
 
+  //! @brief write name and value of options in the first num_grp
+  //!  registered groups, one option per line
+  //! @param os the output stream
+  //! @param num_grp number of option groups to be written
+  void Print_value(std::ostream& os, uint32_t num_grp) const;
+
+  //! @brief get number of registered option groups
+  uint32_t Num_group() const { return _groups.size(); }
+
   //! @brief register option description hanle for top level options
   //! @param desc_handle the pointer of the option descriptor handle to be
   //!  registered
@@ -0,0 +1,57 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef AIR_UTIL_PARALLEL_H
+#define AIR_UTIL_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace air {
+
+namespace util {
+
+//! @brief Call func(i) for each i in [0, num) on at most jobs threads
+//!
+//! Indices are handed out one at a time so that a thread finishing a cheap
+//! item picks up the next one, which balances items of very different cost
+//! like a big main graph and small helper functions. The calling thread
+//! works as one of the threads. func is called on the calling thread only
+//! if jobs or num is not greater than 1.
+template <typename F>
+void Parallel_for(uint32_t num, uint32_t jobs, F&& func) {
+  if (jobs <= 1 || num <= 1) {
+    for (uint32_t i = 0; i < num; ++i) {
+      func(i);
+    }
+    return;
+  }
+  std::atomic<uint32_t> next(0);
+  auto                  worker = [&func, &next, num]() {
+    for (uint32_t i = next++; i < num; i = next++) {
+      func(i);
+    }
+  };
+  std::vector<std::thread> pool;
+  for (uint32_t i = 1; i < std::min(jobs, num); ++i) {
+    pool.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thr : pool) {
+    thr.join();
+  }
+}
+
+}  // namespace util
+
+}  // namespace air
+
+#endif  // AIR_UTIL_PARALLEL_H
@@ -0,0 +1,270 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef AIR_OPT_SSA_COMPLEX_BUILDER_H
+#define AIR_OPT_SSA_COMPLEX_BUILDER_H
+
+#include <vector>
+
+#include "air/base/visitor.h"
+#include "air/core/handler.h"
+#include "air/opt/cfg.h"
+#include "air/opt/ssa_container.h"
+#include "air/opt/ssa_node_list.h"
+#include "ssa_rename_ctx.h"
+#include "ssa_rename_handler.h"
+
+namespace air {
+
+namespace opt {
+
+//! @brief COMPLEX SSA BUILDER
+//! SSA symbols are created by SIMPLE_SYMTAB_HANDLER. PHI_NODEs are inserted
+//! on iterated dominance frontier of defs and versions are renamed by
+//! walking dominator tree of CFG. PHI_NODEs are still attached to IF/DO_LOOP
+//! so that the result is the same as simple builder for well-formed IR,
+//! without PHI on join/header which has only one reachable predecessor.
+class COMPLEX_BUILDER {
+public:
+  COMPLEX_BUILDER(SSA_CONTAINER* cont, const CFG* cfg)
+      : _ssa_cont(cont), _cfg(cfg) {}
+
+  //! @brief Insert PHI_NODE for each def on iterated dominance frontier
+  void Insert_phi() {
+    std::vector<std::vector<uint32_t> > def_bb(_ssa_cont->Num_sym());
+    for (uint32_t bb : _cfg->Rpo()) {
+      for (const CFG::ITEM& item : _cfg->Bb(bb).Items()) {
+        Collect_def(item, bb, def_bb);
+      }
+    }
+
+    std::vector<std::vector<uint32_t> > phi_sym(_cfg->Num_bb());
+    std::vector<uint32_t>               has_phi(_cfg->Num_bb(), UINT32_MAX);
+    std::vector<uint32_t>               in_work(_cfg->Num_bb(), UINT32_MAX);
+    std::vector<uint32_t>               work;
+    for (uint32_t sym = 0; sym < def_bb.size(); ++sym) {
+      for (uint32_t bb : def_bb[sym]) {
+        if (in_work[bb] != sym) {
+          in_work[bb] = sym;
+          work.push_back(bb);
+        }
+      }
+      while (!work.empty()) {
+        uint32_t bb = work.back();
+        work.pop_back();
+        for (uint32_t df : _cfg->Bb(bb).Df()) {
+          if (has_phi[df] == sym) {
+            continue;
+          }
+          has_phi[df] = sym;
+          // no PHI on EXIT, nothing is used after it
+          if (_cfg->Bb(df).Scf() != air::base::Null_id) {
+            phi_sym[df].push_back(sym);
+          }
+          if (in_work[df] != sym) {
+            in_work[df] = sym;
+            work.push_back(df);
+          }
+        }
+      }
+    }
+
+    for (uint32_t bb = 0; bb < phi_sym.size(); ++bb) {
+      if (phi_sym[bb].empty()) {
+        continue;
+      }
+      air::base::NODE_PTR scf =
+          _ssa_cont->Container()->Node(_cfg->Bb(bb).Scf());
+      uint32_t    size = SSA_CONTAINER::Phi_size(scf);
+      PHI_NODE_ID list;
+      for (uint32_t sym : phi_sym[bb]) {
+        PHI_NODE_PTR phi = _ssa_cont->New_phi(SSA_SYM_ID(sym), size);
+        phi->Set_next(list);
+        list = phi->Id();
+      }
+      _ssa_cont->Set_node_phi(scf->Id(), list);
+    }
+  }
+
+  //! @brief Rename versions by walking dominator tree. Unreachable blocks are
+  //! renamed at last with versions on function entry
+  void Rename() {
+    typedef air::base::VISITOR<RENAME_CTX, air::core::HANDLER<RENAME_HANDLER> >
+        RENAME_VISITOR;
+
+    RENAME_CTX     ctx(_ssa_cont, true);
+    RENAME_VISITOR trav(ctx);
+    air::base::NODE_ID entry = _ssa_cont->Container()->Entry_node()->Id();
+    ctx.Initialize(entry);
+
+    struct FRAME {
+      uint32_t _bb;
+      size_t   _mark;
+      uint32_t _kid;
+    };
+    std::vector<FRAME> stack;
+    stack.push_back(FRAME{_cfg->Entry(), ctx.Num_pushed(), 0});
+    Rename_bb(_cfg->Entry(), trav, ctx);
+    while (!stack.empty()) {
+      FRAME&                       top  = stack.back();
+      const std::vector<uint32_t>& kids = _cfg->Bb(top._bb).Dom_kids();
+      if (top._kid < kids.size()) {
+        uint32_t kid = kids[top._kid++];
+        stack.push_back(FRAME{kid, ctx.Num_pushed(), 0});
+        Rename_bb(kid, trav, ctx);
+      } else {
+        ctx.Pop_to(top._mark);
+        stack.pop_back();
+      }
+    }
+
+    for (uint32_t bb = 0; bb < _cfg->Num_bb(); ++bb) {
+      if (!_cfg->Bb(bb).Reachable()) {
+        size_t mark = ctx.Num_pushed();
+        Rename_bb(bb, trav, ctx);
+        ctx.Pop_to(mark);
+      }
+    }
+    ctx.Finalize(entry);
+    _ver_bb.resize(_ssa_cont->Num_ver(), CFG::NO_BB);
+  }
+
+  //! @brief Verify def of each version used in reachable blocks dominates
+  //! the use, PHI operand is checked at end of predecessor
+  void Verify() const {
+    for (uint32_t bb : _cfg->Rpo()) {
+      const CFG::BB& blk = _cfg->Bb(bb);
+      for (const CFG::ITEM& item : blk.Items()) {
+        Verify_use(_ssa_cont->Container()->Node(item._node), bb);
+      }
+      if (blk.Scf() == air::base::Null_id) {
+        continue;
+      }
+      PHI_LIST list(_ssa_cont, _ssa_cont->Node_phi(blk.Scf()));
+      list.For_each([this, &blk](PHI_NODE_PTR phi) {
+        for (uint32_t pred : blk.Pred()) {
+          uint32_t opnd = _cfg->Bb(pred).Phi_opnd();
+          AIR_ASSERT_MSG(opnd < phi->Size(), "SSA: bad phi operand index");
+          Verify_ver(phi->Opnd_id(opnd), pred);
+        }
+      });
+    }
+  }
+
+private:
+  // REQUIRED UNDEFINED UNWANTED methods
+  COMPLEX_BUILDER(void);
+  COMPLEX_BUILDER(const COMPLEX_BUILDER&);
+  COMPLEX_BUILDER& operator=(const COMPLEX_BUILDER&);
+
+  // collect symbols defined by item into def_bb
+  void Collect_def(const CFG::ITEM& item, uint32_t bb,
+                   std::vector<std::vector<uint32_t> >& def_bb) const {
+    air::base::NODE_PTR node = _ssa_cont->Container()->Node(item._node);
+    auto add_def = [&def_bb, bb](SSA_SYM_ID sym) {
+      std::vector<uint32_t>& list = def_bb[sym.Value()];
+      if (list.empty() || list.back() != bb) {
+        list.push_back(bb);
+      }
+    };
+    switch (item._kind) {
+      case CFG::STMT: {
+        SSA_SYM_ID sym = _ssa_cont->Node_sym_id(node->Id());
+        if (sym != air::base::Null_id) {
+          add_def(sym);
+        }
+        if (SSA_CONTAINER::Has_chi(node) &&
+            _ssa_cont->Node_chi(node->Id()) != air::base::Null_id) {
+          CHI_LIST list(_ssa_cont, _ssa_cont->Node_chi(node->Id()));
+          list.For_each(
+              [&add_def](CHI_NODE_PTR chi) { add_def(chi->Sym_id()); });
+        }
+        break;
+      }
+      case CFG::IV_INIT:
+      case CFG::IV_STEP:
+        add_def(_ssa_cont->Node_sym_id(node->Id()));
+        break;
+      default:
+        break;
+    }
+  }
+
+  template <typename VISITOR>
+  void Rename_bb(uint32_t bb, VISITOR& trav, RENAME_CTX& ctx) {
+    const CFG::BB&        blk  = _cfg->Bb(bb);
+    air::base::CONTAINER* cntr = _ssa_cont->Container();
+    size_t                mark = ctx.Num_pushed();
+    if (blk.Scf() != air::base::Null_id) {
+      ctx.Rename_phi_list(cntr->Node(blk.Scf()));
+    }
+    for (const CFG::ITEM& item : blk.Items()) {
+      air::base::NODE_PTR node = cntr->Node(item._node);
+      trav.template Visit<void>(node);
+      if (item._kind == CFG::IV_INIT || item._kind == CFG::IV_STEP) {
+        ctx.Handle_def(node->Id());
+      }
+    }
+    _ver_bb.resize(_ssa_cont->Num_ver(), CFG::NO_BB);
+    for (size_t i = mark; i < ctx.Num_pushed(); ++i) {
+      _ver_bb[ctx.Pushed(i).Value()] = bb;
+    }
+    // fill PHI operand of successor
+    if (blk.Phi_opnd() != CFG::NO_OPND) {
+      AIR_ASSERT(blk.Succ().size() == 1);
+      const CFG::BB& succ = _cfg->Bb(blk.Succ()[0]);
+      ctx.Rename_phi_opnd(cntr->Node(succ.Scf()), blk.Phi_opnd());
+    }
+  }
+
+  void Verify_use(air::base::NODE_PTR node, uint32_t bb) const {
+    if (SSA_CONTAINER::Has_ver(node)) {
+      SSA_VER_ID ver = _ssa_cont->Node_ver_id(node->Id());
+      if (ver != air::base::Null_id) {
+        Verify_ver(ver, bb);
+      }
+    }
+    if (SSA_CONTAINER::Has_mu(node) &&
+        _ssa_cont->Node_mu(node->Id()) != air::base::Null_id) {
+      MU_LIST list(_ssa_cont, _ssa_cont->Node_mu(node->Id()));
+      list.For_each(
+          [this, bb](MU_NODE_PTR mu) { Verify_ver(mu->Opnd_id(), bb); });
+    }
+    if (SSA_CONTAINER::Has_chi(node) &&
+        _ssa_cont->Node_chi(node->Id()) != air::base::Null_id) {
+      CHI_LIST list(_ssa_cont, _ssa_cont->Node_chi(node->Id()));
+      list.For_each(
+          [this, bb](CHI_NODE_PTR chi) { Verify_ver(chi->Opnd_id(), bb); });
+    }
+    for (uint32_t i = 0; i < node->Num_child(); ++i) {
+      Verify_use(node->Child(i), bb);
+    }
+  }
+
+  void Verify_ver(SSA_VER_ID ver, uint32_t bb) const {
+    AIR_ASSERT_MSG(ver != air::base::Null_id, "SSA: version not renamed");
+    // zero version is defined on function entry
+    uint32_t def_bb = _ver_bb[ver.Value()];
+    if (def_bb == CFG::NO_BB) {
+      def_bb = _cfg->Entry();
+    }
+    AIR_ASSERT_MSG(_cfg->Dominates(def_bb, bb),
+                   "SSA: def in BB%d doesn't dominate use in BB%d", def_bb,
+                   bb);
+  }
+
+  SSA_CONTAINER*        _ssa_cont;
+  const CFG*            _cfg;
+  std::vector<uint32_t> _ver_bb;  // version -> block defining it
+};
+
+}  // namespace opt
+
+}  // namespace air
+
+#endif  // AIR_OPT_SSA_COMPLEX_BUILDER_H
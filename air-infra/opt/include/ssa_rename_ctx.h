@@ -25,7 +25,11 @@ namespace opt {
 //! No alias analysis, no irregular control flow.
 class RENAME_CTX : public air::base::ANALYZE_CTX {
 public:
-  RENAME_CTX(SSA_CONTAINER* cont) : _ssa_cont(cont), _stack(cont) {}
+  //! @brief Construct renaming context
+  //! @param log_push Log pushed versions so that they can be popped by
+  //!                 Pop_to(), used by complex builder walking dominator tree
+  RENAME_CTX(SSA_CONTAINER* cont, bool log_push = false)
+      : _ssa_cont(cont), _stack(cont), _log_push(log_push) {}
 
   template <typename RETV, typename VISITOR>
   RETV Handle_unknown_domain(VISITOR* visitor, air::base::NODE_PTR node) {
@@ -46,6 +50,27 @@ public:
   //! @brief Pop block mark from renaming stack
   void Pop_mark(air::base::NODE_PTR node) { _stack.Pop_mark(node); }
 
+  //! @brief Number of versions pushed so far
+  size_t Num_pushed() const {
+    AIR_ASSERT(_log_push);
+    return _pushed.size();
+  }
+
+  //! @brief Version pushed at given index of the log
+  SSA_VER_ID Pushed(size_t idx) const {
+    AIR_ASSERT(idx < _pushed.size());
+    return SSA_VER_ID(_pushed[idx]);
+  }
+
+  //! @brief Pop versions pushed after Num_pushed() returned mark
+  void Pop_to(size_t mark) {
+    AIR_ASSERT(_log_push && mark <= _pushed.size());
+    while (_pushed.size() > mark) {
+      _stack.Pop_ver(_ssa_cont->Ver(SSA_VER_ID(_pushed.back())));
+      _pushed.pop_back();
+    }
+  }
+
 public:
   //! @brief Create and push new version defined by stmt
   SSA_VER_ID Gen_stmt_def(SSA_SYM_ID sym, air::base::STMT_ID stmt) {
@@ -53,7 +78,7 @@ public:
     SSA_VER_PTR ver = _ssa_cont->New_ver(VER_DEF_KIND::STMT, sym);
     ver->Set_version(_stack.Next_version(sym));
     ver->Set_def_stmt(stmt);
-    _stack.Push_ver(ver);
+    Push_ver(ver);
     return ver->Id();
   }
 
@@ -85,19 +110,19 @@ public:
     AIR_ASSERT(SSA_CONTAINER::Has_phi(node));
 
     auto rename = [](PHI_NODE_PTR phi, SSA_CONTAINER* cont,
-                     VERSION_STACK& stk) {
+                     VERSION_STACK& stk, RENAME_CTX* ctx) {
       SSA_SYM_ID sym = phi->Sym_id();
       AIR_ASSERT(sym.Value() < stk.Size());
       SSA_VER_PTR ver = cont->New_ver(VER_DEF_KIND::PHI, sym);
       ver->Set_version(stk.Next_version(sym));
       ver->Set_def_phi(phi->Id());
       phi->Set_result(ver->Id());
-      stk.Push_ver(ver);
+      ctx->Push_ver(ver);
     };
 
     PHI_NODE_ID id = _ssa_cont->Node_phi(node->Id());
     PHI_LIST    list(_ssa_cont, id);
-    list.For_each(rename, _ssa_cont, _stack);
+    list.For_each(rename, _ssa_cont, _stack, this);
   }
 
   //! @brief Rename PHI_NODE operand
@@ -124,7 +149,7 @@ public:
   void Rename_chi_list(air::base::NODE_PTR node) {
     AIR_ASSERT(SSA_CONTAINER::Has_chi(node));
     auto rename = [](CHI_NODE_PTR chi, SSA_CONTAINER* cont,
-                     VERSION_STACK& stk) {
+                     VERSION_STACK& stk, RENAME_CTX* ctx) {
       SSA_SYM_ID sym = chi->Sym_id();
       AIR_ASSERT(sym.Value() < stk.Size());
       // 1. rename opnd
@@ -137,17 +162,26 @@ public:
       ver->Set_version(stk.Next_version(sym));
       ver->Set_def_chi(chi->Id());
       chi->Set_result(ver->Id());
-      stk.Push_ver(ver);
+      ctx->Push_ver(ver);
     };
 
     CHI_NODE_ID chi_id = _ssa_cont->Node_chi(node->Id());
     CHI_LIST    list(_ssa_cont, chi_id);
-    list.For_each(rename, _ssa_cont, _stack);
+    list.For_each(rename, _ssa_cont, _stack, this);
   }
 
 private:
-  SSA_CONTAINER* _ssa_cont;
-  VERSION_STACK  _stack;
+  void Push_ver(SSA_VER_PTR ver) {
+    _stack.Push_ver(ver);
+    if (_log_push) {
+      _pushed.push_back(ver->Id().Value());
+    }
+  }
+
+  SSA_CONTAINER*        _ssa_cont;
+  VERSION_STACK         _stack;
+  std::vector<uint32_t> _pushed;    // versions pushed, in order
+  bool                  _log_push;  // log pushed versions for Pop_to()
 };
 
 }  // namespace opt
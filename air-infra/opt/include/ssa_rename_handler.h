@@ -41,7 +41,7 @@ public:
 
   template <typename RETV, typename VISITOR>
   RETV Handle_ldf(VISITOR* visitor, air::base::NODE_PTR node) {
-    AIR_ASSERT(false);
+    visitor->Context().Handle_use(node->Id());
   }
 
   template <typename RETV, typename VISITOR>
@@ -56,7 +56,7 @@ public:
 
   template <typename RETV, typename VISITOR>
   RETV Handle_ldpf(VISITOR* visitor, air::base::NODE_PTR node) {
-    AIR_ASSERT(false);
+    visitor->Context().Handle_use(node->Id());
   }
 
   template <typename RETV, typename VISITOR>
@@ -89,7 +89,8 @@ public:
 
   template <typename RETV, typename VISITOR>
   RETV Handle_stf(VISITOR* visitor, air::base::NODE_PTR node) {
-    AIR_ASSERT(false);
+    visitor->template Visit<RETV>(node->Child(0));
+    visitor->Context().Handle_def(node->Id());
   }
 
   template <typename RETV, typename VISITOR>
@@ -105,7 +106,8 @@ public:
 
   template <typename RETV, typename VISITOR>
   RETV Handle_stpf(VISITOR* visitor, air::base::NODE_PTR node) {
-    AIR_ASSERT(false);
+    visitor->template Visit<RETV>(node->Child(0));
+    visitor->Context().Handle_def(node->Id());
   }
 
   template <typename RETV, typename VISITOR>
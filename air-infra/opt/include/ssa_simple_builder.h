@@ -110,6 +110,9 @@ private:
   }
 
   void Append_phi_def(air::base::STMT_PTR stmt, SSA_SYM_ID sym) {
+    if (!_scf_phi) {
+      return;
+    }
     while (stmt != air::base::Null_ptr) {
       if (SSA_CONTAINER::Has_phi(stmt->Node())) {
         SCF_SYM_INFO* info = Get_scf_info(stmt->Id().Value());
@@ -130,7 +133,11 @@ private:
   }
 
 public:
-  SIMPLE_BUILDER_CTX(SSA_CONTAINER* cont) : _ssa_cont(cont) {
+  //! @brief Construct symtab builder context
+  //! @param scf_phi Collect defs in IF/DO_LOOP for Insert_phi(). Complex
+  //!                builder places PHI with dominance frontier instead
+  SIMPLE_BUILDER_CTX(SSA_CONTAINER* cont, bool scf_phi = true)
+      : _ssa_cont(cont), _scf_phi(scf_phi) {
     air::util::CXX_MEM_ALLOCATOR<U64_SYM_MAP, MEM_POOL> u64_map_allocator(
         &_mpool);
     _datum_map = u64_map_allocator.Allocate(13, std::hash<uint64_t>(),
@@ -219,6 +226,7 @@ private:
   U64_SYM_MAP* _preg_map;
   // for phi insertion
   U32_SCF_MAP* _scf_map;
+  bool         _scf_phi;
 };
 
 //! @brief SIMPLE_SYMTAB_HANDLER
@@ -258,7 +266,8 @@ public:
 
   template <typename RETV, typename VISITOR>
   RETV Handle_ldf(VISITOR* visitor, air::base::NODE_PTR node) {
-    AIR_ASSERT(false);
+    visitor->Context().Handle_variable(node->Addr_datum_id(),
+                                       node->Field_id().Value(), node, false);
   }
 
   template <typename RETV, typename VISITOR>
@@ -274,7 +283,8 @@ public:
 
   template <typename RETV, typename VISITOR>
   RETV Handle_ldpf(VISITOR* visitor, air::base::NODE_PTR node) {
-    AIR_ASSERT(false);
+    visitor->Context().Handle_variable(node->Preg_id(),
+                                       node->Field_id().Value(), node, false);
   }
 
   template <typename RETV, typename VISITOR>
@@ -307,7 +317,9 @@ public:
 
   template <typename RETV, typename VISITOR>
   RETV Handle_stf(VISITOR* visitor, air::base::NODE_PTR node) {
-    AIR_ASSERT(false);
+    visitor->template Visit<RETV>(node->Child(0));
+    visitor->Context().Handle_variable(node->Addr_datum_id(),
+                                       node->Field_id().Value(), node, true);
   }
 
   template <typename RETV, typename VISITOR>
@@ -324,7 +336,9 @@ public:
 
   template <typename RETV, typename VISITOR>
   RETV Handle_stpf(VISITOR* visitor, air::base::NODE_PTR node) {
-    AIR_ASSERT(false);
+    visitor->template Visit<RETV>(node->Child(0));
+    visitor->Context().Handle_variable(node->Preg_id(),
+                                       node->Field_id().Value(), node, true);
   }
 
   template <typename RETV, typename VISITOR>
@@ -0,0 +1,300 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "air/opt/cfg.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "air/core/opcode.h"
+#include "air/opt/ssa_container.h"
+
+using namespace air::base;
+
+namespace air {
+
+namespace opt {
+
+void CFG::Build() {
+  AIR_ASSERT(_bb.empty());
+  _entry         = New_bb();
+  _exit          = New_bb();
+  NODE_PTR entry = _func->Container().Entry_node();
+  for (uint32_t i = 0; i < entry->Num_child(); ++i) {
+    NODE_PTR kid = entry->Child(i);
+    if (kid->Opcode() == air::core::OPC_IDNAME) {
+      Add_item(_entry, EXPR, kid->Id());
+    }
+  }
+  uint32_t last = Build_block(entry->Body_blk(), _entry);
+  if (last != NO_BB) {
+    Connect(last, _exit);
+  }
+  Compute_rpo();
+  Compute_dom();
+  Compute_df();
+}
+
+uint32_t CFG::New_bb() {
+  uint32_t id = _bb.size();
+  _bb.emplace_back();
+  _bb.back()._id = id;
+  return id;
+}
+
+void CFG::Add_item(uint32_t bb, ITEM_KIND kind, NODE_ID node) {
+  _bb[bb]._items.push_back(ITEM{kind, node});
+  _item_bb[node.Value()] = bb;
+}
+
+void CFG::Connect(uint32_t from, uint32_t to, uint32_t opnd) {
+  AIR_ASSERT(opnd == NO_OPND || _bb[from]._succ.empty());
+  _bb[from]._succ.push_back(to);
+  _bb[from]._phi_opnd = opnd;
+  _bb[to]._pred.push_back(from);
+}
+
+uint32_t CFG::Build_block(NODE_PTR blk, uint32_t cur) {
+  AIR_ASSERT(blk->Is_block());
+  for (STMT_PTR stmt = blk->Begin_stmt(); stmt != blk->End_stmt();
+       stmt          = stmt->Next()) {
+    cur = Build_stmt(stmt->Node(), cur);
+  }
+  return cur;
+}
+
+uint32_t CFG::Build_stmt(NODE_PTR node, uint32_t cur) {
+  if (node->Is_block()) {
+    // nested statement block doesn't change control flow
+    return Build_block(node, cur);
+  }
+  if (cur == NO_BB) {
+    // statement after RET/RETV
+    cur = New_bb();
+  }
+  switch (node->Opcode()) {
+    case air::core::OPC_IF: {
+      Add_item(cur, EXPR, node->Child_id(0));
+      uint32_t then_bb = New_bb();
+      uint32_t else_bb = New_bb();
+      Connect(cur, then_bb);
+      Connect(cur, else_bb);
+      uint32_t then_end = Build_block(node->Child(1), then_bb);
+      uint32_t else_end = Build_block(node->Child(2), else_bb);
+      uint32_t join     = New_bb();
+      _bb[join]._scf    = node->Id();
+      _phi_bb[node->Id().Value()] = join;
+      if (then_end != NO_BB) {
+        Connect(then_end, join, 0);
+      }
+      if (else_end != NO_BB) {
+        Connect(else_end, join, 1);
+      }
+      return join;
+    }
+    case air::core::OPC_DO_LOOP: {
+      Add_item(cur, IV_INIT, node->Child_id(0));
+      uint32_t header = New_bb();
+      _bb[header]._scf            = node->Id();
+      _phi_bb[node->Id().Value()] = header;
+      Connect(cur, header, PREHEADER_PHI_OPND_ID);
+      Add_item(header, EXPR, node->Child_id(1));
+      uint32_t body  = New_bb();
+      uint32_t exit  = New_bb();
+      Connect(header, body);
+      Connect(header, exit);
+      uint32_t latch = Build_block(node->Child(3), body);
+      if (latch == NO_BB) {
+        // body always returns, IV-update is unreachable
+        latch = New_bb();
+      }
+      Add_item(latch, IV_STEP, node->Child_id(2));
+      Connect(latch, header, BACK_EDGE_PHI_OPND_ID);
+      return exit;
+    }
+    case air::core::OPC_RET:
+    case air::core::OPC_RETV:
+      Add_item(cur, STMT, node->Id());
+      Connect(cur, _exit);
+      return NO_BB;
+    default:
+      for (uint32_t i = 0; i < node->Num_child(); ++i) {
+        AIR_ASSERT_MSG(!node->Child(i)->Is_block(),
+                       "CFG: unsupported control flow statement");
+      }
+      Add_item(cur, STMT, node->Id());
+      return cur;
+  }
+}
+
+void CFG::Compute_rpo() {
+  // iterative DFS from entry, block is appended to post order once all its
+  // successors are visited
+  std::vector<uint32_t>                      post;
+  std::vector<std::pair<uint32_t, uint32_t>> stack;
+  _bb[_entry]._reachable = true;
+  stack.emplace_back(_entry, 0);
+  while (!stack.empty()) {
+    uint32_t bb  = stack.back().first;
+    uint32_t idx = stack.back().second;
+    if (idx < _bb[bb]._succ.size()) {
+      ++stack.back().second;
+      uint32_t succ = _bb[bb]._succ[idx];
+      if (!_bb[succ]._reachable) {
+        _bb[succ]._reachable = true;
+        stack.emplace_back(succ, 0);
+      }
+    } else {
+      post.push_back(bb);
+      stack.pop_back();
+    }
+  }
+  _rpo.assign(post.rbegin(), post.rend());
+
+  // remove edges from unreachable blocks
+  for (BB& bb : _bb) {
+    if (bb._reachable) {
+      continue;
+    }
+    for (uint32_t succ : bb._succ) {
+      std::vector<uint32_t>& pred = _bb[succ]._pred;
+      pred.erase(std::remove(pred.begin(), pred.end(), bb._id), pred.end());
+    }
+    bb._succ.clear();
+    bb._phi_opnd = NO_OPND;
+  }
+}
+
+uint32_t CFG::Intersect(uint32_t a, uint32_t b,
+                        const std::vector<uint32_t>& rpo_idx) const {
+  while (a != b) {
+    while (rpo_idx[a] > rpo_idx[b]) {
+      a = _bb[a]._idom;
+    }
+    while (rpo_idx[b] > rpo_idx[a]) {
+      b = _bb[b]._idom;
+    }
+  }
+  return a;
+}
+
+void CFG::Compute_dom() {
+  // "A Simple, Fast Dominance Algorithm", Cooper, Harvey and Kennedy
+  std::vector<uint32_t> rpo_idx(_bb.size(), NO_BB);
+  for (uint32_t i = 0; i < _rpo.size(); ++i) {
+    rpo_idx[_rpo[i]] = i;
+  }
+  _bb[_entry]._idom = _entry;
+  bool changed      = true;
+  while (changed) {
+    changed = false;
+    for (uint32_t i = 1; i < _rpo.size(); ++i) {
+      BB&      bb       = _bb[_rpo[i]];
+      uint32_t new_idom = NO_BB;
+      for (uint32_t pred : bb._pred) {
+        if (_bb[pred]._idom == NO_BB) {
+          continue;
+        }
+        new_idom = (new_idom == NO_BB) ? pred
+                                       : Intersect(pred, new_idom, rpo_idx);
+      }
+      AIR_ASSERT(new_idom != NO_BB);
+      if (bb._idom != new_idom) {
+        bb._idom = new_idom;
+        changed  = true;
+      }
+    }
+  }
+  _bb[_entry]._idom = NO_BB;
+  for (uint32_t i = 1; i < _rpo.size(); ++i) {
+    _bb[_bb[_rpo[i]]._idom]._dom_kids.push_back(_rpo[i]);
+  }
+
+  // number dominator tree in preorder for Dominates()
+  uint32_t              num = 0;
+  std::vector<uint32_t> stack(1, _entry);
+  std::vector<uint32_t> order;
+  while (!stack.empty()) {
+    uint32_t bb = stack.back();
+    stack.pop_back();
+    _bb[bb]._pre = num++;
+    order.push_back(bb);
+    const std::vector<uint32_t>& kids = _bb[bb]._dom_kids;
+    stack.insert(stack.end(), kids.rbegin(), kids.rend());
+  }
+  for (std::vector<uint32_t>::reverse_iterator it = order.rbegin();
+       it != order.rend(); ++it) {
+    BB& bb   = _bb[*it];
+    bb._post = bb._pre;
+    for (uint32_t kid : bb._dom_kids) {
+      bb._post = std::max(bb._post, _bb[kid]._post);
+    }
+  }
+}
+
+void CFG::Compute_df() {
+  for (uint32_t id : _rpo) {
+    const BB& bb = _bb[id];
+    if (bb._pred.size() < 2) {
+      continue;
+    }
+    for (uint32_t runner : bb._pred) {
+      while (runner != bb._idom) {
+        std::vector<uint32_t>& df = _bb[runner]._df;
+        if (df.empty() || df.back() != id) {
+          df.push_back(id);
+        }
+        runner = _bb[runner]._idom;
+      }
+    }
+  }
+}
+
+void CFG::Print(std::ostream& os, uint32_t indent) const {
+  static const char* kind_name[] = {"stmt", "expr", "iv_init", "iv_step"};
+  auto print_list = [](std::ostream& os, const char* name,
+                       const std::vector<uint32_t>& list) {
+    os << " " << name << "(";
+    for (uint32_t i = 0; i < list.size(); ++i) {
+      os << (i == 0 ? "" : ",") << list[i];
+    }
+    os << ")";
+  };
+  for (const BB& bb : _bb) {
+    os << std::string(indent * INDENT_SPACE, ' ') << "BB" << bb._id;
+    if (bb._id == _entry) {
+      os << " entry";
+    } else if (bb._id == _exit) {
+      os << " exit";
+    }
+    if (!bb._reachable) {
+      os << " unreachable";
+    }
+    print_list(os, "pred", bb._pred);
+    print_list(os, "succ", bb._succ);
+    if (bb._idom != NO_BB) {
+      os << " idom(" << bb._idom << ")";
+    }
+    print_list(os, "df", bb._df);
+    if (bb._scf != Null_id) {
+      os << " phi(ID(0x" << std::hex << bb._scf.Value() << std::dec << "))";
+    }
+    os << std::endl;
+    for (const ITEM& item : bb._items) {
+      os << std::string((indent + 1) * INDENT_SPACE, ' ')
+         << kind_name[item._kind] << " ID(0x" << std::hex
+         << item._node.Value() << std::dec << ")" << std::endl;
+    }
+  }
+}
+
+void CFG::Print() const { Print(std::cout, 0); }
+
+}  // namespace opt
+
+}  // namespace air
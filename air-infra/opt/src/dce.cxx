@@ -0,0 +1,153 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "air/opt/dce.h"
+
+#include "air/core/opcode.h"
+#include "air/opt/ssa_node_list.h"
+
+using namespace air::base;
+
+namespace air {
+
+namespace opt {
+
+static bool Is_load(NODE_PTR node) {
+  return node->Opcode() == air::core::OPC_LD ||
+         node->Opcode() == air::core::OPC_LDP ||
+         node->Opcode() == air::core::OPC_LDF ||
+         node->Opcode() == air::core::OPC_LDPF;
+}
+
+void DCE::Perform() {
+  NODE_PTR body = _cntr->Entry_node()->Body_blk();
+  _exposed.Collect(body);
+  _live_ver.resize(_ssa_cntr->Num_ver(), false);
+  Mark_block(body);
+  Propagate();
+  Sweep_block(body);
+}
+
+bool DCE::Is_removable(NODE_PTR node) const {
+  if (node->Opcode() != air::core::OPC_ST &&
+      node->Opcode() != air::core::OPC_STP) {
+    return false;
+  }
+  return _exposed.Is_tracked(node) && Is_pure(node->Child(0));
+}
+
+bool DCE::Is_pure(NODE_PTR expr) const {
+  if (!Is_load(expr) && !_policy->Is_pure(expr)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < expr->Num_child(); ++i) {
+    if (!Is_pure(expr->Child(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void DCE::Mark_block(NODE_PTR blk) {
+  for (STMT_PTR stmt = blk->Begin_stmt(); stmt != blk->End_stmt();
+       stmt          = stmt->Next()) {
+    NODE_PTR node = stmt->Node();
+    if (!Is_removable(node)) {
+      Mark_use(node);
+    }
+  }
+}
+
+void DCE::Mark_use(NODE_PTR expr) {
+  if (expr->Is_block()) {
+    Mark_block(expr);
+    return;
+  }
+  if (Is_load(expr)) {
+    Mark_ver(_ssa_cntr->Node_ver_id(expr->Id()));
+  }
+  if (SSA_CONTAINER::Has_mu(expr) &&
+      _ssa_cntr->Node_mu(expr->Id()) != Null_id) {
+    MU_LIST list(_ssa_cntr, _ssa_cntr->Node_mu(expr->Id()));
+    list.For_each([this](MU_NODE_PTR mu) { Mark_ver(mu->Opnd_id()); });
+  }
+  for (uint32_t i = 0; i < expr->Num_child(); ++i) {
+    Mark_use(expr->Child(i));
+  }
+}
+
+void DCE::Mark_ver(SSA_VER_ID ver) {
+  if (ver == Null_id || _live_ver[ver.Value()]) {
+    return;
+  }
+  _live_ver[ver.Value()] = true;
+  _worklist.push_back(ver);
+}
+
+void DCE::Propagate() {
+  while (!_worklist.empty()) {
+    SSA_VER_PTR ver = _ssa_cntr->Ver(_worklist.back());
+    _worklist.pop_back();
+    switch (ver->Kind()) {
+      case VER_DEF_KIND::STMT: {
+        // other statements are live already
+        NODE_PTR def = _cntr->Node(NODE_ID(ver->Def_stmt_id().Value()));
+        if (Is_removable(def) && _live_stmt.insert(def->Id().Value()).second) {
+          Mark_use(def->Child(0));
+        }
+        break;
+      }
+      case VER_DEF_KIND::PHI: {
+        PHI_NODE_PTR phi = _ssa_cntr->Phi_node(ver->Def_phi_id());
+        for (uint32_t i = 0; i < phi->Size(); ++i) {
+          Mark_ver(phi->Opnd_id(i));
+        }
+        break;
+      }
+      case VER_DEF_KIND::CHI:
+        Mark_ver(_ssa_cntr->Chi_node(ver->Def_chi_id())->Opnd_id());
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void DCE::Sweep_block(NODE_PTR blk) {
+  for (STMT_PTR stmt = blk->Begin_stmt(); stmt != blk->End_stmt();) {
+    STMT_PTR next = stmt->Next();
+    NODE_PTR node = stmt->Node();
+    if (Is_removable(node)) {
+      if (_live_stmt.find(node->Id().Value()) == _live_stmt.end()) {
+        Eliminate(node->Child(0));
+        STMT_LIST(blk).Remove(stmt);
+        ++_num_dead;
+      }
+    } else if (node->Is_block()) {
+      Sweep_block(node);
+    } else {
+      for (uint32_t i = 0; i < node->Num_child(); ++i) {
+        if (node->Child(i)->Is_block()) {
+          Sweep_block(node->Child(i));
+        }
+      }
+    }
+    stmt = next;
+  }
+}
+
+void DCE::Eliminate(NODE_PTR node) {
+  for (uint32_t i = 0; i < node->Num_child(); ++i) {
+    Eliminate(node->Child(i));
+  }
+  _policy->Eliminate(node);
+}
+
+}  // namespace opt
+
+}  // namespace air
@@ -0,0 +1,379 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "air/opt/gvn.h"
+
+#include <algorithm>
+#include <string>
+
+#include "air/core/opcode.h"
+#include "air/opt/ssa_node_list.h"
+
+using namespace air::base;
+
+namespace air {
+
+namespace opt {
+
+void GVN::Perform() {
+  NODE_PTR body = _cntr->Entry_node()->Body_blk();
+  _exposed.Collect(body);
+  _ver_vn.resize(_ssa_cntr->Num_ver(), 0);
+  Handle_block(body);
+}
+
+void GVN::Handle_block(NODE_PTR blk) {
+  size_t avail_mark = _avail_log.size();
+  size_t cur_mark   = _cur_log.size();
+  for (STMT_PTR stmt = blk->Begin_stmt(); stmt != blk->End_stmt();) {
+    // stmt may be removed
+    STMT_PTR next = stmt->Next();
+    Handle_stmt(stmt);
+    stmt = next;
+  }
+  // values defined in block don't dominate statements after it
+  while (_avail_log.size() > avail_mark) {
+    const LOG_ENTRY& ent = _avail_log.back();
+    if (ent._avail._kind == NONE) {
+      _avail.erase(ent._vn);
+    } else {
+      _avail[ent._vn] = ent._avail;
+    }
+    _avail_log.pop_back();
+  }
+  while (_cur_log.size() > cur_mark) {
+    _cur[_cur_log.back()._sym] = _cur_log.back()._ver;
+    _cur_log.pop_back();
+  }
+}
+
+void GVN::Handle_stmt(STMT_PTR stmt) {
+  NODE_PTR node = stmt->Node();
+  if (node->Is_block()) {
+    Handle_block(node);
+    return;
+  }
+  if (node->Is_if()) {
+    Handle_expr(node, 0, stmt, true);
+    Handle_block(node->Then_blk());
+    Handle_block(node->Else_blk());
+    Update_phi(node);
+    return;
+  }
+  if (node->Is_do_loop()) {
+    // only IV init is evaluated once before the loop
+    Handle_expr(node, 0, stmt, true);
+    Update_phi(node);
+    Handle_block(node->Body_blk());
+    return;
+  }
+  bool is_store = (node->Opcode() == air::core::OPC_ST ||
+                   node->Opcode() == air::core::OPC_STP) &&
+                  _exposed.Is_tracked(node);
+  uint32_t vn = 0;
+  for (uint32_t i = 0; i < node->Num_child(); ++i) {
+    vn = Handle_expr(node, i, stmt, !is_store);
+  }
+  if (is_store) {
+    Handle_store(stmt, vn);
+    return;
+  }
+
+  // other definitions kill values held by the symbol
+  SSA_VER_ID ver = _ssa_cntr->Node_ver_id(node->Id());
+  if (ver != Null_id) {
+    Set_cur(_ssa_cntr->Ver(ver)->Sym_id(), ver);
+  }
+  if (SSA_CONTAINER::Has_chi(node) &&
+      _ssa_cntr->Node_chi(node->Id()) != Null_id) {
+    CHI_LIST list(_ssa_cntr, _ssa_cntr->Node_chi(node->Id()));
+    list.For_each([this](CHI_NODE_PTR chi) {
+      Set_cur(chi->Sym_id(), chi->Result_id());
+    });
+  }
+}
+
+void GVN::Handle_store(STMT_PTR stmt, uint32_t vn) {
+  NODE_PTR   node = stmt->Node();
+  SSA_VER_ID ver  = _ssa_cntr->Node_ver_id(node->Id());
+  SSA_SYM_ID sym  = _ssa_cntr->Node_sym_id(node->Id());
+  AIR_ASSERT(ver != Null_id && sym != Null_id);
+  AIR_ASSERT(ver.Value() < _ver_vn.size());
+  _ver_vn[ver.Value()] = vn;
+
+  bool       is_st = (node->Opcode() == air::core::OPC_ST);
+  AVAIL_KIND kind  = is_st ? VAR : PREG;
+  uint32_t   var =
+      is_st ? node->Addr_datum_id().Value() : node->Preg_id().Value();
+  AVAIL* avail = Find(vn);
+  if (avail != nullptr && avail->_kind == kind && avail->_var == var) {
+    // variable already holds the value. keep the old version as current one
+    // since it still describes content of the variable
+    Drop_candidate(node->Child(0));
+    Eliminate(node->Child(0));
+    STMT_LIST::Enclosing_list(stmt).Remove(stmt);
+    ++_num_store;
+    return;
+  }
+  Set_cur(sym, ver);
+  if (avail == nullptr || avail->_kind == CANDIDATE) {
+    AVAIL holder;
+    holder._kind = kind;
+    holder._var  = var;
+    holder._sym  = sym.Value();
+    holder._ver  = ver.Value();
+    Set_avail(vn, holder);
+  }
+}
+
+uint32_t GVN::Handle_expr(NODE_PTR parent, uint32_t kid, STMT_PTR stmt,
+                          bool share) {
+  NODE_PTR node = parent->Child(kid);
+  if (node->Num_child() == 0) {
+    return Leaf_vn(node);
+  }
+
+  VN_KEY key;
+  key.push_back(((uint64_t)node->Domain() << 32) | node->Operator());
+  key.push_back(node->Rtype_id().Value());
+  if (node->Has_access_type()) {
+    key.push_back(node->Access_type_id().Value());
+  }
+  Append_attr_key(node, key);
+  for (uint32_t i = 0; i < node->Num_child(); ++i) {
+    key.push_back(Handle_expr(node, i, stmt, true));
+  }
+  if (!_policy->Is_pure(node)) {
+    return ++_last_vn;
+  }
+  uint32_t vn = Lookup(key);
+  _node_vn[node->Id().Value()] = vn;
+
+  // whole value can only be stored into another variable by copy
+  bool copy = (parent->Opcode() == air::core::OPC_ST ||
+               parent->Opcode() == air::core::OPC_STP);
+  if (copy && !_policy->Is_copyable(node->Rtype())) {
+    return vn;
+  }
+  AVAIL* avail = Find(vn);
+  if (avail != nullptr && avail->_kind == CANDIDATE) {
+    Share(avail);
+  }
+  if (avail != nullptr && Replace(parent, kid, avail)) {
+    return vn;
+  }
+  if (avail == nullptr && share && _policy->Is_worth_sharing(node)) {
+    AVAIL cand;
+    cand._kind   = CANDIDATE;
+    cand._stmt   = stmt->Id().Value();
+    cand._parent = parent->Id().Value();
+    cand._kid    = kid;
+    cand._node   = node->Id().Value();
+    Set_avail(vn, cand);
+  }
+  return vn;
+}
+
+uint32_t GVN::Leaf_vn(NODE_PTR node) {
+  if (node->Opcode() == air::core::OPC_LD ||
+      node->Opcode() == air::core::OPC_LDP) {
+    SSA_VER_ID ver = _ssa_cntr->Node_ver_id(node->Id());
+    if (ver != Null_id && _exposed.Is_tracked(node)) {
+      return Ver_vn(ver);
+    }
+    return ++_last_vn;
+  }
+  if (!_policy->Is_pure(node)) {
+    return ++_last_vn;
+  }
+  VN_KEY key;
+  key.push_back(((uint64_t)node->Domain() << 32) | node->Operator());
+  key.push_back(node->Rtype_id().Value());
+  if (node->Opcode() == air::core::OPC_INTCONST) {
+    key.push_back(node->Intconst());
+  } else if (node->Has_const_id()) {
+    key.push_back(node->Const_id().Value());
+  } else if (node->Has_sym()) {
+    key.push_back(node->Addr_datum_id().Value());
+  }
+  Append_attr_key(node, key);
+  return Lookup(key);
+}
+
+void GVN::Append_attr_key(NODE_PTR node, VN_KEY& key) {
+  if (!META_INFO::Has_prop<OPR_PROP::ATTR>(node->Opcode())) {
+    return;
+  }
+  // nodes differing in any attribute like scale or level get different value
+  // numbers. attributes are numbered by their exact content and sorted so
+  // that the order they were set in doesn't matter
+  std::vector<uint32_t> attr_id;
+  for (ATTR_ITER it = node->Begin_attr(); it != node->End_attr(); ++it) {
+    std::string attr((*it)->Key());
+    attr.push_back('\0');
+    attr += std::to_string((uint32_t)(*it)->Type()) + ":" +
+            std::to_string((*it)->Count()) + ":";
+    attr.append((*it)->Value());
+    auto res = _attr_id.emplace(attr, _attr_id.size() + 1);
+    attr_id.push_back(res.first->second);
+  }
+  std::sort(attr_id.begin(), attr_id.end());
+  key.push_back(attr_id.size());
+  key.insert(key.end(), attr_id.begin(), attr_id.end());
+}
+
+uint32_t GVN::Ver_vn(SSA_VER_ID ver) {
+  AIR_ASSERT(ver.Value() < _ver_vn.size());
+  // value of PHI/CHI result and zero version is only known to be itself
+  if (_ver_vn[ver.Value()] == 0) {
+    _ver_vn[ver.Value()] = ++_last_vn;
+  }
+  return _ver_vn[ver.Value()];
+}
+
+uint32_t GVN::Lookup(const VN_KEY& key) {
+  VN_MAP::iterator it = _vn_map.find(key);
+  if (it != _vn_map.end()) {
+    return it->second;
+  }
+  uint32_t vn = ++_last_vn;
+  _vn_map.insert(it, std::make_pair(key, vn));
+  return vn;
+}
+
+void GVN::Update_phi(NODE_PTR node) {
+  PHI_NODE_ID head = _ssa_cntr->Node_phi(node->Id());
+  if (head == Null_id) {
+    return;
+  }
+  PHI_LIST list(_ssa_cntr, head);
+  list.For_each([this](PHI_NODE_PTR phi) {
+    Set_cur(phi->Sym_id(), phi->Result_id());
+  });
+}
+
+bool GVN::Is_valid(const AVAIL& avail) const {
+  switch (avail._kind) {
+    case VAR:
+    case PREG:
+      return Cur_ver(SSA_SYM_ID(avail._sym)) == avail._ver;
+    case TMP:
+      return true;
+    case CANDIDATE:
+      // candidate is gone if the tree holding it was replaced
+      return _cntr->Node(NODE_ID(avail._parent))->Child_id(avail._kid) ==
+             NODE_ID(avail._node);
+    default:
+      return false;
+  }
+}
+
+GVN::AVAIL* GVN::Find(uint32_t vn) {
+  AVAIL_MAP::iterator it = _avail.find(vn);
+  if (it == _avail.end() || !Is_valid(it->second)) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+bool GVN::Replace(NODE_PTR parent, uint32_t kid, AVAIL* avail) {
+  NODE_PTR node = parent->Child(kid);
+  NODE_PTR ld;
+  if (avail->_kind == PREG) {
+    PREG_PTR preg = _func->Preg(PREG_ID(avail->_var));
+    if (preg->Type_id() != node->Rtype_id()) {
+      return false;
+    }
+    ld = _cntr->New_ldp(preg, node->Spos());
+  } else {
+    AIR_ASSERT(avail->_kind == VAR || avail->_kind == TMP);
+    ADDR_DATUM_PTR var = _func->Addr_datum(ADDR_DATUM_ID(avail->_var));
+    if (var->Type_id() != node->Rtype_id()) {
+      return false;
+    }
+    ld = _cntr->New_ld(var, node->Spos());
+  }
+  Copy_attr(ld, node);
+  parent->Set_child(kid, ld);
+  Drop_candidate(node);
+  Eliminate(node);
+  ++_num_redundant;
+  return true;
+}
+
+void GVN::Share(AVAIL* cand) {
+  AIR_ASSERT(cand->_kind == CANDIDATE);
+  NODE_PTR parent = _cntr->Node(NODE_ID(cand->_parent));
+  NODE_PTR expr   = parent->Child(cand->_kid);
+  STMT_PTR stmt   = _cntr->Stmt(STMT_ID(cand->_stmt));
+
+  // st tmp = expr right before statement of the first occurrence, which
+  // dominates all later occurrences in the scope
+  std::string name = _policy->Tmp_prefix() + std::to_string(_num_tmp++);
+  ADDR_DATUM_PTR tmp = _func->New_var(expr->Rtype(), name.c_str(),
+                                      expr->Spos());
+  NODE_PTR ld = _cntr->New_ld(tmp, expr->Spos());
+  Copy_attr(ld, expr);
+  parent->Set_child(cand->_kid, ld);
+  STMT_PTR st = _cntr->New_st(expr, tmp, expr->Spos());
+  Copy_attr(st->Node(), expr);
+  STMT_LIST::Enclosing_list(stmt).Prepend(stmt, st);
+
+  // update in place to keep the scope of candidate
+  *cand       = AVAIL();
+  cand->_kind = TMP;
+  cand->_var  = tmp->Id().Value();
+}
+
+void GVN::Set_avail(uint32_t vn, const AVAIL& avail) {
+  AVAIL_MAP::iterator it = _avail.find(vn);
+  _avail_log.push_back({vn, it != _avail.end() ? it->second : AVAIL()});
+  if (avail._kind == NONE) {
+    _avail.erase(vn);
+  } else {
+    _avail[vn] = avail;
+  }
+}
+
+void GVN::Set_cur(SSA_SYM_ID sym, SSA_VER_ID ver) {
+  _cur_log.push_back({sym.Value(), Cur_ver(sym)});
+  _cur[sym.Value()] = ver.Value();
+}
+
+uint32_t GVN::Cur_ver(SSA_SYM_ID sym) const {
+  U32_MAP::const_iterator it = _cur.find(sym.Value());
+  if (it != _cur.end()) {
+    return it->second;
+  }
+  return _ssa_cntr->Sym(sym)->Zero_ver_id().Value();
+}
+
+void GVN::Drop_candidate(NODE_PTR node) {
+  U32_MAP::iterator it = _node_vn.find(node->Id().Value());
+  if (it != _node_vn.end()) {
+    AVAIL_MAP::iterator avail = _avail.find(it->second);
+    if (avail != _avail.end() && avail->second._kind == CANDIDATE &&
+        avail->second._node == node->Id().Value()) {
+      Set_avail(it->second, AVAIL());
+    }
+  }
+  for (uint32_t i = 0; i < node->Num_child(); ++i) {
+    Drop_candidate(node->Child(i));
+  }
+}
+
+void GVN::Eliminate(NODE_PTR node) {
+  for (uint32_t i = 0; i < node->Num_child(); ++i) {
+    Eliminate(node->Child(i));
+  }
+  _policy->Eliminate(node);
+}
+
+}  // namespace opt
+
+}  // namespace air
@@ -0,0 +1,171 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "air/opt/licm.h"
+
+#include <string>
+
+#include "air/core/opcode.h"
+
+using namespace air::base;
+
+namespace air {
+
+namespace opt {
+
+void LICM::Perform() {
+  NODE_PTR body = _cntr->Entry_node()->Body_blk();
+  _exposed.Collect(body);
+  Handle_block(body);
+}
+
+bool LICM::Run_once(NODE_PTR loop) {
+  NODE_PTR init = loop->Loop_init();
+  NODE_PTR comp = loop->Compare();
+  if (init->Opcode() != air::core::OPC_INTCONST ||
+      (comp->Opcode() != air::core::OPC_LT &&
+       comp->Opcode() != air::core::OPC_LE) ||
+      comp->Child(0)->Opcode() != air::core::OPC_LD ||
+      comp->Child(0)->Addr_datum_id() != loop->Iv_id() ||
+      comp->Child(1)->Opcode() != air::core::OPC_INTCONST) {
+    return false;
+  }
+  int64_t lb = init->Intconst();
+  int64_t ub = comp->Child(1)->Intconst();
+  return comp->Opcode() == air::core::OPC_LT ? lb < ub : lb <= ub;
+}
+
+void LICM::Handle_block(NODE_PTR blk) {
+  for (STMT_PTR stmt = blk->Begin_stmt(); stmt != blk->End_stmt();
+       stmt          = stmt->Next()) {
+    NODE_PTR node = stmt->Node();
+    if (node->Opcode() == air::core::OPC_DO_LOOP) {
+      Handle_loop(stmt);
+    } else if (node->Is_block()) {
+      Handle_block(node);
+    } else {
+      for (uint32_t i = 0; i < node->Num_child(); ++i) {
+        if (node->Child(i)->Is_block()) {
+          Handle_block(node->Child(i));
+        }
+      }
+    }
+  }
+}
+
+void LICM::Handle_loop(STMT_PTR loop) {
+  NODE_PTR node = loop->Node();
+  if (Run_once(node)) {
+    _def.clear();
+    _def.insert(Key(false, node->Iv_id().Value()));
+    Collect_def(node->Body_blk());
+    Hoist_block(node->Body_blk(), loop);
+  }
+  // expressions invariant in inner loops only
+  Handle_block(node->Body_blk());
+}
+
+void LICM::Collect_def(NODE_PTR node) {
+  if (node->Is_block()) {
+    for (STMT_PTR stmt = node->Begin_stmt(); stmt != node->End_stmt();
+         stmt          = stmt->Next()) {
+      Collect_def(stmt->Node());
+    }
+    return;
+  }
+  switch (node->Opcode()) {
+    case air::core::OPC_ST:
+    case air::core::OPC_STF:
+      _def.insert(Key(false, node->Addr_datum_id().Value()));
+      break;
+    case air::core::OPC_STP:
+    case air::core::OPC_STPF:
+      _def.insert(Key(true, node->Preg_id().Value()));
+      break;
+    case air::core::OPC_DO_LOOP:
+      _def.insert(Key(false, node->Iv_id().Value()));
+      break;
+    default:
+      if (node->Is_call() && !node->Ret_preg_id().Is_null()) {
+        _def.insert(Key(true, node->Ret_preg_id().Value()));
+      }
+      break;
+  }
+  for (uint32_t i = 0; i < node->Num_child(); ++i) {
+    if (node->Child(i)->Is_block()) {
+      Collect_def(node->Child(i));
+    }
+  }
+}
+
+void LICM::Hoist_block(NODE_PTR blk, STMT_PTR loop) {
+  for (STMT_PTR stmt = blk->Begin_stmt(); stmt != blk->End_stmt();
+       stmt          = stmt->Next()) {
+    NODE_PTR node = stmt->Node();
+    if (node->Opcode() == air::core::OPC_DO_LOOP) {
+      // body of inner loop is evaluated whenever the loop is entered
+      if (Run_once(node)) {
+        Hoist_block(node->Body_blk(), loop);
+      }
+    } else if (node->Is_block()) {
+      Hoist_block(node, loop);
+    } else if (node->Opcode() != air::core::OPC_IF) {
+      for (uint32_t i = 0; i < node->Num_child(); ++i) {
+        Hoist_expr(node, i, loop);
+      }
+    }
+  }
+}
+
+void LICM::Hoist_expr(NODE_PTR parent, uint32_t kid, STMT_PTR loop) {
+  NODE_PTR expr = parent->Child(kid);
+  if (expr->Is_block()) {
+    return;
+  }
+  if (!_policy->Is_worth_sharing(expr) || !Is_invariant(expr)) {
+    for (uint32_t i = 0; i < expr->Num_child(); ++i) {
+      Hoist_expr(expr, i, loop);
+    }
+    return;
+  }
+
+  // st tmp = expr right before the loop
+  std::string name = std::string(_policy->Tmp_prefix()) + "licm_" +
+                     std::to_string(_num_hoisted++);
+  ADDR_DATUM_PTR tmp =
+      _func->New_var(expr->Rtype(), name.c_str(), expr->Spos());
+  NODE_PTR ld = _cntr->New_ld(tmp, expr->Spos());
+  Copy_attr(ld, expr);
+  parent->Set_child(kid, ld);
+  STMT_PTR st = _cntr->New_st(expr, tmp, expr->Spos());
+  Copy_attr(st->Node(), expr);
+  STMT_LIST::Enclosing_list(loop).Prepend(loop, st);
+}
+
+bool LICM::Is_invariant(NODE_PTR expr) const {
+  if (expr->Opcode() == air::core::OPC_LD ||
+      expr->Opcode() == air::core::OPC_LDP) {
+    uint64_t key = expr->Is_preg_op()
+                       ? Key(true, expr->Preg_id().Value())
+                       : Key(false, expr->Addr_datum_id().Value());
+    return _exposed.Is_tracked(expr) && _def.find(key) == _def.end();
+  }
+  if (!_policy->Is_pure(expr)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < expr->Num_child(); ++i) {
+    if (!Is_invariant(expr->Child(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace opt
+
+}  // namespace air
@@ -0,0 +1,80 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "air/opt/opt_policy.h"
+
+using namespace air::base;
+
+namespace air {
+
+namespace opt {
+
+void EXPOSED_VAR::Collect(NODE_PTR node) {
+  if (node->Is_block()) {
+    for (STMT_PTR stmt = node->Begin_stmt(); stmt != node->End_stmt();
+         stmt          = stmt->Next()) {
+      Collect(stmt->Node());
+    }
+    return;
+  }
+
+  switch (node->Opcode()) {
+    case air::core::OPC_LDF:
+    case air::core::OPC_STF:
+    case air::core::OPC_LDA:
+    case air::core::OPC_LDPF:
+    case air::core::OPC_STPF:
+      Expose(node);
+      break;
+    case air::core::OPC_ST:
+      // formal may be passed by reference in generated code
+      if (node->Addr_datum()->Is_formal()) {
+        Expose(node);
+      }
+      break;
+    default:
+      break;
+  }
+  // call or non-CORE statement may update variable passed in place
+  if (node->Is_root() &&
+      (node->Is_call() || node->Domain() != air::core::CORE)) {
+    for (uint32_t i = 0; i < node->Num_child(); ++i) {
+      NODE_PTR kid = node->Child(i);
+      if (kid->Opcode() == air::core::OPC_LD ||
+          kid->Opcode() == air::core::OPC_LDP) {
+        Expose(kid);
+      }
+    }
+  }
+  for (uint32_t i = 0; i < node->Num_child(); ++i) {
+    Collect(node->Child(i));
+  }
+}
+
+bool EXPOSED_VAR::Is_tracked(NODE_PTR node) const {
+  if (node->Is_preg_op()) {
+    return _vars.find(Key(true, node->Preg_id().Value())) == _vars.end() &&
+           _policy->Is_value_type(node->Preg()->Type());
+  }
+  ADDR_DATUM_ID var = node->Addr_datum_id();
+  return var.Is_local() &&
+         _vars.find(Key(false, var.Value())) == _vars.end() &&
+         _policy->Is_value_type(node->Addr_datum()->Type());
+}
+
+void EXPOSED_VAR::Expose(NODE_PTR node) {
+  if (node->Is_preg_op()) {
+    _vars.insert(Key(true, node->Preg_id().Value()));
+  } else {
+    _vars.insert(Key(false, node->Addr_datum_id().Value()));
+  }
+}
+
+}  // namespace opt
+
+}  // namespace air
@@ -10,6 +10,8 @@
 
 #include "air/base/visitor.h"
 #include "air/core/handler.h"
+#include "air/opt/cfg.h"
+#include "ssa_complex_builder.h"
 #include "ssa_rename_ctx.h"
 #include "ssa_rename_handler.h"
 #include "ssa_simple_builder.h"
@@ -61,6 +63,45 @@ void SSA_BUILDER::Build_simple() {
   verify_ctx.Finalize(body->Id());
 }
 
+void SSA_BUILDER::Build_complex() {
+  Trace(TRACE_IR_BEFORE_SSA, "\nBefore SSA:\n");
+  Trace_obj(TRACE_IR_BEFORE_SSA, _cont);
+
+  // step 1: build SSA symtab by traversing IR, PHI is placed later with DF
+  SIMPLE_BUILDER_CTX build_ctx(_cont, false);
+  _cont->Set_state(SSA_CONTAINER::SYM_CREATE);
+  air::base::VISITOR<SIMPLE_BUILDER_CTX,
+                     air::core::HANDLER<SIMPLE_SYMTAB_HANDLER> >
+                      symtab_trav(build_ctx);
+  air::base::NODE_PTR body = _scope->Container().Entry_node();
+  symtab_trav.template Visit<void>(body);
+
+  // step 2: build CFG/DOM/DF
+  CFG cfg(_scope);
+  cfg.Build();
+  Trace(TRACE_CFG, "\nCFG:\n");
+  Trace_obj(TRACE_CFG, &cfg);
+
+  // step 3: insert PHI on iterated dominance frontier
+  COMPLEX_BUILDER builder(_cont, &cfg);
+  _cont->Set_state(SSA_CONTAINER::PHI_INSERT);
+  builder.Insert_phi();
+
+  Trace(TRACE_IR_AFTER_INSERT_PHI, "\nAfter phi insertion:\n");
+  Trace_obj(TRACE_IR_AFTER_INSERT_PHI, _cont);
+
+  // step 4: rename versions along dominator tree
+  _cont->Set_state(SSA_CONTAINER::RENAME);
+  builder.Rename();
+  _cont->Set_state(SSA_CONTAINER::SSA);
+
+  Trace(TRACE_IR_AFTER_SSA, "\nAfter renaming:\n");
+  Trace_obj(TRACE_IR_AFTER_SSA, _cont);
+
+  // step 5 (optional): verify SSA
+  builder.Verify();
+}
+
 }  // namespace opt
 
 }  // namespace air
@@ -0,0 +1,87 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "air/core/opcode.h"
+#include "air/driver/driver_ctx.h"
+#include "air/opt/dce.h"
+#include "air/opt/gvn.h"
+#include "air/opt/ssa_build.h"
+#include "air/opt/ssa_container.h"
+
+using namespace air::base;
+using namespace air::opt;
+
+int Test_gvn_dce() {
+  GLOB_SCOPE* glob = GLOB_SCOPE::Get();
+  SPOS        spos = glob->Unknown_simple_spos();
+
+  // foo(a, b)
+  STR_PTR  foo_str  = glob->New_str("foo");
+  FUNC_PTR foo_func = glob->New_func(foo_str, spos);
+  foo_func->Set_parent(glob->Comp_env_id());
+  SIGNATURE_TYPE_PTR foo_sig = glob->New_sig_type();
+  TYPE_PTR           sint32  = glob->Prim_type(PRIMITIVE_TYPE::INT_S32);
+  glob->New_ret_param(sint32, foo_sig);
+  STR_PTR a_str = glob->New_str("a");
+  glob->New_param(a_str, sint32, foo_sig, spos);
+  STR_PTR b_str = glob->New_str("b");
+  glob->New_param(b_str, sint32, foo_sig, spos);
+  foo_sig->Set_complete();
+  ENTRY_PTR foo_entry = glob->New_entry_point(foo_sig, foo_func, foo_str, spos);
+  FUNC_SCOPE*    foo_scope = &glob->New_func_scope(foo_func);
+  CONTAINER*     cntr      = &foo_scope->Container();
+  STMT_PTR       estmt     = cntr->New_func_entry(spos);
+  STMT_LIST      sl        = cntr->Stmt_list();
+  ADDR_DATUM_PTR a_var     = foo_scope->Formal(0);
+  ADDR_DATUM_PTR b_var     = foo_scope->Formal(1);
+  ADDR_DATUM_PTR x_var = foo_scope->New_var(sint32, glob->New_str("x"), spos);
+  ADDR_DATUM_PTR y_var = foo_scope->New_var(sint32, glob->New_str("y"), spos);
+  ADDR_DATUM_PTR z_var = foo_scope->New_var(sint32, glob->New_str("z"), spos);
+
+  // x = a + b
+  NODE_PTR add_x = cntr->New_bin_arith(air::core::OPC_ADD,
+                                       cntr->New_ld(a_var, spos),
+                                       cntr->New_ld(b_var, spos), spos);
+  sl.Append(cntr->New_st(add_x, x_var, spos));
+  // y = a + b, redundant
+  NODE_PTR add_y = cntr->New_bin_arith(air::core::OPC_ADD,
+                                       cntr->New_ld(a_var, spos),
+                                       cntr->New_ld(b_var, spos), spos);
+  sl.Append(cntr->New_st(add_y, y_var, spos));
+  // z = a * b, dead
+  NODE_PTR mul_z = cntr->New_bin_arith(air::core::OPC_MUL,
+                                       cntr->New_ld(a_var, spos),
+                                       cntr->New_ld(b_var, spos), spos);
+  sl.Append(cntr->New_st(mul_z, z_var, spos));
+  // return x + y
+  NODE_PTR ret = cntr->New_bin_arith(air::core::OPC_ADD,
+                                     cntr->New_ld(x_var, spos),
+                                     cntr->New_ld(y_var, spos), spos);
+  sl.Append(cntr->New_retv(ret, spos));
+
+  air::driver::DRIVER_CTX driver_ctx;
+  OPT_POLICY              policy;
+  SSA_CONTAINER           gvn_ssa(cntr);
+  SSA_BUILDER(foo_scope, &gvn_ssa, &driver_ctx).Perform();
+  GVN gvn(foo_scope, &gvn_ssa, &policy);
+  gvn.Perform();
+
+  SSA_CONTAINER dce_ssa(cntr);
+  SSA_BUILDER(foo_scope, &dce_ssa, &driver_ctx).Perform();
+  DCE dce(foo_scope, &dce_ssa, &policy);
+  dce.Perform();
+
+  // print IR for testing
+  foo_scope->Print();
+  return gvn.Num_redundant() == 1 && dce.Num_dead() == 1 ? 0 : 1;
+}
+
+int main() {
+  air::core::Register_core();
+  return Test_gvn_dce();
+}
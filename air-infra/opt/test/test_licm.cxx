@@ -0,0 +1,91 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "air/core/opcode.h"
+#include "air/opt/licm.h"
+
+using namespace air::base;
+using namespace air::opt;
+
+// multiply is expensive enough to be hoisted
+class MUL_POLICY : public OPT_POLICY {
+public:
+  bool Is_worth_sharing(NODE_PTR node) const {
+    return node->Opcode() == air::core::OPC_MUL;
+  }
+};
+
+int Test_licm() {
+  GLOB_SCOPE* glob = GLOB_SCOPE::Get();
+  SPOS        spos = glob->Unknown_simple_spos();
+
+  // foo(a, b)
+  STR_PTR  foo_str  = glob->New_str("foo");
+  FUNC_PTR foo_func = glob->New_func(foo_str, spos);
+  foo_func->Set_parent(glob->Comp_env_id());
+  SIGNATURE_TYPE_PTR foo_sig = glob->New_sig_type();
+  TYPE_PTR           sint32  = glob->Prim_type(PRIMITIVE_TYPE::INT_S32);
+  glob->New_ret_param(sint32, foo_sig);
+  STR_PTR a_str = glob->New_str("a");
+  glob->New_param(a_str, sint32, foo_sig, spos);
+  STR_PTR b_str = glob->New_str("b");
+  glob->New_param(b_str, sint32, foo_sig, spos);
+  foo_sig->Set_complete();
+  ENTRY_PTR foo_entry = glob->New_entry_point(foo_sig, foo_func, foo_str, spos);
+  FUNC_SCOPE*    foo_scope = &glob->New_func_scope(foo_func);
+  CONTAINER*     cntr      = &foo_scope->Container();
+  STMT_PTR       estmt     = cntr->New_func_entry(spos);
+  STMT_LIST      sl        = cntr->Stmt_list();
+  ADDR_DATUM_PTR a_var     = foo_scope->Formal(0);
+  ADDR_DATUM_PTR b_var     = foo_scope->Formal(1);
+  ADDR_DATUM_PTR i_var = foo_scope->New_var(sint32, glob->New_str("i"), spos);
+  ADDR_DATUM_PTR x_var = foo_scope->New_var(sint32, glob->New_str("x"), spos);
+
+  // x = 0
+  sl.Append(cntr->New_st(cntr->New_intconst(sint32, 0, spos), x_var, spos));
+  // for (i = 0; i < 4; ++i)
+  NODE_PTR comp = cntr->New_bin_arith(air::core::OPC_LT,
+                                      cntr->New_ld(i_var, spos),
+                                      cntr->New_intconst(sint32, 4, spos),
+                                      spos);
+  NODE_PTR incr = cntr->New_bin_arith(air::core::OPC_ADD,
+                                      cntr->New_ld(i_var, spos),
+                                      cntr->New_intconst(sint32, 1, spos),
+                                      spos);
+  NODE_PTR  body = cntr->New_stmt_block(spos);
+  STMT_LIST body_list(body);
+  //   x = x + a * b, a * b is invariant
+  NODE_PTR mul_a_b = cntr->New_bin_arith(air::core::OPC_MUL,
+                                         cntr->New_ld(a_var, spos),
+                                         cntr->New_ld(b_var, spos), spos);
+  NODE_PTR add_x   = cntr->New_bin_arith(
+      air::core::OPC_ADD, cntr->New_ld(x_var, spos), mul_a_b, spos);
+  body_list.Append(cntr->New_st(add_x, x_var, spos));
+  //   x = x * i, x and i are changed in loop
+  NODE_PTR mul_x_i = cntr->New_bin_arith(air::core::OPC_MUL,
+                                         cntr->New_ld(x_var, spos),
+                                         cntr->New_ld(i_var, spos), spos);
+  body_list.Append(cntr->New_st(mul_x_i, x_var, spos));
+  sl.Append(cntr->New_do_loop(i_var, cntr->New_intconst(sint32, 0, spos),
+                              comp, incr, body, spos));
+  // return x
+  sl.Append(cntr->New_retv(cntr->New_ld(x_var, spos), spos));
+
+  MUL_POLICY policy;
+  LICM       licm(foo_scope, &policy);
+  licm.Perform();
+
+  // print IR for testing
+  foo_scope->Print();
+  return licm.Num_hoisted() == 1 ? 0 : 1;
+}
+
+int main() {
+  air::core::Register_core();
+  return Test_licm();
+}
@@ -0,0 +1,112 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "air/core/opcode.h"
+#include "air/driver/driver_ctx.h"
+#include "air/opt/ssa_build.h"
+#include "air/opt/ssa_container.h"
+#include "air/opt/ssa_node_list.h"
+
+using namespace air::base;
+using namespace air::opt;
+
+static uint32_t Num_phi(SSA_CONTAINER* ssa_cntr, NODE_PTR node) {
+  uint32_t num = 0;
+  PHI_LIST list(ssa_cntr, ssa_cntr->Node_phi(node->Id()));
+  list.For_each([&num](PHI_NODE_PTR phi) { ++num; });
+  return num;
+}
+
+int Test_build_ssa_cfg() {
+  GLOB_SCOPE* glob = GLOB_SCOPE::Get();
+  SPOS        spos = glob->Unknown_simple_spos();
+
+  // foo(a, c)
+  STR_PTR  foo_str  = glob->New_str("foo");
+  FUNC_PTR foo_func = glob->New_func(foo_str, spos);
+  foo_func->Set_parent(glob->Comp_env_id());
+  SIGNATURE_TYPE_PTR foo_sig = glob->New_sig_type();
+  TYPE_PTR           sint32  = glob->Prim_type(PRIMITIVE_TYPE::INT_S32);
+  glob->New_ret_param(sint32, foo_sig);
+  STR_PTR a_str = glob->New_str("a");
+  glob->New_param(a_str, sint32, foo_sig, spos);
+  STR_PTR c_str = glob->New_str("c");
+  glob->New_param(c_str, sint32, foo_sig, spos);
+  foo_sig->Set_complete();
+  ENTRY_PTR foo_entry = glob->New_entry_point(foo_sig, foo_func, foo_str, spos);
+  FUNC_SCOPE*    foo_scope = &glob->New_func_scope(foo_func);
+  CONTAINER*     cntr      = &foo_scope->Container();
+  STMT_PTR       estmt     = cntr->New_func_entry(spos);
+  STMT_LIST      sl        = cntr->Stmt_list();
+  ADDR_DATUM_PTR a_var     = foo_scope->Formal(0);
+  ADDR_DATUM_PTR c_var     = foo_scope->Formal(1);
+  ADDR_DATUM_PTR i_var = foo_scope->New_var(sint32, glob->New_str("i"), spos);
+  ADDR_DATUM_PTR x_var = foo_scope->New_var(sint32, glob->New_str("x"), spos);
+
+  // x = 0
+  sl.Append(cntr->New_st(cntr->New_intconst(sint32, 0, spos), x_var, spos));
+  // for (i = 0; i < c; ++i)
+  NODE_PTR comp = cntr->New_bin_arith(
+      air::core::OPC_LT, cntr->New_ld(i_var, spos), cntr->New_ld(c_var, spos),
+      spos);
+  NODE_PTR one  = cntr->New_intconst(sint32, 1, spos);
+  NODE_PTR incr = cntr->New_bin_arith(air::core::OPC_ADD,
+                                      cntr->New_ld(i_var, spos), one, spos);
+  NODE_PTR  body = cntr->New_stmt_block(spos);
+  STMT_LIST body_list(body);
+  //   if (x < 10)
+  NODE_PTR if_cond = cntr->New_bin_arith(air::core::OPC_LT,
+                                         cntr->New_ld(x_var, spos),
+                                         cntr->New_intconst(sint32, 10, spos),
+                                         spos);
+  NODE_PTR then_blk = cntr->New_stmt_block(spos);
+  NODE_PTR else_blk = cntr->New_stmt_block(spos);
+  STMT_PTR if_stmt  = cntr->New_if_then_else(if_cond, then_blk, else_blk, spos);
+  //     { x = x + a }, in nested block
+  NODE_PTR  nest_blk = cntr->New_stmt_block(spos);
+  STMT_LIST nest_list(nest_blk);
+  NODE_PTR  add_x_a  = cntr->New_bin_arith(
+      air::core::OPC_ADD, cntr->New_ld(x_var, spos), cntr->New_ld(a_var, spos),
+      spos);
+  nest_list.Append(cntr->New_st(add_x_a, x_var, spos));
+  STMT_LIST(then_blk).Append(nest_blk->Stmt());
+  //   else { return x; x = 5 }
+  STMT_LIST else_list(else_blk);
+  else_list.Append(cntr->New_retv(cntr->New_ld(x_var, spos), spos));
+  else_list.Append(
+      cntr->New_st(cntr->New_intconst(sint32, 5, spos), x_var, spos));
+  body_list.Append(if_stmt);
+  STMT_PTR do_loop = cntr->New_do_loop(
+      i_var, cntr->New_intconst(sint32, 0, spos), comp, incr, body, spos);
+  sl.Append(do_loop);
+  // return x
+  sl.Append(cntr->New_retv(cntr->New_ld(x_var, spos), spos));
+
+  // print IR for testing
+  foo_scope->Print();
+
+  // Build SSA with CFG
+  air::driver::DRIVER_CTX driver_ctx;
+  SSA_CONTAINER           ssa_cntr(cntr);
+  SSA_BUILDER             bldr(foo_scope, &ssa_cntr, &driver_ctx);
+  bldr.Ssa_config().Set_build_cfg(true);
+  bldr.Perform();
+  ssa_cntr.Print(std::cout);
+
+  // x and i are merged on loop header. ELSE always returns so there is no
+  // merge after IF
+  return Num_phi(&ssa_cntr, do_loop->Node()) == 2 &&
+                 Num_phi(&ssa_cntr, if_stmt->Node()) == 0
+             ? 0
+             : 1;
+}
+
+int main() {
+  air::core::Register_core();
+  return Test_build_ssa_cfg();
+}
@@ -14,6 +14,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iostream>
@@ -25,13 +26,20 @@ namespace air {
 namespace util {
 
 FILE_MAP::FILE_MAP(const char* name, bool op)
-    : _file(name), _fd(0), _file_size(0), _map(0), _map_size(0), _op(op) {
+    : _file(name),
+      _fd(0),
+      _file_size(0),
+      _map(0),
+      _map_size(0),
+      _prot(0),
+      _flags(0),
+      _op(op) {
   if (op) {
     Open(O_RDWR | O_CREAT | O_TRUNC);
     Write(PROT_READ | PROT_WRITE, MAP_SHARED);
   } else {
     Open(O_RDONLY);
-    Read(PROT_READ, MAP_SHARED);
+    Read(PROT_READ, MAP_PRIVATE);
   }
 }
 
@@ -63,12 +71,7 @@ void FILE_MAP::Read(uint32_t prot, uint32_t flags) {
 
   Set_file_size(file_info.st_size);
 
-  // TODO: To be completed remap ops
-  if (file_info.st_size > MAPPED_SIZE) {
-    Set_map_size(MAPPED_SIZE);
-  } else {
-    Set_map_size(file_info.st_size);
-  }
+  Set_map_size(file_info.st_size);
 
   _map = (char*)mmap(NULL, Get_map_size(), prot, flags, Get_file_id(), 0);
   if (_map == MAP_FAILED) {
@@ -79,36 +82,54 @@ void FILE_MAP::Read(uint32_t prot, uint32_t flags) {
 }
 
 void FILE_MAP::Write(uint32_t prot, uint32_t flags) {
-  Set_map_size(MAPPED_SIZE);
-  lseek(_fd, Get_map_size() - 1, SEEK_END);
-  write(_fd, "", 1);
-
-  _map = (char*)mmap(NULL, Get_map_size(), prot, flags, _fd, 0);
+  // reserve address space only, the file is mapped into it by Expand as it
+  // grows, so that addresses being written stay valid
+  Set_map_size(MAPPED_MAX_SIZE);
+  _map = (char*)mmap(NULL, Get_map_size(), PROT_NONE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
   if (_map == MAP_FAILED) {
     close(_fd);
-    CMPLR_ASSERT(false, "Map elf file failed: %s", Get_file_name());
-    // TODO: to be completed err info
+    CMPLR_ASSERT(false, "Reserve map of elf file failed: %s", Get_file_name());
   }
+  _prot  = prot;
+  _flags = flags;
+  Expand(MAPPED_SIZE);
 }
 
-void FILE_MAP::Remap(uint32_t sz) {
-  // remap file
-  if (ftruncate(_fd, sz) == -1) {
-    std::cerr << "Failed to truncate file" << std::endl;
-    CMPLR_ASSERT(false, "Failed to truncate file");
-    munmap(_map, Get_map_size());
+void FILE_MAP::Expand(off_t sz) {
+  if (sz <= Get_file_size()) {
+    return;
+  }
+  CMPLR_ASSERT(sz <= Get_map_size(), "Elf file exceeds %jx bytes: %s",
+               (intmax_t)Get_map_size(), Get_file_name());
+  // double the file in units of MAPPED_SIZE to keep extensions few
+  off_t old_size = Get_file_size();
+  off_t new_size = (sz + MAPPED_SIZE - 1) / MAPPED_SIZE * MAPPED_SIZE;
+  new_size       = std::min(std::max(new_size, old_size * 2), Get_map_size());
+  if (ftruncate(_fd, new_size) == -1) {
+    close(_fd);
+    CMPLR_ASSERT(false, "Failed to extend elf file: %s", Get_file_name());
+  }
+  void* addr = mmap(_map + old_size, new_size - old_size, _prot,
+                    _flags | MAP_FIXED, _fd, old_size);
+  if (addr == MAP_FAILED) {
     close(_fd);
+    CMPLR_ASSERT(false, "Map elf file failed: %s", Get_file_name());
   }
+  Set_file_size(new_size);
+}
 
-  // remap file
-  void* new_data = mremap(_map, Get_map_size(), sz, MREMAP_MAYMOVE);
-  if (new_data == MAP_FAILED) {
-    CMPLR_ASSERT(false, "Failed to remap file");
+void FILE_MAP::Remap(uint32_t sz) {
+  // truncate file to real size, the reserved address space is kept until
+  // Unmap and nothing beyond sz is accessed any more
+  if (ftruncate(_fd, sz) == -1) {
     munmap(_map, Get_map_size());
     close(_fd);
+    CMPLR_ASSERT(false, "Failed to truncate file: %s", Get_file_name());
   }
-  _map = (char*)new_data;
+  Set_file_size(sz);
 }
+
 void FILE_MAP::Unmap() {
   // Don't forget to free the mmapped memory
   if (munmap(_map, Get_map_size()) == -1) {
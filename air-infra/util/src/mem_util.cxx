@@ -20,6 +20,29 @@ MEM_STATS MEM_POOL_MANAGER::Non_pool_stats;
 // Print memory consumption details
 void MEM_POOL_MANAGER::Print() {}  // MEM_POOL_MANAGER::Print
 
+bool Proc_mem_usage(uint64_t& rss_kb, uint64_t& peak_kb) {
+  rss_kb     = 0;
+  peak_kb    = 0;
+  FILE* file = fopen("/proc/self/status", "r");
+  if (file == nullptr) {
+    return false;
+  }
+  char line[128];
+  int  found = 0;
+  while (found < 2 && fgets(line, sizeof(line), file) != nullptr) {
+    unsigned long long val = 0;
+    if (sscanf(line, "VmRSS: %llu kB", &val) == 1) {
+      rss_kb = val;
+      ++found;
+    } else if (sscanf(line, "VmHWM: %llu kB", &val) == 1) {
+      peak_kb = val;
+      ++found;
+    }
+  }
+  fclose(file);
+  return found == 2;
+}
+
 }  // namespace util
 
 }  // namespace air
@@ -119,6 +119,44 @@ void OPTION_MGR::Print(ostream& os, uint32_t indent) {
 
 void OPTION_MGR::Print() { Print(cout, 1); }
 
+// write value of each option in handle
+static void Print_desc_value(ostream& os, const char* prefix,
+                             const OPTION_DESC_HANDLE* handle) {
+  for (uint32_t i = 0; i < handle->Size(); ++i) {
+    const OPTION_DESC* desc = handle->Option(i);
+    os << prefix << desc->Name() << "=";
+    switch (desc->Kind()) {
+      case K_NONE:
+      case K_BOOL:
+        os << *(bool*)desc->Option_var();
+        break;
+      case K_INT64:
+        os << *(int64_t*)desc->Option_var();
+        break;
+      case K_UINT64:
+        os << *(uint64_t*)desc->Option_var();
+        break;
+      case K_DOUBLE:
+        os << *(double*)desc->Option_var();
+        break;
+      case K_STR:
+        os << *(string*)desc->Option_var();
+        break;
+      default:
+        break;
+    }
+    os << endl;
+  }
+}
+
+void OPTION_MGR::Print_value(ostream& os, uint32_t num_grp) const {
+  AIR_ASSERT(num_grp <= _groups.size());
+  for (uint32_t i = 0; i < num_grp; ++i) {
+    string prefix = "-" + string(_groups[i]->Name()) + ":";
+    Print_desc_value(os, prefix.c_str(), _groups[i]->Options());
+  }
+}
+
 void OPTION_MGR::Top_level_option_rule_checker() {
   vector<OPTION_DESC_HANDLE*> option_descs = Top_level_option();
   unordered_set<string>       name_set;
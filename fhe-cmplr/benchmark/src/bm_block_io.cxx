@@ -0,0 +1,115 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#define PROFILE
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/block_io.h"
+
+namespace {
+
+constexpr uint64_t BLOCK_SIZE  = 256 * 1024;
+constexpr uint32_t BLOCK_COUNT = 256;
+constexpr uint32_t IN_FLIGHT   = 8;
+
+// read mode of benchmark
+enum MODE { SYNC, RING, RING_FIXED, RING_DIRECT, RING_DIRECT_FIXED };
+
+// data file of BLOCK_COUNT blocks in BM_BLOCK_IO_DIR, /tmp by default. Use
+// a directory on tmpfs or disk to compare the paths on it
+std::string Data_file() {
+  static std::string fname;
+  if (!fname.empty()) {
+    return fname;
+  }
+  const char* dir = getenv("BM_BLOCK_IO_DIR");
+  fname = std::string(dir != nullptr ? dir : "/tmp") + "/bm_block_io.bin";
+  int fd = open(fname.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
+  std::vector<char> buf(BLOCK_SIZE);
+  for (uint32_t i = 0; i < BLOCK_COUNT; ++i) {
+    memset(buf.data(), 'a' + i % 26, BLOCK_SIZE);
+    if (write(fd, buf.data(), BLOCK_SIZE) != (ssize_t)BLOCK_SIZE) {
+      break;
+    }
+  }
+  close(fd);
+  return fname;
+}
+
+//! Read all blocks of data file with IN_FLIGHT reads in flight, reported as
+//! bytes read per second
+void Bm_block_io(benchmark::State& state) {
+  MODE  mode      = (MODE)state.range(0);
+  bool  sync_read = (mode == SYNC);
+  bool  direct_io = (mode == RING_DIRECT || mode == RING_DIRECT_FIXED);
+  bool  fixed_buf = (mode == RING_FIXED || mode == RING_DIRECT_FIXED);
+  char* buf;
+  if (posix_memalign((void**)&buf, 4096, BLOCK_SIZE * IN_FLIGHT) != 0 ||
+      !Block_io_init(sync_read)) {
+    state.SkipWithError("failed to initialize block io");
+    return;
+  }
+  if (fixed_buf && !Block_io_register_buffer(buf, BLOCK_SIZE * IN_FLIGHT)) {
+    state.SkipWithError("failed to register buffer");
+  }
+  int fd = Block_io_open(Data_file().c_str(), sync_read, direct_io);
+  if (fd == -1) {
+    state.SkipWithError("failed to open data file");
+  }
+  BLOCK_INFO blk[IN_FLIGHT];
+  for (uint32_t i = 0; i < IN_FLIGHT; ++i) {
+    blk[i]._iovec.iov_base = buf + i * BLOCK_SIZE;
+    blk[i]._iovec.iov_len  = BLOCK_SIZE;
+  }
+  for (auto _ : state) {
+    if (fd == -1) {
+      break;
+    }
+    for (uint32_t i = 0; i < BLOCK_COUNT; i += IN_FLIGHT) {
+      for (uint32_t k = 0; k < IN_FLIGHT; ++k) {
+        blk[k]._blk_sts = BLK_INVALID;
+        if (sync_read) {
+          pread(fd, blk[k]._iovec.iov_base, BLOCK_SIZE, (i + k) * BLOCK_SIZE);
+        } else {
+          Block_io_prefetch(fd, (i + k) * BLOCK_SIZE, &blk[k]);
+        }
+      }
+      for (uint32_t k = 0; k < IN_FLIGHT && !sync_read; ++k) {
+        Block_io_read(fd, (i + k) * BLOCK_SIZE, &blk[k]);
+      }
+      benchmark::DoNotOptimize(buf[0]);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * BLOCK_SIZE * BLOCK_COUNT);
+  if (fd != -1) {
+    Block_io_close(fd);
+  }
+  Block_io_fini(sync_read);
+  free(buf);
+}
+
+}  // namespace
+
+BENCHMARK(Bm_block_io)
+    ->ArgName("mode")
+    ->Arg(SYNC)
+    ->Arg(RING)
+    ->Arg(RING_FIXED)
+    ->Arg(RING_DIRECT)
+    ->Arg(RING_DIRECT_FIXED)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
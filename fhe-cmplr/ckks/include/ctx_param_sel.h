@@ -0,0 +1,114 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef FHE_CKKS_CTX_PARAM_SEL_H
+#define FHE_CKKS_CTX_PARAM_SEL_H
+
+#include <ostream>
+#include <vector>
+
+#include "air/base/container.h"
+#include "air/base/st.h"
+#include "air/driver/driver_ctx.h"
+#include "air/util/error.h"
+#include "fhe/ckks/config.h"
+#include "fhe/core/lower_ctx.h"
+#include "fhe/core/scheme_info_config.h"
+
+namespace fhe {
+namespace ckks {
+using namespace air::base;
+
+//! @brief Kind of CKKS operation in latency model
+enum PARAM_OP_KIND : uint32_t {
+  POK_ADD,        //!< add/sub/neg of ciphertext and ciphertext or plaintext
+  POK_MUL_PLAIN,  //!< multiply ciphertext with plaintext or scalar
+  POK_MUL_CIPH,   //!< tensor product of two ciphertexts
+  POK_KSWITCH,    //!< relinearize or rotate, a key switch
+  POK_RESCALE,    //!< rescale
+  POK_ENCODE,     //!< encode plaintext at runtime
+  POK_BOOTSTRAP,  //!< bootstrap
+  POK_LAST,
+};
+
+//! @brief One legal CKKS parameter set and its estimated cost
+struct PARAM_CAND {
+  uint32_t _poly_deg;     //!< N
+  uint32_t _q0_bit_num;   //!< bit number of first prime
+  uint32_t _sf_bit_num;   //!< bit number of scaling factor
+  uint32_t _q_part_num;   //!< decomposition number of key switch
+  uint32_t _p_prime_num;  //!< number of P primes
+  uint32_t _mod_bit_num;  //!< bit number of P*Q
+  uint32_t _precision;    //!< estimated bits of precision
+  double   _latency;      //!< estimated latency in ms
+
+  void Print(std::ostream& os) const;
+};
+
+//! @brief Select N, bit number of q0 and scaling factor and q part number
+//! (dnum) with a latency model once CTX_PARAM_ANA has run on all functions.
+//! Legal parameter sets hold the messages, keep P*Q under the modulus table
+//! of the security level (128-bit if none is set) and meet CKKS:precision.
+//! Each set is scored by the operations counted in all functions, weighted
+//! by loop trip counts and costed with per-op formulas fitted to ut_ckks_perf
+//! at the average level. The mul level is fixed by the program, so is the
+//! bit number of q0 and scaling factor when the program bootstraps or the
+//! options set them.
+class CTX_PARAM_SEL {
+public:
+  using DRIVER_CTX = air::driver::DRIVER_CTX;
+  using CAND_VEC   = std::vector<PARAM_CAND>;
+
+  CTX_PARAM_SEL(core::LOWER_CTX* ctx, const DRIVER_CTX* driver_ctx,
+                const CKKS_CONFIG* config)
+      : _lower_ctx(ctx), _driver_ctx(driver_ctx), _config(config) {}
+
+  //! @brief Count operations of func_scope
+  void Count_ops(FUNC_SCOPE* func_scope);
+
+  //! @brief Record count executions of op kind
+  void Add_op(PARAM_OP_KIND kind, uint64_t count) { _op_cnt[kind] += count; }
+
+  //! @brief Estimated latency in ms of counted operations
+  double Latency(uint32_t poly_deg, uint32_t mul_level, uint32_t q_part_num,
+                 uint32_t p_prime_num) const;
+
+  //! @brief Enumerate legal candidates for param, the fastest one of each
+  //! (N, q part num) pair, and rank them fastest first
+  void Enumerate(const core::CTX_PARAM& param, core::SECURITY_LEVEL sec_lev,
+                 uint32_t precision);
+
+  //! @brief Select parameters and update CTX_PARAM in LOWER_CTX
+  R_CODE Run();
+
+  const CAND_VEC& Cands() const { return _cands; }
+  void            Print(std::ostream& os) const;
+
+  DECLARE_TRACE_DETAIL_API((*_config), _driver_ctx)
+
+private:
+  // REQUIRED UNDEFINED UNWANTED methods
+  CTX_PARAM_SEL(void);
+  CTX_PARAM_SEL(const CTX_PARAM_SEL&);
+  CTX_PARAM_SEL& operator=(const CTX_PARAM_SEL&);
+
+  static constexpr uint64_t DEFAULT_TRIP_CNT = 8;
+
+  void Count_ops(NODE_PTR node, uint64_t weight);
+
+  core::LOWER_CTX*   _lower_ctx;
+  const DRIVER_CTX*  _driver_ctx;
+  const CKKS_CONFIG* _config;
+  uint64_t           _op_cnt[POK_LAST] = {};  // weighted executions
+  CAND_VEC           _cands;                  // ranked candidates
+};
+
+}  // namespace ckks
+}  // namespace fhe
+
+#endif  // FHE_CKKS_CTX_PARAM_SEL_H
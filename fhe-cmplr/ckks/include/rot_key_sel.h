@@ -0,0 +1,143 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef FHE_CKKS_ROT_KEY_SEL_H
+#define FHE_CKKS_ROT_KEY_SEL_H
+
+#include <map>
+#include <ostream>
+#include <set>
+#include <vector>
+
+#include "air/base/container.h"
+#include "air/base/st.h"
+#include "air/driver/driver_ctx.h"
+#include "air/util/debug.h"
+#include "fhe/ckks/config.h"
+#include "fhe/core/lower_ctx.h"
+
+namespace fhe {
+namespace ckks {
+using namespace air::base;
+
+//! @brief Choose the rotation keys of a function under a key budget.
+//! A rotation whose key is dropped is rewritten as a chain of rotations by
+//! power-of-two digits, taken from its binary form or its non-adjacent form
+//! (NAF), whichever needs fewer new keys. Each extra digit costs one key
+//! switch per execution, each digit key is shared by all rewritten
+//! rotations. Rotations are rewritten cheapest first until the number of
+//! keys fits the budget. A digit must be less than the number of slots, as
+//! rotating by it is a full turn, so NAF reaching it is not taken.
+class ROT_KEY_PLAN {
+public:
+  using ROT_SET    = std::set<int32_t>;
+  using DIGITS     = std::vector<int32_t>;
+  using WEIGHT_MAP = std::map<int32_t, uint64_t>;
+  using DIGITS_MAP = std::map<int32_t, DIGITS>;
+
+  //! @brief Construct plan with budget of keys for ciphertexts with at least
+  //! slots slots, 0 if it's unknown
+  ROT_KEY_PLAN(uint64_t budget, uint32_t slots = 0)
+      : _budget(budget), _slots(slots) {}
+
+  //! @brief Return binary digits of rot from the least significant one
+  static DIGITS Binary(int32_t rot);
+
+  //! @brief Return NAF digits of rot from the least significant one
+  static DIGITS Naf(int32_t rot);
+
+  //! @brief Keep the key of rot, which can't be rewritten
+  void Add_pinned(int32_t rot) { _pinned.insert(rot); }
+
+  //! @brief Record a constant rotation by rot executed weight times
+  void Add_rotate(int32_t rot, uint64_t weight) { _weight[rot] += weight; }
+
+  //! @brief Select keys and rotations to rewrite
+  void Select();
+
+  bool Is_rewritten(int32_t rot) const {
+    return _rewritten.find(rot) != _rewritten.end();
+  }
+  //! @brief Return digits rewritten rotation rot is composed of
+  const DIGITS& Digits(int32_t rot) const {
+    DIGITS_MAP::const_iterator it = _rewritten.find(rot);
+    AIR_ASSERT(it != _rewritten.end());
+    return it->second;
+  }
+  bool              Fit_budget() const { return Num_key() <= _budget; }
+  const ROT_SET&    Keys() const { return _keys; }
+  const DIGITS_MAP& Rewritten() const { return _rewritten; }
+  uint64_t          Budget() const { return _budget; }
+  uint32_t          Num_key() const { return _keys.size(); }
+  uint32_t          Num_orig_key() const { return _num_orig_key; }
+  uint64_t          Extra_kswitch() const { return _extra_kswitch; }
+  void              Print(std::ostream& os) const;
+
+private:
+  bool In_slots(const DIGITS& digits) const;
+
+  uint64_t   _budget;             // max number of rotation keys
+  uint32_t   _slots;              // digits are less than it, 0 if unknown
+  ROT_SET    _pinned;             // keys can't be dropped
+  WEIGHT_MAP _weight;             // executions of constant rotations
+  ROT_SET    _keys;               // selected keys
+  DIGITS_MAP _rewritten;          // rotations rewritten to digits
+  uint32_t   _num_orig_key  = 0;  // number of keys without rewriting
+  uint64_t   _extra_kswitch = 0;  // weighted key switches added
+};
+
+//! @brief Rewrite constant rotations of a CKKS function so that the
+//! rotation keys collected later by CTX_PARAM_ANA fit CKKS:rot_key_budget.
+//! Rotations with a runtime index and keys already requested by other
+//! functions are kept. Executions of a rotation inside loops are weighted by
+//! LOOP_WEIGHT per nest level, as trip counts are unknown here.
+class ROT_KEY_SEL {
+public:
+  using DRIVER_CTX = air::driver::DRIVER_CTX;
+
+  ROT_KEY_SEL(FUNC_SCOPE* func_scope, core::LOWER_CTX* ctx,
+              const DRIVER_CTX* driver_ctx, const CKKS_CONFIG* config)
+      : _func_scope(func_scope),
+        _lower_ctx(ctx),
+        _driver_ctx(driver_ctx),
+        _config(config),
+        _plan(config->Rot_key_budget(),
+              ctx->Get_ctx_param().Get_poly_degree() / 2) {}
+
+  //! @brief Select rotation keys and rewrite rotations of dropped keys
+  void Run();
+
+  const ROT_KEY_PLAN& Plan() const { return _plan; }
+
+  DECLARE_TRACE_DETAIL_API((*_config), _driver_ctx)
+
+private:
+  // REQUIRED UNDEFINED UNWANTED methods
+  ROT_KEY_SEL(void);
+  ROT_KEY_SEL(const ROT_KEY_SEL&);
+  ROT_KEY_SEL& operator=(const ROT_KEY_SEL&);
+
+  static constexpr uint64_t LOOP_WEIGHT = 8;
+
+  bool Is_rotate(NODE_PTR node) const;
+  bool Is_const_rotate(NODE_PTR node) const;
+  void Collect(NODE_PTR node, uint64_t weight);
+  void     Rewrite(NODE_PTR node, STMT_PTR stmt);
+  NODE_PTR Rewrite_rotate(NODE_PTR rot_node, STMT_PTR stmt);
+
+  FUNC_SCOPE*        _func_scope;
+  core::LOWER_CTX*   _lower_ctx;
+  const DRIVER_CTX*  _driver_ctx;
+  const CKKS_CONFIG* _config;
+  ROT_KEY_PLAN       _plan;
+};
+
+}  // namespace ckks
+}  // namespace fhe
+
+#endif  // FHE_CKKS_ROT_KEY_SEL_H
@@ -401,8 +401,11 @@ public:
   template <typename RETV, typename VISITOR>
   RETV Handle_add(VISITOR* visitor, NODE_PTR add_node);
 
-  // template <typename RETV, typename VISITOR>
-  // RETV Handle_sub(VISITOR* visitor, NODE_PTR add_node);
+  //! scale of sub is managed the same way as add
+  template <typename RETV, typename VISITOR>
+  RETV Handle_sub(VISITOR* visitor, NODE_PTR sub_node) {
+    return Handle_add<RETV>(visitor, sub_node);
+  }
 
   template <typename RETV, typename VISITOR>
   RETV Handle_rotate(VISITOR* visitor, NODE_PTR rot_node);
@@ -16,6 +16,8 @@
 #include "fhe/ckks/sihe2ckks_lower.h"
 #include "fhe/core/ctx_param_ana.h"
 #include "fhe/sihe/sihe_handler.h"
+#include "ctx_param_sel.h"
+#include "rot_key_sel.h"
 #include "scale_manager.h"
 
 using namespace air::base;
@@ -42,9 +44,24 @@ GLOB_SCOPE* Ckks_driver(GLOB_SCOPE* glob, core::LOWER_CTX* lower_ctx,
     SCALE_MANAGER scale_mngr(ckks_func, lower_ctx);
     scale_mngr.Run();
 
+    if (config->Rot_key_budget() != 0) {
+      ROT_KEY_SEL rot_key_sel(ckks_func, lower_ctx, driver_ctx, config);
+      rot_key_sel.Run();
+    }
+
     core::CTX_PARAM_ANA ctx_param_ana(ckks_func, lower_ctx, driver_ctx, config);
     ctx_param_ana.Run();
   }
+
+  // select N, q0, sf and q_part_num with ops of all functions
+  if (config->Auto_param()) {
+    CTX_PARAM_SEL param_sel(lower_ctx, driver_ctx, config);
+    for (GLOB_SCOPE::FUNC_SCOPE_ITER it = new_glob->Begin_func_scope();
+         it != new_glob->End_func_scope(); ++it) {
+      param_sel.Count_ops(&(*it));
+    }
+    param_sel.Run();
+  }
   return new_glob;
 }  // Ckks_driver
 
@@ -26,6 +26,16 @@ static OPTION_DESC Ckks_option[] = {
                              &Ckks_config._sf,                                                                                             air::util::K_UINT64, 0, V_EQUAL},
     {"poly_degree",               "N",     "Poly degree",                 &Ckks_config._poly_deg,
                              air::util::K_UINT64,                                                                                                               0, V_EQUAL},
+    {"gvn",                       "gvn",   "Run GVN and DCE on CKKS IR",  &Ckks_config._gvn,
+                             air::util::K_NONE,                                                                                                                 0, V_NONE },
+    {"licm",                      "licm",  "Hoist loop invariant encode and FHE op out of loop",
+                             &Ckks_config._licm,                                                                                           air::util::K_NONE,   0, V_NONE },
+    {"rot_key_budget",            "rkb",   "Max number of rotation keys, 0 for no limit",
+                             &Ckks_config._rot_key_budget,                                                                                 air::util::K_UINT64, 0, V_EQUAL},
+    {"auto_param",                "ap",    "Select N, q0, sf and q part num with latency model",
+                             &Ckks_config._auto_param,                                                                                     air::util::K_NONE,   0, V_NONE },
+    {"precision",                 "prec",  "Bit number of precision required by auto_param",
+                             &Ckks_config._precision,                                                                                      air::util::K_UINT64, 0, V_EQUAL},
 };
 
 static OPTION_DESC_HANDLE Ckks_option_handle = {
@@ -48,6 +58,11 @@ void CKKS_CONFIG::Print(std::ostream& os) const {
   os << "  Bit number of scale factor:  " << Scale_factor_bit_num()
      << std::endl;
   os << "  Poly degree N:               " << Poly_deg() << std::endl;
+  os << "  Run GVN and DCE:             " << Gvn() << std::endl;
+  os << "  Run LICM:                    " << Licm() << std::endl;
+  os << "  Rotation key budget:         " << Rot_key_budget() << std::endl;
+  os << "  Auto select parameters:      " << Auto_param() << std::endl;
+  os << "  Bit number of precision:     " << Precision() << std::endl;
 }
 
 }  // namespace ckks
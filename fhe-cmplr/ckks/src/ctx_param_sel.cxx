@@ -0,0 +1,276 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "ctx_param_sel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+#include "air/core/opcode.h"
+#include "air/util/debug.h"
+#include "fhe/ckks/ckks_opcode.h"
+#include "fhe/core/scheme_info_ana.h"
+
+namespace fhe {
+namespace ckks {
+
+// Cost of each op in ns fitted to ut_ckks_perf (rtlib/ant) with l primes:
+// add and mul_plain scale with N*l, rescale and encode with N*log2(N)*l, and
+// key switch with N*log2(N)*(l + (dnum+2)*(l+K)) where K is number of P
+// primes. Bootstrap is about 48 key switches at the top level.
+static constexpr double ADD_NS       = 33.;
+static constexpr double MUL_PLAIN_NS = 72.;
+static constexpr double MUL_CIPH_NS  = 200.;
+static constexpr double RESCALE_NS   = 28.;
+static constexpr double ENCODE_NS    = 15.;
+static constexpr double KSWITCH_NS   = 17.5;
+static constexpr double BTS_KSWITCH  = 48.;
+
+// q0 keeps 3 more bits than scaling factor for the integral part
+static constexpr uint32_t Q0_HEADROOM     = 3;
+static constexpr uint32_t MAX_Q0_BIT_NUM  = 60;
+static constexpr uint32_t MIN_SF_BIT_NUM  = 20;
+static constexpr uint32_t MAX_NUM_OF_CAND = 8;
+
+// bits of scaling factor eaten by encoding and rescale noise, which grows
+// with sqrt(N)
+static uint32_t Noise_bit_num(uint32_t poly_deg_pow) {
+  return (poly_deg_pow + 1) / 2 + 4;
+}
+
+// trip count of do_loop with constant init, bound and stride, or dflt
+static uint64_t Trip_cnt(NODE_PTR loop, uint64_t dflt) {
+  NODE_PTR init = loop->Child(0);
+  NODE_PTR cmp  = loop->Child(1);
+  NODE_PTR incr = loop->Child(2);
+  auto     is_intconst = [](NODE_PTR node) {
+    return node->Domain() == air::core::CORE &&
+           node->Operator() == air::core::OPCODE::INTCONST;
+  };
+  if (!is_intconst(init) || cmp->Num_child() != 2 ||
+      !is_intconst(cmp->Child(1)) || incr->Domain() != air::core::CORE ||
+      incr->Operator() != air::core::OPCODE::ADD || incr->Num_child() != 2 ||
+      !is_intconst(incr->Child(1)) || incr->Child(1)->Intconst() <= 0) {
+    return dflt;
+  }
+  int64_t start  = init->Intconst();
+  int64_t bound  = cmp->Child(1)->Intconst();
+  int64_t stride = incr->Child(1)->Intconst();
+  if (cmp->Operator() == air::core::OPCODE::LE) {
+    bound += 1;
+  } else if (cmp->Operator() != air::core::OPCODE::LT) {
+    return dflt;
+  }
+  return bound <= start ? 0 : (bound - start + stride - 1) / stride;
+}
+
+void PARAM_CAND::Print(std::ostream& os) const {
+  os << "N=" << _poly_deg << " q0=" << _q0_bit_num << " sf=" << _sf_bit_num
+     << " q_part=" << _q_part_num << " P=" << _p_prime_num
+     << " modulus=" << _mod_bit_num << " precision=" << _precision
+     << " latency=" << std::fixed << std::setprecision(3) << _latency << "ms"
+     << std::defaultfloat;
+}
+
+void CTX_PARAM_SEL::Count_ops(NODE_PTR node, uint64_t weight) {
+  if (node->Is_block()) {
+    for (STMT_PTR stmt = node->Begin_stmt(); stmt != node->End_stmt();
+         stmt          = stmt->Next()) {
+      Count_ops(stmt->Node(), weight);
+    }
+    return;
+  }
+  if (node->Domain() == air::core::CORE &&
+      node->Operator() == air::core::OPCODE::DO_LOOP) {
+    weight *= Trip_cnt(node, DEFAULT_TRIP_CNT);
+  }
+  for (uint32_t i = 0; i < node->Num_child(); ++i) {
+    Count_ops(node->Child(i), weight);
+  }
+  if (node->Domain() != CKKS_DOMAIN::ID) return;
+
+  switch (node->Operator()) {
+    case CKKS_OPERATOR::ADD:
+    case CKKS_OPERATOR::SUB:
+    case CKKS_OPERATOR::NEG:
+      Add_op(POK_ADD, weight);
+      break;
+    case CKKS_OPERATOR::MUL:
+      Add_op(_lower_ctx->Is_cipher_type(node->Child(1)->Rtype_id())
+                 ? POK_MUL_CIPH
+                 : POK_MUL_PLAIN,
+             weight);
+      break;
+    case CKKS_OPERATOR::RELIN:
+    case CKKS_OPERATOR::ROTATE:
+      Add_op(POK_KSWITCH, weight);
+      break;
+    case CKKS_OPERATOR::RESCALE:
+      Add_op(POK_RESCALE, weight);
+      break;
+    case CKKS_OPERATOR::ENCODE:
+      Add_op(POK_ENCODE, weight);
+      break;
+    case CKKS_OPERATOR::BOOTSTRAP:
+      Add_op(POK_BOOTSTRAP, weight);
+      break;
+    default:
+      break;
+  }
+}
+
+void CTX_PARAM_SEL::Count_ops(FUNC_SCOPE* func_scope) {
+  Count_ops(func_scope->Container().Entry_node(), 1);
+}
+
+double CTX_PARAM_SEL::Latency(uint32_t poly_deg, uint32_t mul_level,
+                              uint32_t q_part_num, uint32_t p_prime_num) const {
+  // ops run at all levels, cost them at the average number of primes
+  double n       = poly_deg;
+  double log_n   = std::log2(n);
+  double top     = std::max(mul_level, 1U);
+  double avg     = (top + 1.) / 2.;
+  auto   kswitch = [&](double l) {
+    return KSWITCH_NS * n * log_n * (l + (q_part_num + 2.) * (l + p_prime_num));
+  };
+  double ns = _op_cnt[POK_ADD] * ADD_NS * n * avg +
+              _op_cnt[POK_MUL_PLAIN] * MUL_PLAIN_NS * n * avg +
+              _op_cnt[POK_MUL_CIPH] * MUL_CIPH_NS * n * avg +
+              _op_cnt[POK_RESCALE] * RESCALE_NS * n * log_n * avg +
+              _op_cnt[POK_ENCODE] * ENCODE_NS * n * log_n * avg +
+              _op_cnt[POK_KSWITCH] * kswitch(avg) +
+              _op_cnt[POK_BOOTSTRAP] * BTS_KSWITCH * kswitch(top);
+  return ns * 1e-6;
+}
+
+void CTX_PARAM_SEL::Enumerate(const core::CTX_PARAM& param,
+                              core::SECURITY_LEVEL sec_lev,
+                              uint32_t             precision) {
+  _cands.clear();
+  uint32_t mul_level = param.Get_mul_level();
+  if (mul_level == 0) return;
+
+  const core::MODULUS_INFO* mod_info = core::Modulus_info(sec_lev);
+  AIR_ASSERT(mod_info != nullptr);
+  uint32_t min_deg = param.Get_min_poly_degree() != 0
+                         ? param.Get_min_poly_degree()
+                         : param.Get_poly_degree();
+  uint32_t min_pow = std::max((uint32_t)std::ceil(std::log2(min_deg)),
+                              mod_info->Least_poly_deg_pow());
+  uint32_t max_pow = mod_info->Max_poly_deg_pow();
+  if (_config->Rot_key_budget() != 0 && param.Get_poly_degree() != 0) {
+    // ROT_KEY_SEL has decomposed rotations with NAF digits up to half of the
+    // current N, which must stay below the slot count
+    min_pow = std::max(min_pow,
+                       (uint32_t)std::ceil(std::log2(param.Get_poly_degree())));
+  }
+  if (_config->Poly_deg() != 0) {
+    // N set by option out of the table has no legal candidate
+    uint32_t pow = std::log2(_config->Poly_deg());
+    if (pow < min_pow || pow > max_pow) return;
+    min_pow = pow;
+    max_pow = pow;
+  }
+  // bootstrapping requires the bit number of q0 and sf set by CTX_PARAM
+  bool fix_sf = _op_cnt[POK_BOOTSTRAP] != 0 || _config->Q0_bit_num() != 0;
+
+  for (uint32_t pow = min_pow; pow <= max_pow; ++pow) {
+    uint32_t max_mod_bit_num = mod_info->Max_mod_bit_num(sec_lev, pow);
+    for (uint32_t q_part = 1; q_part <= mul_level; ++q_part) {
+      uint32_t   min_sf = fix_sf ? param.Get_scaling_factor_bit_num()
+                                 : std::max(MIN_SF_BIT_NUM,
+                                            precision + Noise_bit_num(pow));
+      uint32_t   max_sf = fix_sf ? param.Get_scaling_factor_bit_num()
+                                 : MAX_Q0_BIT_NUM - Q0_HEADROOM;
+      PARAM_CAND best;
+      bool       found = false;
+      for (uint32_t sf = min_sf; sf <= max_sf; ++sf) {
+        uint32_t q0 = fix_sf ? param.Get_first_prime_bit_num()
+                             : sf + Q0_HEADROOM;
+        uint32_t mod_bit_num =
+            core::CTX_PARAM::Modulus_bit_num(mul_level, q_part, q0, sf);
+        if (mod_bit_num > max_mod_bit_num) break;
+        PARAM_CAND cand;
+        cand._poly_deg    = 1U << pow;
+        cand._q0_bit_num  = q0;
+        cand._sf_bit_num  = sf;
+        cand._q_part_num  = q_part;
+        cand._p_prime_num =
+            core::CTX_PARAM::P_prime_num(mul_level, q_part, q0, sf);
+        cand._mod_bit_num = mod_bit_num;
+        cand._precision   = sf > Noise_bit_num(pow) ? sf - Noise_bit_num(pow)
+                                                    : 0;
+        cand._latency = Latency(cand._poly_deg, mul_level, q_part,
+                                cand._p_prime_num);
+        // a larger sf costing the same gains precision
+        if (!found || cand._latency <= best._latency) {
+          best  = cand;
+          found = true;
+        }
+      }
+      if (found) _cands.push_back(best);
+    }
+  }
+
+  std::stable_sort(_cands.begin(), _cands.end(),
+                   [](const PARAM_CAND& a, const PARAM_CAND& b) {
+                     if (a._latency != b._latency) {
+                       return a._latency < b._latency;
+                     }
+                     if (a._precision != b._precision) {
+                       return a._precision > b._precision;
+                     }
+                     return a._mod_bit_num < b._mod_bit_num;
+                   });
+}
+
+R_CODE CTX_PARAM_SEL::Run() {
+  core::CTX_PARAM&     param = _lower_ctx->Get_ctx_param();
+  core::SECURITY_LEVEL sec_lev =
+      (core::SECURITY_LEVEL)param.Get_security_level();
+  if (sec_lev == core::HE_STD_NOT_SET) {
+    sec_lev = core::HE_STD_128_CLASSIC;
+  }
+  Enumerate(param, sec_lev, _config->Precision());
+  Trace_obj(TRACE_PARAM_SEL, this);
+  // keep parameters of CTX_PARAM_ANA if none is legal
+  if (_cands.empty()) return R_CODE::NORMAL;
+
+  const PARAM_CAND& best = _cands.front();
+  param.Set_selected_param(best._poly_deg, best._q0_bit_num, best._sf_bit_num,
+                           best._q_part_num);
+  return R_CODE::NORMAL;
+}
+
+void CTX_PARAM_SEL::Print(std::ostream& os) const {
+  const core::CTX_PARAM& param = _lower_ctx->Get_ctx_param();
+  os << "CTX_PARAM_SEL: mul_level=" << param.Get_mul_level()
+     << " precision=" << _config->Precision() << " ops: add="
+     << _op_cnt[POK_ADD] << " mul_plain=" << _op_cnt[POK_MUL_PLAIN]
+     << " mul_ciph=" << _op_cnt[POK_MUL_CIPH]
+     << " kswitch=" << _op_cnt[POK_KSWITCH]
+     << " rescale=" << _op_cnt[POK_RESCALE]
+     << " encode=" << _op_cnt[POK_ENCODE]
+     << " bootstrap=" << _op_cnt[POK_BOOTSTRAP] << std::endl;
+  if (_cands.empty()) {
+    os << "  no legal parameters, keep N=" << param.Get_poly_degree()
+       << " q0=" << param.Get_first_prime_bit_num()
+       << " sf=" << param.Get_scaling_factor_bit_num()
+       << " q_part=" << param.Get_q_part_num() << std::endl;
+    return;
+  }
+  for (size_t i = 0; i < _cands.size() && i < MAX_NUM_OF_CAND; ++i) {
+    os << "  " << (i == 0 ? "* " : "  ") << i << ": ";
+    _cands[i].Print(os);
+    os << std::endl;
+  }
+}
+
+}  // namespace ckks
+}  // namespace fhe
@@ -10,6 +10,7 @@
 
 #include "fhe/ckks/ckks_gen.h"
 #include "fhe/driver/fhe_cmplr.h"
+#include "fhe/opt/opt_driver.h"
 
 namespace fhe {
 
@@ -33,6 +34,14 @@ R_CODE CKKS_PASS::Run() {
   air::base::GLOB_SCOPE* glob =
       Ckks_driver(Get_driver()->Glob_scope(), &Get_driver()->Lower_ctx(),
                   Get_driver()->Context(), &_config);
+  if (_config.Licm()) {
+    opt::Licm_driver(glob, &Get_driver()->Lower_ctx(), Get_driver()->Context(),
+                     _config, opt::OPT_LEVEL::CKKS);
+  }
+  if (_config.Gvn()) {
+    opt::Opt_driver(glob, &Get_driver()->Lower_ctx(), Get_driver()->Context(),
+                    _config, opt::OPT_LEVEL::CKKS);
+  }
   Get_driver()->Update_glob_scope(glob);
   return R_CODE::NORMAL;
 }
@@ -0,0 +1,312 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "rot_key_sel.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "air/core/opcode.h"
+#include "air/opt/opt_policy.h"
+#include "air/util/debug.h"
+#include "fhe/ckks/ckks_opcode.h"
+
+namespace fhe {
+namespace ckks {
+
+static const char* Rot_idx_key       = "nums";
+static const char* Prefix_of_rot_var = "_rot_tmp_";
+
+ROT_KEY_PLAN::DIGITS ROT_KEY_PLAN::Binary(int32_t rot) {
+  DIGITS  digits;
+  int64_t val  = rot < 0 ? -(int64_t)rot : rot;
+  int64_t sign = rot < 0 ? -1 : 1;
+  for (int64_t pow = 1; val != 0; val >>= 1, pow <<= 1) {
+    if ((val & 1) != 0) digits.push_back(sign * pow);
+  }
+  return digits;
+}
+
+ROT_KEY_PLAN::DIGITS ROT_KEY_PLAN::Naf(int32_t rot) {
+  DIGITS  digits;
+  int64_t val  = rot < 0 ? -(int64_t)rot : rot;
+  int64_t sign = rot < 0 ? -1 : 1;
+  for (int64_t pow = 1; val != 0; val >>= 1, pow <<= 1) {
+    if ((val & 1) == 0) continue;
+    // digit is 1 for val % 4 == 1 and -1 for val % 4 == 3
+    int64_t digit = 2 - (val & 3);
+    val -= digit;
+    digits.push_back(sign * digit * pow);
+  }
+  return digits;
+}
+
+bool ROT_KEY_PLAN::In_slots(const DIGITS& digits) const {
+  for (int32_t digit : digits) {
+    if (_slots != 0 && std::abs((int64_t)digit) >= _slots) return false;
+  }
+  return true;
+}
+
+// number of digits without a key in keys
+static size_t Num_new_key(const ROT_KEY_PLAN::DIGITS&  digits,
+                          const ROT_KEY_PLAN::ROT_SET& keys) {
+  size_t num = 0;
+  for (int32_t digit : digits) {
+    if (keys.find(digit) == keys.end()) ++num;
+  }
+  return num;
+}
+
+void ROT_KEY_PLAN::Select() {
+  ROT_SET orig(_pinned);
+  for (const auto& rot : _weight) {
+    orig.insert(rot.first);
+  }
+  _num_orig_key  = orig.size();
+  _keys          = orig;
+  _extra_kswitch = 0;
+  _rewritten.clear();
+  if (_budget == 0 || orig.size() <= _budget) return;
+
+  // candidates with least cost of extra key switches, cheapest first. NAF
+  // has fewest digits, binary form is taken if NAF reaches slots
+  std::vector<std::pair<uint64_t, int32_t>> cand;
+  for (const auto& rot : _weight) {
+    DIGITS digits = Naf(rot.first);
+    if (!In_slots(digits)) digits = Binary(rot.first);
+    if (!In_slots(digits)) continue;
+    size_t num_digit = digits.size();
+    if (num_digit <= 1 || _pinned.find(rot.first) != _pinned.end()) continue;
+    cand.push_back(std::make_pair(rot.second * (num_digit - 1), rot.first));
+  }
+  std::sort(cand.begin(), cand.end());
+
+  // rewrite the shortest prefix of candidates fitting the budget, otherwise
+  // the prefix with fewest keys
+  ROT_SET    cur(orig);
+  DIGITS_MAP decomp;
+  size_t     num_rewrite = 0;
+  for (size_t i = 0; i < cand.size() && _keys.size() > _budget; ++i) {
+    int32_t rot     = cand[i].second;
+    DIGITS  bin     = Binary(rot);
+    DIGITS  naf     = Naf(rot);
+    size_t  bin_new = Num_new_key(bin, cur);
+    size_t  naf_new = Num_new_key(naf, cur);
+    if (!In_slots(naf) || bin_new < naf_new ||
+        (bin_new == naf_new && bin.size() < naf.size())) {
+      decomp[rot] = bin;
+    } else {
+      decomp[rot] = naf;
+    }
+    cur.erase(rot);
+    cur.insert(decomp[rot].begin(), decomp[rot].end());
+    if (cur.size() < _keys.size()) {
+      _keys       = cur;
+      num_rewrite = i + 1;
+    }
+  }
+  for (size_t i = 0; i < num_rewrite; ++i) {
+    int32_t rot     = cand[i].second;
+    _rewritten[rot] = decomp[rot];
+    _extra_kswitch += _weight[rot] * (decomp[rot].size() - 1);
+  }
+}
+
+void ROT_KEY_PLAN::Print(std::ostream& os) const {
+  os << "ROT_KEY_SEL: budget=" << _budget << " keys=" << _num_orig_key << "->"
+     << Num_key() << " rewritten=" << _rewritten.size()
+     << " extra_kswitch=" << _extra_kswitch
+     << (Fit_budget() ? "" : " (budget not met)") << std::endl;
+  os << "  keys:";
+  for (int32_t rot : _keys) {
+    os << " " << rot;
+  }
+  os << std::endl;
+  for (const auto& rot : _rewritten) {
+    os << "  " << rot.first << " =";
+    for (int32_t digit : rot.second) {
+      os << " " << digit;
+    }
+    os << std::endl;
+  }
+}
+
+bool ROT_KEY_SEL::Is_rotate(NODE_PTR node) const {
+  return node->Domain() == CKKS_DOMAIN::ID &&
+         node->Operator() == CKKS_OPERATOR::ROTATE;
+}
+
+bool ROT_KEY_SEL::Is_const_rotate(NODE_PTR node) const {
+  if (!Is_rotate(node)) return false;
+  NODE_PTR idx = node->Child(1);
+  uint32_t cnt = 0;
+  node->Attr<int>(Rot_idx_key, &cnt);
+  return cnt == 1 && idx->Domain() == air::core::CORE &&
+         idx->Operator() == air::core::OPCODE::INTCONST;
+}
+
+void ROT_KEY_SEL::Collect(NODE_PTR node, uint64_t weight) {
+  if (node->Is_block()) {
+    for (STMT_PTR stmt = node->Begin_stmt(); stmt != node->End_stmt();
+         stmt          = stmt->Next()) {
+      Collect(stmt->Node(), weight);
+    }
+    return;
+  }
+  bool is_loop = node->Domain() == air::core::CORE &&
+                 node->Operator() == air::core::OPCODE::DO_LOOP;
+  for (uint32_t i = 0; i < node->Num_child(); ++i) {
+    Collect(node->Child(i), is_loop ? weight * LOOP_WEIGHT : weight);
+  }
+  if (!Is_rotate(node)) return;
+
+  uint32_t   cnt = 0;
+  const int* rot = node->Attr<int>(Rot_idx_key, &cnt);
+  AIR_ASSERT(rot != nullptr && cnt > 0);
+  if (Is_const_rotate(node)) {
+    _plan.Add_rotate(rot[0], weight);
+    return;
+  }
+  for (uint32_t i = 0; i < cnt; ++i) {
+    _plan.Add_pinned(rot[i]);
+  }
+}
+
+void ROT_KEY_SEL::Rewrite(NODE_PTR node, STMT_PTR stmt) {
+  if (node->Is_block()) {
+    for (STMT_PTR st = node->Begin_stmt(); st != node->End_stmt();
+         st          = st->Next()) {
+      Rewrite(st->Node(), st);
+    }
+    return;
+  }
+  for (uint32_t i = 0; i < node->Num_child(); ++i) {
+    NODE_PTR child = node->Child(i);
+    Rewrite(child, stmt);
+    if (Is_const_rotate(child) &&
+        _plan.Is_rewritten(child->Attr<int>(Rot_idx_key)[0])) {
+      node->Set_child(i, Rewrite_rotate(child, stmt));
+    }
+  }
+}
+
+template <typename T>
+static void Set_attr_as(NODE_PTR node, ATTR_PTR attr) {
+  node->Set_attr(attr->Key(), (const T*)attr->Value().data(), attr->Count());
+}
+
+// copy attributes of rotate src but the rotate index to rotate dst by value.
+// air::opt::Copy_attr shares the attribute list, where setting rotate index
+// of one digit would change all of them
+static void Copy_rotate_attr(NODE_PTR dst, NODE_PTR src) {
+  for (ATTR_ITER it = src->Begin_attr(); it != src->End_attr(); ++it) {
+    ATTR_PTR attr = *it;
+    if (strcmp(attr->Key(), Rot_idx_key) == 0) continue;
+    switch (attr->Type()) {
+      case PRIMITIVE_TYPE::INT_S8:
+        if (attr->Count() == 0) {
+          dst->Set_attr(attr->Key(), std::string(attr->Value()).c_str());
+        } else {
+          Set_attr_as<char>(dst, attr);
+        }
+        break;
+      case PRIMITIVE_TYPE::INT_S16:
+        Set_attr_as<int16_t>(dst, attr);
+        break;
+      case PRIMITIVE_TYPE::INT_S32:
+        Set_attr_as<int32_t>(dst, attr);
+        break;
+      case PRIMITIVE_TYPE::INT_S64:
+        Set_attr_as<int64_t>(dst, attr);
+        break;
+      case PRIMITIVE_TYPE::INT_U8:
+        Set_attr_as<unsigned char>(dst, attr);
+        break;
+      case PRIMITIVE_TYPE::INT_U16:
+        Set_attr_as<uint16_t>(dst, attr);
+        break;
+      case PRIMITIVE_TYPE::INT_U32:
+        Set_attr_as<uint32_t>(dst, attr);
+        break;
+      case PRIMITIVE_TYPE::INT_U64:
+        Set_attr_as<uint64_t>(dst, attr);
+        break;
+      case PRIMITIVE_TYPE::FLOAT_32:
+        Set_attr_as<float>(dst, attr);
+        break;
+      case PRIMITIVE_TYPE::FLOAT_64:
+        Set_attr_as<double>(dst, attr);
+        break;
+      default:
+        AIR_ASSERT_MSG(false, "unsupported attribute type");
+    }
+  }
+}
+
+// new rotate of opnd by digit with scale and level of rot_node
+static NODE_PTR New_digit_rotate(NODE_PTR rot_node, NODE_PTR opnd,
+                                 int32_t digit) {
+  CONTAINER* cntr = rot_node->Container();
+  SPOS       spos = rot_node->Spos();
+  NODE_PTR   rot =
+      cntr->New_cust_node(rot_node->Opcode(), rot_node->Rtype(), spos);
+  rot->Set_child(0, opnd);
+  rot->Set_child(
+      1, cntr->New_intconst(rot_node->Child(1)->Rtype(), digit, spos));
+  rot->Set_attr(Rot_idx_key, &digit, 1);
+  Copy_rotate_attr(rot, rot_node);
+  return rot;
+}
+
+// rotate nodes of digits are all new, as attribute list of rot_node may be
+// shared with other nodes and its rotate index can't be changed in place
+NODE_PTR ROT_KEY_SEL::Rewrite_rotate(NODE_PTR rot_node, STMT_PTR stmt) {
+  CONTAINER*                  cntr = &_func_scope->Container();
+  SPOS                        spos = rot_node->Spos();
+  const ROT_KEY_PLAN::DIGITS& digits =
+      _plan.Digits(rot_node->Attr<int>(Rot_idx_key)[0]);
+  AIR_ASSERT(digits.size() > 1);
+
+  // rotate by all digits but the last one into temporaries before stmt,
+  // and return rotate of the last temporary by the last digit
+  NODE_PTR  opnd = rot_node->Child(0);
+  STMT_LIST sl(stmt->Parent_node());
+  for (size_t i = 0; i + 1 < digits.size(); ++i) {
+    NODE_PTR rot = New_digit_rotate(rot_node, opnd, digits[i]);
+
+    std::string    tmp_name(Prefix_of_rot_var +
+                            std::to_string(rot_node->Id().Value()) + "_" +
+                            std::to_string(i));
+    ADDR_DATUM_PTR tmp_var =
+        _func_scope->New_var(rot_node->Rtype(), tmp_name.c_str(), spos);
+    sl.Prepend(stmt, cntr->New_st(rot, tmp_var, spos));
+    // load of temporary keeps scale and level of rot_node as well
+    opnd = cntr->New_ld(tmp_var, spos);
+    air::opt::Copy_attr(opnd, rot_node);
+  }
+  return New_digit_rotate(rot_node, opnd, digits.back());
+}
+
+void ROT_KEY_SEL::Run() {
+  // keys already requested by other functions are kept
+  for (int32_t rot : _lower_ctx->Get_ctx_param().Get_rotate_index()) {
+    _plan.Add_pinned(rot);
+  }
+  Collect(_func_scope->Container().Entry_node(), 1);
+  _plan.Select();
+  Trace_obj(TRACE_ROT_KEY_SEL, &_plan);
+  if (_plan.Rewritten().empty()) return;
+  Rewrite(_func_scope->Container().Entry_node(), STMT_PTR());
+}
+
+}  // namespace ckks
+}  // namespace fhe
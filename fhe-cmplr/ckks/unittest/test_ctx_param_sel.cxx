@@ -0,0 +1,106 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "ctx_param_sel.h"
+#include "fhe/core/scheme_info_ana.h"
+#include "gtest/gtest.h"
+
+using namespace fhe::ckks;
+using namespace fhe::core;
+
+class TEST_CTX_PARAM_SEL : public ::testing::Test {
+protected:
+  void SetUp() override {
+    CTX_PARAM& param = _lower_ctx.Get_ctx_param();
+    param.Set_mul_level(3, true);
+    param.Update_min_poly_degree(64);
+  }
+
+  void Check_legal(const CTX_PARAM_SEL& sel, uint32_t precision) {
+    const MODULUS_INFO* mod_info = Modulus_info(HE_STD_128_CLASSIC);
+    ASSERT_FALSE(sel.Cands().empty());
+    for (size_t i = 0; i < sel.Cands().size(); ++i) {
+      const PARAM_CAND& cand = sel.Cands()[i];
+      uint32_t          pow  = std::log2(cand._poly_deg);
+      EXPECT_LE(cand._mod_bit_num,
+                mod_info->Max_mod_bit_num(HE_STD_128_CLASSIC, pow));
+      EXPECT_EQ(cand._mod_bit_num,
+                CTX_PARAM::Modulus_bit_num(3, cand._q_part_num,
+                                           cand._q0_bit_num, cand._sf_bit_num));
+      EXPECT_GE(cand._precision, precision);
+      EXPECT_GT(cand._q0_bit_num, cand._sf_bit_num);
+      if (i > 0) EXPECT_LE(sel.Cands()[i - 1]._latency, cand._latency);
+    }
+  }
+
+  LOWER_CTX   _lower_ctx;
+  CKKS_CONFIG _config;
+};
+
+TEST_F(TEST_CTX_PARAM_SEL, rank) {
+  CTX_PARAM_SEL sel(&_lower_ctx, nullptr, &_config);
+  sel.Add_op(POK_ADD, 10);
+  sel.Add_op(POK_MUL_PLAIN, 10);
+  sel.Add_op(POK_KSWITCH, 10);
+  sel.Enumerate(_lower_ctx.Get_ctx_param(), HE_STD_128_CLASSIC, 20);
+  Check_legal(sel, 20);
+  // N=4096 can't hold 3 levels of 30-bit primes at 128-bit security
+  EXPECT_EQ(sel.Cands().front()._poly_deg, 8192);
+  EXPECT_LT(sel.Latency(8192, 3, 1, 2), sel.Latency(16384, 3, 1, 2));
+  EXPECT_LT(sel.Latency(8192, 3, 1, 2), sel.Latency(8192, 3, 1, 3));
+}
+
+TEST_F(TEST_CTX_PARAM_SEL, precision) {
+  CTX_PARAM_SEL sel(&_lower_ctx, nullptr, &_config);
+  sel.Add_op(POK_KSWITCH, 1);
+  sel.Enumerate(_lower_ctx.Get_ctx_param(), HE_STD_128_CLASSIC, 40);
+  Check_legal(sel, 40);
+  sel.Enumerate(_lower_ctx.Get_ctx_param(), HE_STD_128_CLASSIC, 60);
+  EXPECT_TRUE(sel.Cands().empty());
+}
+
+TEST_F(TEST_CTX_PARAM_SEL, fixed_by_option) {
+  _config._poly_deg = 16384;
+  _config._q0       = 40;
+  _config._sf       = 35;
+  CTX_PARAM& param  = _lower_ctx.Get_ctx_param();
+  param.Set_first_prime_bit_num(40);
+  param.Set_scaling_factor_bit_num(35);
+  CTX_PARAM_SEL sel(&_lower_ctx, nullptr, &_config);
+  sel.Add_op(POK_KSWITCH, 1);
+  sel.Enumerate(param, HE_STD_128_CLASSIC, 0);
+  Check_legal(sel, 0);
+  for (const PARAM_CAND& cand : sel.Cands()) {
+    EXPECT_EQ(cand._poly_deg, 16384);
+    EXPECT_EQ(cand._q0_bit_num, 40);
+    EXPECT_EQ(cand._sf_bit_num, 35);
+  }
+  // N below the security table
+  _config._poly_deg = 512;
+  sel.Enumerate(param, HE_STD_128_CLASSIC, 0);
+  EXPECT_TRUE(sel.Cands().empty());
+}
+
+TEST_F(TEST_CTX_PARAM_SEL, rot_key_budget) {
+  // N=16384 picked before ROT_KEY_SEL decomposed rotations into NAF digits up
+  // to 8192, a smaller N would leave digits out of its slots
+  CTX_PARAM& param = _lower_ctx.Get_ctx_param();
+  param.Set_poly_degree(16384);
+  _config._rot_key_budget = 4;
+  CTX_PARAM_SEL sel(&_lower_ctx, nullptr, &_config);
+  sel.Add_op(POK_KSWITCH, 10);
+  sel.Enumerate(param, HE_STD_128_CLASSIC, 20);
+  Check_legal(sel, 20);
+  for (const PARAM_CAND& cand : sel.Cands()) {
+    EXPECT_GE(cand._poly_deg, 16384);
+  }
+  // without the budget N=8192 is still the fastest
+  _config._rot_key_budget = 0;
+  sel.Enumerate(param, HE_STD_128_CLASSIC, 20);
+  EXPECT_EQ(sel.Cands().front()._poly_deg, 8192);
+}
@@ -0,0 +1,208 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "air/base/meta_info.h"
+#include "air/core/opcode.h"
+#include "air/driver/driver_ctx.h"
+#include "fhe/ckks/ckks_gen.h"
+#include "fhe/ckks/ckks_opcode.h"
+#include "fhe/sihe/sihe_gen.h"
+#include "gtest/gtest.h"
+#include "rot_key_sel.h"
+
+using namespace air::base;
+using namespace fhe::ckks;
+using namespace fhe::core;
+
+TEST(ROT_KEY_SEL, naf) {
+  EXPECT_EQ(ROT_KEY_PLAN::Naf(0), std::vector<int32_t>());
+  EXPECT_EQ(ROT_KEY_PLAN::Naf(8), std::vector<int32_t>({8}));
+  EXPECT_EQ(ROT_KEY_PLAN::Naf(7), std::vector<int32_t>({-1, 8}));
+  EXPECT_EQ(ROT_KEY_PLAN::Naf(-7), std::vector<int32_t>({1, -8}));
+  EXPECT_EQ(ROT_KEY_PLAN::Naf(11), std::vector<int32_t>({-1, -4, 16}));
+  EXPECT_EQ(ROT_KEY_PLAN::Binary(11), std::vector<int32_t>({1, 2, 8}));
+  EXPECT_EQ(ROT_KEY_PLAN::Binary(-6), std::vector<int32_t>({-2, -4}));
+  for (int32_t rot = -1000; rot <= 1000; ++rot) {
+    std::vector<int32_t> digits = ROT_KEY_PLAN::Naf(rot);
+    int32_t              sum    = 0;
+    for (size_t i = 0; i < digits.size(); ++i) {
+      sum += digits[i];
+      // no two adjacent digits are non-zero
+      if (i > 0) EXPECT_GE(std::abs(digits[i]), 4 * std::abs(digits[i - 1]));
+    }
+    EXPECT_EQ(sum, rot);
+  }
+}
+
+TEST(ROT_KEY_SEL, no_budget) {
+  ROT_KEY_PLAN plan(0);
+  plan.Add_rotate(3, 1);
+  plan.Add_rotate(5, 1);
+  plan.Add_rotate(7, 1);
+  plan.Select();
+  EXPECT_EQ(plan.Num_key(), 3);
+  EXPECT_TRUE(plan.Rewritten().empty());
+}
+
+TEST(ROT_KEY_SEL, rewrite_rare) {
+  // 1, 2, 4, 8 are digits of the others and can't be dropped
+  ROT_KEY_PLAN plan(6);
+  for (int32_t rot : {1, 2, 4, 8}) {
+    plan.Add_rotate(rot, 1);
+  }
+  plan.Add_rotate(3, 100);
+  plan.Add_rotate(6, 1);
+  plan.Add_rotate(12, 1);
+  plan.Add_rotate(9, 64);
+  plan.Select();
+  EXPECT_TRUE(plan.Fit_budget());
+  EXPECT_EQ(plan.Num_orig_key(), 8);
+  EXPECT_EQ(plan.Keys(), ROT_KEY_PLAN::ROT_SET({1, 2, 3, 4, 8, 9}));
+  // binary digits need no new key while NAF ones -2 and -4 do
+  EXPECT_EQ(plan.Rewritten().size(), 2);
+  EXPECT_EQ(plan.Digits(6), ROT_KEY_PLAN::DIGITS({2, 4}));
+  EXPECT_EQ(plan.Digits(12), ROT_KEY_PLAN::DIGITS({4, 8}));
+  EXPECT_EQ(plan.Extra_kswitch(), 2);
+}
+
+TEST(ROT_KEY_SEL, pinned) {
+  // dynamic rotations keep their keys even if the budget is not met
+  ROT_KEY_PLAN plan(2);
+  plan.Add_pinned(3);
+  plan.Add_pinned(5);
+  plan.Add_rotate(7, 1);
+  plan.Select();
+  EXPECT_FALSE(plan.Fit_budget());
+  EXPECT_TRUE(plan.Keys().count(3) && plan.Keys().count(5));
+  EXPECT_TRUE(plan.Rewritten().empty());
+}
+
+TEST(ROT_KEY_SEL, slots) {
+  // NAF of 7 is -1 + 8, rotating by 8 slots is a full turn
+  for (uint32_t slots : {0, 8}) {
+    ROT_KEY_PLAN plan(2, slots);
+    plan.Add_pinned(8);
+    plan.Add_rotate(-1, 1);
+    plan.Add_rotate(7, 1);
+    plan.Select();
+    if (slots == 0) {
+      EXPECT_EQ(plan.Digits(7), ROT_KEY_PLAN::DIGITS({-1, 8}));
+    } else {
+      EXPECT_TRUE(plan.Rewritten().empty());
+    }
+  }
+}
+
+class TEST_ROT_KEY_SEL : public ::testing::Test {
+protected:
+  void SetUp() override {
+    META_INFO::Remove_all();
+    air::core::Register_core();
+    fhe::ckks::Register_ckks_domain();
+    _glob = new GLOB_SCOPE(0, true);
+    _spos = _glob->Unknown_simple_spos();
+    fhe::sihe::SIHE_GEN(_glob, &_lower_ctx).Register_sihe_types();
+    CKKS_GEN(_glob, &_lower_ctx).Register_ckks_types();
+    _ciph_ty = _glob->Type(_lower_ctx.Get_cipher_type_id());
+
+    // void main(ciph_x)
+    STR_PTR  name = _glob->New_str("main");
+    FUNC_PTR func = _glob->New_func(name, _spos);
+    func->Set_parent(_glob->Comp_env_id());
+    SIGNATURE_TYPE_PTR sig = _glob->New_sig_type();
+    _glob->New_ret_param(_glob->Prim_type(PRIMITIVE_TYPE::VOID), sig);
+    _glob->New_param(_glob->New_str("ciph_x"), _ciph_ty, sig, _spos);
+    sig->Set_complete();
+    _glob->New_global_entry_point(sig, func, name, _spos);
+    _func = &_glob->New_func_scope(func);
+    _cntr = &_func->Container();
+    _cntr->New_func_entry(_spos);
+  }
+
+  void TearDown() override {
+    delete _glob;
+    META_INFO::Remove_all();
+  }
+
+  // z = rotate(x, rot) at scale 2 and level 3
+  NODE_PTR Gen_rotate(const char* z, int32_t rot) {
+    NODE_PTR rotate = _cntr->New_cust_node(OPC_ROTATE, _ciph_ty, _spos);
+    rotate->Set_child(0, _cntr->New_ld(_func->Formal(0), _spos));
+    rotate->Set_child(
+        1, _cntr->New_intconst(_glob->Prim_type(PRIMITIVE_TYPE::INT_S32), rot,
+                               _spos));
+    rotate->Set_attr("nums", &rot, 1);
+    uint32_t scale = 2;
+    uint32_t level = 3;
+    rotate->Set_attr(_lower_ctx.Attr_name(FHE_ATTR_KIND::SCALE), &scale, 1);
+    rotate->Set_attr(_lower_ctx.Attr_name(FHE_ATTR_KIND::LEVEL), &level, 1);
+    ADDR_DATUM_PTR var = _func->New_var(_ciph_ty, _glob->New_str(z), _spos);
+    _cntr->Stmt_list().Append(_cntr->New_st(rotate, var, _spos));
+    return rotate;
+  }
+
+  // check node has scale 2 and level 3
+  void Check_attr(NODE_PTR node) {
+    const uint32_t* scale =
+        node->Attr<uint32_t>(_lower_ctx.Attr_name(FHE_ATTR_KIND::SCALE));
+    const uint32_t* level =
+        node->Attr<uint32_t>(_lower_ctx.Attr_name(FHE_ATTR_KIND::LEVEL));
+    ASSERT_NE(scale, nullptr);
+    ASSERT_NE(level, nullptr);
+    EXPECT_EQ(*scale, 2);
+    EXPECT_EQ(*level, 3);
+  }
+
+  GLOB_SCOPE* _glob = nullptr;
+  FUNC_SCOPE* _func = nullptr;
+  CONTAINER*  _cntr = nullptr;
+  TYPE_PTR    _ciph_ty;
+  SPOS        _spos;
+  LOWER_CTX   _lower_ctx;
+};
+
+// rotate by 7 is rewritten to rotates by binary digits 1, 2 and 4, NAF -1 + 8
+// reaches 8 slots
+TEST_F(TEST_ROT_KEY_SEL, rewrite) {
+  _lower_ctx.Get_ctx_param().Set_poly_degree(16);
+  Gen_rotate("z7", 7);
+  Gen_rotate("z1", 1);
+  Gen_rotate("z2", 2);
+  Gen_rotate("z4", 4);
+
+  CKKS_CONFIG config;
+  config._rot_key_budget = 3;
+  air::driver::DRIVER_CTX driver_ctx;
+  ROT_KEY_SEL             sel(_func, &_lower_ctx, &driver_ctx, &config);
+  sel.Run();
+  EXPECT_EQ(sel.Plan().Keys(), ROT_KEY_PLAN::ROT_SET({1, 2, 4}));
+
+  // t0 = rotate(x, 1); t1 = rotate(t0, 2); z7 = rotate(t1, 4), rotates and
+  // loads of temporaries keep scale and level
+  STMT_LIST     sl    = _cntr->Stmt_list();
+  STMT_PTR      stmt  = sl.Begin_stmt();
+  ADDR_DATUM_ID datum = _func->Formal(0)->Id();
+  for (int32_t digit : {1, 2, 4}) {
+    ASSERT_NE(stmt, sl.End_stmt());
+    NODE_PTR rot = stmt->Node()->Child(0);
+    ASSERT_EQ(rot->Opcode(), OPC_ROTATE);
+    EXPECT_EQ(rot->Child(1)->Intconst(), digit);
+    uint32_t   cnt  = 0;
+    const int* nums = rot->Attr<int>("nums", &cnt);
+    ASSERT_EQ(cnt, 1);
+    EXPECT_EQ(nums[0], digit);
+    Check_attr(rot);
+    ASSERT_EQ(rot->Child(0)->Opcode(), air::core::OPC_LD);
+    EXPECT_EQ(rot->Child(0)->Addr_datum_id(), datum);
+    if (digit != 1) {
+      Check_attr(rot->Child(0));
+    }
+    datum = stmt->Node()->Addr_datum_id();
+    stmt  = stmt->Next();
+  }
+}
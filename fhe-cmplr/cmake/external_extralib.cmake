@@ -30,4 +30,7 @@ if (M_LIBRARY)
   set (MATH_LIBS ${MATH_LIBS} ${M_LIBRARY})
 else ()
   message (FATAL_ERROR "libm need to be installed")
-endif ()
\ No newline at end of file
+endif ()
+# rtlib encodes plaintext on worker threads
+find_package (Threads REQUIRED)
+set (MATH_LIBS ${MATH_LIBS} Threads::Threads)
@@ -174,6 +174,8 @@ void CTX_PARAM_ANA::Build_ssa() {
   air::opt::SSA_BUILDER ssa_builder(Func_scope(), &Ssa_cntr(), Driver_ctx());
   // update SSA_CONFIG
   air::opt::SSA_CONFIG& ssa_config = ssa_builder.Ssa_config();
+  // CFG based SSA handles early return and nested statement blocks
+  ssa_config.Set_build_cfg(true);
   ssa_config.Set_trace_ir_before_ssa(
       Config()->Is_trace(ckks::TRACE_DETAIL::TRACE_IR_BEFORE_SSA));
   ssa_config.Set_trace_ir_after_insert_phi(
@@ -22,6 +22,7 @@ void RT_DATA_DUMPER::Dump_hdr(const DATA_FILE_HDR& hdr) {
   _os << "  Align:    " << (uint32_t)hdr._ent_align << std::endl;
   _os << "  Count:    " << hdr._ent_count << std::endl;
   _os << "  LUT ofst: " << hdr._lut_ofst << std::endl;
+  _os << "  Schedule: " << hdr._sched_count << std::endl;
   //_os << "  Created:  " << hdr._ctime << std::endl;
   _os << "  Model:    " << hdr._model << std::endl;
   _os << "  UUID:     " << hdr._uuid << std::endl;
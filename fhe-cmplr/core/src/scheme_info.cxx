@@ -125,23 +125,35 @@ uint32_t CTX_PARAM::Mul_depth_of_bootstrap() {
   }
 }
 
-uint32_t CTX_PARAM::Get_p_prime_num() const {
-  uint32_t num_per_part = std::ceil(1. * Get_mul_level() / Get_q_part_num());
-  uint32_t bit_num      = Get_first_prime_bit_num() +
-                     (num_per_part - 1) * Get_scaling_factor_bit_num();
-  uint32_t p_prime_num = std::ceil(1. * bit_num / BIT_NUM_OF_P_PRIME);
+uint32_t CTX_PARAM::P_prime_num(uint32_t mul_level, uint32_t q_part_num,
+                                uint32_t q0_bit_num, uint32_t sf_bit_num) {
+  uint32_t num_per_part = std::ceil(1. * mul_level / q_part_num);
+  uint32_t bit_num      = q0_bit_num + (num_per_part - 1) * sf_bit_num;
+  uint32_t p_prime_num  = std::ceil(1. * bit_num / BIT_NUM_OF_P_PRIME);
   return p_prime_num;
 }
 
-uint32_t CTX_PARAM::Get_modulus_bit_num() const {
-  uint32_t mod_bit_num = Get_first_prime_bit_num();
-  if (Get_mul_level() > 1) {
-    mod_bit_num += (Get_mul_level() - 1) * Get_scaling_factor_bit_num();
+uint32_t CTX_PARAM::Modulus_bit_num(uint32_t mul_level, uint32_t q_part_num,
+                                    uint32_t q0_bit_num, uint32_t sf_bit_num) {
+  uint32_t mod_bit_num = q0_bit_num;
+  if (mul_level > 1) {
+    mod_bit_num += (mul_level - 1) * sf_bit_num;
   }
-  mod_bit_num += Get_p_prime_num() * BIT_NUM_OF_P_PRIME;
-
+  mod_bit_num += P_prime_num(mul_level, q_part_num, q0_bit_num, sf_bit_num) *
+                 BIT_NUM_OF_P_PRIME;
   return mod_bit_num;
 }
 
+uint32_t CTX_PARAM::Get_p_prime_num() const {
+  return P_prime_num(Get_mul_level(), Get_q_part_num(),
+                     Get_first_prime_bit_num(), Get_scaling_factor_bit_num());
+}
+
+uint32_t CTX_PARAM::Get_modulus_bit_num() const {
+  return Modulus_bit_num(Get_mul_level(), Get_q_part_num(),
+                         Get_first_prime_bit_num(),
+                         Get_scaling_factor_bit_num());
+}
+
 }  // namespace core
 }  // namespace fhe
\ No newline at end of file
@@ -26,7 +26,8 @@ static const TENSOR_OP_INFO Mul_level_of_nn_op[nn::core::OPCODE::SUB + 1] = {
     TENSOR_OP_INFO(nn::core::OPC_FLATTEN, 1),
     TENSOR_OP_INFO(nn::core::OPC_GEMM, 1),
     TENSOR_OP_INFO(nn::core::OPC_GLOBAL_AVERAGE_POOL, 1),
-    TENSOR_OP_INFO(nn::core::OPC_MAX_POOL, 1),
+    // max_pool: relu rounds are counted in Handle_max_pool
+    TENSOR_OP_INFO(nn::core::OPC_MAX_POOL, 0),
     TENSOR_OP_INFO(nn::core::OPC_MUL, 1),
     TENSOR_OP_INFO(nn::core::OPC_RELU, 9),
     TENSOR_OP_INFO(nn::core::OPC_RESHAPE, 0),
@@ -49,7 +50,7 @@ const MODULUS_INFO Mod_info[] = {
     {HE_STD_256_CLASSIC, 10, {14, 29, 58, 118, 237, 476, 956}  },
 };
 
-static inline const MODULUS_INFO* Modulus_info(SECURITY_LEVEL sec_lev) {
+const MODULUS_INFO* Modulus_info(SECURITY_LEVEL sec_lev) {
   const MODULUS_INFO* mod_info = nullptr;
   switch (sec_lev) {
     case HE_STD_NOT_SET:
@@ -107,6 +108,7 @@ void SCHEME_INFO_ANA::Update_scheme_info_with_ana_res() {
   uint32_t       msg_len_bit_num = std::ceil(log2(msg_len));
   uint64_t       poly_deg        = (2ULL << msg_len_bit_num);
   SECURITY_LEVEL sec_level       = Config()->Security_level();
+  Ctx_param().Update_min_poly_degree(poly_deg);
   if (sec_level == HE_STD_NOT_SET) {
     Ctx_param().Set_poly_degree(poly_deg);
     return;
@@ -21,6 +21,8 @@ enum TRACE_DETAIL {
   TRACE_IR_BEFORE_SSA           = 2,
   TRACE_IR_AFTER_SSA_INSERT_PHI = 3,
   TRACE_IR_AFTER_SSA            = 4,
+  TRACE_ROT_KEY_SEL             = 5,
+  TRACE_PARAM_SEL               = 6,
 };
 
 struct CKKS_CONFIG : public air::util::COMMON_CONFIG {
@@ -35,11 +37,21 @@ public:
   uint32_t Q0_bit_num() const { return _q0; }
   uint32_t Scale_factor_bit_num() const { return _sf; }
   uint32_t Poly_deg() const { return _poly_deg; }
+  bool     Gvn() const { return _gvn; }
+  bool     Licm() const { return _licm; }
+  uint64_t Rot_key_budget() const { return _rot_key_budget; }
+  bool     Auto_param() const { return _auto_param; }
+  uint64_t Precision() const { return _precision; }
   // leave this member public so that OPTION_DESC can access it
   uint64_t _secret_key_hamming_weight = 0;
   uint32_t _q0                        = 0;
   uint32_t _sf                        = 0;
   uint32_t _poly_deg                  = 0;
+  bool     _gvn                       = false;
+  bool     _licm                      = false;
+  uint64_t _rot_key_budget            = 0;
+  bool     _auto_param                = false;
+  uint64_t _precision                 = 20;
 };
 
 //! @brief Macro to define API to access CKKS config
@@ -48,6 +60,11 @@ public:
   uint64_t Q0_bit_num() const { return cfg.Q0_bit_num(); }                     \
   uint64_t Scale_factor_bit_num() const { return cfg.Scale_factor_bit_num(); } \
   uint64_t Poly_deg() const { return cfg.Poly_deg(); }                         \
+  bool     Gvn() const { return cfg.Gvn(); }                                   \
+  bool     Licm() const { return cfg.Licm(); }                                 \
+  uint64_t Rot_key_budget() const { return cfg.Rot_key_budget(); }             \
+  bool     Auto_param() const { return cfg.Auto_param(); }                     \
+  uint64_t Precision() const { return cfg.Precision(); }                       \
   DECLARE_COMMON_CONFIG_ACCESS_API(cfg)
 
 }  // namespace ckks
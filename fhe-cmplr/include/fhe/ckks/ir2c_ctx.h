@@ -9,6 +9,11 @@
 #ifndef FHE_CKKS_IR2C_CTX_H
 #define FHE_CKKS_IR2C_CTX_H
 
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <vector>
+
 #include "air/base/container_decl.h"
 #include "air/base/st_decl.h"
 #include "air/util/debug.h"
@@ -49,6 +54,10 @@ public:
   //! @brief Destruct ir2c ctx object
   ~IR2C_CTX() {
     if (_rt_data_writer != nullptr) {
+      std::vector<uint32_t> seq;
+      std::vector<uint64_t> iter;
+      Expand_pt_site(0, _pt_site.size(), iter, seq);
+      _rt_data_writer->Set_schedule(seq);
       delete _rt_data_writer;
       Finalize_encode_context();
     }
@@ -91,8 +100,9 @@ public:
           _os << " = *(PLAIN)Pt_get(";
         }
         _os << idx << " /* " << name << " */";
+        Record_pt_get(visitor, idx, {});
       } else {
-        uint64_t idx = _rt_data_writer->Append(name, data, count);
+        uint64_t idx = Append_msg(cst, 0, count, 1);
         // Pt_from_msg_validate(&dest, cst, index, len, scale, level)
         // Pt_from_msg(&dest, index, len, scale, level)
         if (Rt_validate()) {
@@ -105,6 +115,7 @@ public:
           Emit_st_var<RETV, VISITOR>(visitor, dest);
         }
         _os << ", " << idx << " /* " << name << " */";
+        Record_pt_get(visitor, idx, {});
       }
     } else if (_rt_data_writer != nullptr &&
                node->Child(0)->Opcode() == nn::vector::OPC_SLICE &&
@@ -164,25 +175,26 @@ public:
             }
             visitor->template Visit<RETV>(start);
             _os << " + " << idx << " /* " << name << " */";
+            Record_pt_get(visitor, idx, subscript);
           }
-        } else {
-          uint64_t idx = _rt_data_writer->Append(name, data + i * span, count);
-          if (i == 0) {
-            // Pt_from_msg(&dest, index, len, scale, level)
-            // Pt_from_msg_validate(&dest, cst, index, len, scale, level)
-            if (Rt_validate()) {
-              _os << "Pt_from_msg_validate(&";
-              Emit_st_var<RETV, VISITOR>(visitor, dest);
-              _os << ", ";
-              visitor->template Visit<RETV>(node->Child(0));  // buffer address
-            } else {
-              _os << "Pt_from_msg(&";
-              Emit_st_var<RETV, VISITOR>(visitor, dest);
-            }
+        } else if (i == 0) {
+          // all loop_cnt entries are appended once
+          uint64_t idx = Append_msg(cst, span, count, loop_cnt);
+          // Pt_from_msg(&dest, index, len, scale, level)
+          // Pt_from_msg_validate(&dest, cst, index, len, scale, level)
+          if (Rt_validate()) {
+            _os << "Pt_from_msg_validate(&";
+            Emit_st_var<RETV, VISITOR>(visitor, dest);
             _os << ", ";
-            visitor->template Visit<RETV>(start);
-            _os << " + " << idx << " /* " << name << " */";
+            visitor->template Visit<RETV>(node->Child(0));  // buffer address
+          } else {
+            _os << "Pt_from_msg(&";
+            Emit_st_var<RETV, VISITOR>(visitor, dest);
           }
+          _os << ", ";
+          visitor->template Visit<RETV>(start);
+          _os << " + " << idx << " /* " << name << " */";
+          Record_pt_get(visitor, idx, subscript);
         }
       }
     } else {
@@ -200,7 +212,12 @@ public:
       AIR_ASSERT(domain_type->Is_prim());
       switch (domain_type->Cast_to_prim()->Encoding()) {
         case air::base::PRIMITIVE_TYPE::FLOAT_32:
-          _os << "Encode_plain_from_float(&";
+          // constant data is never changed, encoded plaintext can be reused
+          if (Pt_cache() && Is_const_data(cst)) {
+            _os << "Encode_plain_from_float_cached(&";
+          } else {
+            _os << "Encode_plain_from_float(&";
+          }
           break;
         case air::base::PRIMITIVE_TYPE::FLOAT_64:
           _os << "Encode_plain_from_double(&";
@@ -255,6 +272,14 @@ public:
     return true;
   }
 
+  // Check if node is a constant array or a slice of it
+  static bool Is_const_data(air::base::NODE_PTR node) {
+    if (node->Opcode() == nn::vector::OPC_SLICE) {
+      node = node->Child(0);
+    }
+    return node->Opcode() == air::core::OPC_LDC;
+  }
+
   // Parse compound expression with add/mul to get subscript info
   bool Parse_subscript_expr(
       air::base::NODE_PTR                        node,
@@ -277,9 +302,133 @@ public:
     return false;
   }
 
-  fhe::core::RT_DATA_WRITER* _rt_data_writer;
-  std::string                _data_file_uuid;
-  fhe::core::DATA_ENTRY_TYPE _data_entry_type;
+  // append msg [i * span, i * span + count) of cst for i in [0, num) to data
+  // file, return index of the first entry. Constants are interned, so the
+  // same entries encoded at several places are written only once
+  uint64_t Append_msg(air::base::CONSTANT_PTR cst, uint64_t span,
+                      uint64_t count, uint64_t num) {
+    MSG_KEY key(cst->Id().Value(), span, count, num);
+    auto    it = _msg_idx.find(key);
+    if (it != _msg_idx.end()) {
+      return it->second;
+    }
+    const float* data  = (const float*)cst->Array_buffer();
+    uint64_t     first = 0;
+    for (uint64_t i = 0; i < num; ++i) {
+      char name[32];
+      if (span == 0) {
+        snprintf(name, 32, "cst_%d", cst->Id().Value());
+      } else {
+        snprintf(name, 32, "cst_%d_%d", cst->Id().Value(), (int)i);
+      }
+      uint64_t idx = _rt_data_writer->Append(name, data + i * span, count);
+      if (i == 0) {
+        first = idx;
+      }
+    }
+    _msg_idx[key] = first;
+    return first;
+  }
+
+  // record a Pt_get or Pt_from_msg of entry idx plus the linearized
+  // subscript of slice loops with enclosing loops, from which the order of
+  // entries requested at runtime is expanded for Pt_mgr to prefetch, evict
+  // or encode entries ahead
+  template <typename VISITOR>
+  void Record_pt_get(
+      VISITOR* visitor, uint64_t idx,
+      const std::vector<std::pair<int64_t, int64_t> >& subscript) {
+    PT_SITE site;
+    site._idx = idx;
+    for (size_t i = 1; visitor->Parent(i) != air::base::Null_ptr; ++i) {
+      air::base::NODE_PTR loop = visitor->Parent(i);
+      if (loop->Opcode() != air::core::OPC_DO_LOOP) {
+        continue;
+      }
+      // trip count of loop with unknown bounds is taken as 1
+      int64_t  lb, ub, stride;
+      uint64_t trip = 1;
+      if (Parse_do_loop(loop, lb, ub, stride) && stride > 0) {
+        trip = (ub > lb) ? (ub - lb + stride - 1) / stride : 0;
+      }
+      // slice loops have lb 0 and stride 1, subscript[k] is (iv, ub of k)
+      int64_t coef = 0;
+      int64_t mul  = 1;
+      for (size_t k = 0; k < subscript.size(); ++k) {
+        if (subscript[k].first == loop->Iv_id().Value()) {
+          coef = mul;
+          break;
+        }
+        mul *= subscript[k].second;
+      }
+      site._loop.push_back(
+          {loop->Container(), loop->Id().Value(), trip, (uint64_t)coef});
+    }
+    std::reverse(site._loop.begin(), site._loop.end());
+    _pt_site.push_back(site);
+  }
+
+  // expand sites [begin, end) sharing loops at level lower than iter.size()
+  // into entry indices in execution order. Sites in same loop are adjacent
+  // because they are recorded in the order of the loop body
+  void Expand_pt_site(size_t begin, size_t end, std::vector<uint64_t>& iter,
+                      std::vector<uint32_t>& seq) {
+    size_t depth = iter.size();
+    size_t i     = begin;
+    while (i < end && seq.size() < MAX_PT_SCHED) {
+      const PT_SITE& site = _pt_site[i];
+      if (site._loop.size() == depth) {
+        uint64_t idx = site._idx;
+        for (size_t k = 0; k < depth; ++k) {
+          idx += iter[k] * site._loop[k]._coef;
+        }
+        seq.push_back(idx);
+        ++i;
+        continue;
+      }
+      const PT_LOOP& loop = site._loop[depth];
+      size_t         j    = i + 1;
+      while (j < end && _pt_site[j]._loop.size() > depth &&
+             _pt_site[j]._loop[depth]._cntr == loop._cntr &&
+             _pt_site[j]._loop[depth]._id == loop._id) {
+        ++j;
+      }
+      iter.push_back(0);
+      for (uint64_t it = 0; it < loop._trip && seq.size() < MAX_PT_SCHED;
+           ++it) {
+        iter.back() = it;
+        Expand_pt_site(i, j, iter, seq);
+      }
+      iter.pop_back();
+      i = j;
+    }
+  }
+
+  // loop enclosing a Pt_get, coef is the stride of entry index on iterations
+  struct PT_LOOP {
+    const void* _cntr;
+    uint32_t    _id;
+    uint64_t    _trip;
+    uint64_t    _coef;
+  };
+
+  // Pt_get of entry _idx in enclosing loops, outermost loop first
+  struct PT_SITE {
+    uint64_t             _idx;
+    std::vector<PT_LOOP> _loop;
+  };
+
+  // schedule longer than this is truncated, Pt_mgr falls back to demand read
+  static constexpr size_t MAX_PT_SCHED = 1 << 22;
+
+  // constant id, span, count and number of msg entries in data file
+  typedef std::tuple<uint32_t, uint64_t, uint64_t, uint64_t> MSG_KEY;
+
+  fhe::core::RT_DATA_WRITER*  _rt_data_writer;
+  std::string                 _data_file_uuid;
+  fhe::core::DATA_ENTRY_TYPE  _data_entry_type;
+  std::map<MSG_KEY, uint64_t> _msg_idx;
+  std::vector<PT_SITE>        _pt_site;
 };  // IR2C_CTX
 
 }  // namespace ckks
@@ -43,6 +43,23 @@ public:
     ctx << ")";
   }
 
+  //! @brief Handle CKKS SUB operator
+  template <typename RETV, typename VISITOR>
+  void Handle_sub(VISITOR* visitor, air::base::NODE_PTR node) {
+    fhe::ckks::IR2C_CTX& ctx = visitor->Context();
+    AIR_ASSERT(ctx.Is_cipher_type(node->Child(0)->Rtype_id()));
+    AIR_ASSERT(ctx.Is_cipher_type(node->Child(1)->Rtype_id()));
+    air::base::NODE_PTR parent = ctx.Parent(1);
+    AIR_ASSERT(parent != air::base::Null_ptr && parent->Is_st());
+    ctx << "Sub_ciph(&";
+    ctx.template Emit_st_var<RETV, VISITOR>(visitor, parent);
+    ctx << ", ";
+    visitor->template Visit<RETV>(node->Child(0));
+    ctx << ", ";
+    visitor->template Visit<RETV>(node->Child(1));
+    ctx << ")";
+  }
+
   //! @brief Handle CKKS MUL operator
   template <typename RETV, typename VISITOR>
   void Handle_mul(VISITOR* visitor, air::base::NODE_PTR node) {
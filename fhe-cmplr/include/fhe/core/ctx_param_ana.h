@@ -543,6 +543,10 @@ public:
   template <typename RETV, typename VISITOR>
   RETV Handle_add(VISITOR* visitor, NODE_PTR add_node);
   template <typename RETV, typename VISITOR>
+  RETV Handle_sub(VISITOR* visitor, NODE_PTR sub_node) {
+    return Handle_add<RETV>(visitor, sub_node);
+  }
+  template <typename RETV, typename VISITOR>
   RETV Handle_rotate(VISITOR* visitor, NODE_PTR rot_node);
   template <typename RETV, typename VISITOR>
   RETV Handle_relin(VISITOR* visitor, NODE_PTR relin_node);
@@ -15,6 +15,7 @@
 #include <functional>
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 #include "air/base/container.h"
 #include "air/base/st.h"
@@ -182,6 +183,23 @@ public:
 
   const char* Attr_name(FHE_ATTR_KIND attr) const;
 
+  //! record slot layout of a batch packed into one ciphertext: image n of
+  //! input/output is at slot n*block. dim[0] of input/output shape is batch
+  void Set_batch_layout(int64_t block, const std::vector<int64_t>& input_shape,
+                        const std::vector<int64_t>& output_shape) {
+    _batch_block        = block;
+    _batch_input_shape  = input_shape;
+    _batch_output_shape = output_shape;
+  }
+  bool    Is_batch_packed() const { return _batch_block > 0; }
+  int64_t Get_batch_block() const { return _batch_block; }
+  const std::vector<int64_t>& Get_batch_input_shape() const {
+    return _batch_input_shape;
+  }
+  const std::vector<int64_t>& Get_batch_output_shape() const {
+    return _batch_output_shape;
+  }
+
 private:
   // REQUIRED UNDEFINED UNWANTED methods
   LOWER_CTX(const LOWER_CTX&);
@@ -191,6 +209,9 @@ private:
   TYPE_ID   _fhe_type[FHE_TYPE_KIND::END];  // type id gen in fhe
   FHE_FUNC_INFO
   _fhe_func_info[FHE_FUNC::FHE_FUNC_END];  // info of func gen in fhe
+  int64_t              _batch_block = 0;     // slot distance of packed images
+  std::vector<int64_t> _batch_input_shape;   // shape of packed input
+  std::vector<int64_t> _batch_output_shape;  // shape of packed output
 };
 
 //! @brief Context for FHE lowering phases
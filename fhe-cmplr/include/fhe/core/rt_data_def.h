@@ -25,6 +25,9 @@
 //!   | LUT entry      |   |
 //!   |    ent_ofst    +---/
 //!   | LUT entry      |
+//!   +----------------+<------ sched_ofst
+//!   | SCHED entry    |
+//!   | SCHED entry    |
 //!   +----------------+
 
 #include <stdint.h>
@@ -88,16 +91,18 @@ static inline const char* Data_entry_name(DATA_ENTRY_TYPE type) {
 
 //! @brief external data file header. For both compiler and rt
 struct DATA_FILE_HDR {
-  char            _magic[8];   //!< "!ANTFHE\0"
-  uint32_t        _rt_ver;     //!< Runtime version: major.minor.patch.build
-  uint16_t        _flag;       //!< reserved flags
-  uint8_t         _ent_type;   //!< message or plaintext
-  uint8_t         _ent_align;  //!< entry alignment, 2^(_entry_align)
-  uint64_t        _ent_count;  //!< entry count
-  uint64_t        _lut_ofst;   //!< lookup table offset in the file
-  struct timespec _ctime;      //!< creation time
-  char            _model[48];  //!< uuid to match model and executable file
-  char            _uuid[40];   //!< uuid to match model and executable file
+  char            _magic[8];     //!< "!ANTFHE\0"
+  uint32_t        _rt_ver;       //!< Runtime version: major.minor.patch.build
+  uint16_t        _flag;         //!< reserved flags
+  uint8_t         _ent_type;     //!< message or plaintext
+  uint8_t         _ent_align;    //!< entry alignment, 2^(_entry_align)
+  uint64_t        _ent_count;    //!< entry count
+  uint64_t        _lut_ofst;     //!< lookup table offset in the file
+  struct timespec _ctime;        //!< creation time
+  char            _model[48];    //!< uuid to match model and executable file
+  char            _uuid[40];     //!< uuid to match model and executable file
+  uint64_t        _sched_ofst;   //!< access schedule offset in the file
+  uint64_t        _sched_count;  //!< access schedule entry count
 };
 
 //! @brief lookup table entry in external data file. For both compiler and rt
@@ -108,6 +113,16 @@ struct DATA_LUT_ENTRY {
   uint64_t _ent_ofst;  //!< offset of the data in file
 };
 
+//! @brief next use of a plaintext not requested any more
+#define DATA_SCHED_NONE 0xFFFFFFFF
+
+//! @brief access schedule entry in external data file. Entries are in the
+//! order plaintexts are requested by generated code. For both compiler and rt
+struct DATA_SCHED_ENTRY {
+  uint32_t _index;     //!< index of the plaintext requested
+  uint32_t _next_use;  //!< position of next request to the same plaintext
+};
+
 #ifdef __cplusplus
 }  // namespace core
 }  // namespace fhe
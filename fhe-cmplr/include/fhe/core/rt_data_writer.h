@@ -46,11 +46,14 @@ public:
     memcpy(_hdr._magic, DATA_FILE_MAGIC, sizeof(_hdr._magic));
     _hdr._rt_ver    = RT_VERSION_FULL;
     _hdr._flag      = 0;
-    _hdr._ent_count = _lut.size();
-    _hdr._lut_ofst  = _os.tellp();
+    _hdr._ent_count   = _lut.size();
+    _hdr._lut_ofst    = _os.tellp();
+    _hdr._sched_ofst  = _hdr._lut_ofst + _lut.size() * sizeof(DATA_LUT_ENTRY);
+    _hdr._sched_count = _sched.size();
     timespec_get(&_hdr._ctime, TIME_UTC);
     if (_os) {
       _os.write((char*)_lut.data(), _lut.size() * sizeof(DATA_LUT_ENTRY));
+      _os.write((char*)_sched.data(), _sched.size() * sizeof(DATA_SCHED_ENTRY));
       _os.seekp(0);
       _os.write((char*)&_hdr, sizeof(_hdr));
       _os.flush();
@@ -75,6 +78,22 @@ public:
 
   uint64_t Cur_idx() const { return _lut.size(); }
 
+  //! @brief Set access schedule with indices of entries in the order they are
+  //! requested at runtime. Next use of each request is filled for runtime to
+  //! keep entries used soon in memory
+  void Set_schedule(const std::vector<uint32_t>& seq) {
+    AIR_ASSERT(seq.size() < DATA_SCHED_NONE);
+    std::vector<uint32_t> next(_lut.size(), DATA_SCHED_NONE);
+    _sched.resize(seq.size());
+    for (uint32_t i = seq.size(); i > 0; --i) {
+      uint32_t idx = seq[i - 1];
+      AIR_ASSERT(idx < _lut.size());
+      _sched[i - 1]._index    = idx;
+      _sched[i - 1]._next_use = next[idx];
+      next[idx]               = i - 1;
+    }
+  }
+
 private:
   uint64_t Write_data(const char* name, const char* data, uint32_t size) {
     uint64_t idx  = _lut.size();
@@ -105,6 +124,7 @@ private:
   std::ofstream                   _os;
   DATA_FILE_HDR                   _hdr;
   std::vector<CXX_DATA_LUT_ENTRY> _lut;
+  std::vector<DATA_SCHED_ENTRY>   _sched;
 
 };  // RT_DATA_WRITER
 
@@ -45,6 +45,10 @@ void Free_plain_buffer(struct PLAINTEXT_BUFFER* buf);
 //! @brief get pointer to PLAINTEXT from pt buffer
 void* Cast_buffer_to_plain(struct PLAINTEXT_BUFFER* buf);
 
+//! @brief initialize PLAINTEXT with copy of the one in pt buffer, which is
+//! the same as encoding the message into PLAINTEXT directly
+void Copy_plain_from_buffer(void* plain, struct PLAINTEXT_BUFFER* buf);
+
 //! @brief compare two PLAINTEXT BUFFER
 bool Compare_plain_buffer(const struct PLAINTEXT_BUFFER* pb_x,
                           const struct PLAINTEXT_BUFFER* pb_y);
@@ -9,6 +9,7 @@
 #ifndef FHE_CORE_SCHEME_INFO_H
 #define FHE_CORE_SCHEME_INFO_H
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <set>
@@ -50,6 +51,23 @@ public:
 
   uint32_t Get_poly_degree() const { return _poly_degree; }
 
+  //! record min poly degree to hold the messages, poly degree may grow over
+  //! it for security
+  void Update_min_poly_degree(uint32_t deg) {
+    _min_poly_degree = std::max(_min_poly_degree, deg);
+  }
+  uint32_t Get_min_poly_degree() const { return _min_poly_degree; }
+
+  //! set parameters chosen by CTX_PARAM_SEL, poly_deg may be less than the
+  //! current one unless rotations are decomposed by ROT_KEY_SEL
+  void Set_selected_param(uint32_t poly_deg, uint32_t q0_bit_num,
+                          uint32_t sf_bit_num, uint32_t q_part_num) {
+    _poly_degree            = poly_deg;
+    _first_prime_bit_num    = q0_bit_num;
+    _scaling_factor_bit_num = sf_bit_num;
+    _q_part_num             = q_part_num;
+  }
+
   /**
    * @brief calculate min poly degree for a message.
    * poly degree is double of ceil power2 of msg_len.
@@ -87,6 +105,12 @@ public:
     return _scaling_factor_bit_num;
   }
   uint32_t Get_p_prime_num() const;
+  //! return number of P primes for given parameters
+  static uint32_t P_prime_num(uint32_t mul_level, uint32_t q_part_num,
+                              uint32_t q0_bit_num, uint32_t sf_bit_num);
+  //! return bit number of P*Q for given parameters
+  static uint32_t Modulus_bit_num(uint32_t mul_level, uint32_t q_part_num,
+                                  uint32_t q0_bit_num, uint32_t sf_bit_num);
   void     Set_q_part_num(uint32_t num) { _q_part_num = num; }
   uint32_t Get_q_part_num() const { return _q_part_num; }
   void     Set_hamming_weight(uint32_t hw) { _hamming_weight = hw; }
@@ -107,6 +131,7 @@ private:
   CTX_PARAM& operator=(const CTX_PARAM&);
 
   uint32_t          _poly_degree            = 4;
+  uint32_t          _min_poly_degree        = 0;
   uint32_t          _security_level         = 0;
   uint32_t          _mul_level              = 0;
   uint32_t          _first_prime_bit_num    = 33;
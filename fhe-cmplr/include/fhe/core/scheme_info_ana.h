@@ -9,6 +9,8 @@
 #ifndef FHE_CORE_SCHEME_INFO_ANA_H
 #define FHE_CORE_SCHEME_INFO_ANA_H
 
+#include <cmath>
+
 #include "air/base/analyze_ctx.h"
 #include "air/base/container_decl.h"
 #include "air/base/visitor.h"
@@ -88,6 +90,9 @@ public:
   }
 
   uint32_t Least_poly_deg_pow() const { return _least_poly_deg_pow; }
+  uint32_t Max_poly_deg_pow() const {
+    return _least_poly_deg_pow + _mod_bit_num.size() - 1;
+  }
 
 private:
   // REQUIRED UNDEFINED UNWANTED methods
@@ -100,6 +105,9 @@ private:
   std::vector<uint32_t> _mod_bit_num;
 };
 
+//! return modulus info at security level sec_lev
+const MODULUS_INFO* Modulus_info(SECURITY_LEVEL sec_lev);
+
 //! Context of SCHEME_INFO_ANA visitor.
 class SCHEME_INFO_ANA_CTX : public air::base::ANALYZE_CTX {
 public:
@@ -423,11 +431,25 @@ RETV TENSOR_ANA_HANDLER::Handle_max_pool(VISITOR*            visitor,
   // 1. update msg length of current function
   visitor->Context().Update_msg_len(Msg_len(max_pool));
 
-  // 2. cal and return mul_level of max_pool result
+  // 2. cal and return mul_level of max_pool result.
+  // max(a, b) = b + relu(a - b) is evaluated in ceil(log2(kh)) +
+  // ceil(log2(kw)) rounds. Like relu, each round bootstraps its input, so
+  // the result level is that of the last relu.
   air::base::NODE_PTR data_child = max_pool->Child(0);
   uint32_t input_level = visitor->template Visit<RETV>(data_child).Mul_level();
+  uint32_t   num_ks    = 0;
+  const int* ks        = max_pool->Attr<int>("kernel_shape", &num_ks);
+  uint32_t   num_round = 0;
+  for (uint32_t i = 0; ks != nullptr && i < num_ks; ++i) {
+    num_round += std::ceil(std::log2(ks[i]));
+  }
+  if (num_round == 0) {
+    return RETV(input_level);
+  }
+  uint32_t bts_mul_level =
+      visitor->Context().Get_ctx_param()->Mul_depth_of_bootstrap();
   uint32_t mul_level_of_max_pool =
-      input_level + Mul_level_of_tensor_op(nn::core::OPC_MAX_POOL);
+      bts_mul_level + Mul_level_of_tensor_op(nn::core::OPC_RELU);
   return RETV(mul_level_of_max_pool);
 }
 
@@ -48,6 +48,10 @@ public:
     return !_pass_mgr.Pass_enable<PASS_ID::POLY>();
   }
 
+  void Disable_poly2c_pass() {
+    _pass_mgr.Set_pass_enable<PASS_ID::POLY2C>(false);
+  }
+
 private:
   FHE_PASS_MANAGER     _pass_mgr;
   fhe::core::LOWER_CTX _lower_ctx;
@@ -0,0 +1,219 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef FHE_INTERP_CKKS_HANDLER_H
+#define FHE_INTERP_CKKS_HANDLER_H
+
+#include "air/base/container.h"
+#include "fhe/ckks/ckks_opcode.h"
+#include "fhe/ckks/invalid_handler.h"
+#include "fhe/interp/interp_ctx.h"
+
+namespace fhe {
+
+namespace interp {
+
+//! @brief Handler to interpret CKKS operators with ANT runtime library.
+//! Each operator allocates a new ciphertext for its result.
+class CKKS_HANDLER : public fhe::ckks::INVALID_HANDLER {
+public:
+  //! @brief Handle CKKS ADD operator
+  template <typename RETV, typename VISITOR>
+  RETV Handle_add(VISITOR* visitor, air::base::NODE_PTR node) {
+    INTERP_CTX& ctx   = visitor->Context();
+    RETV        opnd0 = visitor->template Visit<RETV>(node->Child(0));
+    RETV        opnd1 = visitor->template Visit<RETV>(node->Child(1));
+    AIR_ASSERT_MSG(opnd0.Is_ciph(), "first operand of add must be cipher");
+    ctx.Inc_op_count();
+    // zero cipher is the identity of add
+    if (opnd0.Is_zero()) {
+      AIR_ASSERT_MSG(opnd1.Is_ciph(), "add plain to zero cipher");
+      return opnd1;
+    }
+    if (opnd1.Is_ciph() && opnd1.Is_zero()) return opnd0;
+
+    CIPHERTEXT* res = Alloc_ciphertext();
+    if (opnd1.Is_ciph()) {
+      Add_ciph(res, opnd0.Ciph(), opnd1.Ciph());
+    } else if (opnd1.Is_plain()) {
+      Add_plain(res, opnd0.Ciph(), opnd1.Plain());
+    } else {
+      // encode float to the same scale degree and level as ciph
+      RETV plain = ctx.Encode_scalar(opnd1, opnd0.Ciph(), true);
+      Add_plain(res, opnd0.Ciph(), plain.Plain());
+    }
+    return INTERP_VALUE::New_ciph(res);
+  }
+
+  //! @brief Handle CKKS SUB operator
+  template <typename RETV, typename VISITOR>
+  RETV Handle_sub(VISITOR* visitor, air::base::NODE_PTR node) {
+    INTERP_CTX& ctx   = visitor->Context();
+    RETV        opnd0 = visitor->template Visit<RETV>(node->Child(0));
+    RETV        opnd1 = visitor->template Visit<RETV>(node->Child(1));
+    AIR_ASSERT_MSG(opnd0.Is_ciph() && opnd1.Is_ciph(),
+                   "only cipher - cipher is supported");
+    ctx.Inc_op_count();
+    CIPHERTEXT* res = Alloc_ciphertext();
+    Sub_ciph(res, opnd0.Ciph(), opnd1.Ciph());
+    return INTERP_VALUE::New_ciph(res);
+  }
+
+  //! @brief Handle CKKS MUL operator
+  template <typename RETV, typename VISITOR>
+  RETV Handle_mul(VISITOR* visitor, air::base::NODE_PTR node) {
+    INTERP_CTX& ctx   = visitor->Context();
+    RETV        opnd0 = visitor->template Visit<RETV>(node->Child(0));
+    RETV        opnd1 = visitor->template Visit<RETV>(node->Child(1));
+    AIR_ASSERT_MSG(opnd0.Is_ciph(), "first operand of mul must be cipher");
+    ctx.Inc_op_count();
+    if (opnd0.Is_zero()) return opnd0;
+    if (opnd1.Is_ciph() && opnd1.Is_zero()) return opnd1;
+
+    if (opnd1.Is_ciph() && ctx.Is_cipher3_type(node->Rtype_id())) {
+      CIPHERTEXT3* res = Alloc_ciphertext3();
+      Mul_ciph3(res, opnd0.Ciph(), opnd1.Ciph());
+      return INTERP_VALUE::New_ciph3(res);
+    }
+    CIPHERTEXT* res = Alloc_ciphertext();
+    if (opnd1.Is_ciph()) {
+      Mul_ciph(res, opnd0.Ciph(), opnd1.Ciph());
+    } else if (opnd1.Is_plain()) {
+      Mul_plain(res, opnd0.Ciph(), opnd1.Plain());
+    } else {
+      // encode float to scale degree 1 at the level of ciph
+      RETV plain = ctx.Encode_scalar(opnd1, opnd0.Ciph(), false);
+      Mul_plain(res, opnd0.Ciph(), plain.Plain());
+    }
+    return INTERP_VALUE::New_ciph(res);
+  }
+
+  //! @brief Handle CKKS ENCODE operator: (data, len, scale, level)
+  template <typename RETV, typename VISITOR>
+  RETV Handle_encode(VISITOR* visitor, air::base::NODE_PTR node) {
+    INTERP_CTX& ctx  = visitor->Context();
+    RETV        data = visitor->template Visit<RETV>(node->Child(0));
+    int64_t     len  = visitor->template Visit<RETV>(node->Child(1)).Int_val();
+    int64_t     sc   = visitor->template Visit<RETV>(node->Child(2)).Int_val();
+    int64_t     lev  = visitor->template Visit<RETV>(node->Child(3)).Int_val();
+    if (data.Is_data()) {
+      AIR_ASSERT_MSG((size_t)len <= data.Data_len(),
+                     "encode %d elements from %d", (int)len,
+                     (int)data.Data_len());
+      return ctx.Encode(data.Data(), len, sc, lev);
+    }
+    float val = data.Float_val();
+    return ctx.Encode(&val, 1, sc, lev);
+  }
+
+  //! @brief Handle CKKS RELIN operator
+  template <typename RETV, typename VISITOR>
+  RETV Handle_relin(VISITOR* visitor, air::base::NODE_PTR node) {
+    INTERP_CTX& ctx  = visitor->Context();
+    RETV        opnd = visitor->template Visit<RETV>(node->Child(0));
+    if (opnd.Is_zero()) return opnd;
+    ctx.Inc_op_count();
+    CIPHERTEXT* res = Alloc_ciphertext();
+    Relin(res, opnd.Ciph3());
+    return INTERP_VALUE::New_ciph(res);
+  }
+
+  //! @brief Handle CKKS RESCALE operator
+  template <typename RETV, typename VISITOR>
+  RETV Handle_rescale(VISITOR* visitor, air::base::NODE_PTR node) {
+    INTERP_CTX& ctx  = visitor->Context();
+    RETV        opnd = visitor->template Visit<RETV>(node->Child(0));
+    if (opnd.Is_zero()) return opnd;
+    ctx.Inc_op_count();
+    CIPHERTEXT* res = Alloc_ciphertext();
+    Rescale_ciph(res, opnd.Ciph());
+    return INTERP_VALUE::New_ciph(res);
+  }
+
+  //! @brief Handle CKKS UPSCALE operator
+  template <typename RETV, typename VISITOR>
+  RETV Handle_upscale(VISITOR* visitor, air::base::NODE_PTR node) {
+    INTERP_CTX& ctx  = visitor->Context();
+    RETV        opnd = visitor->template Visit<RETV>(node->Child(0));
+    int64_t     size = visitor->template Visit<RETV>(node->Child(1)).Int_val();
+    if (opnd.Is_zero()) return opnd;
+    ctx.Inc_op_count();
+    CIPHERTEXT* res = Alloc_ciphertext();
+    Upscale_ciph(res, opnd.Ciph(), size);
+    return INTERP_VALUE::New_ciph(res);
+  }
+
+  //! @brief Handle CKKS MOD_SWITCH operator
+  template <typename RETV, typename VISITOR>
+  RETV Handle_mod_switch(VISITOR* visitor, air::base::NODE_PTR node) {
+    INTERP_CTX& ctx  = visitor->Context();
+    RETV        opnd = visitor->template Visit<RETV>(node->Child(0));
+    if (opnd.Is_zero()) return opnd;
+    ctx.Inc_op_count();
+    // Modswitch_ciph works in place, operand may be shared
+    CIPHERTEXT* res = Alloc_ciphertext();
+    Copy_ciph(res, opnd.Ciph());
+    Modswitch_ciph(res);
+    return INTERP_VALUE::New_ciph(res);
+  }
+
+  //! @brief Handle CKKS ROTATE operator
+  template <typename RETV, typename VISITOR>
+  RETV Handle_rotate(VISITOR* visitor, air::base::NODE_PTR node) {
+    INTERP_CTX& ctx  = visitor->Context();
+    RETV        opnd = visitor->template Visit<RETV>(node->Child(0));
+    int64_t     rot  = visitor->template Visit<RETV>(node->Child(1)).Int_val();
+    if (opnd.Is_zero()) return opnd;
+    ctx.Inc_op_count();
+    CIPHERTEXT* res = Alloc_ciphertext();
+    if (rot == 0) {
+      Copy_ciph(res, opnd.Ciph());
+    } else {
+      Rotate_ciph(res, opnd.Ciph(), (int32_t)rot);
+    }
+    return INTERP_VALUE::New_ciph(res);
+  }
+
+  //! @brief Handle CKKS BOOTSTRAP operator
+  template <typename RETV, typename VISITOR>
+  RETV Handle_bootstrap(VISITOR* visitor, air::base::NODE_PTR node) {
+    INTERP_CTX& ctx  = visitor->Context();
+    RETV        opnd = visitor->template Visit<RETV>(node->Child(0));
+    AIR_ASSERT_MSG(!opnd.Is_zero(), "bootstrap zero cipher");
+    const char* attr_name =
+        ctx.Lower_ctx().Attr_name(fhe::core::FHE_ATTR_KIND::LEVEL);
+    const uint32_t* level = node->Attr<uint32_t>(attr_name);
+    ctx.Inc_op_count();
+    CIPHERTEXT* res = Alloc_ciphertext();
+    Bootstrap(res, opnd.Ciph(), level == nullptr ? 0 : *level);
+    return INTERP_VALUE::New_ciph(res);
+  }
+
+  //! @brief Handle CKKS SCALE operator
+  template <typename RETV, typename VISITOR>
+  RETV Handle_scale(VISITOR* visitor, air::base::NODE_PTR node) {
+    RETV opnd = visitor->template Visit<RETV>(node->Child(0));
+    AIR_ASSERT_MSG(!opnd.Is_zero(), "scale of zero cipher");
+    return INTERP_VALUE::New_int(Sc_degree(opnd.Ciph()));
+  }
+
+  //! @brief Handle CKKS LEVEL operator
+  template <typename RETV, typename VISITOR>
+  RETV Handle_level(VISITOR* visitor, air::base::NODE_PTR node) {
+    RETV opnd = visitor->template Visit<RETV>(node->Child(0));
+    AIR_ASSERT_MSG(!opnd.Is_zero(), "level of zero cipher");
+    return INTERP_VALUE::New_int(Level(opnd.Ciph()));
+  }
+
+};  // CKKS_HANDLER
+
+}  // namespace interp
+
+}  // namespace fhe
+
+#endif  // FHE_INTERP_CKKS_HANDLER_H
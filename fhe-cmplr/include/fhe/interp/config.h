@@ -0,0 +1,46 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef FHE_INTERP_CONFIG_H
+#define FHE_INTERP_CONFIG_H
+
+#include "air/driver/common_config.h"
+#include "air/driver/driver_ctx.h"
+
+namespace fhe {
+namespace interp {
+
+enum TRACE_DETAIL {
+  TRACE_INTERP = 0,
+};
+
+struct INTERP_CONFIG : public air::util::COMMON_CONFIG {
+public:
+  INTERP_CONFIG(void) {}
+
+  void Register_options(air::driver::DRIVER_CTX* ctx);
+  void Update_options();
+
+  void Print(std::ostream& os) const;
+
+  const char* Input_file() const { return _input_file.c_str(); }
+  const char* Output_file() const { return _output_file.c_str(); }
+  bool        Has_input_file() const { return !_input_file.empty(); }
+  bool        Has_output_file() const { return !_output_file.empty(); }
+  uint64_t    Seed() const { return _seed; }
+
+  // leave this member public so that OPTION_DESC can access it
+  std::string _input_file;   // read input tensor from file
+  std::string _output_file;  // write decoded output to file
+  uint64_t    _seed = 1;     // seed to generate input if no input file
+};
+
+}  // namespace interp
+}  // namespace fhe
+
+#endif  // FHE_INTERP_CONFIG_H
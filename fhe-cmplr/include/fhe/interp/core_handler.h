@@ -0,0 +1,285 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef FHE_INTERP_CORE_HANDLER_H
+#define FHE_INTERP_CORE_HANDLER_H
+
+#include <vector>
+
+#include "air/base/container.h"
+#include "air/core/invalid_handler.h"
+#include "air/core/opcode.h"
+#include "fhe/interp/interp_ctx.h"
+
+namespace fhe {
+
+namespace interp {
+
+//! @brief Handler to interpret CORE operators in CKKS IR
+class CORE_HANDLER : public air::core::INVALID_HANDLER {
+public:
+  //! @brief Handle BLOCK, stop at RETV
+  template <typename RETV, typename VISITOR>
+  RETV Handle_block(VISITOR* visitor, air::base::NODE_PTR node) {
+    INTERP_CTX& ctx = visitor->Context();
+    for (air::base::STMT_PTR stmt = node->Begin_stmt();
+         stmt != node->End_stmt() && !ctx.Frame()._returned;
+         stmt = stmt->Next()) {
+      visitor->template Visit<RETV>(stmt->Node());
+    }
+    return RETV();
+  }
+
+  //! @brief Handle DO_LOOP: iv = init; while (cond) { body; iv = incr; }
+  template <typename RETV, typename VISITOR>
+  RETV Handle_do_loop(VISITOR* visitor, air::base::NODE_PTR node) {
+    INTERP_CTX&               ctx = visitor->Context();
+    air::base::ADDR_DATUM_PTR iv  = node->Iv();
+    ctx.Set_var(iv, visitor->template Visit<RETV>(node->Child(0)));
+    while (visitor->template Visit<RETV>(node->Child(1)).Int_val() != 0) {
+      visitor->template Visit<RETV>(node->Child(3));
+      if (ctx.Frame()._returned) break;
+      ctx.Set_var(iv, visitor->template Visit<RETV>(node->Child(2)));
+    }
+    return RETV();
+  }
+
+  //! @brief Handle IF
+  template <typename RETV, typename VISITOR>
+  RETV Handle_if(VISITOR* visitor, air::base::NODE_PTR node) {
+    if (visitor->template Visit<RETV>(node->Child(0)).Int_val() != 0) {
+      visitor->template Visit<RETV>(node->Then_blk());
+    } else {
+      visitor->template Visit<RETV>(node->Else_blk());
+    }
+    return RETV();
+  }
+
+  //! @brief Handle LD
+  template <typename RETV, typename VISITOR>
+  RETV Handle_ld(VISITOR* visitor, air::base::NODE_PTR node) {
+    return visitor->Context().Var(node->Addr_datum());
+  }
+
+  //! @brief Handle ST
+  template <typename RETV, typename VISITOR>
+  RETV Handle_st(VISITOR* visitor, air::base::NODE_PTR node) {
+    RETV val = visitor->template Visit<RETV>(node->Child(0));
+    visitor->Context().Set_var(node->Addr_datum(), val);
+    return RETV();
+  }
+
+  //! @brief Handle LDP
+  template <typename RETV, typename VISITOR>
+  RETV Handle_ldp(VISITOR* visitor, air::base::NODE_PTR node) {
+    return visitor->Context().Preg(node->Preg_id());
+  }
+
+  //! @brief Handle STP
+  template <typename RETV, typename VISITOR>
+  RETV Handle_stp(VISITOR* visitor, air::base::NODE_PTR node) {
+    RETV val = visitor->template Visit<RETV>(node->Child(0));
+    visitor->Context().Set_preg(node->Preg_id(), val);
+    return RETV();
+  }
+
+  //! @brief Handle INTCONST
+  template <typename RETV, typename VISITOR>
+  RETV Handle_intconst(VISITOR* visitor, air::base::NODE_PTR node) {
+    return INTERP_VALUE::New_int((int64_t)node->Intconst());
+  }
+
+  //! @brief Handle LDC: float/int scalar or float array
+  template <typename RETV, typename VISITOR>
+  RETV Handle_ldc(VISITOR* visitor, air::base::NODE_PTR node) {
+    air::base::CONSTANT_PTR cst = node->Const();
+    switch (cst->Kind()) {
+      case air::base::CONSTANT_KIND::FLOAT:
+        return INTERP_VALUE::New_float(cst->Float_literal().Val_as_double());
+      case air::base::CONSTANT_KIND::SIGNED_INT:
+        return INTERP_VALUE::New_int(cst->Integer_literal().Val_as_int64());
+      case air::base::CONSTANT_KIND::UNSIGNED_INT:
+        return INTERP_VALUE::New_int(
+            (int64_t)cst->Integer_literal().Val_as_uint64());
+      case air::base::CONSTANT_KIND::ARRAY: {
+        air::base::TYPE_PTR elem_type = cst->Type()->Cast_to_arr()->Elem_type();
+        AIR_ASSERT_MSG(elem_type->Is_prim() &&
+                           elem_type->Cast_to_prim()->Encoding() ==
+                               air::base::PRIMITIVE_TYPE::FLOAT_32,
+                       "only float32 array constant is supported");
+        return INTERP_VALUE::New_data(cst->Array_ptr<float>(),
+                                      cst->Array_byte_len() / sizeof(float));
+      }
+      default:
+        AIR_ASSERT_MSG(false, "unsupported constant kind %d",
+                       (int)cst->Kind());
+        return RETV();
+    }
+  }
+
+  //! @brief Handle ZERO: zero cipher if stored to a cipher variable
+  template <typename RETV, typename VISITOR>
+  RETV Handle_zero(VISITOR* visitor, air::base::NODE_PTR node) {
+    INTERP_CTX&         ctx    = visitor->Context();
+    air::base::NODE_PTR parent = ctx.Parent(1);
+    if (parent != air::base::Null_ptr &&
+        parent->Opcode() == air::core::OPC_ST &&
+        ctx.Is_cipher_type(parent->Addr_datum()->Type_id())) {
+      return INTERP_VALUE::New_zero_ciph();
+    }
+    AIR_ASSERT_MSG(node->Rtype()->Is_prim(), "unsupported zero type");
+    return INTERP_VALUE::New_int(0);
+  }
+
+  //! @brief Handle ILD of ARRAY(LDCA) on 1-D integer constant array
+  template <typename RETV, typename VISITOR>
+  RETV Handle_ild(VISITOR* visitor, air::base::NODE_PTR node) {
+    air::base::NODE_PTR array = node->Child(0);
+    AIR_ASSERT_MSG(array->Opcode() == air::core::OPC_ARRAY &&
+                       array->Child(0)->Opcode() == air::core::OPC_LDCA &&
+                       array->Num_child() == 2,
+                   "only ild of 1-D constant array is supported");
+    air::base::CONSTANT_PTR cst = array->Child(0)->Const();
+    int64_t idx = visitor->template Visit<RETV>(array->Child(1)).Int_val();
+    air::base::PRIM_TYPE_PTR elem_type =
+        cst->Type()->Cast_to_arr()->Elem_type()->Cast_to_prim();
+    switch (elem_type->Encoding()) {
+      case air::base::PRIMITIVE_TYPE::INT_S32:
+        return INTERP_VALUE::New_int(cst->Array_elem<int32_t>(idx));
+      case air::base::PRIMITIVE_TYPE::INT_U32:
+        return INTERP_VALUE::New_int(cst->Array_elem<uint32_t>(idx));
+      default:
+        AIR_ASSERT_MSG(false, "unsupported array element type");
+        return RETV();
+    }
+  }
+
+  //! @brief Handle CALL: interpret callee and set return preg
+  template <typename RETV, typename VISITOR>
+  RETV Handle_call(VISITOR* visitor, air::base::NODE_PTR node) {
+    INTERP_CTX&       ctx = visitor->Context();
+    std::vector<RETV> args;
+    args.reserve(node->Num_arg());
+    for (uint32_t i = 0; i < node->Num_arg(); ++i) {
+      args.push_back(visitor->template Visit<RETV>(node->Child(i)));
+    }
+    air::base::FUNC_SCOPE* callee =
+        &node->Glob_scope().Open_func_scope(node->Entry()->Owning_func_id());
+    RETV retv = ctx.Call(visitor, callee, args);
+    if (node->Has_ret_var()) {
+      ctx.Set_preg(node->Ret_preg_id(), retv);
+    }
+    return RETV();
+  }
+
+  //! @brief Handle RETV: main graph sends result to runtime output
+  template <typename RETV, typename VISITOR>
+  RETV Handle_retv(VISITOR* visitor, air::base::NODE_PTR node) {
+    INTERP_CTX&   ctx   = visitor->Context();
+    RETV          val   = visitor->template Visit<RETV>(node->Child(0));
+    INTERP_FRAME& frame = ctx.Frame();
+    frame._returned     = true;
+    if (frame._func->Owning_func()->Entry_point()->Is_program_entry()) {
+      AIR_ASSERT_MSG(val.Is_ciph() && !val.Is_zero(),
+                     "main graph must return a cipher");
+      // Set_output_data takes over polys in data, pass a copy to it
+      CIPHERTEXT* output = Alloc_ciphertext();
+      Copy_ciph(output, val.Ciph());
+      Set_output_data(ctx.Output_name().c_str(), 0, output);
+      Free_ciphertext(output);
+    } else {
+      frame._retv = val;
+    }
+    return RETV();
+  }
+
+  //! @brief Handle RET
+  template <typename RETV, typename VISITOR>
+  RETV Handle_ret(VISITOR* visitor, air::base::NODE_PTR node) {
+    visitor->Context().Frame()._returned = true;
+    return RETV();
+  }
+
+  //! @brief Integer arithmetic and compare operators
+  template <typename RETV, typename VISITOR>
+  RETV Handle_add(VISITOR* visitor, air::base::NODE_PTR node) {
+    return Binary(visitor, node, [](int64_t a, int64_t b) { return a + b; });
+  }
+  template <typename RETV, typename VISITOR>
+  RETV Handle_sub(VISITOR* visitor, air::base::NODE_PTR node) {
+    return Binary(visitor, node, [](int64_t a, int64_t b) { return a - b; });
+  }
+  template <typename RETV, typename VISITOR>
+  RETV Handle_mul(VISITOR* visitor, air::base::NODE_PTR node) {
+    return Binary(visitor, node, [](int64_t a, int64_t b) { return a * b; });
+  }
+  template <typename RETV, typename VISITOR>
+  RETV Handle_shl(VISITOR* visitor, air::base::NODE_PTR node) {
+    return Binary(visitor, node, [](int64_t a, int64_t b) { return a << b; });
+  }
+  template <typename RETV, typename VISITOR>
+  RETV Handle_eq(VISITOR* visitor, air::base::NODE_PTR node) {
+    return Binary(visitor, node,
+                  [](int64_t a, int64_t b) { return (int64_t)(a == b); });
+  }
+  template <typename RETV, typename VISITOR>
+  RETV Handle_ne(VISITOR* visitor, air::base::NODE_PTR node) {
+    return Binary(visitor, node,
+                  [](int64_t a, int64_t b) { return (int64_t)(a != b); });
+  }
+  template <typename RETV, typename VISITOR>
+  RETV Handle_lt(VISITOR* visitor, air::base::NODE_PTR node) {
+    return Binary(visitor, node,
+                  [](int64_t a, int64_t b) { return (int64_t)(a < b); });
+  }
+  template <typename RETV, typename VISITOR>
+  RETV Handle_le(VISITOR* visitor, air::base::NODE_PTR node) {
+    return Binary(visitor, node,
+                  [](int64_t a, int64_t b) { return (int64_t)(a <= b); });
+  }
+  template <typename RETV, typename VISITOR>
+  RETV Handle_gt(VISITOR* visitor, air::base::NODE_PTR node) {
+    return Binary(visitor, node,
+                  [](int64_t a, int64_t b) { return (int64_t)(a > b); });
+  }
+  template <typename RETV, typename VISITOR>
+  RETV Handle_ge(VISITOR* visitor, air::base::NODE_PTR node) {
+    return Binary(visitor, node,
+                  [](int64_t a, int64_t b) { return (int64_t)(a >= b); });
+  }
+
+  //! @brief Timing and pragma have no effect on the result
+  template <typename RETV, typename VISITOR>
+  RETV Handle_tm_start(VISITOR* visitor, air::base::NODE_PTR node) {
+    return RETV();
+  }
+  template <typename RETV, typename VISITOR>
+  RETV Handle_tm_taken(VISITOR* visitor, air::base::NODE_PTR node) {
+    return RETV();
+  }
+  template <typename RETV, typename VISITOR>
+  RETV Handle_pragma(VISITOR* visitor, air::base::NODE_PTR node) {
+    return RETV();
+  }
+
+private:
+  template <typename VISITOR, typename OP>
+  INTERP_VALUE Binary(VISITOR* visitor, air::base::NODE_PTR node, OP op) {
+    AIR_ASSERT_MSG(node->Rtype()->Is_int(), "only integer %s is supported",
+                   node->Name());
+    int64_t a = visitor->template Visit<INTERP_VALUE>(node->Child(0)).Int_val();
+    int64_t b = visitor->template Visit<INTERP_VALUE>(node->Child(1)).Int_val();
+    return INTERP_VALUE::New_int(op(a, b));
+  }
+};  // CORE_HANDLER
+
+}  // namespace interp
+
+}  // namespace fhe
+
+#endif  // FHE_INTERP_CORE_HANDLER_H
@@ -0,0 +1,209 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef FHE_INTERP_INTERP_CTX_H
+#define FHE_INTERP_INTERP_CTX_H
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "air/base/analyze_ctx.h"
+#include "air/base/container.h"
+#include "air/base/st.h"
+#include "fhe/core/lower_ctx.h"
+#include "fhe/interp/config.h"
+#include "rt_ant/rt_ant.h"
+
+namespace fhe {
+
+namespace interp {
+
+//! @brief Value of an expression evaluated by the interpreter.
+//! Ciphertext, ciphertext3 and plaintext values are immutable and shared:
+//! every CKKS operator allocates a new result, so a store only copies the
+//! reference and the runtime object is freed with its last reference.
+//! A CIPH value without ciphertext is the zero cipher from CORE.zero.
+class INTERP_VALUE {
+public:
+  enum KIND : uint8_t { NONE, INT, FLOAT, DATA, CIPH, CIPH3, PLAIN };
+
+  INTERP_VALUE() : _kind(NONE) {}
+
+  static INTERP_VALUE New_int(int64_t val);
+  static INTERP_VALUE New_float(double val);
+  static INTERP_VALUE New_data(const float* data, size_t len);
+  static INTERP_VALUE New_ciph(CIPHERTEXT* ciph);
+  static INTERP_VALUE New_ciph3(CIPHERTEXT3* ciph);
+  static INTERP_VALUE New_plain(PLAINTEXT* plain);
+  static INTERP_VALUE New_zero_ciph() { return New_ciph(nullptr); }
+
+  KIND Kind() const { return _kind; }
+  bool Is_int() const { return _kind == INT; }
+  bool Is_float() const { return _kind == FLOAT; }
+  bool Is_data() const { return _kind == DATA; }
+  bool Is_ciph() const { return _kind == CIPH; }
+  bool Is_ciph3() const { return _kind == CIPH3; }
+  bool Is_plain() const { return _kind == PLAIN; }
+  bool Is_zero() const { return _kind == CIPH && _obj == nullptr; }
+
+  int64_t Int_val() const {
+    AIR_ASSERT_MSG(_kind == INT, "value is not an integer");
+    return _int;
+  }
+  double Float_val() const {
+    AIR_ASSERT_MSG(_kind == FLOAT || _kind == INT, "value is not a number");
+    return _kind == FLOAT ? _float : (double)_int;
+  }
+  const float* Data() const {
+    AIR_ASSERT_MSG(_kind == DATA, "value is not constant data");
+    return _data;
+  }
+  size_t Data_len() const {
+    AIR_ASSERT_MSG(_kind == DATA, "value is not constant data");
+    return _len;
+  }
+  CIPHERTEXT* Ciph() const {
+    AIR_ASSERT_MSG(_kind == CIPH && _obj != nullptr, "value is not a cipher");
+    return static_cast<CIPHERTEXT*>(_obj.get());
+  }
+  CIPHERTEXT3* Ciph3() const {
+    AIR_ASSERT_MSG(_kind == CIPH3, "value is not a cipher3");
+    return static_cast<CIPHERTEXT3*>(_obj.get());
+  }
+  PLAINTEXT* Plain() const {
+    AIR_ASSERT_MSG(_kind == PLAIN, "value is not a plain");
+    return static_cast<PLAINTEXT*>(_obj.get());
+  }
+
+private:
+  KIND _kind;
+  union {
+    int64_t _int;
+    double  _float;
+  };
+  const float*          _data = nullptr;  // DATA: constant owned by GLOB_SCOPE
+  size_t                _len  = 0;        // DATA: number of elements
+  std::shared_ptr<void> _obj;             // CIPH/CIPH3/PLAIN: runtime object
+};
+
+//! @brief Values of variables and pregs of one function activation
+struct INTERP_FRAME {
+  INTERP_FRAME(air::base::FUNC_SCOPE* func) : _func(func) {}
+
+  air::base::FUNC_SCOPE*                     _func;
+  std::unordered_map<uint32_t, INTERP_VALUE> _var;
+  std::unordered_map<uint32_t, INTERP_VALUE> _preg;
+  INTERP_VALUE                               _retv;
+  bool                                       _returned = false;
+};
+
+//! @brief Context to interpret CKKS IR, each CKKS operator is executed by the
+//! corresponding ANT runtime API in rtlib/ant/include/ckks/cipher_eval.h
+class INTERP_CTX : public air::base::ANALYZE_CTX {
+public:
+  INTERP_CTX(const core::LOWER_CTX& lower_ctx, const INTERP_CONFIG& cfg)
+      : _lower_ctx(lower_ctx), _config(cfg) {}
+
+  const core::LOWER_CTX& Lower_ctx() const { return _lower_ctx; }
+  const INTERP_CONFIG&   Config() const { return _config; }
+
+  bool Is_cipher_type(air::base::TYPE_ID ty) const {
+    return _lower_ctx.Is_cipher_type(ty);
+  }
+  bool Is_cipher3_type(air::base::TYPE_ID ty) const {
+    return _lower_ctx.Is_cipher3_type(ty);
+  }
+  bool Is_plain_type(air::base::TYPE_ID ty) const {
+    return _lower_ctx.Is_plain_type(ty);
+  }
+
+  //! @brief Frame of the function being interpreted. Frames live in a deque
+  //! so that the reference stays valid when a nested call pushes a new one
+  INTERP_FRAME& Frame() {
+    AIR_ASSERT(!_frame.empty());
+    return _frame.back();
+  }
+  void Push_frame(air::base::FUNC_SCOPE* func) { _frame.emplace_back(func); }
+  void Pop_frame() {
+    AIR_ASSERT(!_frame.empty());
+    _frame.pop_back();
+  }
+
+  const INTERP_VALUE& Var(air::base::ADDR_DATUM_PTR var) {
+    auto it = Frame()._var.find(var->Id().Value());
+    AIR_ASSERT_MSG(it != Frame()._var.end(), "use of undefined variable %s",
+                   var->Name()->Char_str());
+    return it->second;
+  }
+  void Set_var(air::base::ADDR_DATUM_PTR var, const INTERP_VALUE& val) {
+    Frame()._var[var->Id().Value()] = val;
+  }
+  const INTERP_VALUE& Preg(air::base::PREG_ID preg) {
+    auto it = Frame()._preg.find(preg.Value());
+    AIR_ASSERT_MSG(it != Frame()._preg.end(), "use of undefined preg %d",
+                   preg.Value());
+    return it->second;
+  }
+  void Set_preg(air::base::PREG_ID preg, const INTERP_VALUE& val) {
+    Frame()._preg[preg.Value()] = val;
+  }
+
+  //! @brief Name of the output passed to Set_output_data by main graph
+  const std::string& Output_name() const { return _output_name; }
+  void Set_output_name(const char* name) { _output_name = name; }
+
+  //! @brief Number of CKKS operators executed
+  uint64_t Op_count() const { return _op_count; }
+  void     Inc_op_count() { ++_op_count; }
+
+  //! @brief Interpret function func with args, return value of its RETV
+  template <typename VISITOR>
+  INTERP_VALUE Call(VISITOR* visitor, air::base::FUNC_SCOPE* func,
+                    const std::vector<INTERP_VALUE>& args) {
+    air::base::NODE_PTR entry = func->Container().Entry_node();
+    AIR_ASSERT_MSG(args.size() == entry->Num_child() - 1,
+                   "argument count mismatch for %s",
+                   func->Owning_func()->Name()->Char_str());
+    Push_frame(func);
+    for (uint32_t i = 0; i < args.size(); ++i) {
+      Set_var(func->Formal(i), args[i]);
+    }
+    visitor->template Visit<INTERP_VALUE>(entry->Body_blk());
+    INTERP_VALUE retv = Frame()._retv;
+    Pop_frame();
+    return retv;
+  }
+
+  //! @brief Encode float data into a plaintext with scale degree and level
+  INTERP_VALUE Encode(const float* data, size_t len, uint32_t sc_degree,
+                      uint32_t level);
+
+  //! @brief Encode number into a plaintext which has the same scale degree
+  //! and level as ciph if same_scale, or scale degree 1 otherwise
+  INTERP_VALUE Encode_scalar(const INTERP_VALUE& num, CIPHERTEXT* ciph,
+                             bool same_scale);
+
+private:
+  INTERP_CTX(const INTERP_CTX&)            = delete;
+  INTERP_CTX& operator=(const INTERP_CTX&) = delete;
+
+  const core::LOWER_CTX&   _lower_ctx;
+  const INTERP_CONFIG&     _config;
+  std::deque<INTERP_FRAME> _frame;
+  std::string              _output_name;
+  uint64_t                 _op_count = 0;
+};
+
+}  // namespace interp
+
+}  // namespace fhe
+
+#endif  // FHE_INTERP_INTERP_CTX_H
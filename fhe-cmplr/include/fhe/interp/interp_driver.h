@@ -0,0 +1,84 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef FHE_INTERP_INTERP_DRIVER_H
+#define FHE_INTERP_INTERP_DRIVER_H
+
+#include <string>
+#include <vector>
+
+#include "air/base/st.h"
+#include "air/driver/driver_ctx.h"
+#include "common/rt_api.h"
+#include "fhe/core/lower_ctx.h"
+#include "fhe/interp/config.h"
+
+namespace fhe {
+
+namespace interp {
+
+//! @brief Run the program entry of CKKS IR against ANT runtime library
+//! without generating C code. The runtime calls back to the hooks normally
+//! emitted by POLY2C (Get_context_params, Get_encode_scheme, Main_graph,
+//! ...), which are answered by the driver being run.
+class INTERP_DRIVER {
+public:
+  INTERP_DRIVER(air::driver::DRIVER_CTX* driver_ctx,
+                const core::LOWER_CTX& lower_ctx, const INTERP_CONFIG& cfg)
+      : _driver_ctx(driver_ctx), _lower_ctx(lower_ctx), _config(cfg) {}
+
+  ~INTERP_DRIVER();
+
+  //! @brief Encrypt input of shape, interpret program entry of glob and
+  //! return the decrypted output
+  std::vector<double> Run(air::base::GLOB_SCOPE*      glob,
+                          const std::vector<int64_t>& input_shape,
+                          const std::vector<double>&  input);
+
+  //! @brief Number of CKKS operators executed by last Run
+  uint64_t Op_count() const { return _op_count; }
+
+  // callbacks from runtime library
+  CKKS_PARAMS* Context_params();
+  DATA_SCHEME* Encode_scheme(int idx);
+  DATA_SCHEME* Decode_scheme(int idx);
+  int          Input_count() const { return 1; }
+  int          Output_count() const { return 1; }
+  bool         Main_graph();
+
+  //! @brief Driver being run, used by runtime callbacks
+  static INTERP_DRIVER* Running() { return _running; }
+
+  DECLARE_TRACE_DETAIL_API(_config, _driver_ctx)
+
+private:
+  INTERP_DRIVER(const INTERP_DRIVER&)            = delete;
+  INTERP_DRIVER& operator=(const INTERP_DRIVER&) = delete;
+
+  DATA_SCHEME* New_scheme(const char* name, const std::vector<int64_t>& shape);
+
+  air::driver::DRIVER_CTX* _driver_ctx;
+  const core::LOWER_CTX&   _lower_ctx;
+  const INTERP_CONFIG&     _config;
+  air::base::FUNC_SCOPE*   _main       = nullptr;
+  CKKS_PARAMS*             _params     = nullptr;
+  DATA_SCHEME*             _enc_scheme = nullptr;
+  DATA_SCHEME*             _dec_scheme = nullptr;
+  std::string              _input_name;
+  std::string              _output_name;
+  std::vector<int64_t>     _input_shape;
+  uint64_t                 _op_count = 0;
+
+  static INTERP_DRIVER* _running;
+};
+
+}  // namespace interp
+
+}  // namespace fhe
+
+#endif  // FHE_INTERP_INTERP_DRIVER_H
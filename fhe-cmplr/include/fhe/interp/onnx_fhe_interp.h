@@ -0,0 +1,56 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef FHE_INTERP_ONNX_FHE_INTERP_H
+#define FHE_INTERP_ONNX_FHE_INTERP_H
+
+#include <vector>
+
+#include "fhe/driver/onnx_fhe_cmplr.h"
+#include "fhe/interp/config.h"
+
+namespace fhe {
+
+namespace interp {
+
+//! @brief Compile ONNX model down to CKKS IR and interpret it with ANT
+//! runtime library directly, so that a model can be run end to end without
+//! generating, compiling and linking C code. POLY and POLY2C are disabled.
+class ONNX_FHE_INTERP : public air::driver::DRIVER {
+public:
+  ONNX_FHE_INTERP();
+
+  R_CODE Init(int argc, char** argv);
+
+  R_CODE Pre_run();
+
+  R_CODE Run();
+
+  void Post_run();
+
+  void Fini();
+
+private:
+  // read input from -INTERP:in file or generate it with -INTERP:seed
+  bool Prepare_input(std::vector<double>& input);
+
+  // write output to -INTERP:out file or stdout
+  bool Write_output(const std::vector<double>& output);
+
+  driver::ONNX_PASS_MANAGER _onnx_pass;
+  driver::FHE_COMPILER      _fhe_cmplr;
+  INTERP_CONFIG             _config;
+  std::vector<int64_t>      _input_shape;   // shape of main graph input
+  int64_t                   _output_count;  // elements of main graph output
+};  // ONNX_FHE_INTERP
+
+}  // namespace interp
+
+}  // namespace fhe
+
+#endif  // FHE_INTERP_ONNX_FHE_INTERP_H
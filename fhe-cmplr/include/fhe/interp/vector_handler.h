@@ -0,0 +1,42 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef FHE_INTERP_VECTOR_HANDLER_H
+#define FHE_INTERP_VECTOR_HANDLER_H
+
+#include "air/base/container.h"
+#include "fhe/interp/interp_ctx.h"
+#include "nn/vector/invalid_handler.h"
+
+namespace fhe {
+
+namespace interp {
+
+//! @brief Handler to interpret VECTOR operators left in CKKS IR, which only
+//! select constant data to be encoded
+class VECTOR_HANDLER : public nn::vector::INVALID_HANDLER {
+public:
+  //! @brief Handle VECTOR SLICE: (data, index, size) -> data[index*size, +size)
+  template <typename RETV, typename VISITOR>
+  RETV Handle_slice(VISITOR* visitor, air::base::NODE_PTR node) {
+    RETV    data = visitor->template Visit<RETV>(node->Child(0));
+    int64_t idx  = visitor->template Visit<RETV>(node->Child(1)).Int_val();
+    int64_t size = visitor->template Visit<RETV>(node->Child(2)).Int_val();
+    AIR_ASSERT_MSG((idx + 1) * size <= (int64_t)data.Data_len(),
+                   "slice [%d, %d) out of bound %d", (int)(idx * size),
+                   (int)((idx + 1) * size), (int)data.Data_len());
+    return INTERP_VALUE::New_data(data.Data() + idx * size, size);
+  }
+
+};  // VECTOR_HANDLER
+
+}  // namespace interp
+
+}  // namespace fhe
+
+#endif  // FHE_INTERP_VECTOR_HANDLER_H
@@ -0,0 +1,41 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef FHE_OPT_OPT_DRIVER_H
+#define FHE_OPT_OPT_DRIVER_H
+
+#include "air/base/st.h"
+#include "air/driver/common_config.h"
+#include "air/driver/driver_ctx.h"
+#include "fhe/core/lower_ctx.h"
+#include "fhe/opt/opt_policy.h"
+
+namespace fhe {
+
+namespace opt {
+
+//! @brief Run GVN and DCE in place on each function of glob at IR level.
+//! Functions are optimized concurrently with -jobs=N. Eliminated FHE
+//! operations are written to trace file if trace_stat of config is on.
+void Opt_driver(air::base::GLOB_SCOPE* glob, const core::LOWER_CTX* lower_ctx,
+                const air::driver::DRIVER_CTX*  driver_ctx,
+                const air::util::COMMON_CONFIG& config, OPT_LEVEL level);
+
+//! @brief Hoist loop invariant FHE operations, such as encoding a constant
+//! message at a scale and level not changed in DO_LOOP, out of loops in each
+//! function of glob. Number of hoisted operations is written to trace file
+//! if trace_stat of config is on.
+void Licm_driver(air::base::GLOB_SCOPE* glob, const core::LOWER_CTX* lower_ctx,
+                 const air::driver::DRIVER_CTX*  driver_ctx,
+                 const air::util::COMMON_CONFIG& config, OPT_LEVEL level);
+
+}  // namespace opt
+
+}  // namespace fhe
+
+#endif  // FHE_OPT_OPT_DRIVER_H
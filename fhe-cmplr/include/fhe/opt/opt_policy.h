@@ -0,0 +1,67 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef FHE_OPT_OPT_POLICY_H
+#define FHE_OPT_OPT_POLICY_H
+
+#include "air/opt/opt_policy.h"
+#include "fhe/core/lower_ctx.h"
+
+namespace fhe {
+
+namespace opt {
+
+//! @brief IR level GVN/DCE runs on
+enum class OPT_LEVEL {
+  SIHE,
+  CKKS,
+  POLY,
+};
+
+//! @brief FHE knowledge for GVN/DCE. Also counts FHE operations eliminated.
+//!
+//! SIHE/CKKS operators are pure except bootstrap and SIHE *_msg which call
+//! into the library. POLY operators update ciphertext/polynomial in place,
+//! so on POLY IR only scalar variables are tracked and only metadata queries
+//! are pure.
+class FHE_OPT_POLICY : public air::opt::OPT_POLICY {
+public:
+  FHE_OPT_POLICY(const core::LOWER_CTX* lower_ctx, OPT_LEVEL level)
+      : _lower_ctx(lower_ctx), _level(level) {}
+
+  bool Is_pure(air::base::NODE_PTR node) const;
+  bool Is_value_type(air::base::TYPE_PTR type) const;
+  bool Is_copyable(air::base::TYPE_PTR type) const;
+  bool Is_worth_sharing(air::base::NODE_PTR node) const;
+  const char* Tmp_prefix() const;
+  void        Eliminate(air::base::NODE_PTR node);
+
+  uint32_t Num_rotate() const { return _num_rotate; }
+  uint32_t Num_encode() const { return _num_encode; }
+  uint32_t Num_key_switch() const { return _num_key_switch; }
+  uint32_t Num_op() const { return _num_op; }
+
+private:
+  // REQUIRED UNDEFINED UNWANTED methods
+  FHE_OPT_POLICY(void);
+  FHE_OPT_POLICY(const FHE_OPT_POLICY&);
+  FHE_OPT_POLICY& operator=(const FHE_OPT_POLICY&);
+
+  const core::LOWER_CTX* _lower_ctx;
+  OPT_LEVEL              _level;
+  uint32_t               _num_rotate     = 0;  // rotations eliminated
+  uint32_t               _num_encode     = 0;  // encodes eliminated
+  uint32_t               _num_key_switch = 0;  // key switches eliminated
+  uint32_t               _num_op         = 0;  // all FHE ops eliminated
+};
+
+}  // namespace opt
+
+}  // namespace fhe
+
+#endif  // FHE_OPT_OPT_POLICY_H
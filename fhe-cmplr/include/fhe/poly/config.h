@@ -21,7 +21,8 @@ public:
       : _inline_rotate(false),
         _inline_relin(false),
         _reuse_preg_as_retv(true),
-        _fuse_decomp_modup(true) {}
+        _fuse_decomp_modup(true),
+        _gvn(false) {}
 
   void Register_options(air::driver::DRIVER_CTX* ctx);
   void Update_options();
@@ -42,12 +43,17 @@ public:
 
   void Set_fuse_decomp_modup(bool v) { _fuse_decomp_modup = v; }
 
+  bool Gvn() const { return _gvn; }
+
+  void Set_gvn(bool v) { _gvn = v; }
+
   void Print(std::ostream& os) const;
 
   bool _inline_rotate;
   bool _inline_relin;
   bool _reuse_preg_as_retv;
   bool _fuse_decomp_modup;
+  bool _gvn;
 };  // struct POLY_CONFIG
 
 #define DECLARE_POLY_CONFIG(name, config)                               \
@@ -74,6 +80,13 @@ public:
        &config._fuse_decomp_modup,                                      \
        air::util::K_NONE,                                               \
        0,                                                               \
+       air::util::V_NONE},                                              \
+      {"gvn",                                                           \
+       "gvn",                                                           \
+       "Run GVN and DCE on scalars in " #name,                          \
+       &config._gvn,                                                    \
+       air::util::K_NONE,                                               \
+       0,                                                               \
        air::util::V_NONE},
 
 }  // namespace poly
@@ -362,9 +362,9 @@ public:
   template <typename RETV, typename VISITOR>
   void Handle_tm_start(VISITOR* visitor, air::base::NODE_PTR node) {
     IR2C_CTX& ctx = visitor->Context();
-    ctx << "Tm_start(";
+    ctx << "Tm_start_at(";
     ctx.Emit_constant_str_init(node->Const());
-    ctx << ")";
+    ctx << ", " << node->Spos().File() << ", " << node->Spos().Line() << ")";
   }
 
   //! @brief Special handling for CORE TM_TAKEN operator
@@ -13,6 +13,7 @@
 #include "fhe/poly/invalid_handler.h"
 #include "fhe/poly/ir2c_ctx.h"
 #include "fhe/poly/opcode.h"
+#include "fhe/poly/poly2c_mplan.h"
 
 namespace fhe {
 
@@ -72,6 +73,24 @@ public:
     ctx << ")";
   }
 
+  //! @brief Emit a Move_ciph call to RTlib to hand buffer of child1 over
+  //! to child0
+  template <typename RETV, typename VISITOR>
+  void Handle_move(VISITOR* visitor, air::base::NODE_PTR node) {
+    IR2C_CTX& ctx = visitor->Context();
+    AIR_ASSERT(node->Child(0)->Rtype_id() == node->Child(1)->Rtype_id());
+    if (ctx.Is_cipher3_type(node->Child(0)->Rtype_id())) {
+      ctx << "Move_ciph3(";
+    } else {
+      AIR_ASSERT(ctx.Is_cipher_type(node->Child(0)->Rtype_id()));
+      ctx << "Move_ciph(";
+    }
+    visitor->template Visit<RETV>(node->Child(0));
+    ctx << ", ";
+    visitor->template Visit<RETV>(node->Child(1));
+    ctx << ")";
+  }
+
   //! @brief Emit a Get_auto_order call to RTlib
   template <typename RETV, typename VISITOR>
   void Handle_auto_order(VISITOR* visitor, air::base::NODE_PTR node) {
@@ -179,6 +198,23 @@ public:
     ctx << ", degree)";
   }
 
+  //! @brief Emit a HW_MODSUB call to RTlib
+  template <typename RETV, typename VISITOR>
+  void Handle_hw_modsub(VISITOR* visitor, air::base::NODE_PTR node) {
+    IR2C_CTX&           ctx    = visitor->Context();
+    air::base::NODE_PTR parent = ctx.Parent(1);
+    AIR_ASSERT(parent != air::base::Null_ptr && parent->Is_st());
+    ctx << "Hw_modsub(";
+    ctx.template Emit_st_var<RETV, VISITOR>(visitor, parent);
+    ctx << ", ";
+    visitor->template Visit<RETV>(node->Child(0));
+    ctx << ", ";
+    visitor->template Visit<RETV>(node->Child(1));
+    ctx << ", ";
+    visitor->template Visit<RETV>(node->Child(2));
+    ctx << ", degree)";
+  }
+
   //! @brief Emit a HW_MODMUL call to RTlib
   template <typename RETV, typename VISITOR>
   void Handle_hw_modmul(VISITOR* visitor, air::base::NODE_PTR node) {
@@ -247,9 +283,14 @@ public:
     } else {
       AIR_ASSERT(ctx.Is_cipher_type(node->Child(0)->Rtype_id()));
       AIR_ASSERT(ctx.Is_cipher_type(node->Child(1)->Rtype_id()));
-      fname     = (ctx.Is_plain_type(node->Child(2)->Rtype_id())
-                       ? "Init_ciph_same_scale_plain"
-                       : "Init_ciph_same_scale");
+      if (ctx.Is_plain_type(node->Child(2)->Rtype_id())) {
+        fname = "Init_ciph_same_scale_plain";
+      } else if (node->Attr<uint32_t>(MPLAN_REUSE_ATTR) != nullptr) {
+        // result holds a buffer planned by MPLAN_PASS, maybe at other level
+        fname = "Init_ciph_same_scale_reuse";
+      } else {
+        fname = "Init_ciph_same_scale";
+      }
       two_param = false;
     }
     ctx << fname;
@@ -293,6 +334,11 @@ public:
       ctx << "Hw_modmul(";
       Gen_hw_op_param(visitor, node, val);
       ctx << ")";
+    } else if (val->Opcode() ==
+               air::base::OPCODE(POLYNOMIAL_DID, OPCODE::HW_MODSUB)) {
+      ctx << "Hw_modsub(";
+      Gen_hw_op_param(visitor, node, val);
+      ctx << ")";
     } else if (val->Opcode() ==
                air::base::OPCODE(POLYNOMIAL_DID, OPCODE::HW_ROTATE)) {
       ctx << "Hw_rotate(";
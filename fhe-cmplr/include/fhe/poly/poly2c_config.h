@@ -22,6 +22,8 @@ public:
       : _prov_str("ant"),
         _ct_encode(false),
         _free_poly(false),
+        _mem_plan(false),
+        _pt_cache(false),
         _provider(fhe::core::PROVIDER::ANT),
         _ifile(nullptr) {}
 
@@ -36,26 +38,37 @@ public:
   const char*    Data_file() const { return _data_file.c_str(); }
   const char*    Ifile() const { return _ifile; }
   bool           Emit_data_file() const { return !_data_file.empty(); }
+  const char*    Weight_blob() const { return _weight_blob.c_str(); }
+  bool           Emit_weight_blob() const { return !_weight_blob.empty(); }
   bool           Ct_encode() const { return _ct_encode; }
-  bool           Free_poly() const { return _free_poly; }
+  bool           Free_poly() const { return _free_poly || _mem_plan; }
+  bool           Mem_plan() const { return _mem_plan; }
+  bool           Pt_cache() const { return _pt_cache; }
 
   // leave this member public so that OPTION_DESC can access it
   std::string _prov_str;
-  std::string _data_file;  // place data in a seperated file
-  bool        _ct_encode;  // encode constant at compile-time
-  bool        _free_poly;  // insert free_poly
+  std::string _data_file;    // place data in a seperated file
+  std::string _weight_blob;  // place constant arrays in a binary blob
+  bool        _ct_encode;    // encode constant at compile-time
+  bool        _free_poly;    // insert free_poly
+  bool        _mem_plan;     // share ciphertext buffers by live range
+  bool        _pt_cache;     // cache plaintext encoded at runtime
 
   fhe::core::PROVIDER _provider;  // parsed from _prov_str
   const char*         _ifile;     // set ifile if data_file is set
 };
 
 //! @brief Macro to define API to access POLY2C config
-#define DECLARE_POLY2C_CONFIG_ACCESS_API(cfg)                            \
-  core::PROVIDER Provider() const { return cfg.Provider(); }             \
-  const char*    Data_file() const { return cfg.Data_file(); }           \
-  bool           Emit_data_file() const { return cfg.Emit_data_file(); } \
-  bool           Ct_encode() const { return cfg.Ct_encode(); }           \
-  bool           Free_poly() const { return cfg.Free_poly(); }           \
+#define DECLARE_POLY2C_CONFIG_ACCESS_API(cfg)                                \
+  core::PROVIDER Provider() const { return cfg.Provider(); }                 \
+  const char*    Data_file() const { return cfg.Data_file(); }               \
+  bool           Emit_data_file() const { return cfg.Emit_data_file(); }     \
+  const char*    Weight_blob() const { return cfg.Weight_blob(); }           \
+  bool           Emit_weight_blob() const { return cfg.Emit_weight_blob(); } \
+  bool           Ct_encode() const { return cfg.Ct_encode(); }               \
+  bool           Free_poly() const { return cfg.Free_poly(); }               \
+  bool           Mem_plan() const { return cfg.Mem_plan(); }                 \
+  bool           Pt_cache() const { return cfg.Pt_cache(); }                 \
   DECLARE_COMMON_CONFIG_ACCESS_API(cfg)
 
 }  // namespace poly
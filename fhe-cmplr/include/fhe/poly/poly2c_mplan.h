@@ -0,0 +1,133 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef FHE_POLY_POLY2C_MPLAN_H
+#define FHE_POLY_POLY2C_MPLAN_H
+
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "air/base/container.h"
+#include "air/base/st.h"
+#include "fhe/core/lower_ctx.h"
+
+namespace fhe {
+
+namespace poly {
+
+//! @brief Attribute of INIT_CIPH_* whose result holds a buffer handed over by
+//! MOVE, possibly from a ciphertext at another level
+static constexpr const char* MPLAN_REUSE_ATTR = "mplan_reuse";
+
+//! @brief Live range and slot of a local ciphertext or plaintext
+struct MPLAN_VAR {
+  air::base::ADDR_DATUM_PTR _sym;        //!< variable, or null for preg
+  air::base::PREG_PTR       _preg;       //!< preg, or null for variable
+  air::base::TYPE_PTR       _type;       //!< type of sym or preg
+  uint32_t                  _polys;      //!< number of polys to hold data
+  uint32_t                  _start;      //!< first reference
+  uint32_t                  _end;        //!< last reference including free
+  uint32_t                  _last_use;   //!< last reference except free
+  air::base::STMT_PTR       _first_ref;  //!< stmt of first reference
+  std::vector<air::base::STMT_PTR> _frees;  //!< FREE stmts of the var
+  uint32_t                         _slot;   //!< assigned slot
+  bool _moved;  //!< buffer is handed over by MOVE instead of freed
+};
+
+//! @brief Buffer of a type shared by variables with disjoint live ranges
+struct MPLAN_SLOT {
+  air::base::TYPE_PTR      _type;     //!< CIPHERTEXT or CIPHERTEXT3
+  uint64_t                 _size;     //!< bytes at the top level
+  uint64_t                 _ofst;     //!< offset in the function arena
+  std::vector<std::string> _holders;  //!< holders in live range order
+};
+
+//! @brief Memory planner on POLY IR after MFREE_PASS inserted FREE stmts.
+//! Computes live ranges of local ciphertexts and plaintexts in statement
+//! order, extended over loops they live across, then
+//!  - lets an elementwise add or multiply-plain write its result into the
+//!    buffer of a ciphertext operand dying in that op (in-place)
+//!  - assigns ciphertexts of the same type to shared slots by linear scan,
+//!    realized by handing the buffer of a dead holder to the next one with
+//!    MOVE instead of FREE plus a new allocation
+//! The ring degree is fixed and a slot is sized for the top level. INIT_CIPH_*
+//! of a holder taking a buffer is marked with MPLAN_REUSE_ATTR, so that the
+//! add of two ciphertexts calls Init_ciph_same_scale_reuse instead of
+//! Init_ciph_same_scale, other inits call Init_poly. Both keep the buffer if
+//! it is large enough for the level of the holder and regrow it otherwise,
+//! never shrinking it. Print reports the slot layout and the peak footprint.
+class MPLAN_PASS {
+public:
+  MPLAN_PASS(const fhe::core::LOWER_CTX& ctx) : _lower_ctx(ctx) {}
+
+  void Perform(air::base::FUNC_SCOPE* func);
+
+  //! @brief Print slot layout and peak memory as a C comment
+  void Print(std::ostream& os) const;
+
+private:
+  MPLAN_PASS(const MPLAN_PASS&)            = delete;
+  MPLAN_PASS& operator=(const MPLAN_PASS&) = delete;
+
+  using VAR_MAP = std::unordered_map<uint64_t, uint32_t>;
+
+  void     Analyze(air::base::NODE_PTR body);
+  void     Walk_block(air::base::NODE_PTR blk);
+  void     Walk_stmt(air::base::STMT_PTR stmt);
+  void     Walk_expr(air::base::NODE_PTR node, air::base::STMT_PTR stmt);
+  void     Add_ref(air::base::NODE_PTR node, air::base::STMT_PTR stmt);
+  void     Add_ref(air::base::ADDR_DATUM_PTR sym, air::base::PREG_PTR preg,
+                   air::base::STMT_PTR stmt);
+  void     Extend_over_loops();
+  uint64_t Peak() const;
+  std::vector<uint64_t> Profile() const;  // live bytes at each seq
+  uint64_t Var_size(const MPLAN_VAR& var) const;
+
+  bool Try_in_place(air::base::STMT_PTR stmt);
+  void Rename(air::base::NODE_PTR node, const MPLAN_VAR& from,
+              const MPLAN_VAR& to);
+  bool Elementwise_block(air::base::NODE_PTR blk, const MPLAN_VAR& dst);
+  void Assign_slots();
+  void Insert_move(air::base::STMT_PTR pos, const MPLAN_VAR& dst,
+                   const MPLAN_VAR& src);
+  void Remove_frees(MPLAN_VAR& var);
+
+  MPLAN_VAR* Find_var(air::base::NODE_PTR node);
+  uint32_t   Seq(air::base::STMT_PTR stmt) const;
+  bool       Is_cipher(air::base::TYPE_PTR type) const {
+    return _lower_ctx.Is_cipher_type(type->Id());
+  }
+  bool Is_cipher3(air::base::TYPE_PTR type) const {
+    return _lower_ctx.Is_cipher3_type(type->Id());
+  }
+
+  const fhe::core::LOWER_CTX& _lower_ctx;
+  air::base::FUNC_SCOPE*      _func = nullptr;
+  std::vector<MPLAN_VAR>      _vars;
+  VAR_MAP                     _var_idx;    // sym or preg to _vars index
+  std::unordered_map<uint32_t, uint32_t> _stmt_seq;  // stmt id to seq
+  std::vector<air::base::STMT_PTR>       _stmts;     // stmts in seq order
+  std::vector<uint32_t> _end_seq;  // last seq in stmt, indexed by seq
+  std::vector<std::pair<uint32_t, uint32_t>> _loops;  // seq range of loops
+  std::vector<MPLAN_SLOT>                    _slots;
+  uint32_t _seq        = 0;
+  uint32_t _num_holder = 0;  // ciphertexts assigned to slots
+  uint32_t _num_move   = 0;  // buffers handed over
+  uint32_t _num_ipl    = 0;  // in-place ops
+  uint64_t _peak_free = 0;  // peak with FREE after last use
+  uint64_t _peak_plan = 0;  // peak after planning
+  uint64_t _total     = 0;  // footprint without FREE
+};
+
+}  // namespace poly
+
+}  // namespace fhe
+
+#endif  // FHE_POLY_POLY2C_MPLAN_H
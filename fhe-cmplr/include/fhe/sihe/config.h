@@ -34,12 +34,14 @@ public:
 
   uint32_t Relu_mul_depth() const { return _relu_mul_depth; }
   uint32_t Relu_base_type() const { return _relu_base_type; }
+  bool     Gvn() const { return _gvn; }
 
   // leave this member public so that OPTION_DESC can access it
   std::string _relu_value_range;
   double      _relu_value_range_def_val = 1.0;
   uint32_t    _relu_mul_depth           = 0;
   uint32_t    _relu_base_type           = 0;
+  bool        _gvn                      = false;
 };  // struct SIHE_CONFIG
 
 #define DECLARE_SIHE_CONFIG_ACCESS_API(cfg)                  \
@@ -48,7 +50,8 @@ public:
     return cfg.Relu_value_range(name);                       \
   }                                                          \
   uint32_t Relu_mul_depth() { return cfg.Relu_mul_depth(); } \
-  uint32_t Relu_base_type() { return cfg.Relu_base_type(); }
+  uint32_t Relu_base_type() { return cfg.Relu_base_type(); } \
+  bool     Gvn() { return cfg.Gvn(); }
 
 }  // namespace sihe
 }  // namespace fhe
@@ -152,7 +152,7 @@ RETV TENSOR2SIHE_IMPL::Handle_relu(VISITOR* visitor, NODE_PTR node) {
   // 1. bootstapping before relu: bs_tmp = SIHE.bootstrap(op0)
   PREG_PTR bs_tmp = func_scope->New_preg(cipher_type);
   {
-    TIMING_UTIL timing(ctx, node->Spos(), "FHE::bootstrap", true);
+    TIMING_UTIL timing(ctx, node, "FHE::bootstrap", true);
     NODE_PTR    bs_node    = sihe_gen.Gen_bootstrap(op0, spos);
     STMT_PTR    st_bs_node = cntr->New_stp(bs_node, bs_tmp, spos);
     visitor->Context().Prepend(st_bs_node);
@@ -171,7 +171,7 @@ RETV TENSOR2SIHE_IMPL::Handle_relu(VISITOR* visitor, NODE_PTR node) {
   }
 
   // 2. call App_relu: CORE.call App_relu(bs_tmp)
-  TIMING_UTIL          timing(ctx, node->Spos(), "FHE::relu", false);
+  TIMING_UTIL          timing(ctx, node, "FHE::relu", false);
   PREG_PTR             relu_ret_var     = func_scope->New_preg(cipher_type);
   core::FHE_FUNC_INFO& approx_relu_info = lower_ctx.Get_approx_relu_func_info();
   FUNC_SCOPE* approx_relu = approx_relu_info.Get_func_scope(glob_scope);
@@ -196,8 +196,12 @@ RETV TENSOR2SIHE_IMPL::Handle_relu(VISITOR* visitor, NODE_PTR node) {
   NODE_PTR  ld_formal0  = cntr->New_ldp(bs_tmp, spos);
   relu_call->Node()->Set_child(0, ld_formal0);
 
-  NODE_PTR ld_formal1       = cntr->New_ldp(bs_tmp, spos);
-  double   relu_value_range = ctx.Relu_value_range(node->Attr("name"));
+  NODE_PTR   ld_formal1       = cntr->New_ldp(bs_tmp, spos);
+  double     relu_value_range = ctx.Relu_value_range(node->Attr("name"));
+  const int* vr_scale         = node->Attr<int>(nn::core::ATTR_VR_SCALE);
+  if (vr_scale != nullptr) {
+    relu_value_range *= *vr_scale;
+  }
   ctx.Trace(TRACE_RELU_VR, "Relu range for ", node->Attr("name"), " is [-",
             relu_value_range, ", ", relu_value_range, "]\n");
 
@@ -178,6 +178,17 @@ RETV VECTOR2SIHE_IMPL::Handle_mul(VISITOR* visitor, NODE_PTR node) {
   return RETV(ret);
 }
 
+template <typename RETV, typename VISITOR>
+RETV VECTOR2SIHE_IMPL::Handle_sub(VISITOR* visitor, NODE_PTR node) {
+  // no SUB_MSG to validate against, lower children directly
+  NODE_PTR op0 = visitor->template Visit<RETV>(node->Child(0)).Node();
+  NODE_PTR op1 = visitor->template Visit<RETV>(node->Child(1)).Node();
+  OPCODE   sub_op(SIHE_DOMAIN::ID, SIHE_OPERATOR::SUB);
+  NODE_PTR ret = Lower_bin_arith_node(visitor->Context(), node, sub_op, op0,
+                                      op1);
+  return RETV(ret);
+}
+
 template <typename RETV, typename VISITOR>
 RETV VECTOR2SIHE_IMPL::Handle_roll(VISITOR* visitor, NODE_PTR node) {
   VALIDATE_UTIL<NUM_CHILD::TWO> util(visitor->Context().Container(), false);
@@ -0,0 +1,45 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "fhe/interp/config.h"
+
+using namespace air::base;
+using namespace air::util;
+
+namespace fhe {
+namespace interp {
+
+static INTERP_CONFIG Interp_config;
+
+static OPTION_DESC Interp_option[] = {
+    DECLARE_COMMON_CONFIG(interp, Interp_config),
+    {"input",  "in",  "File of input tensor values separated by space or comma",
+                             &Interp_config._input_file,  air::util::K_STR,    0, V_EQUAL},
+    {"output", "out", "File to write the decoded output values",
+                             &Interp_config._output_file, air::util::K_STR,    0, V_EQUAL},
+    {"seed",   "",    "Seed to generate random input if no input file is given",
+                             &Interp_config._seed,        air::util::K_UINT64, 0, V_EQUAL},
+};
+
+static OPTION_DESC_HANDLE Interp_option_handle = {
+    sizeof(Interp_option) / sizeof(Interp_option[0]), Interp_option};
+
+static OPTION_GRP Interp_option_grp = {
+    "INTERP", "Interpret CKKS IR with the ANT runtime library", ':',
+    air::util::V_EQUAL, &Interp_option_handle};
+
+void INTERP_CONFIG::Register_options(air::driver::DRIVER_CTX* ctx) {
+  ctx->Register_option_group(&Interp_option_grp);
+}
+
+void INTERP_CONFIG::Update_options() { *this = Interp_config; }
+
+void INTERP_CONFIG::Print(std::ostream& os) const { COMMON_CONFIG::Print(os); }
+
+}  // namespace interp
+}  // namespace fhe
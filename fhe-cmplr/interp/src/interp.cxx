@@ -0,0 +1,27 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "fhe/interp/onnx_fhe_interp.h"
+
+int main(int argc, char* argv[]) {
+  fhe::interp::ONNX_FHE_INTERP interp;
+  R_CODE                       ret_code = interp.Init(argc, argv);
+  if (ret_code == R_CODE::NORMAL) {
+    ret_code = interp.Pre_run();
+  } else {
+    return int(ret_code);
+  }
+  if (ret_code == R_CODE::NORMAL) {
+    ret_code = interp.Run();
+  }
+
+  interp.Post_run();
+  interp.Fini();
+
+  return int(ret_code);
+}
@@ -0,0 +1,76 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "fhe/interp/interp_ctx.h"
+
+namespace fhe {
+
+namespace interp {
+
+INTERP_VALUE INTERP_VALUE::New_int(int64_t val) {
+  INTERP_VALUE ret;
+  ret._kind = INT;
+  ret._int  = val;
+  return ret;
+}
+
+INTERP_VALUE INTERP_VALUE::New_float(double val) {
+  INTERP_VALUE ret;
+  ret._kind  = FLOAT;
+  ret._float = val;
+  return ret;
+}
+
+INTERP_VALUE INTERP_VALUE::New_data(const float* data, size_t len) {
+  INTERP_VALUE ret;
+  ret._kind = DATA;
+  ret._data = data;
+  ret._len  = len;
+  return ret;
+}
+
+INTERP_VALUE INTERP_VALUE::New_ciph(CIPHERTEXT* ciph) {
+  INTERP_VALUE ret;
+  ret._kind = CIPH;
+  if (ciph != nullptr) {
+    ret._obj.reset(ciph, [](void* p) { Free_ciphertext((CIPHERTEXT*)p); });
+  }
+  return ret;
+}
+
+INTERP_VALUE INTERP_VALUE::New_ciph3(CIPHERTEXT3* ciph) {
+  INTERP_VALUE ret;
+  ret._kind = CIPH3;
+  ret._obj.reset(ciph, [](void* p) { Free_ciphertext3((CIPHERTEXT3*)p); });
+  return ret;
+}
+
+INTERP_VALUE INTERP_VALUE::New_plain(PLAINTEXT* plain) {
+  INTERP_VALUE ret;
+  ret._kind = PLAIN;
+  ret._obj.reset(plain, [](void* p) { Free_plaintext((PLAINTEXT*)p); });
+  return ret;
+}
+
+INTERP_VALUE INTERP_CTX::Encode(const float* data, size_t len,
+                                uint32_t sc_degree, uint32_t level) {
+  PLAINTEXT* plain = Alloc_plaintext();
+  Encode_plain_from_float(plain, const_cast<float*>(data), len, sc_degree,
+                          level);
+  return INTERP_VALUE::New_plain(plain);
+}
+
+INTERP_VALUE INTERP_CTX::Encode_scalar(const INTERP_VALUE& num,
+                                       CIPHERTEXT* ciph, bool same_scale) {
+  float val = num.Float_val();
+  return Encode(&val, 1, same_scale ? Sc_degree(ciph) : 1, Level(ciph));
+}
+
+}  // namespace interp
+
+}  // namespace fhe
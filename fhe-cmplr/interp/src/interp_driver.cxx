@@ -0,0 +1,223 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "fhe/interp/interp_driver.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "air/base/visitor.h"
+#include "air/core/handler.h"
+#include "fhe/ckks/ckks_handler.h"
+#include "fhe/interp/ckks_handler.h"
+#include "fhe/interp/core_handler.h"
+#include "fhe/interp/interp_ctx.h"
+#include "fhe/interp/vector_handler.h"
+#include "nn/vector/handler.h"
+
+using namespace air::base;
+
+namespace fhe {
+
+namespace interp {
+
+INTERP_DRIVER* INTERP_DRIVER::_running = nullptr;
+
+INTERP_DRIVER::~INTERP_DRIVER() {
+  free(_params);
+  free(_enc_scheme);
+  free(_dec_scheme);
+}
+
+// name of the variable returned by program entry, which is the name of
+// output data passed to Set_output_data
+static const char* Output_name(FUNC_SCOPE* func) {
+  NODE_PTR body = func->Container().Entry_node()->Body_blk();
+  for (STMT_PTR stmt = body->Begin_stmt(); stmt != body->End_stmt();
+       stmt          = stmt->Next()) {
+    NODE_PTR node = stmt->Node();
+    if (node->Opcode() == air::core::OPC_RETV &&
+        node->Child(0)->Opcode() == air::core::OPC_LD) {
+      return node->Child(0)->Addr_datum()->Base_sym()->Name()->Char_str();
+    }
+  }
+  AIR_ASSERT_MSG(false, "program entry does not return a variable");
+  return nullptr;
+}
+
+std::vector<double> INTERP_DRIVER::Run(GLOB_SCOPE*                 glob,
+                                       const std::vector<int64_t>& input_shape,
+                                       const std::vector<double>&  input) {
+  for (GLOB_SCOPE::FUNC_SCOPE_ITER it = glob->Begin_func_scope();
+       it != glob->End_func_scope(); ++it) {
+    if ((*it).Owning_func()->Entry_point()->Is_program_entry()) {
+      _main = &(*it);
+      break;
+    }
+  }
+  AIR_ASSERT_MSG(_main != nullptr, "no program entry in IR");
+  AIR_ASSERT_MSG(
+      _main->Container().Entry_node()->Num_child() - 1 == 1,
+      "only program entry with single input is supported");
+  _input_name  = _main->Formal(0)->Name()->Char_str();
+  _output_name = Output_name(_main);
+  _input_shape = input_shape;
+
+  AIR_ASSERT(_running == nullptr);
+  _running = this;
+  Prepare_context();
+
+  // 1. encrypt input with encode scheme
+  int64_t nchw[4] = {1, 1, 1, 1};
+  for (size_t i = 0; i < input_shape.size(); ++i) {
+    nchw[std::min(i, (size_t)3)] *= input_shape[i];
+  }
+  AIR_ASSERT_MSG(nchw[0] * nchw[1] * nchw[2] * nchw[3] == (int64_t)input.size(),
+                 "input size %d mismatch with shape", (int)input.size());
+  TENSOR* tensor = Alloc_tensor(nchw[0], nchw[1], nchw[2], nchw[3],
+                                input.data());
+  Prepare_input(tensor, _input_name.c_str());
+  Free_tensor(tensor);
+
+  // 2. call back to Main_graph() to interpret program entry
+  Run_main_graph();
+
+  // 3. decrypt output with decode scheme
+  size_t len = 0;
+  if (_lower_ctx.Is_batch_packed()) {
+    len = _dec_scheme->_shape._n * _dec_scheme->_desc[0]._count;
+  } else {
+    len = _lower_ctx.Get_ctx_param().Get_poly_degree() / 2;
+  }
+  double*             data = Handle_output(_output_name.c_str());
+  std::vector<double> output(data, data + len);
+  free(data);
+
+  Finalize_context();
+  _running = nullptr;
+  Trace(TRACE_INTERP, "interp: ", _op_count, " CKKS operators executed\n");
+  return output;
+}
+
+CKKS_PARAMS* INTERP_DRIVER::Context_params() {
+  if (_params != nullptr) return _params;
+  const core::CTX_PARAM&   param    = _lower_ctx.Get_ctx_param();
+  const std::set<int32_t>& rot_keys = param.Get_rotate_index();
+  _params = (CKKS_PARAMS*)malloc(sizeof(CKKS_PARAMS) +
+                                 rot_keys.size() * sizeof(int32_t));
+  _params->_provider         = LIB_ANT;
+  _params->_poly_degree      = param.Get_poly_degree();
+  _params->_sec_level        = param.Get_security_level();
+  _params->_mul_depth        = param.Get_mul_level();
+  _params->_first_mod_size   = param.Get_first_prime_bit_num();
+  _params->_scaling_mod_size = param.Get_scaling_factor_bit_num();
+  _params->_num_q_parts      = param.Get_q_part_num();
+  _params->_hamming_weight   = param.Get_hamming_weight();
+  _params->_num_rot_idx      = rot_keys.size();
+  std::copy(rot_keys.begin(), rot_keys.end(), _params->_rot_idxs);
+  return _params;
+}
+
+// same layout as the scheme emitted by POLY2C: plain flatten for a single
+// image, or image n at slot n*block for a batch packed by BATCH_PACK
+DATA_SCHEME* INTERP_DRIVER::New_scheme(const char*                 name,
+                                       const std::vector<int64_t>& shape) {
+  DATA_SCHEME* scheme =
+      (DATA_SCHEME*)malloc(sizeof(DATA_SCHEME) + sizeof(MAP_DESC));
+  memset(scheme, 0, sizeof(DATA_SCHEME) + sizeof(MAP_DESC));
+  scheme->_name           = name;
+  scheme->_count          = 1;
+  scheme->_desc[0]._kind  = NORMAL;
+  if (!_lower_ctx.Is_batch_packed()) return scheme;
+
+  int64_t nchw[4] = {1, 1, 1, 1};
+  for (size_t i = 0; i < shape.size(); ++i) {
+    nchw[std::min(i, (size_t)3)] *= shape[i];
+  }
+  int64_t block = _lower_ctx.Get_batch_block();
+  int64_t count = nchw[1] * nchw[2] * nchw[3];
+  AIR_ASSERT_MSG(count <= block, "image size %d exceeds batch block %d",
+                 (int)count, (int)block);
+  scheme->_shape           = {(size_t)nchw[0], (size_t)nchw[1],
+                              (size_t)nchw[2], (size_t)nchw[3]};
+  scheme->_desc[0]._count  = count;
+  scheme->_desc[0]._end    = (nchw[0] - 1) * block + count - 1;
+  scheme->_desc[0]._stride = block;
+  return scheme;
+}
+
+DATA_SCHEME* INTERP_DRIVER::Encode_scheme(int idx) {
+  AIR_ASSERT(idx == 0);
+  if (_enc_scheme == nullptr) {
+    const std::vector<int64_t>& shape = _lower_ctx.Is_batch_packed()
+                                            ? _lower_ctx.Get_batch_input_shape()
+                                            : _input_shape;
+    _enc_scheme = New_scheme(_input_name.c_str(), shape);
+  }
+  return _enc_scheme;
+}
+
+DATA_SCHEME* INTERP_DRIVER::Decode_scheme(int idx) {
+  AIR_ASSERT(idx == 0);
+  if (_dec_scheme == nullptr) {
+    std::vector<int64_t> shape;
+    if (_lower_ctx.Is_batch_packed()) {
+      shape = _lower_ctx.Get_batch_output_shape();
+    }
+    _dec_scheme = New_scheme(_output_name.c_str(), shape);
+  }
+  return _dec_scheme;
+}
+
+bool INTERP_DRIVER::Main_graph() {
+  using CORE = air::core::HANDLER<CORE_HANDLER>;
+  using CKKS = fhe::ckks::HANDLER<CKKS_HANDLER>;
+  using VEC  = nn::vector::HANDLER<VECTOR_HANDLER>;
+  INTERP_CTX ctx(_lower_ctx, _config);
+  ctx.Set_output_name(_output_name.c_str());
+  air::base::VISITOR<INTERP_CTX, CORE, CKKS, VEC> visitor(ctx);
+
+  // formal of program entry comes from encrypted input
+  CIPHERTEXT* input = Alloc_ciphertext();
+  *input            = Get_input_data(_input_name.c_str(), 0);
+  std::vector<INTERP_VALUE> args{INTERP_VALUE::New_ciph(input)};
+  ctx.Call(&visitor, _main, args);
+  _op_count = ctx.Op_count();
+  return true;
+}
+
+}  // namespace interp
+
+}  // namespace fhe
+
+using fhe::interp::INTERP_DRIVER;
+
+// runtime hooks normally emitted by POLY2C into the generated C file
+extern "C" {
+
+CKKS_PARAMS* Get_context_params() {
+  return INTERP_DRIVER::Running()->Context_params();
+}
+
+RT_DATA_INFO* Get_rt_data_info() { return NULL; }
+
+int Get_input_count() { return INTERP_DRIVER::Running()->Input_count(); }
+
+DATA_SCHEME* Get_encode_scheme(int idx) {
+  return INTERP_DRIVER::Running()->Encode_scheme(idx);
+}
+
+int Get_output_count() { return INTERP_DRIVER::Running()->Output_count(); }
+
+DATA_SCHEME* Get_decode_scheme(int idx) {
+  return INTERP_DRIVER::Running()->Decode_scheme(idx);
+}
+
+bool Main_graph() { return INTERP_DRIVER::Running()->Main_graph(); }
+
+}  // extern "C"
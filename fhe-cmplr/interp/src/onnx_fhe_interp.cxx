@@ -0,0 +1,180 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "fhe/interp/onnx_fhe_interp.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#include "air/core/opcode.h"
+#include "fhe/ckks/ckks_opcode.h"
+#include "fhe/interp/interp_driver.h"
+#include "fhe/poly/opcode.h"
+#include "fhe/sihe/sihe_opcode.h"
+#include "nn/core/opcode.h"
+#include "nn/vector/vector_opcode.h"
+
+using namespace air::base;
+
+namespace fhe {
+
+namespace interp {
+
+ONNX_FHE_INTERP::ONNX_FHE_INTERP()
+    : air::driver::DRIVER(true), _fhe_cmplr(false), _output_count(0) {
+  bool ret;
+  ret = air::core::Register_core();
+  AIR_ASSERT(ret);
+  ret = nn::core::Register_nn();
+  AIR_ASSERT(ret);
+  ret = nn::vector::Register_vector_domain();
+  AIR_ASSERT(ret);
+  ret = fhe::sihe::Register_sihe_domain();
+  AIR_ASSERT(ret);
+  ret = fhe::ckks::Register_ckks_domain();
+  AIR_ASSERT(ret);
+  ret = fhe::poly::Register_polynomial();
+  AIR_ASSERT(ret);
+}
+
+R_CODE ONNX_FHE_INTERP::Init(int argc, char** argv) {
+  R_CODE ret_code = _onnx_pass.Init(this);
+  if (ret_code == R_CODE::NORMAL) {
+    ret_code = _fhe_cmplr.Init(this);
+  } else {
+    return ret_code;
+  }
+  if (ret_code == R_CODE::NORMAL) {
+    _config.Register_options(Context());
+    return air::driver::DRIVER::Init(argc, argv);
+  } else {
+    return ret_code;
+  }
+}
+
+R_CODE ONNX_FHE_INTERP::Pre_run() {
+  R_CODE ret_code = _onnx_pass.Pre_run(this);
+  if (ret_code == R_CODE::NORMAL) {
+    ret_code = _fhe_cmplr.Pre_run();
+  }
+  // stop at CKKS IR, which is interpreted instead of lowered to C
+  _fhe_cmplr.Disable_poly_pass();
+  _fhe_cmplr.Disable_poly2c_pass();
+  _config.Update_options();
+  return ret_code;
+}
+
+R_CODE ONNX_FHE_INTERP::Run() {
+  R_CODE ret_code = _onnx_pass.Run(this);
+  if (ret_code != R_CODE::NORMAL) {
+    return ret_code;
+  }
+
+  // input and output shape of main graph before they are flattened
+  for (FUNC_ITER it = Glob_scope()->Begin_func();
+       it != Glob_scope()->End_func(); ++it) {
+    if (!(*it)->Entry_point()->Is_program_entry()) continue;
+    SIGNATURE_TYPE_PTR sig = (*it)->Entry_point()->Type()->Cast_to_sig();
+    for (PARAM_ITER pit = sig->Begin_param(); pit != sig->End_param(); ++pit) {
+      if (!(*pit)->Type()->Is_array()) continue;
+      ARRAY_TYPE_PTR type = (*pit)->Type()->Cast_to_arr();
+      if ((*pit)->Is_ret()) {
+        _output_count = type->Elem_count();
+      } else if (_input_shape.empty()) {
+        _input_shape = type->Shape();
+      }
+    }
+  }
+  AIR_ASSERT_MSG(!_input_shape.empty() && _output_count > 0,
+                 "main graph must take and return a tensor");
+
+  ret_code = _fhe_cmplr.Run();
+  if (ret_code != R_CODE::NORMAL) {
+    return ret_code;
+  }
+
+  std::vector<double> input;
+  if (!Prepare_input(input)) {
+    return R_CODE::USER;
+  }
+  INTERP_DRIVER       interp(Context(), _fhe_cmplr.Lower_ctx(), _config);
+  std::vector<double> output = interp.Run(Glob_scope(), _input_shape, input);
+  if (!_fhe_cmplr.Lower_ctx().Is_batch_packed() &&
+      output.size() > (size_t)_output_count) {
+    output.resize(_output_count);
+  }
+  return Write_output(output) ? R_CODE::NORMAL : R_CODE::USER;
+}
+
+void ONNX_FHE_INTERP::Post_run() {
+  _fhe_cmplr.Post_run();
+  _onnx_pass.Post_run(this);
+}
+
+void ONNX_FHE_INTERP::Fini() {
+  _fhe_cmplr.Fini();
+  _onnx_pass.Fini(this);
+}
+
+bool ONNX_FHE_INTERP::Prepare_input(std::vector<double>& input) {
+  int64_t count = 1;
+  for (int64_t dim : _input_shape) count *= dim;
+
+  if (!_config.Has_input_file()) {
+    // uniform [-1, 1) which is the valid input range of CKKS approximation
+    std::mt19937_64                        gen(_config.Seed());
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    input.resize(count);
+    std::generate(input.begin(), input.end(), [&]() { return dist(gen); });
+    return true;
+  }
+
+  std::ifstream ifs(_config.Input_file());
+  if (!ifs.is_open()) {
+    CMPLR_USR_MSG(U_CODE::Incorrect_Option, "cannot open -INTERP:in file");
+    return false;
+  }
+  std::string text((std::istreambuf_iterator<char>(ifs)),
+                   std::istreambuf_iterator<char>());
+  std::replace(text.begin(), text.end(), ',', ' ');
+  std::istringstream iss(text);
+  double             val;
+  while (iss >> val) input.push_back(val);
+  if ((int64_t)input.size() != count) {
+    CMPLR_USR_MSG(U_CODE::Incorrect_Option,
+                  "number of values in -INTERP:in file mismatch input shape");
+    return false;
+  }
+  return true;
+}
+
+bool ONNX_FHE_INTERP::Write_output(const std::vector<double>& output) {
+  std::ofstream ofs;
+  if (_config.Has_output_file()) {
+    ofs.open(_config.Output_file());
+    if (!ofs.is_open()) {
+      CMPLR_USR_MSG(U_CODE::Incorrect_Option, "cannot open -INTERP:out file");
+      return false;
+    }
+  }
+  std::ostream& os = _config.Has_output_file() ? ofs : std::cout;
+  os << std::setprecision(6) << std::fixed;
+  for (size_t i = 0; i < output.size(); ++i) {
+    bool eol = (i + 1) % 8 == 0 || i + 1 == output.size();
+    os << output[i] << (eol ? "\n" : " ");
+  }
+  return true;
+}
+
+}  // namespace interp
+
+}  // namespace fhe
@@ -0,0 +1,115 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "fhe/interp/onnx_fhe_interp.h"
+#include "gtest/gtest.h"
+#include "onnx.pb.h"
+
+using namespace onnx;
+
+namespace {
+
+void Add_value_info(ValueInfoProto* info, const char* name,
+                    const std::vector<int64_t>& shape) {
+  info->set_name(name);
+  auto* type = info->mutable_type()->mutable_tensor_type();
+  type->set_elem_type(TensorProto_DataType_FLOAT);
+  for (int64_t dim : shape) {
+    type->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+}
+
+void Add_initializer(GraphProto* graph, const char* name,
+                     const std::vector<int64_t>& shape,
+                     const std::vector<float>&   data) {
+  TensorProto* init = graph->add_initializer();
+  init->set_name(name);
+  init->set_data_type(TensorProto_DataType_FLOAT);
+  for (int64_t dim : shape) init->add_dims(dim);
+  // onnx2air only reads initializers in raw format
+  init->set_raw_data(data.data(), data.size() * sizeof(float));
+}
+
+// y = x * w^T + b with x of [1, W] and w of [H, W]
+void Write_gemm_model(const std::string& file, int h, int w,
+                      const std::vector<float>& weight,
+                      const std::vector<float>& bias) {
+  ModelProto model;
+  model.set_ir_version(7);
+  model.add_opset_import()->set_version(13);
+  GraphProto* graph = model.mutable_graph();
+  graph->set_name("interp_gemm");
+  NodeProto* node = graph->add_node();
+  node->add_input("x");
+  node->add_input("w");
+  node->add_input("b");
+  node->add_output("y");
+  node->set_name("gemm0");
+  node->set_op_type("Gemm");
+  AttributeProto* attr = node->add_attribute();
+  attr->set_name("transB");
+  attr->set_type(AttributeProto_AttributeType_INT);
+  attr->set_i(1);
+  Add_initializer(graph, "w", {h, w}, weight);
+  Add_initializer(graph, "b", {h}, bias);
+  Add_value_info(graph->add_input(), "x", {1, w});
+  Add_value_info(graph->add_output(), "y", {1, h});
+
+  std::ofstream ofs(file, std::ios::binary);
+  ASSERT_TRUE(model.SerializeToOstream(&ofs));
+}
+
+}  // namespace
+
+// compile an ONNX Gemm down to CKKS IR, interpret it on the ANT runtime and
+// compare the decrypted output with the plain computation
+TEST(INTERP, gemm_end_to_end) {
+  const int          H = 4, W = 16;
+  std::vector<float> weight(H * W), bias(H), input(W);
+  for (int i = 0; i < H * W; ++i) weight[i] = (float)((i * 37 % 29) - 14) / 16;
+  for (int i = 0; i < H; ++i) bias[i] = 0.25f * (i - 1);
+  for (int i = 0; i < W; ++i) input[i] = (float)((i * 11 % 13) - 6) / 8;
+
+  std::string dir      = testing::TempDir();
+  std::string model    = dir + "interp_gemm.onnx";
+  std::string in_file  = dir + "interp_gemm.in";
+  std::string out_file = dir + "interp_gemm.out";
+  Write_gemm_model(model, H, W, weight, bias);
+  {
+    std::ofstream ofs(in_file);
+    for (float val : input) ofs << val << ",";
+  }
+
+  std::string        in_opt  = "-INTERP:in=" + in_file;
+  std::string        out_opt = "-INTERP:out=" + out_file;
+  std::vector<char*> argv    = {(char*)"fhe_interp", (char*)model.c_str(),
+                                (char*)in_opt.c_str(), (char*)out_opt.c_str()};
+
+  fhe::interp::ONNX_FHE_INTERP interp;
+  ASSERT_EQ(interp.Init(argv.size(), argv.data()), R_CODE::NORMAL);
+  ASSERT_EQ(interp.Pre_run(), R_CODE::NORMAL);
+  ASSERT_EQ(interp.Run(), R_CODE::NORMAL);
+  interp.Post_run();
+  interp.Fini();
+
+  std::ifstream       ifs(out_file);
+  std::vector<double> output;
+  double              val;
+  while (ifs >> val) output.push_back(val);
+  ASSERT_EQ(output.size(), (size_t)H);
+  for (int i = 0; i < H; ++i) {
+    double expect = bias[i];
+    for (int j = 0; j < W; ++j) expect += weight[i * W + j] * input[j];
+    EXPECT_NEAR(output[i], expect, 1e-2) << "output " << i;
+  }
+}
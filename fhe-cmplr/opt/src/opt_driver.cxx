@@ -0,0 +1,151 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "fhe/opt/opt_driver.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "air/opt/dce.h"
+#include "air/opt/gvn.h"
+#include "air/opt/licm.h"
+#include "air/opt/ssa_build.h"
+#include "air/util/parallel.h"
+
+using namespace air::base;
+
+namespace fhe {
+
+namespace opt {
+
+// global strings reserved for temporaries created in each function when
+// functions are optimized concurrently, exceeding it is asserted
+static constexpr uint32_t TMP_PER_FUNC = 4096;
+
+static const char* Level_name(OPT_LEVEL level) {
+  switch (level) {
+    case OPT_LEVEL::SIHE:
+      return "SIHE";
+    case OPT_LEVEL::CKKS:
+      return "CKKS";
+    default:
+      return "POLY";
+  }
+}
+
+// Simple SSA expects blocks owned by IF/DO_LOOP only. Move statements of a
+// nested block statement, which is created by POLY lowering, into the
+// enclosing block. Blocks don't introduce scope so semantics is kept.
+static void Flatten_block(NODE_PTR blk) {
+  STMT_LIST list(blk);
+  for (STMT_PTR stmt = blk->Begin_stmt(); stmt != blk->End_stmt();) {
+    STMT_PTR next = stmt->Next();
+    NODE_PTR node = stmt->Node();
+    if (node->Is_block()) {
+      Flatten_block(node);
+      STMT_LIST inner(node);
+      while (!inner.Is_empty()) {
+        STMT_PTR kid = inner.Begin_stmt();
+        inner.Remove(kid);
+        list.Prepend(stmt, kid);
+      }
+      list.Remove(stmt);
+    } else {
+      for (uint32_t i = 0; i < node->Num_child(); ++i) {
+        if (node->Child(i)->Is_block()) {
+          Flatten_block(node->Child(i));
+        }
+      }
+    }
+    stmt = next;
+  }
+}
+
+// Collect functions of glob to be optimized concurrently by Parallel_for
+static std::vector<FUNC_SCOPE*> Func_list(GLOB_SCOPE* glob, uint32_t jobs) {
+  std::vector<FUNC_SCOPE*> func;
+  for (GLOB_SCOPE::FUNC_SCOPE_ITER it = glob->Begin_func_scope();
+       it != glob->End_func_scope(); ++it) {
+    func.push_back(&(*it));
+  }
+  if (jobs > 1) {
+    // temporaries created by GVN/LICM are named with global strings
+    glob->Reserve_str_const(TMP_PER_FUNC * func.size());
+  }
+  return func;
+}
+
+void Opt_driver(GLOB_SCOPE* glob, const core::LOWER_CTX* lower_ctx,
+                const air::driver::DRIVER_CTX*  driver_ctx,
+                const air::util::COMMON_CONFIG& config, OPT_LEVEL level) {
+  std::vector<FUNC_SCOPE*> func = Func_list(glob, driver_ctx->Jobs());
+  std::vector<std::string> stat(func.size());
+  air::util::Parallel_for(func.size(), driver_ctx->Jobs(), [&](uint32_t i) {
+    FHE_OPT_POLICY policy(lower_ctx, level);
+    Flatten_block(func[i]->Container().Entry_node()->Body_blk());
+
+    // 1. GVN on SSA of original IR
+    air::opt::SSA_CONTAINER gvn_ssa(&func[i]->Container());
+    air::opt::SSA_BUILDER(func[i], &gvn_ssa, driver_ctx).Perform();
+    air::opt::GVN gvn(func[i], &gvn_ssa, &policy);
+    gvn.Perform();
+
+    // 2. DCE on SSA rebuilt after GVN, which leaves dead stores behind
+    air::opt::SSA_CONTAINER dce_ssa(&func[i]->Container());
+    air::opt::SSA_BUILDER(func[i], &dce_ssa, driver_ctx).Perform();
+    air::opt::DCE dce(func[i], &dce_ssa, &policy);
+    dce.Perform();
+
+    if (config.Trace_stat()) {
+      std::ostringstream os;
+      os << "#### " << Level_name(level) << " GVN/DCE of "
+         << func[i]->Owning_func()->Name()->Char_str() << ": "
+         << gvn.Num_redundant() << " redundant expr (" << gvn.Num_tmp()
+         << " tmp), " << gvn.Num_store() << " redundant store, "
+         << dce.Num_dead() << " dead store. Eliminated " << policy.Num_op()
+         << " FHE op, " << policy.Num_rotate() << " rotate, "
+         << policy.Num_encode() << " encode, " << policy.Num_key_switch()
+         << " key switch" << std::endl;
+      stat[i] = os.str();
+    }
+  });
+  if (driver_ctx->Jobs() > 1) glob->Release_str_const();
+  // trace in function order whatever the thread finishing first
+  for (const std::string& str : stat) {
+    driver_ctx->Trace() << str;
+  }
+}
+
+void Licm_driver(GLOB_SCOPE* glob, const core::LOWER_CTX* lower_ctx,
+                 const air::driver::DRIVER_CTX*  driver_ctx,
+                 const air::util::COMMON_CONFIG& config, OPT_LEVEL level) {
+  std::vector<FUNC_SCOPE*> func = Func_list(glob, driver_ctx->Jobs());
+  std::vector<std::string> stat(func.size());
+  air::util::Parallel_for(func.size(), driver_ctx->Jobs(), [&](uint32_t i) {
+    FHE_OPT_POLICY policy(lower_ctx, level);
+    air::opt::LICM licm(func[i], &policy);
+    licm.Perform();
+
+    if (config.Trace_stat()) {
+      std::ostringstream os;
+      os << "#### " << Level_name(level) << " LICM of "
+         << func[i]->Owning_func()->Name()->Char_str() << ": "
+         << licm.Num_hoisted() << " hoisted expr" << std::endl;
+      stat[i] = os.str();
+    }
+  });
+  if (driver_ctx->Jobs() > 1) glob->Release_str_const();
+  for (const std::string& str : stat) {
+    driver_ctx->Trace() << str;
+  }
+}
+
+}  // namespace opt
+
+}  // namespace fhe
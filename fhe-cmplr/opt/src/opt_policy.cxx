@@ -0,0 +1,117 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "fhe/opt/opt_policy.h"
+
+#include "fhe/ckks/ckks_opcode.h"
+#include "fhe/poly/opcode.h"
+#include "fhe/sihe/sihe_opcode.h"
+#include "nn/vector/vector_opcode.h"
+
+using namespace air::base;
+
+namespace fhe {
+
+namespace opt {
+
+bool FHE_OPT_POLICY::Is_pure(NODE_PTR node) const {
+  switch (node->Domain()) {
+    case air::core::CORE:
+      return OPT_POLICY::Is_pure(node);
+    case nn::vector::VECTOR_DOMAIN::ID:
+      // select constant data to be encoded
+      return node->Opcode() == nn::vector::OPC_SLICE;
+    case sihe::SIHE_DOMAIN::ID:
+      return node->Opcode() == sihe::OPC_ROTATE ||
+             node->Opcode() == sihe::OPC_ADD ||
+             node->Opcode() == sihe::OPC_SUB ||
+             node->Opcode() == sihe::OPC_MUL ||
+             node->Opcode() == sihe::OPC_NEG ||
+             node->Opcode() == sihe::OPC_ENCODE;
+    case ckks::CKKS_DOMAIN::ID:
+      return node->Opcode() != ckks::OPC_BOOTSTRAP;
+    case poly::POLYNOMIAL_DID:
+      return node->Opcode() == poly::OPC_DEGREE ||
+             node->Opcode() == poly::OPC_Q_MODULUS ||
+             node->Opcode() == poly::OPC_P_MODULUS ||
+             node->Opcode() == poly::OPC_NUM_DECOMP ||
+             node->Opcode() == poly::OPC_AUTO_ORDER ||
+             node->Opcode() == poly::OPC_SWK ||
+             node->Opcode() == poly::OPC_PK0_AT ||
+             node->Opcode() == poly::OPC_PK1_AT;
+    default:
+      return false;
+  }
+}
+
+bool FHE_OPT_POLICY::Is_value_type(TYPE_PTR type) const {
+  if (_level != OPT_LEVEL::POLY) {
+    return true;
+  }
+  return type->Is_prim() || type->Is_ptr();
+}
+
+bool FHE_OPT_POLICY::Is_copyable(TYPE_PTR type) const {
+  // plaintext is assigned shallowly in generated code
+  return !_lower_ctx->Is_plain_type(type->Id());
+}
+
+bool FHE_OPT_POLICY::Is_worth_sharing(NODE_PTR node) const {
+  if (_level == OPT_LEVEL::POLY) {
+    return false;
+  }
+  return node->Opcode() == sihe::OPC_ROTATE ||
+         node->Opcode() == sihe::OPC_MUL ||
+         node->Opcode() == sihe::OPC_ENCODE ||
+         node->Opcode() == ckks::OPC_ROTATE ||
+         node->Opcode() == ckks::OPC_MUL ||
+         node->Opcode() == ckks::OPC_ENCODE ||
+         node->Opcode() == ckks::OPC_RELIN ||
+         node->Opcode() == ckks::OPC_RESCALE ||
+         node->Opcode() == ckks::OPC_UPSCALE ||
+         node->Opcode() == ckks::OPC_MOD_SWITCH;
+}
+
+const char* FHE_OPT_POLICY::Tmp_prefix() const {
+  switch (_level) {
+    case OPT_LEVEL::SIHE:
+      return "_sihe_gvn_";
+    case OPT_LEVEL::CKKS:
+      return "_ckks_gvn_";
+    default:
+      return "_poly_gvn_";
+  }
+}
+
+void FHE_OPT_POLICY::Eliminate(NODE_PTR node) {
+  if (node->Domain() != sihe::SIHE_DOMAIN::ID &&
+      node->Domain() != ckks::CKKS_DOMAIN::ID &&
+      node->Domain() != poly::POLYNOMIAL_DID) {
+    return;
+  }
+  ++_num_op;
+  if (node->Opcode() == sihe::OPC_ROTATE ||
+      node->Opcode() == ckks::OPC_ROTATE) {
+    ++_num_rotate;
+    ++_num_key_switch;
+  } else if (node->Opcode() == sihe::OPC_ENCODE ||
+             node->Opcode() == ckks::OPC_ENCODE) {
+    ++_num_encode;
+  } else if (node->Opcode() == ckks::OPC_RELIN) {
+    ++_num_key_switch;
+  } else if (node->Opcode() == sihe::OPC_MUL &&
+             _lower_ctx->Is_cipher_type(node->Child(0)->Rtype_id()) &&
+             _lower_ctx->Is_cipher_type(node->Child(1)->Rtype_id())) {
+    // relinearized when lowered to CKKS
+    ++_num_key_switch;
+  }
+}
+
+}  // namespace opt
+
+}  // namespace fhe
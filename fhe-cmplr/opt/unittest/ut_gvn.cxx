@@ -0,0 +1,116 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "air/base/meta_info.h"
+#include "air/core/opcode.h"
+#include "air/driver/driver_ctx.h"
+#include "air/opt/gvn.h"
+#include "air/opt/ssa_build.h"
+#include "fhe/ckks/ckks_gen.h"
+#include "fhe/ckks/ckks_opcode.h"
+#include "fhe/opt/opt_policy.h"
+#include "fhe/sihe/sihe_gen.h"
+#include "gtest/gtest.h"
+
+using namespace air::base;
+using namespace fhe::core;
+
+namespace {
+
+class TEST_GVN : public ::testing::Test {
+protected:
+  void SetUp() override {
+    META_INFO::Remove_all();
+    air::core::Register_core();
+    fhe::ckks::Register_ckks_domain();
+    _glob = GLOB_SCOPE::Get();
+    _spos = _glob->Unknown_simple_spos();
+    fhe::sihe::SIHE_GEN(_glob, &_lower_ctx).Register_sihe_types();
+    fhe::ckks::CKKS_GEN(_glob, &_lower_ctx).Register_ckks_types();
+    _ciph_ty = _glob->Type(_lower_ctx.Get_cipher_type_id());
+
+    // void main(ciph_x)
+    STR_PTR  name = _glob->New_str("main");
+    FUNC_PTR func = _glob->New_func(name, _spos);
+    func->Set_parent(_glob->Comp_env_id());
+    SIGNATURE_TYPE_PTR sig = _glob->New_sig_type();
+    _glob->New_ret_param(_glob->Prim_type(PRIMITIVE_TYPE::VOID), sig);
+    _glob->New_param(_glob->New_str("ciph_x"), _ciph_ty, sig, _spos);
+    sig->Set_complete();
+    _glob->New_global_entry_point(sig, func, name, _spos);
+    _func = &_glob->New_func_scope(func);
+    _cntr = &_func->Container();
+    _cntr->New_func_entry(_spos);
+  }
+
+  void TearDown() override { META_INFO::Remove_all(); }
+
+  typedef std::vector<std::pair<FHE_ATTR_KIND, uint32_t>> ATTR_VEC;
+
+  // z = rotate(x, rot) with attributes set in the order of attr
+  NODE_PTR Gen_rotate(const char* z, int32_t rot, const ATTR_VEC& attr) {
+    NODE_PTR rotate =
+        _cntr->New_cust_node(fhe::ckks::OPC_ROTATE, _ciph_ty, _spos);
+    rotate->Set_child(0, _cntr->New_ld(_func->Formal(0), _spos));
+    rotate->Set_child(
+        1, _cntr->New_intconst(_glob->Prim_type(PRIMITIVE_TYPE::INT_S32), rot,
+                               _spos));
+    for (const auto& kv : attr) {
+      rotate->Set_attr(_lower_ctx.Attr_name(kv.first), &kv.second, 1);
+    }
+    ADDR_DATUM_PTR var = _func->New_var(_ciph_ty, _glob->New_str(z), _spos);
+    _cntr->Stmt_list().Append(_cntr->New_st(rotate, var, _spos));
+    return rotate;
+  }
+
+  GLOB_SCOPE* _glob = nullptr;
+  FUNC_SCOPE* _func = nullptr;
+  CONTAINER*  _cntr = nullptr;
+  TYPE_PTR    _ciph_ty;
+  SPOS        _spos;
+  LOWER_CTX   _lower_ctx;
+};
+
+// CKKS operators are pure, but the same operator on the same operands is only
+// redundant if scale and level attributes are the same as well
+TEST_F(TEST_GVN, ckks_attr) {
+  Gen_rotate("z1", 5, {{LEVEL, 3}});
+  Gen_rotate("z2", 5, {{LEVEL, 3}});
+  NODE_PTR lower = Gen_rotate("z3", 5, {{LEVEL, 2}});
+  Gen_rotate("z4", 4, {{SCALE, 2}, {LEVEL, 3}});
+  Gen_rotate("z5", 4, {{LEVEL, 3}, {SCALE, 2}});
+
+  air::driver::DRIVER_CTX  driver_ctx;
+  fhe::opt::FHE_OPT_POLICY policy(&_lower_ctx, fhe::opt::OPT_LEVEL::CKKS);
+  air::opt::SSA_CONTAINER  ssa(_cntr);
+  air::opt::SSA_BUILDER(_func, &ssa, &driver_ctx).Perform();
+  air::opt::GVN gvn(_func, &ssa, &policy);
+  gvn.Perform();
+
+  // z2 reuses z1 and z5 reuses z4, z3 at another level is kept
+  EXPECT_EQ(gvn.Num_redundant(), 2);
+  EXPECT_EQ(policy.Num_rotate(), 2);
+  EXPECT_EQ(lower->Opcode(), fhe::ckks::OPC_ROTATE);
+  uint32_t        cnt = 0;
+  const uint32_t* level =
+      lower->Attr<uint32_t>(_lower_ctx.Attr_name(LEVEL), &cnt);
+  ASSERT_NE(level, nullptr);
+  EXPECT_EQ(*level, 2);
+  STMT_LIST sl         = _cntr->Stmt_list();
+  uint32_t  num_rotate = 0;
+  for (STMT_PTR stmt = sl.Begin_stmt(); stmt != sl.End_stmt();
+       stmt          = stmt->Next()) {
+    if (stmt->Node()->Num_child() > 0 &&
+        stmt->Node()->Child(0)->Opcode() == fhe::ckks::OPC_ROTATE) {
+      ++num_rotate;
+    }
+  }
+  EXPECT_EQ(num_rotate, 3);
+}
+
+}  // namespace
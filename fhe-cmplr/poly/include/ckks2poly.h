@@ -240,6 +240,10 @@ public:
   template <typename RETV, typename VISITOR>
   CKKS2POLY_RETV Handle_add(VISITOR* visitor, NODE_PTR node);
 
+  //! @brief Handle CKKS_OPERATOR::SUB
+  template <typename RETV, typename VISITOR>
+  CKKS2POLY_RETV Handle_sub(VISITOR* visitor, NODE_PTR node);
+
   //! @brief Handle CKKS_OPERATOR::MUL
   template <typename RETV, typename VISITOR>
   CKKS2POLY_RETV Handle_mul(VISITOR* visitor, NODE_PTR node);
@@ -269,6 +273,14 @@ private:
                                   CKKS2POLY_RETV opnd0_pair,
                                   CKKS2POLY_RETV opnd1_pair);
 
+  CKKS2POLY_RETV Handle_sub_ciph(CKKS2POLY_CTX& ctx, NODE_PTR node,
+                                 CKKS2POLY_RETV opnd0_pair,
+                                 CKKS2POLY_RETV opnd1_pair);
+
+  CKKS2POLY_RETV Handle_sub_plain(CKKS2POLY_CTX& ctx, NODE_PTR node,
+                                  CKKS2POLY_RETV opnd0_pair,
+                                  CKKS2POLY_RETV opnd1_pair);
+
   CKKS2POLY_RETV Handle_mul_ciph(CKKS2POLY_CTX& ctx, NODE_PTR node,
                                  CKKS2POLY_RETV opnd0_pair,
                                  CKKS2POLY_RETV opnd1_pair);
@@ -433,6 +445,32 @@ CKKS2POLY_RETV CKKS2POLY::Handle_add(VISITOR* visitor, NODE_PTR node) {
   return retv;
 }
 
+template <typename RETV, typename VISITOR>
+CKKS2POLY_RETV CKKS2POLY::Handle_sub(VISITOR* visitor, NODE_PTR node) {
+  CKKS2POLY_RETV        retv;
+  CKKS2POLY_CTX&        ctx             = visitor->Context();
+  fhe::core::LOWER_CTX* lower_ctx       = ctx.Lower_ctx();
+  bool                  is_gen_rns_loop = Pre_handle_ckks_op(visitor, node);
+
+  // visit sub's two child node
+  NODE_PTR       opnd0      = node->Child(0);
+  NODE_PTR       opnd1      = node->Child(1);
+  CKKS2POLY_RETV opnd0_pair = visitor->template Visit<RETV>(opnd0);
+  CKKS2POLY_RETV opnd1_pair = visitor->template Visit<RETV>(opnd1);
+
+  if (lower_ctx->Is_cipher_type(opnd1->Rtype_id())) {
+    retv = Handle_sub_ciph(ctx, node, opnd0_pair, opnd1_pair);
+  } else if (lower_ctx->Is_plain_type(opnd1->Rtype_id())) {
+    retv = Handle_sub_plain(ctx, node, opnd0_pair, opnd1_pair);
+  } else {
+    CMPLR_ASSERT(false, "invalid sub opnd_1 type");
+    retv = CKKS2POLY_RETV();
+  }
+
+  retv = Post_handle_ckks_op(visitor, node, retv, is_gen_rns_loop);
+  return retv;
+}
+
 template <typename RETV, typename VISITOR>
 CKKS2POLY_RETV CKKS2POLY::Handle_mul(VISITOR* visitor, NODE_PTR node) {
   CKKS2POLY_RETV        retv;
@@ -666,6 +666,18 @@ public:
   NODE_PTR New_hw_modadd(NODE_PTR opnd0, NODE_PTR opnd1, NODE_PTR opnd2,
                          const SPOS& spos);
 
+  /**
+   * @brief Create hardware modsub node, opnd0 - opnd1
+   *
+   * @param opnd0 operand 0
+   * @param opnd1 Operand 1
+   * @param opnd2 Operand 2
+   * @param spos Source position
+   * @return NODE_PTR
+   */
+  NODE_PTR New_hw_modsub(NODE_PTR opnd0, NODE_PTR opnd1, NODE_PTR opnd2,
+                         const SPOS& spos);
+
   /**
    * @brief Create hardware modmul node
    *
@@ -122,6 +122,36 @@ CKKS2POLY_RETV CKKS2POLY::Handle_add_plain(CKKS2POLY_CTX& ctx, NODE_PTR node,
   return CKKS2POLY_RETV(opnd0_pair.Kind(), add_0, add_1);
 }
 
+CKKS2POLY_RETV CKKS2POLY::Handle_sub_ciph(CKKS2POLY_CTX& ctx, NODE_PTR node,
+                                          CKKS2POLY_RETV opnd0_pair,
+                                          CKKS2POLY_RETV opnd1_pair) {
+  CONST_VAR& v_modulus = ctx.Poly_gen().Get_var(VAR_MODULUS, node->Spos());
+  NODE_PTR   new_opnd2 = ctx.Poly_gen().New_var_load(v_modulus, node->Spos());
+  CMPLR_ASSERT((!opnd0_pair.Is_null() && !opnd1_pair.Is_null()), "null node");
+
+  NODE_PTR sub_0 = ctx.Poly_gen().New_hw_modsub(
+      opnd0_pair.Node1(), opnd1_pair.Node1(), new_opnd2, node->Spos());
+  NODE_PTR sub_1 = ctx.Poly_gen().New_hw_modsub(
+      opnd0_pair.Node2(), opnd1_pair.Node2(), new_opnd2, node->Spos());
+
+  return CKKS2POLY_RETV(opnd0_pair.Kind(), sub_0, sub_1);
+}
+
+CKKS2POLY_RETV CKKS2POLY::Handle_sub_plain(CKKS2POLY_CTX& ctx, NODE_PTR node,
+                                           CKKS2POLY_RETV opnd0_pair,
+                                           CKKS2POLY_RETV opnd1_pair) {
+  CONST_VAR& v_modulus = ctx.Poly_gen().Get_var(VAR_MODULUS, node->Spos());
+  NODE_PTR   new_opnd2 = ctx.Poly_gen().New_var_load(v_modulus, node->Spos());
+  CMPLR_ASSERT((!opnd0_pair.Is_null() && !opnd1_pair.Is_null()), "null node");
+
+  // plaintext only has c0 part
+  NODE_PTR sub_0 = ctx.Poly_gen().New_hw_modsub(
+      opnd0_pair.Node1(), opnd1_pair.Node1(), new_opnd2, node->Spos());
+  NODE_PTR sub_1 = opnd0_pair.Node2();
+
+  return CKKS2POLY_RETV(opnd0_pair.Kind(), sub_0, sub_1);
+}
+
 CKKS2POLY_RETV CKKS2POLY::Handle_add_float(CKKS2POLY_CTX& ctx, NODE_PTR node,
                                            CKKS2POLY_RETV opnd0_pair,
                                            CKKS2POLY_RETV opnd1_pair) {
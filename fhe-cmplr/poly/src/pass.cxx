@@ -9,6 +9,7 @@
 #include "fhe/poly/pass.h"
 
 #include "fhe/driver/fhe_cmplr.h"
+#include "fhe/opt/opt_driver.h"
 #include "fhe/poly/poly_driver.h"
 
 using namespace std;
@@ -38,6 +39,10 @@ R_CODE POLY_PASS::Run() {
   fhe::poly::POLY_DRIVER poly_driver;
   air::base::GLOB_SCOPE* glob =
       poly_driver.Run(_config, _driver->Glob_scope(), _driver->Lower_ctx());
+  if (_config.Gvn()) {
+    opt::Opt_driver(glob, &_driver->Lower_ctx(), _driver->Context(), _config,
+                    opt::OPT_LEVEL::POLY);
+  }
   _driver->Update_glob_scope(glob);
   return R_CODE::NORMAL;
 }
@@ -22,12 +22,20 @@ static OPTION_DESC Poly2c_option[] = {
                              &Poly2c_config._prov_str,  air::util::K_STR,  0, V_EQUAL},
     {"df",  "data_file",             "Store weight data in a seperated file",
                              &Poly2c_config._data_file, air::util::K_STR,  0, V_EQUAL},
+    {"wb",  "weight_blob",           "Store constant arrays in a binary blob linked by .incbin",
+                             &Poly2c_config._weight_blob, air::util::K_STR, 0, V_EQUAL},
     {"cte", "compile-time encoding",
                              "Encode weight data into plaintext at compile-time",
                              &Poly2c_config._ct_encode, air::util::K_NONE, 0, V_NONE },
     {"fp",  "free_poly",
                              "Insert Free_poly right after the last use of the poly or poly in cipher",
                              &Poly2c_config._free_poly, air::util::K_NONE, 0, V_NONE },
+    {"mp",  "mem_plan",
+                             "Plan ciphertext buffers by live range to reuse them and compute in place, implies fp",
+                             &Poly2c_config._mem_plan, air::util::K_NONE, 0, V_NONE },
+    {"pc",  "pt_cache",
+                             "Cache plaintext encoded at runtime from constant data across inferences",
+                             &Poly2c_config._pt_cache, air::util::K_NONE, 0, V_NONE },
 };
 
 static OPTION_DESC_HANDLE Poly2c_option_handle = {
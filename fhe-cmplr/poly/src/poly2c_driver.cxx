@@ -9,6 +9,7 @@
 #include "fhe/poly/poly2c_driver.h"
 
 #include <iostream>
+#include <sstream>
 
 #include "air/base/container.h"
 #include "air/base/flatten_ctx.h"
@@ -22,6 +23,7 @@
 #include "fhe/poly/ir2c_core.h"
 #include "fhe/poly/ir2c_handler.h"
 #include "fhe/poly/poly2c_mfree.h"
+#include "fhe/poly/poly2c_mplan.h"
 #include "fhe/sihe/ir2c_handler.h"
 #include "fhe/sihe/sihe_handler.h"
 #include "nn/vector/handler.h"
@@ -89,6 +91,14 @@ void POLY2C_DRIVER::Run(GLOB_SCOPE* glob) {
       fhe::poly::MFREE_PASS mfree(_ctx.Lower_ctx());
       mfree.Perform(body);
     }
+    if (_ctx.Mem_plan() && _ctx.Provider() == core::PROVIDER::ANT) {
+      // reuse buffers freed by mfree, emit the plan before function
+      MPLAN_PASS mplan(_ctx.Lower_ctx());
+      mplan.Perform(func);
+      std::ostringstream os;
+      mplan.Print(os);
+      _ctx << os.str();
+    }
 
     // emit C code
     air::base::VISITOR<fhe::poly::IR2C_CTX,
@@ -113,7 +123,11 @@ void POLY2C_DRIVER::Run(GLOB_SCOPE* glob) {
 
   Emit_get_context_params();
 
-  _ctx.Emit_global_constants(glob, false);
+  if (_ctx.Emit_weight_blob()) {
+    _ctx.Emit_global_constants_blob(glob, _ctx.Weight_blob());
+  } else {
+    _ctx.Emit_global_constants(glob, false);
+  }
 }
 
 void POLY2C_DRIVER::Emit_get_context_params() {
@@ -164,6 +178,28 @@ void POLY2C_DRIVER::Emit_get_context_params() {
   _ctx << "}\n\n";
 }
 
+// Emit "{n, c, h, w}, 1, {NORMAL, count, start, end, stride}" for a tensor of
+// shape packed with nn::vector::BATCH_PACK. Image n of the tensor is placed
+// at slot n*block of the ciphertext.
+static void Emit_batch_scheme(IR2C_CTX& ctx, const std::vector<int64_t>& shape,
+                              int64_t block) {
+  int64_t nchw[4] = {1, 1, 1, 1};
+  for (size_t i = 0; i < shape.size() && i < 4; ++i) {
+    nchw[i] = shape[i];
+  }
+  // trailing dims of >4D tensor are merged into w
+  for (size_t i = 4; i < shape.size(); ++i) {
+    nchw[3] *= shape[i];
+  }
+  int64_t count = nchw[1] * nchw[2] * nchw[3];
+  AIR_ASSERT_MSG(count <= block, "image size %d exceeds batch block %d",
+                 (int)count, (int)block);
+  ctx << "{" << nchw[0] << ", " << nchw[1] << ", " << nchw[2] << ", "
+      << nchw[3] << "}, ";
+  ctx << "1, {NORMAL, " << count << ", 0, "
+      << (nchw[0] - 1) * block + count - 1 << ", " << block << "}\n";
+}
+
 void POLY2C_DRIVER::Emit_helper_function(FUNC_SCOPE* func_scope) {
   // int Get_input_count()
   uint32_t parm_count =
@@ -172,6 +208,9 @@ void POLY2C_DRIVER::Emit_helper_function(FUNC_SCOPE* func_scope) {
   _ctx << "  return " << parm_count << ";\n";
   _ctx << "}\n\n";
 
+  // layout of packed batch, only the first input is batched
+  const core::LOWER_CTX& lower_ctx = _ctx.Lower_ctx();
+
   // DATA_SCHEME Get_encode_scheme()
   _ctx << "DATA_SCHEME* Get_encode_scheme(int idx) {\n";
   for (uint32_t i = 0; i < parm_count; ++i) {
@@ -179,10 +218,15 @@ void POLY2C_DRIVER::Emit_helper_function(FUNC_SCOPE* func_scope) {
     // input data name
     ADDR_DATUM_PTR parm = func_scope->Formal(i);
     _ctx << "    \"" << parm->Name()->Char_str() << "\", ";
-    // input data shape
-    _ctx << "{0, 0, 0, 0}, ";
-    // input data encode scheme
-    _ctx << "1, {NORMAL, 0, 0, 0, 0}\n";
+    if (i == 0 && lower_ctx.Is_batch_packed()) {
+      Emit_batch_scheme(_ctx, lower_ctx.Get_batch_input_shape(),
+                        lower_ctx.Get_batch_block());
+    } else {
+      // input data shape
+      _ctx << "{0, 0, 0, 0}, ";
+      // input data encode scheme
+      _ctx << "1, {NORMAL, 0, 0, 0, 0}\n";
+    }
     _ctx << "  };\n";
   }
   _ctx << "  static DATA_SCHEME* scheme[] = { ";
@@ -206,10 +250,15 @@ void POLY2C_DRIVER::Emit_helper_function(FUNC_SCOPE* func_scope) {
   _ctx << "  static DATA_SCHEME scheme = {\n";
   // output data name
   _ctx << "    \"" << _ctx.Output_name() << "\", ";
-  // output data shape
-  _ctx << "{0, 0, 0, 0}, ";
-  // output data decode scheme
-  _ctx << "1, {NORMAL, 0, 0, 0, 0}\n";
+  if (lower_ctx.Is_batch_packed()) {
+    Emit_batch_scheme(_ctx, lower_ctx.Get_batch_output_shape(),
+                      lower_ctx.Get_batch_block());
+  } else {
+    // output data shape
+    _ctx << "{0, 0, 0, 0}, ";
+    // output data decode scheme
+    _ctx << "1, {NORMAL, 0, 0, 0, 0}\n";
+  }
   _ctx << "  };\n";
   _ctx << "  return &scheme;\n";
   _ctx << "}\n\n";
@@ -0,0 +1,515 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "fhe/poly/poly2c_mplan.h"
+
+#include <algorithm>
+#include <string>
+
+#include "air/core/opcode.h"
+#include "fhe/poly/opcode.h"
+
+using namespace air::base;
+
+namespace fhe {
+
+namespace poly {
+
+// pregs and syms are numbered separately
+static uint64_t Var_key(ADDR_DATUM_PTR sym) { return sym->Id().Value(); }
+
+static uint64_t Var_key(PREG_PTR preg) {
+  return (1ULL << 32) | preg->Id().Value();
+}
+
+static uint64_t Var_key(NODE_PTR node) {
+  return node->Has_sym() ? Var_key(node->Addr_datum())
+                         : Var_key(node->Preg());
+}
+
+static uint64_t Var_key(const MPLAN_VAR& var) {
+  return var._sym != Null_ptr ? Var_key(var._sym) : Var_key(var._preg);
+}
+
+static std::string Var_name(const MPLAN_VAR& var) {
+  if (var._sym != Null_ptr) return var._sym->Name()->Char_str();
+  return "_preg_" + std::to_string(var._preg->Id().Value());
+}
+
+static bool Is_init_ciph(NODE_PTR node) {
+  return node->Opcode() == OPC_INIT_CIPH_SAME_SCALE ||
+         node->Opcode() == OPC_INIT_CIPH_UP_SCALE ||
+         node->Opcode() == OPC_INIT_CIPH_DOWN_SCALE;
+}
+
+static bool Is_var_ld(NODE_PTR node) {
+  return node->Opcode() == air::core::OPC_LD ||
+         node->Opcode() == air::core::OPC_LDP;
+}
+
+// node or its kids reference var
+static bool Has_ref(NODE_PTR node, const MPLAN_VAR& var) {
+  if ((node->Has_sym() || node->Has_preg()) && Var_key(node) == Var_key(var)) {
+    return true;
+  }
+  for (uint32_t i = 0; i < node->Num_child(); ++i) {
+    if (Has_ref(node->Child(i), var)) return true;
+  }
+  return false;
+}
+
+void MPLAN_PASS::Add_ref(NODE_PTR node, STMT_PTR stmt) {
+  if (node->Has_sym()) {
+    Add_ref(node->Addr_datum(), PREG_PTR(), stmt);
+  } else if (node->Has_preg()) {
+    Add_ref(ADDR_DATUM_PTR(), node->Preg(), stmt);
+  }
+}
+
+void MPLAN_PASS::Add_ref(ADDR_DATUM_PTR sym, PREG_PTR preg, STMT_PTR stmt) {
+  if (sym != Null_ptr && sym->Is_formal() &&
+      !_func->Owning_func()->Entry_point()->Is_program_entry()) {
+    // formals are owned by caller
+    return;
+  }
+  TYPE_PTR type  = sym != Null_ptr ? sym->Type() : preg->Type();
+  TYPE_PTR elem  = type->Is_array() ? type->Cast_to_arr()->Elem_type() : type;
+  uint32_t polys = 0;
+  if (Is_cipher(elem)) {
+    polys = 2;
+  } else if (Is_cipher3(elem)) {
+    polys = 3;
+  } else if (_lower_ctx.Is_plain_type(elem->Id())) {
+    polys = 1;
+  } else {
+    return;
+  }
+  if (type->Is_array()) polys *= type->Cast_to_arr()->Elem_count();
+
+  uint64_t key = sym != Null_ptr ? Var_key(sym) : Var_key(preg);
+  uint32_t seq = Seq(stmt);
+  auto     it  = _var_idx.find(key);
+  if (it == _var_idx.end()) {
+    MPLAN_VAR var;
+    var._sym   = sym;
+    var._preg  = preg;
+    var._type  = type;
+    var._polys = polys;
+    // buffer moved into a new holder belongs to the source at the MOVE
+    var._start     = stmt->Node()->Opcode() == OPC_MOVE ? seq + 1 : seq;
+    var._end       = seq;
+    var._last_use  = seq;
+    var._first_ref = stmt;
+    var._slot      = UINT32_MAX;
+    var._moved     = false;
+    it = _var_idx.insert(std::make_pair(key, _vars.size())).first;
+    _vars.push_back(var);
+  }
+  MPLAN_VAR& var = _vars[it->second];
+  var._end       = seq;
+  if (stmt->Node()->Opcode() != OPC_FREE) {
+    var._last_use = seq;
+  } else if (var._frees.empty() || var._frees.back()->Id() != stmt->Id()) {
+    var._frees.push_back(stmt);
+  }
+}
+
+void MPLAN_PASS::Walk_expr(NODE_PTR node, STMT_PTR stmt) {
+  if (node->Is_block()) {
+    Walk_block(node);
+    return;
+  }
+  Add_ref(node, stmt);
+  for (uint32_t i = 0; i < node->Num_child(); ++i) {
+    Walk_expr(node->Child(i), stmt);
+  }
+}
+
+void MPLAN_PASS::Walk_stmt(STMT_PTR stmt) {
+  uint32_t seq                  = _seq++;
+  _stmt_seq[stmt->Id().Value()] = seq;
+  _stmts.push_back(stmt);
+  _end_seq.push_back(seq);
+  NODE_PTR node = stmt->Node();
+  if (node->Is_block()) {
+    Walk_block(node);
+  } else {
+    Walk_expr(node, stmt);
+    if (node->Opcode() == OPC_MOVE) {
+      MPLAN_VAR* src = Find_var(node->Child(1));
+      if (src != nullptr) src->_moved = true;
+    }
+    if (node->Has_ret_var()) {
+      Add_ref(ADDR_DATUM_PTR(), node->Ret_preg(), stmt);
+    }
+  }
+  _end_seq[seq] = _seq - 1;
+  if (node->Is_do_loop()) _loops.push_back(std::make_pair(seq, _seq - 1));
+}
+
+void MPLAN_PASS::Walk_block(NODE_PTR blk) {
+  for (STMT_PTR stmt = blk->Begin_stmt(); stmt != blk->End_stmt();
+       stmt          = stmt->Next()) {
+    Walk_stmt(stmt);
+  }
+}
+
+void MPLAN_PASS::Extend_over_loops() {
+  // a var referenced both in and out of a loop lives across all iterations
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (const auto& loop : _loops) {
+      for (MPLAN_VAR& var : _vars) {
+        if (var._end < loop.first || var._start > loop.second) continue;
+        if (var._start >= loop.first && var._end <= loop.second) continue;
+        if (var._start > loop.first) {
+          var._start = loop.first;
+          changed    = true;
+        }
+        if (var._end < loop.second) {
+          var._end = loop.second;
+          changed  = true;
+        }
+      }
+    }
+  }
+}
+
+void MPLAN_PASS::Analyze(NODE_PTR body) {
+  _vars.clear();
+  _var_idx.clear();
+  _stmt_seq.clear();
+  _stmts.clear();
+  _end_seq.clear();
+  _loops.clear();
+  _seq = 0;
+  Walk_block(body);
+  for (MPLAN_VAR& var : _vars) {
+    // never freed, lives to the end of function
+    if (var._frees.empty() && !var._moved) var._end = _seq;
+  }
+  Extend_over_loops();
+}
+
+uint32_t MPLAN_PASS::Seq(STMT_PTR stmt) const {
+  auto it = _stmt_seq.find(stmt->Id().Value());
+  AIR_ASSERT(it != _stmt_seq.end());
+  return it->second;
+}
+
+MPLAN_VAR* MPLAN_PASS::Find_var(NODE_PTR node) {
+  if (!Is_var_ld(node)) return nullptr;
+  auto it = _var_idx.find(Var_key(node));
+  return it == _var_idx.end() ? nullptr : &_vars[it->second];
+}
+
+uint64_t MPLAN_PASS::Var_size(const MPLAN_VAR& var) const {
+  const core::CTX_PARAM& param = _lower_ctx.Get_ctx_param();
+  return (uint64_t)var._polys * param.Get_poly_degree() *
+         (param.Get_mul_level() + 1) * sizeof(int64_t);
+}
+
+std::vector<uint64_t> MPLAN_PASS::Profile() const {
+  std::vector<int64_t> delta(_seq + 2, 0);
+  for (const MPLAN_VAR& var : _vars) {
+    if (var._start > var._end) continue;
+    delta[var._start] += Var_size(var);
+    delta[var._end + 1] -= Var_size(var);
+  }
+  std::vector<uint64_t> live(_seq + 1, 0);
+  int64_t               sum = 0;
+  for (uint32_t i = 0; i <= _seq; ++i) {
+    sum += delta[i];
+    live[i] = sum;
+  }
+  return live;
+}
+
+uint64_t MPLAN_PASS::Peak() const {
+  std::vector<uint64_t> live = Profile();
+  return *std::max_element(live.begin(), live.end());
+}
+
+void MPLAN_PASS::Insert_move(STMT_PTR pos, const MPLAN_VAR& dst,
+                             const MPLAN_VAR& src) {
+  CONTAINER* cntr = pos->Container();
+  SPOS       spos = pos->Spos();
+  STMT_PTR   move = cntr->New_cust_stmt(OPC_MOVE, spos);
+  move->Node()->Set_child(0, dst._sym != Null_ptr
+                                 ? cntr->New_ld(dst._sym, spos)
+                                 : cntr->New_ldp(dst._preg, spos));
+  move->Node()->Set_child(1, src._sym != Null_ptr
+                                 ? cntr->New_ld(src._sym, spos)
+                                 : cntr->New_ldp(src._preg, spos));
+  STMT_LIST list(pos->Parent_node());
+  list.Prepend(pos, move);
+  AIR_ASSERT(Is_init_ciph(pos->Node()));
+  uint32_t reuse = 1;
+  pos->Node()->Set_attr(MPLAN_REUSE_ATTR, &reuse, 1);
+}
+
+void MPLAN_PASS::Remove_frees(MPLAN_VAR& var) {
+  for (STMT_PTR free : var._frees) {
+    STMT_LIST list(free->Parent_node());
+    list.Remove(free);
+  }
+  var._frees.clear();
+}
+
+void MPLAN_PASS::Rename(NODE_PTR node, const MPLAN_VAR& from,
+                        const MPLAN_VAR& to) {
+  if (node->Is_block()) {
+    for (STMT_PTR stmt = node->Begin_stmt(); stmt != node->End_stmt();
+         stmt          = stmt->Next()) {
+      Rename(stmt->Node(), from, to);
+    }
+    return;
+  }
+  if ((node->Has_sym() || node->Has_preg()) && Var_key(node) == Var_key(from)) {
+    if (node->Has_sym()) {
+      node->Set_addr_datum(to._sym);
+    } else {
+      node->Set_preg(to._preg);
+    }
+  }
+  for (uint32_t i = 0; i < node->Num_child(); ++i) {
+    Rename(node->Child(i), from, to);
+  }
+}
+
+bool MPLAN_PASS::Elementwise_block(NODE_PTR node, const MPLAN_VAR& dst) {
+  if (node->Is_block()) {
+    for (STMT_PTR stmt = node->Begin_stmt(); stmt != node->End_stmt();
+         stmt          = stmt->Next()) {
+      if (!Elementwise_block(stmt->Node(), dst)) return false;
+    }
+    return true;
+  }
+  if (node->Domain() == POLYNOMIAL_DID) {
+    switch (node->Operator()) {
+      case OPCODE::SET_COEFFS:
+        // dst is written only here
+        if (Has_ref(node->Child(1), dst) || Has_ref(node->Child(2), dst)) {
+          return false;
+        }
+        return Elementwise_block(node->Child(2), dst);
+      case OPCODE::LEVEL:
+      case OPCODE::Q_MODULUS:
+        return true;
+      case OPCODE::FREE:
+        break;
+      case OPCODE::COEFFS:
+      case OPCODE::HW_MODADD:
+      case OPCODE::HW_MODSUB:
+      case OPCODE::HW_MODMUL:
+        break;
+      default:
+        return false;
+    }
+  } else if (node->Domain() != air::core::CORE) {
+    return false;
+  } else if ((node->Has_sym() || node->Has_preg()) &&
+             Var_key(node) == Var_key(dst)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < node->Num_child(); ++i) {
+    if (!Elementwise_block(node->Child(i), dst)) return false;
+  }
+  return true;
+}
+
+bool MPLAN_PASS::Try_in_place(STMT_PTR stmt) {
+  // res = ciph + ciph|plain or res = ciph * plain followed by the block
+  // computing it coefficient by coefficient, write res into the buffer of
+  // the first operand if the operand dies in the block
+  NODE_PTR node = stmt->Node();
+  if (node->Opcode() == OPC_INIT_CIPH_SAME_SCALE) {
+    if (!_lower_ctx.Is_plain_type(node->Child(2)->Rtype_id()) &&
+        !Is_cipher(node->Child(2)->Rtype())) {
+      return false;
+    }
+  } else if (node->Opcode() == OPC_INIT_CIPH_UP_SCALE) {
+    if (!_lower_ctx.Is_plain_type(node->Child(2)->Rtype_id())) return false;
+  } else {
+    return false;
+  }
+  MPLAN_VAR* dst = Find_var(node->Child(0));
+  MPLAN_VAR* src = Find_var(node->Child(1));
+  if (dst == nullptr || src == nullptr || dst == src ||
+      !Is_cipher(dst->_type) || !Is_cipher(src->_type) ||
+      (dst->_sym == Null_ptr) != (src->_sym == Null_ptr) ||
+      Has_ref(node->Child(2), *dst) || src->_frees.empty()) {
+    return false;
+  }
+  STMT_PTR blk = stmt->Next();
+  if (blk->Id() == stmt->Parent_node()->End_stmt_id() ||
+      !blk->Node()->Is_block()) {
+    return false;
+  }
+  uint32_t blk_end = _end_seq[Seq(blk)];
+  if (src->_last_use > blk_end || src->_end != Seq(src->_frees.back())) {
+    return false;
+  }
+  for (STMT_PTR free : src->_frees) {
+    if (free->Parent_node_id() != stmt->Parent_node_id() &&
+        free->Parent_node_id() != blk->Node()->Id()) {
+      return false;
+    }
+  }
+  if (!Elementwise_block(blk->Node(), *dst)) return false;
+
+  Insert_move(stmt, *dst, *src);
+  Remove_frees(*src);
+  Rename(node->Child(1), *src, *dst);
+  Rename(node->Child(2), *src, *dst);
+  Rename(blk->Node(), *src, *dst);
+  ++_num_ipl;
+  return true;
+}
+
+void MPLAN_PASS::Assign_slots() {
+  std::vector<uint32_t> order;
+  for (uint32_t i = 0; i < _vars.size(); ++i) {
+    const MPLAN_VAR& var = _vars[i];
+    if (!var._type->Is_array() &&
+        (Is_cipher(var._type) || Is_cipher3(var._type))) {
+      order.push_back(i);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+    return _vars[a]._start < _vars[b]._start;
+  });
+
+  // linear scan. a dead holder hands its slot to a var first defined by
+  // INIT_CIPH_* in the same block, which allocates only on level growth.
+  // the buffer is held in between, so skip the hand over if it raises peak
+  std::vector<uint64_t> live = Profile();
+  uint64_t              peak = *std::max_element(live.begin(), live.end());
+  std::vector<uint32_t> active;
+  std::vector<uint32_t> dead;
+  std::vector<std::pair<uint32_t, uint32_t>> moves;  // (from, to)
+  for (uint32_t idx : order) {
+    MPLAN_VAR& var = _vars[idx];
+    for (auto it = active.begin(); it != active.end();) {
+      if (_vars[*it]._end < var._start) {
+        if (!_vars[*it]._frees.empty()) dead.push_back(*it);
+        it = active.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    NODE_PTR def = var._first_ref->Node();
+    bool can_take = Is_init_ciph(def) && var._start == Seq(var._first_ref) &&
+                    Is_var_ld(def->Child(0)) &&
+                    Var_key(def->Child(0)) == Var_key(var);
+    for (uint32_t i = 1; can_take && i < def->Num_child(); ++i) {
+      can_take = !Has_ref(def->Child(i), var);
+    }
+    uint32_t donor = UINT32_MAX;
+    if (def->Opcode() == OPC_MOVE) {
+      // in-place result continues the slot of the operand
+      MPLAN_VAR* src = Find_var(def->Child(1));
+      if (src != nullptr && src->_slot != UINT32_MAX) var._slot = src->_slot;
+    }
+    for (uint32_t i = 0; can_take && i < dead.size(); ++i) {
+      const MPLAN_VAR& cand = _vars[dead[i]];
+      if (cand._type->Id() != var._type->Id()) continue;
+      bool fit = true;
+      for (STMT_PTR free : cand._frees) {
+        fit &= free->Parent_node_id() == var._first_ref->Parent_node_id();
+      }
+      for (uint32_t seq = cand._end + 1; fit && seq < var._start; ++seq) {
+        fit = live[seq] + Var_size(cand) <= peak;
+      }
+      if (fit && (donor == UINT32_MAX || cand._end > _vars[donor]._end)) {
+        donor = dead[i];
+      }
+    }
+    if (donor != UINT32_MAX) {
+      for (uint32_t seq = _vars[donor]._end + 1; seq < var._start; ++seq) {
+        live[seq] += Var_size(var);
+      }
+      var._slot = _vars[donor]._slot;
+      dead.erase(std::find(dead.begin(), dead.end(), donor));
+      moves.push_back(std::make_pair(donor, idx));
+    } else if (var._slot == UINT32_MAX) {
+      MPLAN_SLOT slot;
+      slot._type = var._type;
+      slot._size = Var_size(var);
+      slot._ofst =
+          _slots.empty() ? 0 : _slots.back()._ofst + _slots.back()._size;
+      var._slot  = _slots.size();
+      _slots.push_back(slot);
+    }
+    _slots[var._slot]._holders.push_back(Var_name(var));
+    active.push_back(idx);
+    ++_num_holder;
+  }
+
+  for (const auto& move : moves) {
+    MPLAN_VAR& from = _vars[move.first];
+    MPLAN_VAR& to   = _vars[move.second];
+    Insert_move(to._first_ref, to, from);
+    Remove_frees(from);
+    ++_num_move;
+  }
+}
+
+void MPLAN_PASS::Perform(FUNC_SCOPE* func) {
+  _func         = func;
+  NODE_PTR body = func->Container().Stmt_list().Block_node();
+  Analyze(body);
+  _total = 0;
+  for (const MPLAN_VAR& var : _vars) {
+    _total += Var_size(var);
+  }
+  _peak_free = Peak();
+
+  // in-place ops first, they shorten live ranges seen by slot assignment
+  std::vector<STMT_PTR> inits;
+  for (STMT_PTR stmt : _stmts) {
+    if (Is_init_ciph(stmt->Node())) inits.push_back(stmt);
+  }
+  for (STMT_PTR stmt : inits) {
+    if (Try_in_place(stmt)) Analyze(body);
+  }
+
+  Assign_slots();
+  Analyze(body);
+  _peak_plan = Peak();
+}
+
+void MPLAN_PASS::Print(std::ostream& os) const {
+  const core::CTX_PARAM& param = _lower_ctx.Get_ctx_param();
+  uint64_t               arena =
+      _slots.empty() ? 0 : _slots.back()._ofst + _slots.back()._size;
+  os << "/* Memory plan of " << _func->Owning_func()->Name()->Char_str()
+     << ": N=" << param.Get_poly_degree()
+     << ", q primes=" << param.Get_mul_level() + 1 << std::endl;
+  os << " *   peak " << _peak_plan << " bytes, " << _peak_free
+     << " with free after last use, " << _total << " without free" << std::endl;
+  os << " *   " << _num_holder << " ciphertexts in " << _slots.size()
+     << " slots, " << _num_move << " buffers moved, " << _num_ipl
+     << " in-place ops" << std::endl;
+  os << " *   arena " << arena << " bytes" << std::endl;
+  for (uint32_t i = 0; i < _slots.size(); ++i) {
+    const MPLAN_SLOT& slot = _slots[i];
+    os << " *     slot " << i << " @" << slot._ofst << " " << slot._size << " "
+       << slot._type->Name()->Char_str() << ":";
+    for (const std::string& name : slot._holders) {
+      os << " " << name;
+    }
+    os << std::endl;
+  }
+  os << " */" << std::endl;
+}
+
+}  // namespace poly
+
+}  // namespace fhe
@@ -39,6 +39,10 @@ R_CODE POLY2C_PASS::Pre_run() {
 }
 
 R_CODE POLY2C_PASS::Run() {
+  if (_config.Enable() == false) {
+    CMPLR_WARN_MSG(_driver->Tfile(), "POLY2C PASS is disabled.");
+    return R_CODE::NORMAL;
+  }
   std::ofstream            of(_driver->Context()->Ofile());
   fhe::poly::POLY2C_DRIVER poly2c(of, _driver->Lower_ctx(), _config);
   air::base::GLOB_SCOPE*   glob = _driver->Glob_scope();
@@ -744,6 +744,20 @@ NODE_PTR POLY_IR_GEN::New_hw_modadd(NODE_PTR opnd0, NODE_PTR opnd1,
   return add_node;
 }
 
+NODE_PTR POLY_IR_GEN::New_hw_modsub(NODE_PTR opnd0, NODE_PTR opnd1,
+                                    NODE_PTR opnd2, const SPOS& spos) {
+  CMPLR_ASSERT((opnd0->Rtype() == opnd1->Rtype() &&
+                opnd0->Rtype() == Get_type(INT_PTR, spos) &&
+                opnd2->Rtype() == Get_type(MODULUS_PTR, spos)),
+               "unmatched type");
+
+  NODE_PTR sub_node = New_poly_node(HW_MODSUB, opnd0->Rtype(), spos);
+  sub_node->Set_child(0, opnd0);
+  sub_node->Set_child(1, opnd1);
+  sub_node->Set_child(2, opnd2);
+  return sub_node;
+}
+
 NODE_PTR POLY_IR_GEN::New_hw_modmul(NODE_PTR opnd0, NODE_PTR opnd1,
                                     NODE_PTR opnd2, const SPOS& spos) {
   CMPLR_ASSERT((opnd0->Rtype() == opnd1->Rtype() &&
@@ -0,0 +1,258 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "air/base/meta_info.h"
+#include "air/core/opcode.h"
+#include "fhe/ckks/ckks_gen.h"
+#include "fhe/ckks/ckks_opcode.h"
+#include "fhe/poly/opcode.h"
+#include "fhe/poly/poly2c_mplan.h"
+#include "fhe/sihe/sihe_gen.h"
+#include "gtest/gtest.h"
+
+using namespace air::base;
+using namespace fhe::poly;
+
+namespace {
+
+class TEST_POLY2C_MPLAN : public ::testing::Test {
+protected:
+  void SetUp() override {
+    META_INFO::Remove_all();
+    air::core::Register_core();
+    fhe::ckks::Register_ckks_domain();
+    Register_polynomial();
+    _glob = new GLOB_SCOPE(0, true);
+    _spos = _glob->Unknown_simple_spos();
+    fhe::sihe::SIHE_GEN(_glob, &_lower_ctx).Register_sihe_types();
+    fhe::ckks::CKKS_GEN(_glob, &_lower_ctx).Register_ckks_types();
+    _lower_ctx.Get_ctx_param().Set_poly_degree(8);
+    _ciph_ty  = _glob->Type(_lower_ctx.Get_cipher_type_id());
+    _plain_ty = _glob->Type(_lower_ctx.Get_plain_type_id());
+    _u64_ty   = _glob->Prim_type(PRIMITIVE_TYPE::INT_U64);
+
+    // ciph main(ciph_in), formal is owned by caller and not planned
+    STR_PTR  name = _glob->New_str("main");
+    FUNC_PTR func = _glob->New_func(name, _spos);
+    func->Set_parent(_glob->Comp_env_id());
+    SIGNATURE_TYPE_PTR sig = _glob->New_sig_type();
+    _glob->New_ret_param(_ciph_ty, sig);
+    _glob->New_param(_glob->New_str("ciph_in"), _ciph_ty, sig, _spos);
+    sig->Set_complete();
+    _glob->New_global_entry_point(sig, func, name, _spos);
+    _func = &_glob->New_func_scope(func);
+    _cntr = &_func->Container();
+    _cntr->New_func_entry(_spos);
+  }
+
+  void TearDown() override {
+    delete _glob;
+    META_INFO::Remove_all();
+  }
+
+  ADDR_DATUM_PTR New_var(const char* name, TYPE_PTR type) {
+    return _func->New_var(type, _glob->New_str(name), _spos);
+  }
+
+  NODE_PTR Ld(ADDR_DATUM_PTR var) { return _cntr->New_ld(var, _spos); }
+
+  NODE_PTR Ld_in() { return Ld(_func->Formal(0)); }
+
+  // init_ciph_same_scale(res, opnd0, opnd1)
+  STMT_PTR Init(NODE_PTR res, NODE_PTR opnd0, NODE_PTR opnd1) {
+    STMT_PTR stmt = _cntr->New_cust_stmt(OPC_INIT_CIPH_SAME_SCALE, _spos);
+    stmt->Node()->Set_child(0, res);
+    stmt->Node()->Set_child(1, opnd0);
+    stmt->Node()->Set_child(2, opnd1);
+    return stmt;
+  }
+
+  STMT_PTR Free(ADDR_DATUM_PTR var) {
+    STMT_PTR stmt = _cntr->New_cust_stmt(OPC_FREE, _spos);
+    stmt->Node()->Set_child(0, Ld(var));
+    return stmt;
+  }
+
+  NODE_PTR Coeffs(NODE_PTR poly) {
+    NODE_PTR node = _cntr->New_cust_node(OPC_COEFFS, _u64_ty, _spos);
+    node->Set_child(0, poly);
+    node->Set_child(1, _cntr->New_intconst(_u64_ty, 0, _spos));
+    return node;
+  }
+
+  // block { set_coeffs(res, 0, hw_modadd(coeffs(opnd0), coeffs(opnd1))) },
+  // computing res coefficient by coefficient
+  STMT_PTR Add_block(ADDR_DATUM_PTR res, NODE_PTR opnd0, NODE_PTR opnd1) {
+    NODE_PTR add = _cntr->New_cust_node(OPC_HW_MODADD, _u64_ty, _spos);
+    add->Set_child(0, Coeffs(opnd0));
+    add->Set_child(1, Coeffs(opnd1));
+    add->Set_child(2, _cntr->New_cust_node(OPC_Q_MODULUS, _u64_ty, _spos));
+    STMT_PTR set = _cntr->New_cust_stmt(OPC_SET_COEFFS, _spos);
+    set->Node()->Set_child(0, Ld(res));
+    set->Node()->Set_child(1, _cntr->New_intconst(_u64_ty, 0, _spos));
+    set->Node()->Set_child(2, add);
+    NODE_PTR blk = _cntr->New_stmt_block(_spos);
+    STMT_LIST(blk).Append(set);
+    return blk->Stmt();
+  }
+
+  // do_loop i in [0, 4) with empty body, return the body
+  NODE_PTR Append_loop(STMT_LIST sl) {
+    TYPE_PTR       s32  = _glob->Prim_type(PRIMITIVE_TYPE::INT_S32);
+    ADDR_DATUM_PTR iv   = New_var("i", s32);
+    NODE_PTR       body = _cntr->New_stmt_block(_spos);
+    NODE_PTR       cmp  = _cntr->New_bin_arith(
+        air::base::OPCODE(air::core::CORE, air::core::OPCODE::LT), Ld(iv),
+        _cntr->New_intconst(s32, 4, _spos), _spos);
+    NODE_PTR incr = _cntr->New_bin_arith(
+        air::base::OPCODE(air::core::CORE, air::core::OPCODE::ADD), Ld(iv),
+        _cntr->New_intconst(s32, 1, _spos), _spos);
+    sl.Append(_cntr->New_do_loop(iv, _cntr->New_intconst(s32, 0, _spos), cmp,
+                                 incr, body, _spos));
+    return body;
+  }
+
+  std::string Perform() {
+    MPLAN_PASS mplan(_lower_ctx);
+    mplan.Perform(_func);
+    std::ostringstream os;
+    mplan.Print(os);
+    return os.str();
+  }
+
+  std::vector<STMT_PTR> Stmts() {
+    std::vector<STMT_PTR> stmts;
+    STMT_LIST             sl = _cntr->Stmt_list();
+    for (STMT_PTR stmt = sl.Begin_stmt(); stmt != sl.End_stmt();
+         stmt          = stmt->Next()) {
+      stmts.push_back(stmt);
+    }
+    return stmts;
+  }
+
+  // stmt is MOVE(ld dst, ld src)
+  void Check_move(STMT_PTR stmt, ADDR_DATUM_PTR dst, ADDR_DATUM_PTR src) {
+    ASSERT_EQ(stmt->Node()->Opcode(), OPC_MOVE);
+    EXPECT_EQ(stmt->Node()->Child(0)->Addr_datum_id(), dst->Id());
+    EXPECT_EQ(stmt->Node()->Child(1)->Addr_datum_id(), src->Id());
+  }
+
+  bool Has_reuse_attr(STMT_PTR stmt) {
+    return stmt->Node()->Attr<uint32_t>(MPLAN_REUSE_ATTR) != nullptr;
+  }
+
+  GLOB_SCOPE*          _glob = nullptr;
+  FUNC_SCOPE*          _func = nullptr;
+  CONTAINER*           _cntr = nullptr;
+  TYPE_PTR             _ciph_ty;
+  TYPE_PTR             _plain_ty;
+  TYPE_PTR             _u64_ty;
+  SPOS                 _spos;
+  fhe::core::LOWER_CTX _lower_ctx;
+};
+
+// y = x + p writes into the buffer of x, which dies in the add
+TEST_F(TEST_POLY2C_MPLAN, in_place) {
+  ADDR_DATUM_PTR x  = New_var("x", _ciph_ty);
+  ADDR_DATUM_PTR y  = New_var("y", _ciph_ty);
+  ADDR_DATUM_PTR p  = New_var("p", _plain_ty);
+  STMT_LIST      sl = _cntr->Stmt_list();
+  sl.Append(Init(Ld(x), Ld_in(), Ld_in()));
+  sl.Append(Add_block(x, Ld_in(), Ld_in()));
+  sl.Append(Init(Ld(y), Ld(x), Ld(p)));
+  sl.Append(Add_block(y, Ld(x), Ld(p)));
+  sl.Append(Free(x));
+  sl.Append(_cntr->New_retv(Ld(y), _spos));
+
+  std::string plan = Perform();
+  EXPECT_NE(plan.find("2 ciphertexts in 1 slots, 0 buffers moved, 1 in-place"),
+            std::string::npos);
+  EXPECT_NE(plan.find(": x y\n"), std::string::npos);
+
+  // init(x); blk; move(y, x); init(y, y, p); blk(y, y, p); retv y
+  std::vector<STMT_PTR> stmts = Stmts();
+  ASSERT_EQ(stmts.size(), 6);
+  EXPECT_FALSE(Has_reuse_attr(stmts[0]));
+  Check_move(stmts[2], y, x);
+  NODE_PTR init = stmts[3]->Node();
+  ASSERT_EQ(init->Opcode(), OPC_INIT_CIPH_SAME_SCALE);
+  EXPECT_TRUE(Has_reuse_attr(stmts[3]));
+  EXPECT_EQ(init->Child(0)->Addr_datum_id(), y->Id());
+  EXPECT_EQ(init->Child(1)->Addr_datum_id(), y->Id());
+  EXPECT_EQ(init->Child(2)->Addr_datum_id(), p->Id());
+  NODE_PTR set = stmts[4]->Node()->Begin_stmt()->Node();
+  EXPECT_EQ(set->Child(0)->Addr_datum_id(), y->Id());
+  EXPECT_EQ(set->Child(2)->Child(0)->Child(0)->Addr_datum_id(), y->Id());
+  EXPECT_EQ(set->Child(2)->Child(1)->Child(0)->Addr_datum_id(), p->Id());
+  EXPECT_EQ(stmts[5]->Node()->Opcode(), air::core::OPC_RETV);
+}
+
+// a is freed right before b is initialized, b takes the buffer of a
+TEST_F(TEST_POLY2C_MPLAN, donor_hand_over) {
+  ADDR_DATUM_PTR a  = New_var("a", _ciph_ty);
+  ADDR_DATUM_PTR b  = New_var("b", _ciph_ty);
+  STMT_LIST      sl = _cntr->Stmt_list();
+  sl.Append(Init(Ld(a), Ld_in(), Ld_in()));
+  sl.Append(Add_block(a, Ld_in(), Ld_in()));
+  sl.Append(Free(a));
+  sl.Append(Init(Ld(b), Ld_in(), Ld_in()));
+  sl.Append(Add_block(b, Ld_in(), Ld_in()));
+  sl.Append(_cntr->New_retv(Ld(b), _spos));
+
+  std::string plan = Perform();
+  EXPECT_NE(plan.find("2 ciphertexts in 1 slots, 1 buffers moved, 0 in-place"),
+            std::string::npos);
+  EXPECT_NE(plan.find(": a b\n"), std::string::npos);
+
+  // init(a); blk; move(b, a); init(b); blk; retv b, free of a is dropped
+  std::vector<STMT_PTR> stmts = Stmts();
+  ASSERT_EQ(stmts.size(), 6);
+  Check_move(stmts[2], b, a);
+  ASSERT_EQ(stmts[3]->Node()->Opcode(), OPC_INIT_CIPH_SAME_SCALE);
+  EXPECT_EQ(stmts[3]->Node()->Child(0)->Addr_datum_id(), b->Id());
+  EXPECT_TRUE(Has_reuse_attr(stmts[3]));
+  EXPECT_FALSE(Has_reuse_attr(stmts[0]));
+}
+
+// b is defined in the loop and used after it, so it lives across all
+// iterations and can't take the buffer of t dying earlier in the loop body
+TEST_F(TEST_POLY2C_MPLAN, loop_extension) {
+  ADDR_DATUM_PTR t    = New_var("t", _ciph_ty);
+  ADDR_DATUM_PTR b    = New_var("b", _ciph_ty);
+  ADDR_DATUM_PTR c    = New_var("c", _ciph_ty);
+  STMT_LIST      sl   = _cntr->Stmt_list();
+  NODE_PTR       body = Append_loop(sl);
+  STMT_LIST      lsl(body);
+  lsl.Append(Init(Ld(t), Ld_in(), Ld_in()));
+  lsl.Append(Add_block(t, Ld_in(), Ld_in()));
+  lsl.Append(Free(t));
+  lsl.Append(Init(Ld(b), Ld_in(), Ld_in()));
+  lsl.Append(Add_block(b, Ld_in(), Ld_in()));
+  sl.Append(Init(Ld(c), Ld_in(), Ld(b)));
+  sl.Append(Add_block(c, Ld_in(), Ld(b)));
+  sl.Append(Free(b));
+  sl.Append(_cntr->New_retv(Ld(c), _spos));
+
+  std::string plan = Perform();
+  EXPECT_NE(plan.find("3 ciphertexts in 3 slots, 0 buffers moved"),
+            std::string::npos);
+  // loop body is kept, FREE of t included
+  uint32_t num = 0;
+  for (STMT_PTR stmt = body->Begin_stmt(); stmt != body->End_stmt();
+       stmt          = stmt->Next()) {
+    EXPECT_NE(stmt->Node()->Opcode(), OPC_MOVE);
+    ++num;
+  }
+  EXPECT_EQ(num, 5);
+}
+
+}  // namespace
@@ -32,6 +32,10 @@ void Free_cipher(CIPHER ciph);
 //! mul_integer() & mul_by_monomial() & rotate() when ciph2 == NULL
 void Init_ciph_same_scale(CIPHER res, CIPHER ciph1, CIPHER ciph2);
 
+//! @brief Same as Init_ciph_same_scale, but res may hold a buffer handed over
+//! by Move_ciph at another level, which is reused if large enough
+void Init_ciph_same_scale_reuse(CIPHER res, CIPHER ciph1, CIPHER ciph2);
+
 //! @brief Initialize ciphertext from ciph & plain with same scale,
 //! which is used for add_plain()
 void Init_ciph_same_scale_plain(CIPHER res, CIPHER ciph1, PLAIN plain);
@@ -63,6 +67,13 @@ void Init_ciph_down_scale(CIPHER res, CIPHER ciph);
 //! @brief Copy ciphertext
 void Copy_ciph(CIPHER res, CIPHER ciph);
 
+//! @brief Free data of res and hand data of ciph over to res, ciph is left
+//! empty. Used to reuse buffer of a dead ciphertext
+void Move_ciph(CIPHER res, CIPHER ciph);
+
+//! @brief Free data of res and hand data of ciph over to res for ciphertext3
+void Move_ciph3(CIPHER3 res, CIPHER3 ciph);
+
 //! @brief Get level from ciphertext
 size_t Level(CIPHER ciph);
 
@@ -27,6 +27,21 @@ typedef PLAINTEXT* PLAIN;
 void Encode_plain_from_float(PLAIN plain, float* input, size_t len,
                              uint32_t sc_degree, uint32_t level);
 
+//! @brief Encode plaintext from constant float value list. Plaintext is
+//! encoded at the first call and kept in CKKS_CONTEXT, later calls with the
+//! same input, len, sc_degree and level copy it without encoding. Memory of
+//! cached plaintexts is bounded by ENV_PT_CACHE_SIZE. Safe to call from
+//! OpenMP threads. Content of input must not be changed before
+//! Finalize_context
+void Encode_plain_from_float_cached(PLAIN plain, float* input, size_t len,
+                                    uint32_t sc_degree, uint32_t level);
+
+//! @brief Get memsize, count and number of hits of cached plaintext
+void Get_plain_cache(size_t* size, size_t* cnt, size_t* hit);
+
+//! @brief Free plaintexts cached in CKKS_CONTEXT
+void Free_plain_cache();
+
 //! @brief Encode plaintext from input double value list
 //! @param len length of input double vector
 //! @param level level of plaintext: num of q primes
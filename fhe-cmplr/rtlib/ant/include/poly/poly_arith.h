@@ -27,6 +27,18 @@ extern "C" {
 int64_t* Hw_modadd(int64_t* res, int64_t* val1, int64_t* val2, MODULUS* modulus,
                    uint32_t degree);
 
+/**
+ * @brief mod subtract of polynomial, res = val1 - val2
+ *
+ * @param res result value
+ * @param val1 input value
+ * @param val2 input value
+ * @param modulus current Modulus
+ * @param degree poly degree
+ */
+int64_t* Hw_modsub(int64_t* res, int64_t* val1, int64_t* val2, MODULUS* modulus,
+                   uint32_t degree);
+
 /**
  * @brief mod multiply of polynomial
  *
@@ -75,7 +75,8 @@ static inline void Set_coeffs(POLY dst, uint32_t level, uint32_t degree,
                               int64_t* src) {
   assert(level <= Get_num_pq(dst) && "index overflow");
   int64_t* dst_coeffs = Coeffs(dst, level, degree);
-  memcpy(dst_coeffs, src, sizeof(int64_t) * degree);
+  // dst and src are the same after computing in place
+  if (dst_coeffs != src) memcpy(dst_coeffs, src, sizeof(int64_t) * degree);
 }
 
 /**
@@ -29,6 +29,8 @@ typedef struct {
   PTR_TY _encryptor;
   PTR_TY _decryptor;
   PTR_TY _evaluator;
+  PTR_TY _pt_cache;  // plaintexts encoded from constant data, kept across
+                     // inferences
 } CKKS_CONTEXT;
 
 extern CKKS_CONTEXT* Context;
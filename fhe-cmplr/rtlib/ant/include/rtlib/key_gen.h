@@ -68,10 +68,12 @@ static inline POLY Pk0_at(SW_KEY swk, uint32_t idx) {
 }
 
 /**
- * @brief Get p1(POLY) of public key from given switch key & index
+ * @brief Get p1(POLY) of public key from given switch key & index, expanded
+ * from seed if the switch key does not keep it
  */
 static inline POLY Pk1_at(SW_KEY swk, uint32_t idx) {
-  return Get_pk1(Get_swk_at(swk, idx));
+  CKKS_KEY_GENERATOR* generator = (CKKS_KEY_GENERATOR*)Get_key_gen(Context);
+  return Get_swk_a(swk, idx, Get_param_crt(generator->_params));
 }
 
 /**
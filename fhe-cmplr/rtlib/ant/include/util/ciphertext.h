@@ -199,6 +199,43 @@ static inline void Init_ciphertext(CIPHERTEXT* res, uint32_t ring_degree,
   }
 }
 
+/**
+ * @brief Initialize ciphertext like Init_ciphertext, but res may hold a
+ * buffer handed over by Move_ciph from a ciphertext at another level. The
+ * buffer is kept with its contents if it has room for num_primes and
+ * num_primes_p, otherwise it is regrown. It never shrinks
+ *
+ * @param res ciphertext to be initialized
+ * @param ring_degree Ring degree of polynomial
+ * @param num_primes Number of q primes
+ * @param num_primes_p Number of [] primes
+ * @param scaling_factor Scaling factor
+ * @param sf_degree degree of scaling factor for ciphertext
+ * @param slots slots of ciphertext
+ */
+static inline void Init_ciphertext_reuse(CIPHERTEXT* res, uint32_t ring_degree,
+                                         size_t num_primes, size_t num_primes_p,
+                                         double   scaling_factor,
+                                         uint32_t sf_degree, uint32_t slots) {
+  res->_scaling_factor = scaling_factor;
+  res->_sf_degree      = sf_degree;
+  res->_slots          = slots;
+  POLYNOMIAL* polys[2] = {Get_c0(res), Get_c1(res)};
+  for (uint32_t i = 0; i < 2; ++i) {
+    POLYNOMIAL* poly = polys[i];
+    if (Get_poly_coeffs(poly) != NULL) {
+      IS_TRUE(Get_rdgree(poly) == ring_degree, "unmatched ciphertxt");
+      if (Get_num_alloc_primes(poly) >= num_primes + num_primes_p) {
+        poly->_num_primes   = num_primes;
+        poly->_num_primes_p = num_primes_p;
+        continue;
+      }
+      Free_poly_data(poly);
+    }
+    Alloc_poly_data(poly, ring_degree, num_primes, num_primes_p);
+  }
+}
+
 /**
  * @brief Init ciphertext from another ciphertext
  *
@@ -251,6 +288,21 @@ static inline void Copy_ciphertext(CIPHERTEXT* res, CIPHERTEXT* ciph) {
   Copy_polynomial(Get_c1(res), Get_c1(ciph));
 }
 
+/**
+ * @brief Free data of res and hand data of ciph over to res, ciph is left
+ * empty
+ *
+ * @param res ciphertext taking the data
+ * @param ciph input ciphertext
+ */
+static inline void Move_ciphertext(CIPHERTEXT* res, CIPHERTEXT* ciph) {
+  if (res == ciph) return;
+  Free_poly_data(Get_c0(res));
+  Free_poly_data(Get_c1(res));
+  *res = *ciph;
+  memset(ciph, 0, sizeof(CIPHERTEXT));
+}
+
 /**
  * @brief Set level of ciphertext
  *
@@ -429,6 +481,17 @@ static inline void Free_ciphertext3(CIPHERTEXT3* ciph) {
   ciph = NULL;
 }
 
+//! @brief Free data of res and hand data of ciph over to res, ciph is left
+//! empty
+static inline void Move_ciphertext3(CIPHERTEXT3* res, CIPHERTEXT3* ciph) {
+  if (res == ciph) return;
+  Free_poly_data(Get_ciph3_c0(res));
+  Free_poly_data(Get_ciph3_c1(res));
+  Free_poly_data(Get_ciph3_c2(res));
+  *res = *ciph;
+  memset(ciph, 0, sizeof(CIPHERTEXT3));
+}
+
 //! @brief Init CIPHERTEXT3 from CIPHERTEXT
 static inline void Init_ciphertext3_from_ciph(CIPHERTEXT3* res,
                                               CIPHERTEXT*  ciph,
@@ -47,8 +47,8 @@ typedef struct {
 //! @brief Append stats of weigh plaintext
 static inline void Append_weight_plain(CKKS_ENCODER* encoder, size_t mem_size) {
   WEIGHT_STATS* stats = &(encoder->_stats);
-  stats->_weight_plain_size += mem_size;
-  stats->_weight_plain_cnt++;
+  __atomic_fetch_add(&stats->_weight_plain_size, mem_size, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&stats->_weight_plain_cnt, 1, __ATOMIC_RELAXED);
 }
 
 //! @brief Get memsize & count of weigh plaintext
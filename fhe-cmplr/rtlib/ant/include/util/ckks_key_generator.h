@@ -71,6 +71,8 @@ typedef struct {
   PRECOMP_AUTO_IDX_MAP*   _precomp_auto_idx_map;
   PRECOMP_AUTO_ORDER_MAP* _precomp_auto_order_map;
   AUTO_KEY_MAP*           _auto_key_map;
+  SWK_MODE                _swk_mode;  // how switch keys hold a, from
+                                      // ENV_RT_SWK_COMPRESS
 } CKKS_KEY_GENERATOR;
 
 //! @brief Get secret key from CKKS_KEY_GENERATOR
@@ -133,11 +135,23 @@ void Generate_public_key(CKKS_KEY_GENERATOR* generator);
  * @param generator Generator include ckks parameters
  * @param new_key New key to generate switching key
  * @param old_key Old key
- * @param is_fast Fast key switch or not
  */
 void Generate_switching_key(SWITCH_KEY* res, CKKS_KEY_GENERATOR* generator,
-                            POLYNOMIAL* new_key, POLYNOMIAL* old_key,
-                            bool is_fast);
+                            POLYNOMIAL* new_key, POLYNOMIAL* old_key);
+
+//! @brief Sample uniform half a of part of switch key from its seed into a,
+//! a is allocated with size of the key
+void Expand_swk_a(POLYNOMIAL* a, SWITCH_KEY* swk, size_t part,
+                  CRT_CONTEXT* crt);
+
+//! @brief Get uniform half a of part of switch key. For SWK_TRANSIENT keys
+//! the returned polynomial is scratch of current thread, valid until next
+//! call on the thread
+POLYNOMIAL* Get_swk_a(SWITCH_KEY* swk, size_t part, CRT_CONTEXT* crt);
+
+//! @brief Drop uniform halves a of switch key generated with a seed, they
+//! are expanded again from the seed as given by mode
+void Compress_switch_key(SWITCH_KEY* swk, SWK_MODE mode);
 
 /**
  * @brief Generates a relinearization key for CKKS scheme.
@@ -9,6 +9,7 @@
 #ifndef RTLIB_INCLUDE_POLYNOMIAL_H
 #define RTLIB_INCLUDE_POLYNOMIAL_H
 
+#include "common/rt_stat.h"
 #include "common/rtlib_timing.h"
 #include "util/crt.h"
 #include "util/fhe_types.h"
@@ -61,6 +62,7 @@ static inline void Alloc_poly_data(POLYNOMIAL* poly, uint32_t ring_degree,
   poly->_data       = (int64_t*)malloc(alloc_size);
   poly->_is_ntt     = FALSE;
   memset(poly->_data, 0, alloc_size);
+  Rt_stat_count(RTS_ALLOC_BYTES, alloc_size);
 }
 
 /**
@@ -785,6 +787,13 @@ void Free_switch_key_precomputed(VALUE_LIST* precompute);
 void Sample_uniform_poly(POLYNOMIAL* poly, VL_CRTPRIME* q_primes,
                          VL_CRTPRIME* p_primes);
 
+struct ctr_prng;
+
+//! @brief Sample for polynomial coeffcient with uniform distribution from
+//! key stream of prng, same prng state gives same polynomial
+void Sample_uniform_poly_prng(POLYNOMIAL* poly, VL_CRTPRIME* q_primes,
+                              VL_CRTPRIME* p_primes, struct ctr_prng* prng);
+
 //! @brief Sample for polynomial coeffcient with ternary distribution
 //! @param poly Sampled polynomial
 //! @param q_primes q primes which is used for RNS representation
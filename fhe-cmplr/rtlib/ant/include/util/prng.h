@@ -20,6 +20,15 @@
 #define PRNG_BUFFER_SIZE      1024
 #define UNIX_LIKE_SYSTEM      1
 #define PRNG_VAL_SIZE_IN_BITS 32
+#define CHACHA_BLOCK_WORDS    16  // 32-bit words in one ChaCha20 block
+
+// blocks computed side by side per call, one per 32-bit lane of a SIMD
+// register. Key stream does not depend on it
+#ifdef __AVX2__
+#define CHACHA_LANES 8
+#else
+#define CHACHA_LANES 4
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -94,6 +103,60 @@ static inline int32_t Uniform_int_prng(BLAKE2_PRNG* prng, int32_t min,
   return (int32_t)Uniform_uint_prng(prng, (uint32_t)min, (uint32_t)max);
 }
 
+//! @brief CTR_PRNG is a counter mode generator over the ChaCha20 block
+//! function. The 256-bit key is the seed, the 64-bit stream id selects a
+//! substream and the 64-bit block counter makes it seekable, so parallel
+//! users can draw from disjoint substreams of one key. Blocks are computed
+//! CHACHA_LANES at a time with generic vectors, which lower to the SIMD
+//! instructions of target or to scalar code without SIMD
+typedef struct ctr_prng {
+  uint32_t _key[8];   // 256-bit ChaCha20 key
+  uint64_t _stream;   // substream id, state words 14 and 15
+  uint64_t _block;    // counter of next block, state words 12 and 13
+  uint32_t _buf_idx;  // index in _buf of next word, CHACHA_LANES *
+                      // CHACHA_BLOCK_WORDS if _buf is used up
+  uint32_t _buf[CHACHA_LANES * CHACHA_BLOCK_WORDS];
+} CTR_PRNG;
+
+//! @brief Get CTR_PRNG instance of current thread, keyed from Get_prng
+CTR_PRNG* Get_ctr_prng();
+
+//! @brief Initialize prng with key at block 0 of substream stream
+void Init_ctr_prng(CTR_PRNG* prng, const uint32_t key[8], uint64_t stream);
+
+//! @brief Move prng to the start of block in substream stream
+void Seek_ctr_prng(CTR_PRNG* prng, uint64_t stream, uint64_t block);
+
+//! @brief Fill out with len words of key stream
+void Fill_ctr_prng(CTR_PRNG* prng, uint32_t* out, size_t len);
+
+//! @brief Return next word of key stream
+static inline uint32_t Get_ctr_prng_value(CTR_PRNG* prng) {
+  if (prng->_buf_idx == CHACHA_LANES * CHACHA_BLOCK_WORDS) {
+    uint32_t val;
+    Fill_ctr_prng(prng, &val, 1);
+    return val;
+  }
+  return prng->_buf[prng->_buf_idx++];
+}
+
+//! @brief Return a uniform sampled value in [min, max] from key stream
+static inline uint32_t Uniform_uint_ctr_prng(CTR_PRNG* prng, uint32_t min,
+                                             uint32_t max) {
+  uint32_t range = max - min;
+  if (range == MAX_UINT32) {
+    return Get_ctr_prng_value(prng) + min;
+  }
+  range            = range + 1;
+  uint32_t scaling = MAX_UINT32 / range;
+  uint32_t past    = range * scaling;
+  uint32_t ret;
+  do {
+    ret = Get_ctr_prng_value(prng);
+  } while (ret >= past);
+  return ret / scaling + min;
+}
+
 #ifdef __cplusplus
 }
 #endif
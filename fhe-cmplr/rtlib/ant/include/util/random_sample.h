@@ -27,6 +27,13 @@ extern "C" {
  */
 void Sample_uniform(VALUE_LIST* samples, uint64_t upper_bound);
 
+struct ctr_prng;
+
+//! @brief Samples uniformly from [0, upper_bound) with key stream of prng,
+//! same prng state gives same samples
+void Sample_uniform_prng(VALUE_LIST* samples, uint64_t upper_bound,
+                         struct ctr_prng* prng);
+
 /**
  * @brief samples from a discrete triangle distribution
  * samples num_samples values from [-1, 0, 1] with probabilities
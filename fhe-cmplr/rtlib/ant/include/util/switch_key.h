@@ -9,6 +9,7 @@
 #ifndef RTLIB_INCLUDE_SWITCH_KEY_H
 #define RTLIB_INCLUDE_SWITCH_KEY_H
 
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -23,13 +24,28 @@
 extern "C" {
 #endif
 
+//! @brief How uniform halves a of public keys in switch key are held. a is
+//! sampled from a key stream seeded per switch key, so it can be dropped
+//! and expanded again from the 32-byte seed
+typedef enum {
+  SWK_FULL      = 0,  // a is kept in public keys
+  SWK_LAZY      = 1,  // a is expanded at first use and kept
+  SWK_TRANSIENT = 2,  // a is expanded to per-thread scratch at each use
+} SWK_MODE;
+
 /**
  * @brief An instance of a switch key
  * The switch key consists of number of q parts public keys
  *
  */
 typedef struct {
-  VALUE_LIST* _public_keys;  // PTR_TYPE, num of parts public keys
+  VALUE_LIST*     _public_keys;  // PTR_TYPE, num of parts public keys
+  uint32_t        _seed[8];      // seed of key stream a of public keys
+                                 // sampled from, part index selects the
+                                 // substream
+  SWK_MODE        _mode;         // how a of public keys is held
+  bool            _expanded;     // a of all parts is expanded, for SWK_LAZY
+  pthread_mutex_t _lock;         // serialize expansion of a for SWK_LAZY
 } SWITCH_KEY;
 
 /**
@@ -64,6 +80,10 @@ static inline size_t Get_swk_size(SWITCH_KEY* swk) {
 static inline SWITCH_KEY* Alloc_switch_key() {
   SWITCH_KEY* swk   = (SWITCH_KEY*)malloc(sizeof(SWITCH_KEY));
   swk->_public_keys = NULL;
+  swk->_mode        = SWK_FULL;
+  swk->_expanded    = false;
+  memset(swk->_seed, 0, sizeof(swk->_seed));
+  pthread_mutex_init(&swk->_lock, NULL);
   return swk;
 }
 
@@ -99,6 +119,7 @@ static inline void Free_switch_key(SWITCH_KEY* swk) {
     Free_publickey(pk);
   }
   Free_value_list(swk->_public_keys);
+  pthread_mutex_destroy(&swk->_lock);
   free(swk);
 }
 
@@ -41,6 +41,17 @@ void Init_ciph_same_scale(CIPHER res, CIPHER ciph1, CIPHER ciph2) {
   RTLIB_TM_END(RTM_INIT_CIPH_SM_SC, rtm);
 }
 
+void Init_ciph_same_scale_reuse(CIPHER res, CIPHER ciph1, CIPHER ciph2) {
+  RTLIB_TM_START(RTM_INIT_CIPH_SM_SC, rtm);
+  CIPHER ciph = ciph2 != NULL ? Adjust_level(ciph1, ciph2, false, NULL) : ciph1;
+  Init_ciphertext_reuse(res, Get_ciph_degree(ciph), Level(ciph),
+                        Get_num_p(Get_c0(ciph)), Get_ciph_sfactor(ciph),
+                        Sc_degree(ciph), Get_ciph_slots(ciph));
+  Set_is_ntt(Get_c0(res), true);
+  Set_is_ntt(Get_c1(res), true);
+  RTLIB_TM_END(RTM_INIT_CIPH_SM_SC, rtm);
+}
+
 void Init_ciph_same_scale_plain(CIPHER res, CIPHER ciph, PLAIN plain) {
   RTLIB_TM_START(RTM_INIT_CIPH_SM_SC, rtm);
   Init_cipher(res, ciph, Get_ciph_sfactor(ciph), Sc_degree(ciph));
@@ -118,6 +129,10 @@ void Copy_ciph(CIPHER res, CIPHER ciph) {
   RTLIB_TM_END(RTM_COPY_CIPH, rtm);
 }
 
+void Move_ciph(CIPHER res, CIPHER ciph) { Move_ciphertext(res, ciph); }
+
+void Move_ciph3(CIPHER3 res, CIPHER3 ciph) { Move_ciphertext3(res, ciph); }
+
 size_t Level(CIPHER ciph) { return Get_ciph_level(ciph); }
 
 uint32_t Sc_degree(CIPHER ciph) { return Get_ciph_sf_degree(ciph); }
@@ -8,8 +8,10 @@
 
 #include "ckks/plain_eval.h"
 
+#include <pthread.h>
 #include <unistd.h>
 
+#include "common/rt_env.h"
 #include "fhe/core/rt_encode_api.h"
 #include "fhe/core/rt_version.h"
 #include "util/plaintext.h"
@@ -41,6 +43,137 @@ void Encode_plain_from_float(PLAIN plain, float* input, size_t len,
   RTLIB_TM_END(RTM_PT_ENCODE, rtm);
 }
 
+//! @brief Key of cached plaintext, compared as bytes
+typedef struct {
+  float*   _input;
+  size_t   _len;
+  uint32_t _sc_degree;
+  uint32_t _level;
+} PT_CACHE_KEY;
+
+//! @brief Plaintext encoded from constant data
+typedef struct {
+  PT_CACHE_KEY   _key;
+  PLAINTEXT      _plain;
+  UT_hash_handle HH;
+} PT_CACHE_ENTRY;
+
+//! @brief Plaintext cache kept in CKKS_CONTEXT. Entries are in the order of
+//! use, the least recently used one at the head is evicted first
+typedef struct {
+  PT_CACHE_ENTRY* _entry;
+  size_t          _size;      // memory size of cached plaintexts
+  size_t          _max_size;  // bound of _size from ENV_PT_CACHE_SIZE
+  size_t          _hit;       // number of encodings saved
+} PT_CACHE;
+
+static void Copy_plain(PLAINTEXT* dest, PLAINTEXT* src) {
+  POLYNOMIAL* poly = Get_plain_poly(src);
+  Init_plaintext(dest, Get_rdgree(poly), Get_plain_slots(src),
+                 Get_num_q(poly), Get_num_p(poly),
+                 Get_plain_scaling_factor(src), Get_plain_sf_degree(src));
+  Copy_polynomial(Get_plain_poly(dest), poly);
+}
+
+static void Free_plain_entry(PT_CACHE_ENTRY* entry) {
+  Free_poly_data(Get_plain_poly(&entry->_plain));
+  free(entry);
+}
+
+// plaintext cache is reached from parallel loops in generated code, it is
+// only accessed with Pt_cache_lock held while encoding runs without it
+static pthread_mutex_t Pt_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+//! @brief Get plaintext cache, create it at the first call. Must be called
+//! with Pt_cache_lock held
+static PT_CACHE* Plain_cache() {
+  PT_CACHE* cache = (PT_CACHE*)Context->_pt_cache;
+  if (cache == NULL) {
+    cache = (PT_CACHE*)malloc(sizeof(PT_CACHE));
+    memset(cache, 0, sizeof(PT_CACHE));
+    const char* env  = getenv(ENV_PT_CACHE_SIZE);
+    int         size = env ? atoi(env) : -1;
+    cache->_max_size = (size_t)(size < 0 ? 1024 : size) << 20;
+    Context->_pt_cache = (PTR_TY)cache;
+  }
+  return cache;
+}
+
+void Encode_plain_from_float_cached(PLAIN plain, float* input, size_t len,
+                                    uint32_t sc_degree, uint32_t level) {
+  PT_CACHE_KEY key;
+  memset(&key, 0, sizeof(key));
+  key._input     = input;
+  key._len       = len;
+  key._sc_degree = sc_degree;
+  key._level     = level;
+
+  pthread_mutex_lock(&Pt_cache_lock);
+  PT_CACHE*       cache    = Plain_cache();
+  size_t          max_size = cache->_max_size;
+  PT_CACHE_ENTRY* entry;
+  HASH_FIND(HH, cache->_entry, &key, sizeof(PT_CACHE_KEY), entry);
+  if (entry != NULL) {
+    RTLIB_TM_START(RTM_PT_CACHE, rtm);
+    Copy_plain(plain, &entry->_plain);
+    // move to tail as the most recently used
+    HASH_DEL(cache->_entry, entry);
+    HASH_ADD(HH, cache->_entry, _key, sizeof(PT_CACHE_KEY), entry);
+    cache->_hit++;
+    RTLIB_TM_END(RTM_PT_CACHE, rtm);
+    pthread_mutex_unlock(&Pt_cache_lock);
+    return;
+  }
+  pthread_mutex_unlock(&Pt_cache_lock);
+
+  Encode_plain_from_float(plain, input, len, sc_degree, level);
+  size_t size = Get_plain_mem_size(plain);
+  if (size > max_size) return;
+  entry = (PT_CACHE_ENTRY*)malloc(sizeof(PT_CACHE_ENTRY));
+  memset(entry, 0, sizeof(PT_CACHE_ENTRY));
+  entry->_key = key;
+  Copy_plain(&entry->_plain, plain);
+  pthread_mutex_lock(&Pt_cache_lock);
+  PT_CACHE_ENTRY* found;
+  HASH_FIND(HH, cache->_entry, &key, sizeof(PT_CACHE_KEY), found);
+  // keep the entry added by another thread meanwhile
+  if (found == NULL) {
+    while (cache->_entry != NULL && cache->_size + size > max_size) {
+      PT_CACHE_ENTRY* lru = cache->_entry;
+      HASH_DEL(cache->_entry, lru);
+      cache->_size -= Get_plain_mem_size(&lru->_plain);
+      Free_plain_entry(lru);
+    }
+    HASH_ADD(HH, cache->_entry, _key, sizeof(PT_CACHE_KEY), entry);
+    cache->_size += size;
+    entry         = NULL;
+  }
+  pthread_mutex_unlock(&Pt_cache_lock);
+  if (entry != NULL) {
+    Free_plain_entry(entry);
+  }
+}
+
+void Get_plain_cache(size_t* size, size_t* cnt, size_t* hit) {
+  PT_CACHE* cache = (PT_CACHE*)Context->_pt_cache;
+  *size           = cache ? cache->_size : 0;
+  *cnt            = cache ? HASH_COUNT(cache->_entry) : 0;
+  *hit            = cache ? cache->_hit : 0;
+}
+
+void Free_plain_cache() {
+  PT_CACHE* cache = (PT_CACHE*)Context->_pt_cache;
+  if (cache == NULL) return;
+  PT_CACHE_ENTRY* entry;
+  PT_CACHE_ENTRY* tmp;
+  HASH_ITER(HH, cache->_entry, entry, tmp) {
+    HASH_DEL(cache->_entry, entry);
+    Free_plain_entry(entry);
+  }
+  free(cache);
+  Context->_pt_cache = NULL;
+}
+
 void Encode_plain_from_double(PLAIN plain, double* input, size_t len,
                               uint32_t sc_degree, uint32_t level) {
   RTLIB_TM_START(RTM_PT_ENCODE, rtm);
@@ -159,6 +292,11 @@ void* Cast_buffer_to_plain(struct PLAINTEXT_BUFFER* buf) {
   return (void*)pt;
 }
 
+void Copy_plain_from_buffer(void* plain, struct PLAINTEXT_BUFFER* buf) {
+  // weight stats are appended when buffer is encoded
+  Copy_plain((PLAINTEXT*)plain, (PLAINTEXT*)Cast_buffer_to_plain(buf));
+}
+
 bool Compare_plain_buffer(const struct PLAINTEXT_BUFFER* pb_x,
                           const struct PLAINTEXT_BUFFER* pb_y) {
   if (memcmp(pb_x, pb_y, sizeof(struct PLAINTEXT_BUFFER)) != 0) {
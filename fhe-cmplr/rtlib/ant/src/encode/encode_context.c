@@ -40,6 +40,7 @@ void Prepare_encode_context(uint32_t degree, uint32_t sec_level, uint32_t depth,
   CKKS_ENCODER* encoder = Alloc_ckks_encoder(params);
   ctxt->_params         = (PTR_TY)params;
   ctxt->_encoder        = (PTR_TY)encoder;
+  ctxt->_pt_cache       = NULL;
   Context               = ctxt;
 }
 
@@ -56,6 +57,6 @@ void Finalize_encode_context() {
   Context = NULL;
 }
 
-CRT_CONTEXT* Get_crt_context() {
+ATTRIBUTE_WEAK CRT_CONTEXT* Get_crt_context() {
   return Get_param_crt((CKKS_PARAMETER*)Get_param(Context));
 }
@@ -25,6 +25,20 @@ int64_t* Hw_modadd(int64_t* res, int64_t* val1, int64_t* val2, MODULUS* modulus,
   return res;
 }
 
+int64_t* Hw_modsub(int64_t* res, int64_t* val1, int64_t* val2, MODULUS* modulus,
+                   uint32_t degree) {
+  RTLIB_TM_START(RTM_HW_SUB, rtm);
+  int64_t mod = Get_mod_val(modulus);
+  for (uint32_t idx = 0; idx < degree; idx++) {
+    *res = Sub_int64_with_mod(*val1, *val2, mod);
+    val1++;
+    val2++;
+    res++;
+  }
+  RTLIB_TM_END(RTM_HW_SUB, rtm);
+  return res;
+}
+
 int64_t* Hw_modmul(int64_t* res, int64_t* val1, int64_t* val2, MODULUS* modulus,
                    uint32_t degree) {
   RTLIB_TM_START(RTM_HW_MUL, rtm);
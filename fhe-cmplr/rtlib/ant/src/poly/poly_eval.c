@@ -8,10 +8,14 @@
 
 #include "poly/poly_eval.h"
 
+#include "common/rt_stat.h"
+
 POLY Decomp(POLY res, POLY poly, uint32_t q_part_idx) {
   RTLIB_TM_START(RTM_DECOMP, rtm);
   CRT_CONTEXT* crt = Get_crt_context();
   Decompose_poly(res, poly, crt, Num_decomp(poly), q_part_idx);
+  // key switching in generated code decomposes parts from the first one
+  if (q_part_idx == 0) Rt_stat_count(RTS_KEY_SWITCH, 1);
   RTLIB_TM_END(RTM_DECOMP, rtm);
   return res;
 }
@@ -29,6 +33,7 @@ POLY Decomp_modup(POLY res, POLY poly, uint32_t q_part_idx) {
   RTLIB_TM_START(RTM_DECOMP_MODUP, rtm);
   CRT_CONTEXT* crt = Get_crt_context();
   Decompose_modup(res, poly, crt, Num_decomp(poly), q_part_idx);
+  if (q_part_idx == 0) Rt_stat_count(RTS_KEY_SWITCH, 1);
   RTLIB_TM_END(RTM_DECOMP_MODUP, rtm);
   return res;
 }
@@ -10,8 +10,10 @@
 
 #include <stdlib.h>
 
+#include "ckks/plain_eval.h"
 #include "common/io_api.h"
 #include "common/pt_mgr.h"
+#include "common/rt_stat.h"
 #include "common/rtlib.h"
 #include "common/rtlib_timing.h"
 #include "util/ckks_bootstrap_context.h"
@@ -71,6 +73,7 @@ void Prepare_context() {
   ctxt->_encryptor     = (PTR_TY)encryptor;
   ctxt->_decryptor     = (PTR_TY)decryptor;
   ctxt->_evaluator     = (PTR_TY)evaluator;
+  ctxt->_pt_cache      = NULL;
 
   Context = ctxt;
 
@@ -108,6 +111,15 @@ void Finalize_context() {
     Free_ckks_key_generator((CKKS_KEY_GENERATOR*)Context->_key_generator);
     Context->_key_generator = NULL;
   }
+  if (Context->_pt_cache) {
+    size_t pt_cache_cnt, pt_cache_size, pt_cache_hit;
+    Get_plain_cache(&pt_cache_size, &pt_cache_cnt, &pt_cache_hit);
+    printf(
+        "Total memory size for cached plain: cnt = %ld, size = %ld bytes, "
+        "hit = %ld\n",
+        pt_cache_cnt, pt_cache_size, pt_cache_hit);
+    Free_plain_cache();
+  }
   if (Context->_encoder) {
     size_t weight_plain_cnt, weight_plain_size;
     Get_weight_plain((CKKS_ENCODER*)Context->_encoder, &weight_plain_size,
@@ -133,6 +145,7 @@ void Finalize_context() {
   Context = NULL;
   RTLIB_TM_END(RTM_FINALIZE_CONTEXT, rtm);
   RTLIB_TM_REPORT();
+  Report_rt_stat();
   Io_fini();
   Close_trace_file();
 }
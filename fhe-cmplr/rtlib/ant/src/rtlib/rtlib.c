@@ -17,9 +17,30 @@
 #include "util/plaintext.h"
 #include "util/polynomial.h"
 
+//! @brief Return TRUE if images in a batch are packed with a stride
+static inline bool Is_batch_scheme(DATA_SCHEME* scheme) {
+  return scheme->_count == 1 && scheme->_desc[0]._kind == NORMAL &&
+         scheme->_desc[0]._stride > 0;
+}
+
 VALUE_LIST* Pre_encode_scheme(TENSOR* image, DATA_SCHEME* scheme) {
   // TODO: post decode from DATA_SCHEME
-  size_t      len = TENSOR_SIZE(image);
+  size_t len = TENSOR_SIZE(image);
+  if (Is_batch_scheme(scheme)) {
+    // scatter image n to [n * stride, n * stride + count)
+    MAP_DESC* desc  = &scheme->_desc[0];
+    size_t    count = TENSOR_C(image) * TENSOR_H(image) * TENSOR_W(image);
+    IS_TRUE(TENSOR_N(image) == scheme->_shape._n, "batch mismatch");
+    IS_TRUE(count == desc->_count, "image size mismatch");
+    VALUE_LIST* res = Alloc_value_list(DCMPLX_TYPE, desc->_end + 1);
+    size_t      idx = 0;
+    FOR_ALL_TENSOR_ELEM(image, n, c, h, w) {
+      DCMPLX_VALUE_AT(res, n * desc->_stride + idx % count) =
+          TENSOR_ELEM(image, n, c, h, w);
+      idx++;
+    }
+    return res;
+  }
   VALUE_LIST* res = Alloc_value_list(DCMPLX_TYPE, len);
   size_t      idx = 0;
   FOR_ALL_TENSOR_ELEM(image, n, c, h, w) {
@@ -33,6 +54,20 @@ VALUE_LIST* Pre_encode_scheme(TENSOR* image, DATA_SCHEME* scheme) {
 double* Post_decode_scheme(VALUE_LIST* vec, DATA_SCHEME* scheme) {
   // TODO: post decode from DATA_SCHEME
   IS_TRUE(LIST_TYPE(vec) == DCMPLX_TYPE, "invalid type");
+  if (Is_batch_scheme(scheme)) {
+    // gather image n from [n * stride, n * stride + count)
+    MAP_DESC* desc  = &scheme->_desc[0];
+    size_t    batch = scheme->_shape._n;
+    IS_TRUE(desc->_end < LIST_LEN(vec), "invalid length of vector");
+    double* data = (double*)malloc(batch * desc->_count * sizeof(double));
+    for (size_t n = 0; n < batch; n++) {
+      for (size_t i = 0; i < desc->_count; i++) {
+        data[n * desc->_count + i] =
+            creal(Get_dcmplx_value_at(vec, n * desc->_stride + i));
+      }
+    }
+    return data;
+  }
   double* data = (double*)malloc(LIST_LEN(vec) * sizeof(double));
   FOR_ALL_ELEM(vec, idx) { data[idx] = creal(Get_dcmplx_value_at(vec, idx)); }
   return data;
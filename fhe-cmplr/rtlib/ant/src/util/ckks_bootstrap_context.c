@@ -1234,6 +1234,67 @@ SWITCH_KEY* Get_rotation_key(CKKS_BTS_CTX* bts_ctx, int32_t rot_val) {
   return key;
 }
 
+//! @brief Max number of threads for parallel loops of linear transforms, 1
+//! if built without OpenMP
+static inline int32_t Bts_max_threads() {
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+//! @brief Thread index in current parallel loop, 0 if built without OpenMP
+static inline int32_t Bts_thread_id() {
+#ifdef _OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+//! @brief Inner product of hoisted rotations and plaintexts of a giant step
+//! on one RNS limb of extended basis PQ, so that a giant step with all its
+//! limbs can be spread over threads
+static void Bsgs_inner_product_limb(CIPHERTEXT* inner, VL_CIPH* fast_rot,
+                                    VL_PLAIN* vl_pre, int32_t giant,
+                                    int32_t num_baby, int32_t num_rot,
+                                    size_t limb, CRT_CONTEXT* crt) {
+  uint32_t   degree  = Get_rdgree(Get_c0(inner));
+  size_t     num_q   = Get_num_q(Get_c0(inner));
+  CRT_PRIME* prime   = limb < num_q
+                           ? Get_vlprime_at(Get_q_primes(crt), limb)
+                           : Get_vlprime_at(Get_p_primes(crt), limb - num_q);
+  MODULUS*   modulus = Get_modulus(prime);
+  int64_t    mod_val = Get_mod_val(modulus);
+  int64_t*   res0    = Get_poly_coeffs(Get_c0(inner)) + limb * degree;
+  int64_t*   res1    = Get_poly_coeffs(Get_c1(inner)) + limb * degree;
+  for (int32_t j = 0; j < num_baby; j++) {
+    if (j > 0 && (giant + j) == num_rot) {
+      continue;
+    }
+    CIPHERTEXT* rot_ciph = (CIPHERTEXT*)Get_ptr_value_at(fast_rot, j);
+    PLAINTEXT*  plain    = (PLAINTEXT*)Get_ptr_value_at(vl_pre, giant + j);
+    // derive a sub plain to make sure poly level consistent with rot_ciph
+    PLAINTEXT sub_plain;
+    Derive_plain(&sub_plain, plain, num_q, Get_num_p(Get_c0(rot_ciph)));
+    POLYNOMIAL* plain_poly = Get_plain_poly(&sub_plain);
+    IS_TRUE(Is_ntt(plain_poly), "plaintext is not ntt form");
+    // limb of P part follows Q part, both in plain and ciphertext
+    int64_t* pt = limb < num_q
+                      ? Get_poly_coeffs(plain_poly) + limb * degree
+                      : Get_p_coeffs(plain_poly) + (limb - num_q) * degree;
+    int64_t* ct0 = Get_poly_coeffs(Get_c0(rot_ciph)) + limb * degree;
+    int64_t* ct1 = Get_poly_coeffs(Get_c1(rot_ciph)) + limb * degree;
+    for (uint32_t d = 0; d < degree; d++) {
+      int64_t m0 = Mul_int64_mod_barret(ct0[d], pt[d], modulus);
+      int64_t m1 = Mul_int64_mod_barret(ct1[d], pt[d], modulus);
+      res0[d]    = j == 0 ? m0 : Add_int64_with_mod(res0[d], m0, mod_val);
+      res1[d]    = j == 0 ? m1 : Add_int64_with_mod(res1[d], m1, mod_val);
+    }
+  }
+}
+
 CIPHERTEXT* Rotate_iteration(CIPHERTEXT* result, CKKS_BTS_CTX* bts_ctx,
                              VL_VL_PLAIN* conj_pre, VL_VL_I32* rot_in,
                              VL_VL_I32* rot_out, int32_t step, bool encoding,
@@ -1258,10 +1319,6 @@ CIPHERTEXT* Rotate_iteration(CIPHERTEXT* result, CKKS_BTS_CTX* bts_ctx,
   int32_t g_rem        = Get_i32_value_at(param, GIANT_STEP_REM);
   int32_t b_rem        = Get_i32_value_at(param, BABY_STEP_REM);
 
-  CIPHERTEXT* outer     = Alloc_ciphertext();
-  CIPHERTEXT* inner     = Alloc_ciphertext();
-  CIPHERTEXT* temp_ciph = Alloc_ciphertext();
-
   int32_t giant_step = is_rem ? g_rem : g;
   int32_t baby_step  = is_rem ? b_rem : b;
   int32_t num_rot    = is_rem ? num_rots_rem : num_rots;
@@ -1275,107 +1332,160 @@ CIPHERTEXT* Rotate_iteration(CIPHERTEXT* result, CKKS_BTS_CTX* bts_ctx,
   VL_CRTPRIME* p_modulus   = Get_p_primes(crt);
   size_t       p_prime_cnt = ckks_params->_num_p_primes;
 
-  POLYNOMIAL first, temp_poly;
-  Alloc_poly_data(&first, degree, prime_cnt, p_prime_cnt);
-  Alloc_poly_data(&temp_poly, degree, prime_cnt, p_prime_cnt);
+  POLYNOMIAL psi_c0;
+  Alloc_poly_data(&psi_c0, degree, prime_cnt, 0);
 
   // computes the NTTs for each CRT limb (for the hoisted automorphisms used
   // later on)
   VALUE_LIST* digits = Switch_key_precompute(Get_c1(result), crt);
 
+  // P * c0 is same for all hoisted rotations, raise it once and rotate the
+  // raised one instead of raising c0 in each Fast_rotate_ext
+  Scalars_integer_multiply_poly(&psi_c0, Get_c0(result), Get_pmodq(Get_p(crt)),
+                                Get_q(crt), NULL);
+  if (!Is_ntt(&psi_c0)) {
+    Conv_poly2ntt_inplace(&psi_c0, crt);
+  }
+
   VL_CIPH*    fast_rot  = Alloc_value_list(PTR_TYPE, giant_step);
   VALUE_LIST* vl_rot_in = Get_vl_value_at(rot_in, step);
-
   for (int32_t j = 0; j < giant_step; j++) {
-    int32_t val               = Get_i32_value_at(vl_rot_in, j);
     PTR_VALUE_AT(fast_rot, j) = (PTR)Alloc_ciphertext();
-    CIPHERTEXT* rot_ciph      = (CIPHERTEXT*)Get_ptr_value_at(fast_rot, j);
+  }
+
+  // hoisted rotations are independent of each other
+#pragma omp parallel for schedule(dynamic)
+  for (int32_t j = 0; j < giant_step; j++) {
+    int32_t     val      = Get_i32_value_at(vl_rot_in, j);
+    CIPHERTEXT* rot_ciph = (CIPHERTEXT*)Get_ptr_value_at(fast_rot, j);
     if (val != 0) {
       SWITCH_KEY* rot_key = Get_rotation_key(bts_ctx, val);
-      Fast_rotate_ext(rot_ciph, result, val, rot_key, eval, digits, true);
+      Fast_rotate_ext(rot_ciph, result, val, rot_key, eval, digits, FALSE);
+      uint32_t auto_idx = Get_precomp_auto_idx(eval->_keygen, val);
+      IS_TRUE(auto_idx, "cannot get auto_idx");
+      VALUE_LIST* precomp = Get_precomp_auto_order(eval->_keygen, auto_idx);
+      POLYNOMIAL  psi_rot;
+      Alloc_poly_data(&psi_rot, degree, prime_cnt, 0);
+      Rotate_poly(&psi_rot, &psi_c0, auto_idx, precomp, crt);
+      Add_poly(Get_c0(rot_ciph), Get_c0(rot_ciph), &psi_rot, crt, NULL);
+      Free_poly_data(&psi_rot);
     } else {
       Switch_key_ext(rot_ciph, result, eval, true);
     }
   }
 
+  // double hoisting: baby-step products are accumulated in extended basis
+  // PQ, only c1 of each giant step is reduced to Q for its key switch. c0 of
+  // giant steps and key switched results stay in PQ and are reduced once
+  // after the loop
+  VALUE_LIST* vl_pre     = Get_vl_value_at(conj_pre, step);
+  VALUE_LIST* vl_rot_out = Get_vl_value_at(rot_out, step);
+  CIPHERTEXT* rot_ciph_0 = (CIPHERTEXT*)Get_ptr_value_at(fast_rot, 0);
+  PLAINTEXT*  plain_0    = (PLAINTEXT*)Get_ptr_value_at(vl_pre, 0);
+  double      sf = rot_ciph_0->_scaling_factor * plain_0->_scaling_factor;
+  uint32_t    sf_degree  = rot_ciph_0->_sf_degree + plain_0->_sf_degree;
+  size_t      num_limb   = prime_cnt + p_prime_cnt;
+  VL_CIPH*    inner_list = Alloc_value_list(PTR_TYPE, baby_step);
   for (int32_t i = 0; i < baby_step; i++) {
-    int32_t     giant      = giant_step * i;
-    CIPHERTEXT* rot_ciph_0 = (CIPHERTEXT*)Get_ptr_value_at(fast_rot, 0);
-    VALUE_LIST* vl_pre     = Get_vl_value_at(conj_pre, step);
-    PLAINTEXT*  plain      = (PLAINTEXT*)Get_ptr_value_at(vl_pre, giant);
-    // derive a sub plain to make sure poly level consistent with rot_ciph
-    PLAINTEXT sub_plain;
-    Derive_plain(&sub_plain, plain, Get_num_q(Get_c0(rot_ciph_0)),
-                 Get_num_p(Get_c0(rot_ciph_0)));
-    Mul_plaintext(inner, rot_ciph_0, &sub_plain, eval);
-    // continue the loop
-    for (int32_t j = 1; j < giant_step; j++) {
-      CIPHERTEXT* rot_ciph_j = (CIPHERTEXT*)Get_ptr_value_at(fast_rot, j);
-      if ((giant + j) != (int32_t)(num_rot)) {
-        PLAINTEXT* plain_j = (PLAINTEXT*)Get_ptr_value_at(vl_pre, giant + j);
-        // derive a sub plain to make sure poly level consistent with rot_ciph
-        PLAINTEXT sub_plain_j;
-        Derive_plain(&sub_plain_j, plain_j, Get_num_q(Get_c0(rot_ciph_j)),
-                     Get_num_p(Get_c0(rot_ciph_j)));
-        Mul_plaintext(temp_ciph, rot_ciph_j, &sub_plain_j, eval);
-        Add_ciphertext(inner, inner, temp_ciph, eval);
-      }
+    CIPHERTEXT* inner = Alloc_ciphertext();
+    Init_ciphertext(inner, degree, prime_cnt, p_prime_cnt, sf, sf_degree,
+                    slots);
+    Set_is_ntt(Get_c0(inner), TRUE);
+    Set_is_ntt(Get_c1(inner), TRUE);
+    PTR_VALUE_AT(inner_list, i) = (PTR)inner;
+  }
+
+  // inner products are split by RNS limb too, to keep all threads busy when
+  // there are less giant steps than threads
+#pragma omp parallel for collapse(2) schedule(static)
+  for (int32_t i = 0; i < baby_step; i++) {
+    for (size_t limb = 0; limb < num_limb; limb++) {
+      CIPHERTEXT* inner = (CIPHERTEXT*)Get_ptr_value_at(inner_list, i);
+      Bsgs_inner_product_limb(inner, fast_rot, vl_pre, giant_step * i,
+                              giant_step, num_rot, limb, crt);
     }
+  }
 
-    if (i == 0) {
-      Copy_polynomial(&first, Get_c0(inner));
-      memset(Get_c0(inner)->_data, 0, Get_poly_mem_size(Get_c0(inner)));
-      Copy_ciphertext(outer, inner);
-    } else {
-      VALUE_LIST* vl_rot_out = Get_vl_value_at(rot_out, step);
-      int32_t     val        = Get_i32_value_at(vl_rot_out, i);
-      if (val != 0) {
-        CIPHERTEXT* reduce_ciph = Alloc_ciphertext();
-        Init_ciphertext_from_poly(reduce_ciph, &first, inner->_scaling_factor,
-                                  inner->_sf_degree, Get_ciph_slots(inner));
-        Copy_polynomial(Get_c0(reduce_ciph), Get_c0(inner));
-        Reduce_rns_base(Get_c1(reduce_ciph), Get_c1(inner), crt);
-        uint32_t auto_idx = Get_precomp_auto_idx(eval->_keygen, val);
-        IS_TRUE(auto_idx, "cannot get auto_idx");
-        VALUE_LIST* precomp = Get_precomp_auto_order(eval->_keygen, auto_idx);
-        Rotate_poly(&temp_poly, Get_c0(reduce_ciph), auto_idx, precomp, crt);
-        Add_poly(&first, &first, &temp_poly, crt, p_modulus);
-
-        VALUE_LIST* inner_digits =
-            Switch_key_precompute(Get_c1(reduce_ciph), crt);
-        SWITCH_KEY* rot_key = Get_rotation_key(bts_ctx, val);
-        Fast_rotate_ext(temp_ciph, reduce_ciph, val, rot_key, eval,
-                        inner_digits, FALSE);
-        Add_ciphertext(outer, outer, temp_ciph, eval);
-
-        Free_ciphertext(reduce_ciph);
-        Free_switch_key_precomputed(inner_digits);
-      } else {
-        Copy_polynomial(&temp_poly, Get_c0(inner));
-        Add_poly(&first, &first, &temp_poly, crt, p_modulus);
-        memset(Get_c0(inner)->_data, 0, Get_poly_mem_size(Get_c0(inner)));
-        Add_ciphertext(outer, outer, inner, eval);
-      }
+  // giant steps are accumulated into per-thread accumulators in PQ, which
+  // are merged after the loop. modular additions are exact, so the result
+  // does not depend on number of threads
+  int32_t num_acc = Bts_max_threads();
+  if (num_acc > baby_step) {
+    num_acc = baby_step;
+  }
+  VL_CIPH* acc_list = Alloc_value_list(PTR_TYPE, num_acc);
+  for (int32_t t = 0; t < num_acc; t++) {
+    CIPHERTEXT* acc = Alloc_ciphertext();
+    Init_ciphertext(acc, degree, prime_cnt, p_prime_cnt, sf, sf_degree, slots);
+    Set_is_ntt(Get_c0(acc), TRUE);
+    Set_is_ntt(Get_c1(acc), TRUE);
+    PTR_VALUE_AT(acc_list, t) = (PTR)acc;
+  }
+
+#pragma omp parallel for schedule(dynamic) num_threads(num_acc)
+  for (int32_t i = 0; i < baby_step; i++) {
+    CIPHERTEXT* acc = (CIPHERTEXT*)Get_ptr_value_at(acc_list, Bts_thread_id());
+    CIPHERTEXT* inner = (CIPHERTEXT*)Get_ptr_value_at(inner_list, i);
+    int32_t     val   = i == 0 ? 0 : Get_i32_value_at(vl_rot_out, i);
+    if (val == 0) {
+      Add_poly(Get_c0(acc), Get_c0(acc), Get_c0(inner), crt, p_modulus);
+      Add_poly(Get_c1(acc), Get_c1(acc), Get_c1(inner), crt, p_modulus);
+      continue;
     }
+    uint32_t auto_idx = Get_precomp_auto_idx(eval->_keygen, val);
+    IS_TRUE(auto_idx, "cannot get auto_idx");
+    VALUE_LIST* precomp = Get_precomp_auto_order(eval->_keygen, auto_idx);
+    POLYNOMIAL  rot_c0;
+    Alloc_poly_data(&rot_c0, degree, prime_cnt, p_prime_cnt);
+    Rotate_poly(&rot_c0, Get_c0(inner), auto_idx, precomp, crt);
+    Add_poly(Get_c0(acc), Get_c0(acc), &rot_c0, crt, p_modulus);
+    Free_poly_data(&rot_c0);
+
+    // the only ModDown of the giant step. c0 of reduce_ciph is not read by
+    // Fast_rotate_ext without add_first, it only marks the key switch output
+    // as NTT
+    CIPHERTEXT* reduce_ciph = Alloc_ciphertext();
+    CIPHERTEXT* temp_ciph   = Alloc_ciphertext();
+    Init_ciphertext(reduce_ciph, degree, prime_cnt, 0, sf, sf_degree, slots);
+    Set_is_ntt(Get_c0(reduce_ciph), TRUE);
+    Reduce_rns_base(Get_c1(reduce_ciph), Get_c1(inner), crt);
+    VALUE_LIST* inner_digits = Switch_key_precompute(Get_c1(reduce_ciph), crt);
+    SWITCH_KEY* rot_key      = Get_rotation_key(bts_ctx, val);
+    Fast_rotate_ext(temp_ciph, reduce_ciph, val, rot_key, eval, inner_digits,
+                    FALSE);
+    Add_poly(Get_c0(acc), Get_c0(acc), Get_c0(temp_ciph), crt, p_modulus);
+    Add_poly(Get_c1(acc), Get_c1(acc), Get_c1(temp_ciph), crt, p_modulus);
+    Free_switch_key_precomputed(inner_digits);
+    Free_ciphertext(temp_ciph);
+    Free_ciphertext(reduce_ciph);
+  }
+
+  CIPHERTEXT* outer = (CIPHERTEXT*)Get_ptr_value_at(acc_list, 0);
+  for (int32_t t = 1; t < num_acc; t++) {
+    CIPHERTEXT* acc = (CIPHERTEXT*)Get_ptr_value_at(acc_list, t);
+    Add_poly(Get_c0(outer), Get_c0(outer), Get_c0(acc), crt, p_modulus);
+    Add_poly(Get_c1(outer), Get_c1(outer), Get_c1(acc), crt, p_modulus);
   }
-  Add_poly(Get_c0(outer), Get_c0(outer), &first, crt, p_modulus);
   Reduce_rns_base(Get_c0(result), Get_c0(outer), crt);
   Reduce_rns_base(Get_c1(result), Get_c1(outer), crt);
   // set scaling_factor from outer
   result->_scaling_factor = outer->_scaling_factor;
   result->_sf_degree      = outer->_sf_degree;
 
+  FOR_ALL_ELEM(acc_list, idx) {
+    Free_ciphertext((CIPHERTEXT*)Get_ptr_value_at(acc_list, idx));
+  }
+  FOR_ALL_ELEM(inner_list, idx) {
+    Free_ciphertext((CIPHERTEXT*)Get_ptr_value_at(inner_list, idx));
+  }
   FOR_ALL_ELEM(fast_rot, idx) {
-    CIPHERTEXT* ciph = (CIPHERTEXT*)Get_ptr_value_at(fast_rot, idx);
-    Free_ciphertext(ciph);
+    Free_ciphertext((CIPHERTEXT*)Get_ptr_value_at(fast_rot, idx));
   }
+  Free_value_list(acc_list);
+  Free_value_list(inner_list);
   Free_value_list(fast_rot);
   Free_switch_key_precomputed(digits);
-  Free_ciphertext(outer);
-  Free_ciphertext(inner);
-  Free_ciphertext(temp_ciph);
-  Free_poly_data(&first);
-  Free_poly_data(&temp_poly);
+  Free_poly_data(&psi_c0);
 
   return result;
 }
@@ -1616,6 +1726,7 @@ CIPHERTEXT* Eval_bootstrap(CIPHERTEXT* res, CIPHERTEXT* ciph,
   IS_TRACE_CMD(
       Print_cipher_msg(Get_trace_file(), "before bts", ciph, DEF_MSG_LEN));
   // raise mod (q)
+  RTLIB_TM_START(RTM_BS_MOD_RAISE, rtm_raise);
   CIPHERTEXT* raised = Alloc_ciphertext();
   Init_ciphertext_from_ciph(raised, ciph, ciph->_scaling_factor,
                             ciph->_sf_degree);
@@ -1645,6 +1756,7 @@ CIPHERTEXT* Eval_bootstrap(CIPHERTEXT* res, CIPHERTEXT* ciph,
   // convert new_ciph to ntt
   Conv_poly2ntt_inplace(Get_c0(new_ciph), crt);
   Conv_poly2ntt_inplace(Get_c1(new_ciph), crt);
+  RTLIB_TM_END(RTM_BS_MOD_RAISE, rtm_raise);
 
   IS_TRACE_CMD(Print_cipher_poly(Get_trace_file(), "raised", new_ciph));
 
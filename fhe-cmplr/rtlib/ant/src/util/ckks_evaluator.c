@@ -8,6 +8,7 @@
 
 #include "util/ckks_evaluator.h"
 
+#include "common/rt_stat.h"
 #include "common/trace.h"
 #include "util/ciphertext.h"
 #include "util/ckks_bootstrap_context.h"
@@ -420,6 +421,7 @@ CIPHERTEXT* Fast_switch_key_ext(CIPHERTEXT* res, SWITCH_KEY* key,
                                 bool output_ntt) {
   size_t part_size = LIST_LEN(precomputed);
   IS_TRUE(part_size <= Get_swk_size(key), "unmatched size");
+  Rt_stat_count(RTS_KEY_SWITCH, 1);
 
   CRT_CONTEXT* crt = eval->_params->_crt_context;
   POLYNOMIAL*  c0  = Get_c0(res);
@@ -427,7 +429,7 @@ CIPHERTEXT* Fast_switch_key_ext(CIPHERTEXT* res, SWITCH_KEY* key,
   for (size_t part = 0; part < part_size; part++) {
     PUBLIC_KEY* pk        = Get_swk_at(key, part);
     POLYNOMIAL* poly_key0 = Get_pk0(pk);
-    POLYNOMIAL* poly_key1 = Get_pk1(pk);
+    POLYNOMIAL* poly_key1 = Get_swk_a(key, part, crt);
     POLYNOMIAL* raised_c1 = (POLYNOMIAL*)Get_ptr_value_at(precomputed, part);
     Set_is_ntt(poly_key1, TRUE);
     if (!Is_ntt(poly_key0)) {
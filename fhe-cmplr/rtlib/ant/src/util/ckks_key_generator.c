@@ -8,8 +8,16 @@
 
 #include "util/ckks_key_generator.h"
 
+#include <pthread.h>
+
+#include "common/rt_env.h"
+#include "util/prng.h"
 #include "util/random_sample.h"
 
+// scratch for a of SWK_TRANSIENT switch keys
+static POLYNOMIAL Swk_scratch;
+#pragma omp       threadprivate(Swk_scratch)
+
 CKKS_KEY_GENERATOR* Alloc_ckks_key_generator(CKKS_PARAMETER* params,
                                              int32_t*        rot_idx,
                                              size_t          num_rot_idx) {
@@ -20,6 +28,9 @@ CKKS_KEY_GENERATOR* Alloc_ckks_key_generator(CKKS_PARAMETER* params,
   size_t   num_primes    = params->_num_primes;
   size_t   num_p_primes  = params->_num_p_primes;
   generator->_params     = params;
+  const char* swk_env    = getenv(ENV_RT_SWK_COMPRESS);
+  generator->_swk_mode   = swk_env ? (SWK_MODE)atoi(swk_env) : SWK_FULL;
+  IS_TRUE(generator->_swk_mode <= SWK_TRANSIENT, "invalid switch key mode");
   generator->_secret_key = Alloc_secret_key(degree, num_primes, num_p_primes);
   Generate_secret_key(generator);
   generator->_public_key = Alloc_public_key(degree, num_primes, 0);
@@ -125,8 +136,7 @@ void Generate_public_key(CKKS_KEY_GENERATOR* generator) {
 }
 
 void Generate_switching_key(SWITCH_KEY* res, CKKS_KEY_GENERATOR* generator,
-                            POLYNOMIAL* new_key, POLYNOMIAL* old_key,
-                            bool is_fast) {
+                            POLYNOMIAL* new_key, POLYNOMIAL* old_key) {
   CRT_CONTEXT* crt          = generator->_params->_crt_context;
   uint32_t     ring_degree  = generator->_params->_poly_degree;
   size_t       num_primes   = generator->_params->_num_primes;
@@ -140,8 +150,8 @@ void Generate_switching_key(SWITCH_KEY* res, CKKS_KEY_GENERATOR* generator,
   IS_TRACE("new key: ");
   IS_TRACE_CMD(Print_poly(T_FILE, new_key));
 
-  VALUE_LIST* uniform_samples = Alloc_value_list(I64_TYPE, ring_degree);
-  VALUE_LIST* tri_samples     = Alloc_value_list(I64_TYPE, ring_degree);
+  Fill_ctr_prng(Get_ctr_prng(), res->_seed, 8);
+  VALUE_LIST* tri_samples = Alloc_value_list(I64_TYPE, ring_degree);
   POLYNOMIAL  e;
   Alloc_poly_data(&e, ring_degree, num_primes, num_primes_p);
   for (size_t part = 0; part < num_qpart; part++) {
@@ -149,16 +159,8 @@ void Generate_switching_key(SWITCH_KEY* res, CKKS_KEY_GENERATOR* generator,
     PUBLIC_KEY* pk = Get_swk_at(res, part);
     POLYNOMIAL* b  = Get_pk0(pk);
     POLYNOMIAL* a  = Get_pk1(pk);
-    // a
-    Sample_uniform_poly(a, Get_q_primes(crt), Get_p_primes(crt));
-
-#ifndef OPENFHE_COMPAT
-    if (!is_fast) {
-      Set_is_ntt(a, TRUE);
-    }
-#else
-    Set_is_ntt(a, TRUE);
-#endif
+    // a, sampled in NTT form from seed of the key
+    Expand_swk_a(a, res, part, crt);
     IS_TRACE("key a: ");
     IS_TRACE_CMD(Print_poly(T_FILE, a));
 
@@ -196,7 +198,72 @@ void Generate_switching_key(SWITCH_KEY* res, CKKS_KEY_GENERATOR* generator,
   }
   Free_poly_data(&e);
   Free_value_list(tri_samples);
-  Free_value_list(uniform_samples);
+  Compress_switch_key(res, generator->_swk_mode);
+}
+
+void Expand_swk_a(POLYNOMIAL* a, SWITCH_KEY* swk, size_t part,
+                  CRT_CONTEXT* crt) {
+  PUBLIC_KEY* pk = Get_swk_at(swk, part);
+  if (Get_poly_coeffs(a) == NULL) {
+    Alloc_poly_data(a, Get_pubkey_degree(pk), Get_pubkey_prime_cnt(pk),
+                    Get_pubkey_prime_p_cnt(pk));
+  }
+  IS_TRUE(Get_poly_level(a) == Get_pubkey_prime_cnt(pk) &&
+              Get_num_p(a) == Get_pubkey_prime_p_cnt(pk),
+          "unmatched size of a");
+  CTR_PRNG prng;
+  Init_ctr_prng(&prng, swk->_seed, part);
+  Sample_uniform_poly_prng(a, Get_q_primes(crt), Get_p_primes(crt), &prng);
+  Set_is_ntt(a, TRUE);
+}
+
+POLYNOMIAL* Get_swk_a(SWITCH_KEY* swk, size_t part, CRT_CONTEXT* crt) {
+  POLYNOMIAL* a = Get_pk1(Get_swk_at(swk, part));
+  switch (swk->_mode) {
+    case SWK_FULL:
+      return a;
+    case SWK_LAZY:
+      // all parts are expanded once at first use of the key, later uses
+      // don't take the lock
+      if (!__atomic_load_n(&swk->_expanded, __ATOMIC_ACQUIRE)) {
+        pthread_mutex_lock(&swk->_lock);
+        if (!swk->_expanded) {
+          for (size_t i = 0; i < Get_swk_size(swk); i++) {
+            Expand_swk_a(Get_pk1(Get_swk_at(swk, i)), swk, i, crt);
+          }
+          __atomic_store_n(&swk->_expanded, true, __ATOMIC_RELEASE);
+        }
+        pthread_mutex_unlock(&swk->_lock);
+      }
+      return a;
+    case SWK_TRANSIENT: {
+      PUBLIC_KEY* pk   = Get_swk_at(swk, part);
+      size_t      size = Get_pubkey_prime_cnt(pk) + Get_pubkey_prime_p_cnt(pk);
+      if (Get_num_alloc_primes(&Swk_scratch) != size ||
+          Get_rdgree(&Swk_scratch) != Get_pubkey_degree(pk)) {
+        Free_poly_data(&Swk_scratch);
+      }
+      if (Get_poly_coeffs(&Swk_scratch) != NULL) {
+        Init_poly_data(&Swk_scratch, Get_pubkey_degree(pk),
+                       Get_pubkey_prime_cnt(pk), Get_pubkey_prime_p_cnt(pk),
+                       Get_poly_coeffs(&Swk_scratch));
+      }
+      Expand_swk_a(&Swk_scratch, swk, part, crt);
+      return &Swk_scratch;
+    }
+    default:
+      IS_TRUE(FALSE, "invalid switch key mode");
+      return a;
+  }
+}
+
+void Compress_switch_key(SWITCH_KEY* swk, SWK_MODE mode) {
+  swk->_mode     = mode;
+  swk->_expanded = false;
+  if (mode == SWK_FULL) return;
+  for (size_t part = 0; part < Get_swk_size(swk); part++) {
+    Free_poly_data(Get_pk1(Get_swk_at(swk, part)));
+  }
 }
 
 // 𝑒𝑣𝑘 = (𝑏′, 𝑎′)
@@ -210,8 +277,7 @@ void Generate_relin_key(CKKS_KEY_GENERATOR* generator) {
   Multiply_poly_fast(&sk_squared, ntt_sk, ntt_sk, crt, NULL);
   IS_TRACE("sk_squared:");
   IS_TRACE_CMD(Print_poly(T_FILE, &sk_squared));
-  Generate_switching_key(generator->_relin_key, generator, &sk_squared, ntt_sk,
-                         FALSE);
+  Generate_switching_key(generator->_relin_key, generator, &sk_squared, ntt_sk);
   Free_poly_data(&sk_squared);
 }
 
@@ -231,7 +297,7 @@ void Generate_conj_key(SWITCH_KEY* res, CKKS_KEY_GENERATOR* generator) {
   Insert_precomp_auto_order(generator, rot_idx, precomp);
   Rotate_poly(&new_key, ntt_sk, rot_idx, precomp, crt);
   // old_key & new_key is switched for fast conjugate
-  Generate_switching_key(res, generator, sk, &new_key, TRUE);
+  Generate_switching_key(res, generator, sk, &new_key);
   Free_poly_data(&new_key);
 }
 
@@ -256,10 +322,10 @@ void Generate_rot_key(SWITCH_KEY* res, CKKS_KEY_GENERATOR* generator,
   if (is_fast) {
     Rotate_poly(&new_key, ntt_sk, gen_idx, precomp, crt);
     // old_key & new_key is switched for fast rotate
-    Generate_switching_key(res, generator, sk, &new_key, TRUE);
+    Generate_switching_key(res, generator, sk, &new_key);
   } else {
     Rotate_poly(&new_key, sk, gen_idx, precomp, crt);
-    Generate_switching_key(res, generator, &new_key, ntt_sk, FALSE);
+    Generate_switching_key(res, generator, &new_key, ntt_sk);
   }
   Free_poly_data(&new_key);
   Free_value_list(precomp);
@@ -8,6 +8,7 @@
 
 #include "util/ntt.h"
 
+#include "common/rt_stat.h"
 #include "common/rtlib_timing.h"
 #include "common/trace.h"
 #include "util/bit_operations.h"
@@ -171,6 +172,7 @@ void Ftt_fwd(VALUE_LIST* res, NTT_CONTEXT* ntt, VALUE_LIST* coeffs) {
     Init_i64_value_list(res, coeffs_len, Get_i64_values(coeffs));
   }
   Forward_transform(res, ntt, ntt->_rou);
+  Rt_stat_count(RTS_NTT, 1);
   RTLIB_TM_END(RTM_NTT, rtm);
 }
 
@@ -183,6 +185,7 @@ void Ftt_inv(VALUE_LIST* res, NTT_CONTEXT* ntt, VALUE_LIST* coeffs) {
     Init_i64_value_list(res, coeffs_len, Get_i64_values(coeffs));
   }
   Inverse_transform(res, ntt, ntt->_rou_inv);
+  Rt_stat_count(RTS_NTT, 1);
   RTLIB_TM_END(RTM_INTT, rtm);
 }
 
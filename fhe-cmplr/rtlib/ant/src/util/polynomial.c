@@ -10,6 +10,7 @@
 
 #include "common/rt_config.h"
 #include "util/fhe_bignumber.h"
+#include "util/prng.h"
 #include "util/random_sample.h"
 #include "util/secret_key.h"
 
@@ -1348,6 +1349,11 @@ void Free_switch_key_precomputed(VALUE_LIST* precomputed) {
 
 void Sample_uniform_poly(POLYNOMIAL* poly, VL_CRTPRIME* q_primes,
                          VL_CRTPRIME* p_primes) {
+  Sample_uniform_poly_prng(poly, q_primes, p_primes, Get_ctr_prng());
+}
+
+void Sample_uniform_poly_prng(POLYNOMIAL* poly, VL_CRTPRIME* q_primes,
+                              VL_CRTPRIME* p_primes, struct ctr_prng* prng) {
   MODULUS*   q_modulus = Get_modulus_head(q_primes);
   VALUE_LIST samples;
   int64_t*   coeffs   = Get_poly_coeffs(poly);
@@ -1355,7 +1361,7 @@ void Sample_uniform_poly(POLYNOMIAL* poly, VL_CRTPRIME* q_primes,
   for (size_t module_idx = 0; module_idx < Get_poly_level(poly); module_idx++) {
     Init_i64_value_list_no_copy(&samples, r_degree,
                                 coeffs + (module_idx * r_degree));
-    Sample_uniform(&samples, Get_mod_val(q_modulus));
+    Sample_uniform_prng(&samples, Get_mod_val(q_modulus), prng);
     q_modulus = Get_next_modulus(q_modulus);
   }
   if (p_primes) {
@@ -1364,7 +1370,7 @@ void Sample_uniform_poly(POLYNOMIAL* poly, VL_CRTPRIME* q_primes,
     for (size_t module_idx = 0; module_idx < Get_num_p(poly); module_idx++) {
       Init_i64_value_list_no_copy(&samples, r_degree,
                                   coeffs + (module_idx * r_degree));
-      Sample_uniform(&samples, Get_mod_val(p_modulus));
+      Sample_uniform_prng(&samples, Get_mod_val(p_modulus), prng);
       p_modulus = Get_next_modulus(p_modulus);
     }
   }
@@ -8,11 +8,15 @@
 
 #include "util/prng.h"
 
+#include <string.h>
 #include <sys/time.h>
 
 BLAKE2_PRNG* Prng = NULL;
 #pragma omp  threadprivate(Prng)
 
+CTR_PRNG*   Ctr_prng = NULL;
+#pragma omp threadprivate(Ctr_prng)
+
 uint32_t Uniform_uint_rdev(uint32_t min, uint32_t max);
 
 //! @brief Allocate a new BLAKE2_PRNG instance
@@ -69,6 +73,110 @@ BLAKE2_PRNG* Get_prng() {
   return Prng;
 }
 
+// one state word of CHACHA_LANES blocks
+typedef uint32_t CHACHA_VEC __attribute__((vector_size(CHACHA_LANES * 4)));
+
+#define CHACHA_ROTL(v, bits) (((v) << (bits)) | ((v) >> (32 - (bits))))
+
+//! @brief ChaCha20 quarter round on state words of CHACHA_LANES blocks
+#define CHACHA_QUARTER_ROUND(a, b, c, d) \
+  a += b;                                \
+  d = CHACHA_ROTL(d ^ a, 16);            \
+  c += d;                                \
+  b = CHACHA_ROTL(b ^ c, 12);            \
+  a += b;                                \
+  d = CHACHA_ROTL(d ^ a, 8);             \
+  c += d;                                \
+  b = CHACHA_ROTL(b ^ c, 7)
+
+//! @brief Write CHACHA_LANES blocks of key stream from current block to out,
+//! lane l of state vectors works on block _block + l
+static void Gen_chacha_blocks(CTR_PRNG* prng, uint32_t* out) {
+  CHACHA_VEC in[CHACHA_BLOCK_WORDS];
+  CHACHA_VEC x[CHACHA_BLOCK_WORDS];
+  for (uint32_t l = 0; l < CHACHA_LANES; ++l) {
+    uint64_t block = prng->_block + l;
+    in[0][l]       = 0x61707865;  // "expand 32-byte k"
+    in[1][l]       = 0x3320646e;
+    in[2][l]       = 0x79622d32;
+    in[3][l]       = 0x6b206574;
+    for (uint32_t i = 0; i < 8; ++i) {
+      in[4 + i][l] = prng->_key[i];
+    }
+    in[12][l] = (uint32_t)block;
+    in[13][l] = (uint32_t)(block >> 32);
+    in[14][l] = (uint32_t)prng->_stream;
+    in[15][l] = (uint32_t)(prng->_stream >> 32);
+  }
+  for (uint32_t w = 0; w < CHACHA_BLOCK_WORDS; ++w) {
+    x[w] = in[w];
+  }
+  for (uint32_t round = 0; round < 10; ++round) {
+    CHACHA_QUARTER_ROUND(x[0], x[4], x[8], x[12]);
+    CHACHA_QUARTER_ROUND(x[1], x[5], x[9], x[13]);
+    CHACHA_QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+    CHACHA_QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+    CHACHA_QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+    CHACHA_QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+    CHACHA_QUARTER_ROUND(x[2], x[7], x[8], x[13]);
+    CHACHA_QUARTER_ROUND(x[3], x[4], x[9], x[14]);
+  }
+  for (uint32_t w = 0; w < CHACHA_BLOCK_WORDS; ++w) {
+    x[w] += in[w];
+  }
+  for (uint32_t l = 0; l < CHACHA_LANES; ++l) {
+    for (uint32_t w = 0; w < CHACHA_BLOCK_WORDS; ++w) {
+      out[l * CHACHA_BLOCK_WORDS + w] = x[w][l];
+    }
+  }
+  prng->_block += CHACHA_LANES;
+}
+
+void Init_ctr_prng(CTR_PRNG* prng, const uint32_t key[8], uint64_t stream) {
+  FMT_ASSERT(prng != NULL, "prng not allocated yet");
+  memcpy(prng->_key, key, sizeof(prng->_key));
+  Seek_ctr_prng(prng, stream, 0);
+}
+
+void Seek_ctr_prng(CTR_PRNG* prng, uint64_t stream, uint64_t block) {
+  prng->_stream  = stream;
+  prng->_block   = block;
+  prng->_buf_idx = CHACHA_LANES * CHACHA_BLOCK_WORDS;
+}
+
+void Fill_ctr_prng(CTR_PRNG* prng, uint32_t* out, size_t len) {
+  const size_t batch = CHACHA_LANES * CHACHA_BLOCK_WORDS;
+  // words left in buffer from previous call go first
+  size_t cnt = batch - prng->_buf_idx;
+  if (cnt > len) cnt = len;
+  memcpy(out, prng->_buf + prng->_buf_idx, cnt * sizeof(uint32_t));
+  prng->_buf_idx += cnt;
+  out += cnt;
+  len -= cnt;
+  // whole batches are written to out directly
+  for (; len >= batch; out += batch, len -= batch) {
+    Gen_chacha_blocks(prng, out);
+  }
+  if (len > 0) {
+    Gen_chacha_blocks(prng, prng->_buf);
+    memcpy(out, prng->_buf, len * sizeof(uint32_t));
+    prng->_buf_idx = len;
+  }
+}
+
+CTR_PRNG* Get_ctr_prng() {
+  if (Ctr_prng == NULL) {
+    Ctr_prng          = (CTR_PRNG*)malloc(sizeof(CTR_PRNG));
+    BLAKE2_PRNG* seed = Get_prng();
+    uint32_t     key[8];
+    for (uint32_t i = 0; i < 8; i++) {
+      key[i] = Uniform_uint_prng(seed, 0, MAX_UINT32);
+    }
+    Init_ctr_prng(Ctr_prng, key, 0);
+  }
+  return Ctr_prng;
+}
+
 #ifdef UNIX_LIKE_SYSTEM
 uint32_t Get_random_device_seed() {
   uint32_t seed;
@@ -17,6 +17,9 @@
 #include "util/fhe_utils.h"
 #include "util/prng.h"
 
+// words of key stream drawn from CTR_PRNG at a time by samplers
+#define SAMPLE_BATCH 256
+
 void Srand_time() {
   struct timeval t1;
   gettimeofday(&t1, NULL);
@@ -37,6 +40,11 @@ double Random_double() {
 }
 
 void Sample_uniform(VALUE_LIST* sample_list, uint64_t upper_bound) {
+  Sample_uniform_prng(sample_list, upper_bound, Get_ctr_prng());
+}
+
+void Sample_uniform_prng(VALUE_LIST* sample_list, uint64_t upper_bound,
+                         struct ctr_prng* prng) {
   int64_t* samples     = Get_i64_values(sample_list);
   size_t   num_samples = LIST_LEN(sample_list);
 #if Is_Triage_On
@@ -49,26 +57,24 @@ void Sample_uniform(VALUE_LIST* sample_list, uint64_t upper_bound) {
     samples[i] = Random_range(0, upper_bound);
   }
 #else
-  // PRNG each call return PRNG_VAL_SIZE_IN_BITS bits value
-  // if required upper_bound bits larger than PRNG_VAL_SIZE_IN_BITS, needs to
-  // call Get_prng_value several times to fullfill the requirement
-  BLAKE2_PRNG* prng      = Get_prng();
-  uint32_t per_rand_bits = (uint32_t)log2(upper_bound) / PRNG_VAL_SIZE_IN_BITS;
-  uint32_t shift_chunk   = per_rand_bits * PRNG_VAL_SIZE_IN_BITS;
-  uint32_t last_bound    = (uint32_t)(upper_bound >> shift_chunk);
-  for (size_t idx = 0; idx < num_samples; idx++) {
-    while (true) {
-      uint64_t result = 0;
-      for (uint32_t i = 0, shift = 0; i < per_rand_bits;
-           ++i, shift += PRNG_VAL_SIZE_IN_BITS) {
-        result += ((uint64_t)Uniform_uint_prng(prng, 0, MAX_UINT32)) << shift;
-      }
-      result += ((uint64_t)Uniform_uint_prng(prng, 0, last_bound))
-                << shift_chunk;
-
-      if (result < upper_bound) {
-        samples[idx] = result;
-        break;
+  // draw candidates a batch at a time from key stream, keep the low bits
+  // covering upper_bound and reject the ones not less than upper_bound,
+  // which takes less than two candidates per sample on average
+  IS_TRUE(upper_bound > 0, "invalid upper bound");
+  uint64_t mask = UINT64_MAX;
+  if (upper_bound > 1) {
+    mask >>= __builtin_clzll(upper_bound - 1);
+  } else {
+    mask = 0;
+  }
+  uint32_t words[SAMPLE_BATCH];
+  size_t   idx = 0;
+  while (idx < num_samples) {
+    Fill_ctr_prng(prng, words, SAMPLE_BATCH);
+    for (size_t i = 0; i < SAMPLE_BATCH && idx < num_samples; i += 2) {
+      uint64_t val = (words[i] | ((uint64_t)words[i + 1] << 32)) & mask;
+      if (val < upper_bound) {
+        samples[idx++] = val;
       }
     }
   }
@@ -83,15 +89,15 @@ void Sample_triangle(VALUE_LIST* sample_list) {
     samples[i] = 1;
   }
 #else
-  Srand_time();
-  for (size_t i = 0; i < num_samples; i++) {
-    int64_t r = Random_range(0, 4);
-    if (r == 0)
-      samples[i] = -1;
-    else if (r == 1)
-      samples[i] = 1;
-    else
-      samples[i] = 0;
+  // two bits of key stream per sample, -1 and 1 with 1/4 each, 0 with 1/2
+  static const int64_t value[4] = {-1, 1, 0, 0};
+  CTR_PRNG*            prng     = Get_ctr_prng();
+  uint32_t             bits[SAMPLE_BATCH];
+  for (size_t i = 0; i < num_samples; i += SAMPLE_BATCH * 16) {
+    Fill_ctr_prng(prng, bits, SAMPLE_BATCH);
+    for (size_t k = 0; k < SAMPLE_BATCH * 16 && i + k < num_samples; k++) {
+      samples[i + k] = value[(bits[k / 16] >> (k % 16 * 2)) & 3];
+    }
   }
 #endif
 }
@@ -121,10 +127,20 @@ void Sample_ternary(VALUE_LIST* list, int64_t hamming_weight) {
     }
   }
 #else
-  BLAKE2_PRNG* prng = Get_prng();
+  CTR_PRNG* prng = Get_ctr_prng();
   if (hamming_weight == 0) {
-    for (size_t i = 0; i < length; i++) {
-      samples[i] = (int64_t)Uniform_int_prng(prng, -1, 1);
+    // one byte of key stream per candidate, 255 is rejected to keep the
+    // three values equally likely
+    uint32_t       words[SAMPLE_BATCH];
+    const uint8_t* bytes = (const uint8_t*)words;
+    size_t         idx   = 0;
+    while (idx < length) {
+      Fill_ctr_prng(prng, words, SAMPLE_BATCH);
+      for (size_t i = 0; i < SAMPLE_BATCH * 4 && idx < length; i++) {
+        if (bytes[i] != 255) {
+          samples[idx++] = (int64_t)(bytes[i] % 3) - 1;
+        }
+      }
     }
   } else {
     if (hamming_weight > length) hamming_weight = length;
@@ -137,9 +153,9 @@ void Sample_ternary(VALUE_LIST* list, int64_t hamming_weight) {
       memset(samples, 0, length * sizeof(int64_t));
       int64_t total_weight = 0;
       while (total_weight < hamming_weight) {
-        uint32_t index = Uniform_uint_prng(prng, 0, length - 1);
+        uint32_t index = Uniform_uint_ctr_prng(prng, 0, length - 1);
         if (samples[index] == 0) {
-          if (Uniform_int_prng(prng, 0, 1) == 0) {
+          if ((Get_ctr_prng_value(prng) & 1) == 0) {
             samples[index] = -1;
           } else {
             samples[index] = 1;
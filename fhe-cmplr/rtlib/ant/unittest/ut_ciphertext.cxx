@@ -0,0 +1,133 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "gtest/gtest.h"
+#include "helper.h"
+#include "util/ciphertext.h"
+
+class TEST_CIPHERTEXT : public ::testing::Test {
+protected:
+  static constexpr uint32_t DEGREE = 16;
+
+  // fill coefficients of poly with base + index
+  static void Fill(POLYNOMIAL* poly, int64_t base) {
+    int64_t* coeffs = Get_poly_coeffs(poly);
+    for (size_t i = 0; i < Get_poly_len(poly); ++i) {
+      coeffs[i] = base + i;
+    }
+  }
+
+  static void Check(POLYNOMIAL* poly, int64_t base, size_t len) {
+    int64_t* coeffs = Get_poly_coeffs(poly);
+    for (size_t i = 0; i < len; ++i) {
+      EXPECT_EQ(coeffs[i], base + i);
+    }
+  }
+
+  // ciphertext with num_q primes at scale degree 2, c0 and c1 filled with
+  // base and base + 1000
+  static CIPHERTEXT* New_ciph(size_t num_q, int64_t base) {
+    CIPHERTEXT* ciph = Alloc_ciphertext();
+    Init_ciphertext(ciph, DEGREE, num_q, 0, 4.0, 2, DEGREE / 2);
+    Fill(Get_c0(ciph), base);
+    Fill(Get_c1(ciph), base + 1000);
+    return ciph;
+  }
+};
+
+TEST_F(TEST_CIPHERTEXT, move) {
+  CIPHERTEXT* res  = New_ciph(2, 0);
+  CIPHERTEXT* ciph = New_ciph(3, 100);
+  int64_t*    c0   = Get_poly_coeffs(Get_c0(ciph));
+  int64_t*    c1   = Get_poly_coeffs(Get_c1(ciph));
+
+  // res takes the buffer and attributes of ciph, ciph is left empty
+  Move_ciphertext(res, ciph);
+  EXPECT_EQ(Get_poly_coeffs(Get_c0(res)), c0);
+  EXPECT_EQ(Get_poly_coeffs(Get_c1(res)), c1);
+  EXPECT_EQ(Get_ciph_prime_cnt(res), 3);
+  EXPECT_EQ(Get_ciph_sf_degree(res), 2);
+  Check(Get_c0(res), 100, 3 * DEGREE);
+  Check(Get_c1(res), 1100, 3 * DEGREE);
+  EXPECT_EQ(Get_poly_coeffs(Get_c0(ciph)), nullptr);
+  EXPECT_EQ(Get_poly_coeffs(Get_c1(ciph)), nullptr);
+  EXPECT_EQ(Get_num_alloc_primes(Get_c0(ciph)), 0);
+
+  // moving to itself keeps the buffer
+  Move_ciphertext(res, res);
+  EXPECT_EQ(Get_poly_coeffs(Get_c0(res)), c0);
+
+  // ciph can be initialized again after the move
+  Init_ciphertext(ciph, DEGREE, 1, 0, 4.0, 2, DEGREE / 2);
+  EXPECT_NE(Get_poly_coeffs(Get_c0(ciph)), nullptr);
+  EXPECT_EQ(Get_ciph_prime_cnt(ciph), 1);
+
+  Free_ciphertext(res);
+  Free_ciphertext(ciph);
+}
+
+TEST_F(TEST_CIPHERTEXT, move3) {
+  CIPHERTEXT*  ciph = New_ciph(3, 0);
+  CIPHERTEXT3* res  = Alloc_ciphertext3();
+  CIPHERTEXT3* src  = Alloc_ciphertext3();
+  Init_ciphertext3_from_ciph(res, ciph, 4.0, 2);
+  Init_ciphertext3_from_ciph(src, ciph, 8.0, 3);
+  Fill(Get_ciph3_c2(src), 200);
+  int64_t* c0 = Get_poly_coeffs(Get_ciph3_c0(src));
+  int64_t* c2 = Get_poly_coeffs(Get_ciph3_c2(src));
+
+  Move_ciphertext3(res, src);
+  EXPECT_EQ(Get_poly_coeffs(Get_ciph3_c0(res)), c0);
+  EXPECT_EQ(Get_poly_coeffs(Get_ciph3_c2(res)), c2);
+  EXPECT_EQ(Get_ciph3_sf_degree(res), 3);
+  Check(Get_ciph3_c2(res), 200, 3 * DEGREE);
+  EXPECT_EQ(Get_poly_coeffs(Get_ciph3_c0(src)), nullptr);
+  EXPECT_EQ(Get_poly_coeffs(Get_ciph3_c1(src)), nullptr);
+  EXPECT_EQ(Get_poly_coeffs(Get_ciph3_c2(src)), nullptr);
+
+  Move_ciphertext3(res, res);
+  EXPECT_EQ(Get_poly_coeffs(Get_ciph3_c2(res)), c2);
+
+  Free_ciphertext(ciph);
+  Free_ciphertext3(res);
+  Free_ciphertext3(src);
+}
+
+// buffer moved from a ciphertext at another level is reused by
+// Init_ciphertext_reuse only, Init_ciphertext still requires matched level
+TEST_F(TEST_CIPHERTEXT, init_moved_buffer) {
+  CIPHERTEXT* res  = Alloc_ciphertext();
+  CIPHERTEXT* ciph = New_ciph(3, 100);
+  int64_t*    c0   = Get_poly_coeffs(Get_c0(ciph));
+  Move_ciphertext(res, ciph);
+
+  EXPECT_DEBUG_DEATH(
+      Init_ciphertext(res, DEGREE, 2, 0, 4.0, 2, DEGREE / 2), "unmatched");
+
+  // lower level keeps the buffer and its contents
+  Init_ciphertext_reuse(res, DEGREE, 2, 0, 4.0, 2, DEGREE / 2);
+  EXPECT_EQ(Get_poly_coeffs(Get_c0(res)), c0);
+  EXPECT_EQ(Get_ciph_prime_cnt(res), 2);
+  EXPECT_EQ(Get_num_alloc_primes(Get_c0(res)), 3);
+  Check(Get_c0(res), 100, 2 * DEGREE);
+  Check(Get_c1(res), 1100, 2 * DEGREE);
+
+  // back to the top level without growing
+  Init_ciphertext_reuse(res, DEGREE, 3, 0, 4.0, 2, DEGREE / 2);
+  EXPECT_EQ(Get_poly_coeffs(Get_c0(res)), c0);
+  EXPECT_EQ(Get_ciph_prime_cnt(res), 3);
+
+  // higher level regrows the buffer
+  Init_ciphertext_reuse(res, DEGREE, 4, 0, 4.0, 2, DEGREE / 2);
+  EXPECT_EQ(Get_ciph_prime_cnt(res), 4);
+  EXPECT_EQ(Get_num_alloc_primes(Get_c0(res)), 4);
+  EXPECT_EQ(Get_num_alloc_primes(Get_c1(res)), 4);
+
+  Free_ciphertext(res);
+  Free_ciphertext(ciph);
+}
@@ -7,6 +7,7 @@
 //=============================================================================
 
 #include <chrono>
+#include <vector>
 
 #include "common/rt_config.h"
 #include "gtest/gtest.h"
@@ -70,6 +71,8 @@ protected:
   size_t Get_degree() { return _degree; }
   size_t Get_num_iter() { return _num_iterations; }
 
+  CKKS_PARAMETER* Get_param() { return _param; }
+
   microseconds Run_test_add(VALUE_LIST* msg1, VALUE_LIST* msg2,
                             microseconds& encode_time,
                             microseconds& decode_time,
@@ -541,6 +544,42 @@ TEST_F(TEST_EVALUATOR_PERF, Run_inv_ntt) {
   Free_nttcontext(ntt);
 }
 
+TEST_F(TEST_EVALUATOR_PERF, Run_keygen) {
+  size_t       num_iterations = Get_num_iter();
+  size_t       degree         = Get_degree();
+  microseconds keygen(0);
+  microseconds sample(0);
+  // power of 2 rotations as used by rotate and sum
+  std::vector<int32_t> rot_idx;
+  for (int32_t step = 1; step < degree / 2; step *= 2) {
+    rot_idx.push_back(step);
+  }
+  VALUE_LIST* limb = Alloc_value_list(I64_TYPE, degree);
+  for (size_t i = 0; i < num_iterations; i++) {
+    auto                start = chrono::system_clock::now();
+    CKKS_KEY_GENERATOR* gen   = Alloc_ckks_key_generator(
+        Get_param(), rot_idx.data(), rot_idx.size());
+    auto end = chrono::system_clock::now();
+    keygen += duration_cast<microseconds>(end - start);
+    Free_ckks_key_generator(gen);
+
+    start = chrono::system_clock::now();
+    Sample_uniform(limb, 1125899904679937);
+    end = chrono::system_clock::now();
+    sample += duration_cast<microseconds>(end - start);
+  }
+
+  cout << string(80, '-') << endl
+       << left << setw(24) << "keygen:" << right << setw(10)
+       << (double)keygen.count() / num_iterations << " us" << right << setw(24)
+       << "avarage of " << num_iterations << " runs" << endl
+       << left << setw(24) << "sample uniform limb:" << right << setw(10)
+       << (double)sample.count() / num_iterations << " us" << right << setw(24)
+       << "avarage of " << num_iterations << " runs" << endl
+       << string(80, '-') << endl;
+  Free_value_list(limb);
+}
+
 class TEST_BOOTSTRAP_PERF : public ::testing::Test {
 protected:
   void SetUp() override {
@@ -0,0 +1,190 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include <stdlib.h>
+
+#include "ckks/plain_eval.h"
+#include "common/rt_api.h"
+#include "common/rt_env.h"
+#include "gtest/gtest.h"
+#include "rtlib/context.h"
+#include "util/ckks_encoder.h"
+#include "util/ckks_parameters.h"
+#include "util/plaintext.h"
+
+// plain_eval.c links rtlib context which refers to the functions generated
+// by fhe-cmplr. The test sets up its own Context and never calls them
+extern "C" {
+CKKS_PARAMS*  Get_context_params() { return NULL; }
+RT_DATA_INFO* Get_rt_data_info() { return NULL; }
+int           Get_input_count() { return 0; }
+int           Get_output_count() { return 0; }
+DATA_SCHEME*  Get_encode_scheme(int idx) { return NULL; }
+DATA_SCHEME*  Get_decode_scheme(int idx) { return NULL; }
+}
+
+namespace {
+class TEST_PLAIN_CACHE : public ::testing::Test {
+protected:
+  static constexpr uint32_t DEGREE = 4096;
+  static constexpr uint32_t LEVEL  = 10;
+  static constexpr size_t   LEN    = 16;
+
+  // cache bound is read from ENV_PT_CACHE_SIZE when it is created at the
+  // first call, the default bound is used unless a test sets it before
+  void SetUp() override {
+    _params = Alloc_ckks_parameter();
+    Init_ckks_parameters_with_prime_size(_params, DEGREE, HE_STD_NOT_SET,
+                                         LEVEL + 1, 60, 40, 0);
+    _ctx = (CKKS_CONTEXT*)malloc(sizeof(CKKS_CONTEXT));
+    memset(_ctx, 0, sizeof(CKKS_CONTEXT));
+    _ctx->_params  = (PTR_TY)_params;
+    _ctx->_encoder = (PTR_TY)Alloc_ckks_encoder(_params);
+    _saved_ctx     = Context;
+    Context        = _ctx;
+    for (size_t k = 0; k < 4; k++) {
+      for (size_t i = 0; i < LEN; i++) _data[k][i] = 0.25 * k - 0.125 * i;
+    }
+  }
+
+  void TearDown() override {
+    Free_plain_cache();
+    Free_ckks_encoder((CKKS_ENCODER*)_ctx->_encoder);
+    Free_ckks_parameters(_params);
+    free(_ctx);
+    Context = _saved_ctx;
+    unsetenv(ENV_PT_CACHE_SIZE);
+  }
+
+  void Encode(PLAINTEXT* plain, float* data, uint32_t sc_degree,
+              uint32_t level) {
+    memset(plain, 0, sizeof(PLAINTEXT));
+    Encode_plain_from_float_cached(plain, data, LEN, sc_degree, level);
+  }
+
+  bool Same_coeffs(PLAINTEXT* a, PLAINTEXT* b) {
+    POLYNOMIAL* pa = Get_plain_poly(a);
+    POLYNOMIAL* pb = Get_plain_poly(b);
+    if (Get_num_q(pa) != Get_num_q(pb) || Get_num_p(pa) != Get_num_p(pb)) {
+      return false;
+    }
+    size_t cnt = (size_t)Get_rdgree(pa) * (Get_num_q(pa) + Get_num_p(pa));
+    return memcmp(Get_poly_coeffs(pa), Get_poly_coeffs(pb),
+                  cnt * sizeof(int64_t)) == 0;
+  }
+
+  void Free(PLAINTEXT* plain) { Free_poly_data(Get_plain_poly(plain)); }
+
+  size_t Cache_cnt() {
+    size_t size, cnt, hit;
+    Get_plain_cache(&size, &cnt, &hit);
+    return cnt;
+  }
+
+  size_t Cache_hit() {
+    size_t size, cnt, hit;
+    Get_plain_cache(&size, &cnt, &hit);
+    return hit;
+  }
+
+  CKKS_PARAMETER* _params;
+  CKKS_CONTEXT*   _ctx;
+  CKKS_CONTEXT*   _saved_ctx;
+  float           _data[4][LEN];
+};
+
+TEST_F(TEST_PLAIN_CACHE, hit) {
+  PLAINTEXT ref, first, second;
+  memset(&ref, 0, sizeof(ref));
+  Encode_plain_from_float(&ref, _data[0], LEN, 1, LEVEL);
+  Encode(&first, _data[0], 1, LEVEL);
+  EXPECT_EQ(Cache_cnt(), 1);
+  EXPECT_EQ(Cache_hit(), 0);
+  Encode(&second, _data[0], 1, LEVEL);
+  EXPECT_EQ(Cache_cnt(), 1);
+  EXPECT_EQ(Cache_hit(), 1);
+
+  EXPECT_TRUE(Same_coeffs(&ref, &first));
+  EXPECT_TRUE(Same_coeffs(&ref, &second));
+  EXPECT_EQ(Get_plain_sf_degree(&second), Get_plain_sf_degree(&ref));
+  EXPECT_EQ(Get_plain_scaling_factor(&second), Get_plain_scaling_factor(&ref));
+  // the copy owns its data
+  EXPECT_NE(Get_poly_coeffs(Get_plain_poly(&first)),
+            Get_poly_coeffs(Get_plain_poly(&second)));
+  Free(&ref);
+  Free(&first);
+  Free(&second);
+}
+
+TEST_F(TEST_PLAIN_CACHE, miss_on_level_and_scale) {
+  PLAINTEXT plain[4];
+  Encode(&plain[0], _data[0], 1, LEVEL);
+  Encode(&plain[1], _data[0], 1, LEVEL - 1);
+  Encode(&plain[2], _data[0], 2, LEVEL);
+  Encode(&plain[3], _data[1], 1, LEVEL);
+  EXPECT_EQ(Cache_cnt(), 4);
+  EXPECT_EQ(Cache_hit(), 0);
+  EXPECT_EQ(Get_num_q(Get_plain_poly(&plain[1])), LEVEL - 1);
+  EXPECT_EQ(Get_plain_sf_degree(&plain[2]), 2);
+  EXPECT_FALSE(Same_coeffs(&plain[0], &plain[1]));
+  EXPECT_FALSE(Same_coeffs(&plain[0], &plain[2]));
+  EXPECT_FALSE(Same_coeffs(&plain[0], &plain[3]));
+  for (int i = 0; i < 4; i++) Free(&plain[i]);
+}
+
+TEST_F(TEST_PLAIN_CACHE, evict_lru) {
+  // cache bound is 1MB, each plaintext takes about DEGREE * LEVEL * 8 = 320KB,
+  // so 3 of them fit
+  setenv(ENV_PT_CACHE_SIZE, "1", 1);
+  PLAINTEXT plain;
+  for (int i = 0; i < 3; i++) {
+    Encode(&plain, _data[i], 1, LEVEL);
+    size_t size = Get_plain_mem_size(&plain);
+    EXPECT_LE(3 * size, (size_t)1 << 20);
+    EXPECT_GT(4 * size, (size_t)1 << 20);
+    Free(&plain);
+  }
+  EXPECT_EQ(Cache_cnt(), 3);
+
+  // use _data[0] again, _data[1] becomes the least recently used
+  Encode(&plain, _data[0], 1, LEVEL);
+  Free(&plain);
+  EXPECT_EQ(Cache_hit(), 1);
+
+  // the 4th plaintext evicts _data[1]
+  Encode(&plain, _data[3], 1, LEVEL);
+  Free(&plain);
+  size_t size, cnt, hit;
+  Get_plain_cache(&size, &cnt, &hit);
+  EXPECT_EQ(cnt, 3);
+  EXPECT_LE(size, (size_t)1 << 20);
+
+  Encode(&plain, _data[0], 1, LEVEL);
+  Free(&plain);
+  EXPECT_EQ(Cache_hit(), 2);
+  Encode(&plain, _data[2], 1, LEVEL);
+  Free(&plain);
+  EXPECT_EQ(Cache_hit(), 3);
+  Encode(&plain, _data[1], 1, LEVEL);
+  Free(&plain);
+  EXPECT_EQ(Cache_hit(), 3);
+}
+
+TEST_F(TEST_PLAIN_CACHE, too_large) {
+  // a plaintext larger than the bound is encoded but not kept
+  setenv(ENV_PT_CACHE_SIZE, "0", 1);
+  PLAINTEXT plain;
+  Encode(&plain, _data[0], 1, LEVEL);
+  Free(&plain);
+  Encode(&plain, _data[0], 1, LEVEL);
+  Free(&plain);
+  EXPECT_EQ(Cache_cnt(), 0);
+  EXPECT_EQ(Cache_hit(), 0);
+}
+
+}  // namespace
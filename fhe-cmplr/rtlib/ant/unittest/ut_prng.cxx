@@ -6,6 +6,8 @@
 //
 //=============================================================================
 
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "util/fhe_utils.h"
 #include "util/prng.h"
@@ -84,3 +86,98 @@ TEST(sample, test_tenary) {
 
   Free_value_list(value);
 }
+
+TEST(prng, test_chacha_known_answer) {
+  // RFC 8439 2.3.2, 96-bit nonce 000000090000004a00000000 and 32-bit counter
+  // 1 map to block 0x0900000000000001 and stream 0x4a000000 of CTR_PRNG
+  uint32_t key[8] = {0x03020100, 0x07060504, 0x0b0a0908, 0x0f0e0d0c,
+                     0x13121110, 0x17161514, 0x1b1a1918, 0x1f1e1d1c};
+  uint32_t expected[CHACHA_BLOCK_WORDS] = {
+      0xe4e7f110, 0x15593bd1, 0x1fdd0f50, 0xc47120a3, 0xc7f4d1c7, 0x0368c033,
+      0x9aaa2204, 0x4e6cd4c3, 0x466482d2, 0x09aa9f07, 0x05d7c214, 0xa2028bd9,
+      0xd19c12b5, 0xb94e16de, 0xe883d0cb, 0x4e3c50a2};
+  CTR_PRNG prng;
+  Init_ctr_prng(&prng, key, 0);
+  Seek_ctr_prng(&prng, 0x4a000000, 0x0900000000000001ULL);
+  uint32_t out[CHACHA_BLOCK_WORDS];
+  Fill_ctr_prng(&prng, out, CHACHA_BLOCK_WORDS);
+  for (uint32_t i = 0; i < CHACHA_BLOCK_WORDS; i++) {
+    EXPECT_EQ(out[i], expected[i]);
+  }
+}
+
+TEST(prng, test_chacha_seek) {
+  uint32_t key[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  size_t   len    = 1000;
+  std::vector<uint32_t> full(len);
+  CTR_PRNG              prng;
+  Init_ctr_prng(&prng, key, 7);
+  Fill_ctr_prng(&prng, full.data(), len);
+
+  // same words drawn in uneven pieces and one at a time
+  std::vector<uint32_t> part(len);
+  Init_ctr_prng(&prng, key, 7);
+  Fill_ctr_prng(&prng, part.data(), 3);
+  Fill_ctr_prng(&prng, part.data() + 3, 200);
+  for (size_t i = 203; i < len; i++) {
+    part[i] = Get_ctr_prng_value(&prng);
+  }
+  EXPECT_EQ(part, full);
+
+  // seek to a block in the middle of a batch
+  Seek_ctr_prng(&prng, 7, 11);
+  uint32_t val[CHACHA_BLOCK_WORDS];
+  Fill_ctr_prng(&prng, val, CHACHA_BLOCK_WORDS);
+  for (uint32_t i = 0; i < CHACHA_BLOCK_WORDS; i++) {
+    EXPECT_EQ(val[i], full[11 * CHACHA_BLOCK_WORDS + i]);
+  }
+
+  // other substream of the same key differs
+  Seek_ctr_prng(&prng, 8, 0);
+  Fill_ctr_prng(&prng, part.data(), len);
+  size_t same = 0;
+  for (size_t i = 0; i < len; i++) {
+    same += (part[i] == full[i]);
+  }
+  EXPECT_LE(same, 1);
+}
+
+TEST(sample, test_uniform) {
+  // chi-square of samples in at most 16 buckets, below 99.9% critical value
+  // of 15 degrees of freedom 37.7
+  const size_t   size    = 1 << 16;
+  const uint32_t buckets = 16;
+  uint64_t       bound[] = {3, 0x7fffffff, 0x3ffffffffffffULL, 0xfffffffbULL};
+  VALUE_LIST*    value   = Alloc_value_list(I64_TYPE, size);
+  for (uint64_t upper : bound) {
+    Sample_uniform(value, upper);
+    std::vector<double> cnt(buckets, 0);
+    FOR_ALL_ELEM(value, idx) {
+      uint64_t val = (uint64_t)Get_i64_value_at(value, idx);
+      ASSERT_LT(val, upper);
+      cnt[upper < buckets ? val : (uint32_t)((double)val / upper * buckets)]++;
+    }
+    uint32_t num = upper < buckets ? upper : buckets;
+    double   exp = (double)size / num;
+    double   chi = 0;
+    for (uint32_t i = 0; i < num; i++) {
+      chi += (cnt[i] - exp) * (cnt[i] - exp) / exp;
+    }
+    EXPECT_LT(chi, 37.7) << "upper bound " << upper;
+  }
+
+  // ternary without hamming weight and triangle by value frequency
+  Sample_ternary(value, 0);
+  int64_t cnt[3] = {0, 0, 0};
+  FOR_ALL_ELEM(value, idx) { cnt[Get_i64_value_at(value, idx) + 1]++; }
+  for (uint32_t i = 0; i < 3; i++) {
+    EXPECT_NEAR((double)cnt[i] / size, 1.0 / 3, 0.01);
+  }
+  Sample_triangle(value);
+  cnt[0] = cnt[1] = cnt[2] = 0;
+  FOR_ALL_ELEM(value, idx) { cnt[Get_i64_value_at(value, idx) + 1]++; }
+  EXPECT_NEAR((double)cnt[0] / size, 0.25, 0.01);
+  EXPECT_NEAR((double)cnt[1] / size, 0.5, 0.01);
+  EXPECT_NEAR((double)cnt[2] / size, 0.25, 0.01);
+  Free_value_list(value);
+}
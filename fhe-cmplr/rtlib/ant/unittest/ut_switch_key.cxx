@@ -0,0 +1,173 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include <stdlib.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/rt_env.h"
+#include "gtest/gtest.h"
+#include "helper.h"
+#include "util/ciphertext.h"
+#include "util/ckks_decryptor.h"
+#include "util/ckks_encoder.h"
+#include "util/ckks_encryptor.h"
+#include "util/ckks_evaluator.h"
+#include "util/ckks_key_generator.h"
+#include "util/ckks_parameters.h"
+#include "util/plaintext.h"
+#include "util/random_sample.h"
+
+class TEST_SWITCH_KEY : public ::testing::TestWithParam<SWK_MODE> {
+protected:
+  void SetUp() override {
+    setenv(ENV_RT_SWK_COMPRESS, std::to_string(GetParam()).c_str(), 1);
+    _param = Alloc_ckks_parameter();
+    Init_ckks_parameters_with_multiply_depth(_param, _degree, HE_STD_NOT_SET, 3,
+                                             0);
+    int32_t rot_idxs[3] = {1, 2, 5};
+    _keygen             = Alloc_ckks_key_generator(_param, rot_idxs, 3);
+    _encoder            = Alloc_ckks_encoder(_param);
+    _encryptor = Alloc_ckks_encryptor(_param, Get_pk(_keygen), Get_sk(_keygen));
+    _decryptor = Alloc_ckks_decryptor(_param, Get_sk(_keygen));
+    _evaluator = Alloc_ckks_evaluator(_param, _encoder, _decryptor, _keygen);
+    unsetenv(ENV_RT_SWK_COMPRESS);
+  }
+  void TearDown() override {
+    Free_ckks_evaluator(_evaluator);
+    Free_ckks_decryptor(_decryptor);
+    Free_ckks_encryptor(_encryptor);
+    Free_ckks_encoder(_encoder);
+    Free_ckks_key_generator(_keygen);
+    Free_ckks_parameters(_param);
+  }
+
+  // encrypt vec, rotate by rot, multiply by itself and check the result
+  void Run_test_rotate_mul(VALUE_LIST* vec, int32_t rot) {
+    size_t      len = LIST_LEN(vec);
+    VALUE_LIST* exp = Alloc_value_list(DCMPLX_TYPE, len);
+    for (size_t idx = 0; idx < len; idx++) {
+      DCMPLX val                = Get_dcmplx_value_at(vec, (idx + rot) % len);
+      DCMPLX_VALUE_AT(exp, idx) = val * val;
+    }
+    PLAINTEXT*  plain   = Alloc_plaintext();
+    CIPHERTEXT* ciph    = Alloc_ciphertext();
+    CIPHERTEXT* rot_res = Alloc_ciphertext();
+    CIPHERTEXT* mul_res = Alloc_ciphertext();
+    CIPHERTEXT* res     = Alloc_ciphertext();
+    PLAINTEXT*  dec     = Alloc_plaintext();
+    VALUE_LIST* decoded = Alloc_value_list(DCMPLX_TYPE, len);
+
+    ENCODE(plain, _encoder, vec);
+    Encrypt_msg(ciph, _encryptor, plain);
+    uint32_t    auto_idx = Get_precomp_auto_idx(_keygen, rot);
+    SWITCH_KEY* rot_key  = Get_auto_key(_keygen, auto_idx);
+    Eval_fast_rotate(rot_res, ciph, rot, rot_key, _evaluator);
+    Mul_ciphertext(mul_res, rot_res, rot_res, _keygen->_relin_key,
+                   _evaluator);
+    Rescale_ciphertext(res, mul_res, _evaluator);
+    Decrypt(dec, _decryptor, res, NULL);
+    Decode(decoded, _encoder, dec);
+    Check_complex_vector_approx_eq(exp, decoded, 0.01);
+
+    Free_value_list(decoded);
+    Free_plaintext(dec);
+    Free_ciphertext(res);
+    Free_ciphertext(mul_res);
+    Free_ciphertext(rot_res);
+    Free_ciphertext(ciph);
+    Free_plaintext(plain);
+    Free_value_list(exp);
+  }
+
+  uint32_t            _degree = 32;
+  CKKS_PARAMETER*     _param;
+  CKKS_KEY_GENERATOR* _keygen;
+  CKKS_ENCODER*       _encoder;
+  CKKS_ENCRYPTOR*     _encryptor;
+  CKKS_DECRYPTOR*     _decryptor;
+  CKKS_EVALUATOR*     _evaluator;
+};
+
+TEST_P(TEST_SWITCH_KEY, round_trip) {
+  CRT_CONTEXT* crt   = Get_param_crt(_param);
+  SWITCH_KEY*  key   = _keygen->_relin_key;
+  size_t       parts = Get_swk_size(key);
+  EXPECT_EQ(key->_mode, GetParam());
+  if (GetParam() != SWK_FULL) {
+    // only b of public keys is kept after key generation
+    size_t pk_size = Get_pk_mem_size(Get_swk_at(key, 0));
+    EXPECT_EQ(pk_size, sizeof(PUBLIC_KEY) +
+                           Get_poly_mem_size(Get_pk0(Get_swk_at(key, 0))));
+  }
+
+  // a expanded in each mode is same as the one keys are generated with
+  for (size_t part = 0; part < parts; part++) {
+    POLYNOMIAL expanded;
+    memset(&expanded, 0, sizeof(expanded));
+    Expand_swk_a(&expanded, key, part, crt);
+    POLYNOMIAL* a = Get_swk_a(key, part, crt);
+    ASSERT_EQ(Get_poly_mem_size(a), Get_poly_mem_size(&expanded));
+    EXPECT_TRUE(Is_ntt(a));
+    EXPECT_EQ(memcmp(Get_poly_coeffs(a), Get_poly_coeffs(&expanded),
+                     Get_poly_mem_size(a)),
+              0);
+    Free_poly_data(&expanded);
+  }
+}
+
+// threads using a key at the same time get the same a of each part, which
+// is expanded only once for SWK_LAZY
+TEST_P(TEST_SWITCH_KEY, concurrent_use) {
+  if (GetParam() == SWK_TRANSIENT) {
+    GTEST_SKIP() << "a is expanded to scratch of each thread";
+  }
+  CRT_CONTEXT* crt   = Get_param_crt(_param);
+  SWITCH_KEY*  key   = _keygen->_relin_key;
+  size_t       parts = Get_swk_size(key);
+  std::vector<std::vector<POLYNOMIAL*> > res(8,
+                                             std::vector<POLYNOMIAL*>(parts));
+  std::vector<std::thread>               threads;
+  for (size_t t = 0; t < res.size(); t++) {
+    threads.emplace_back([&, t]() {
+      for (size_t part = 0; part < parts; part++) {
+        res[t][part] = Get_swk_a(key, parts - 1 - part, crt);
+      }
+    });
+  }
+  for (std::thread& th : threads) {
+    th.join();
+  }
+  for (size_t part = 0; part < parts; part++) {
+    POLYNOMIAL* a = Get_pk1(Get_swk_at(key, parts - 1 - part));
+    for (size_t t = 0; t < res.size(); t++) {
+      EXPECT_EQ(res[t][part], a);
+    }
+    POLYNOMIAL expanded;
+    memset(&expanded, 0, sizeof(expanded));
+    Expand_swk_a(&expanded, key, parts - 1 - part, crt);
+    EXPECT_EQ(memcmp(Get_poly_coeffs(a), Get_poly_coeffs(&expanded),
+                     Get_poly_mem_size(a)),
+              0);
+    Free_poly_data(&expanded);
+  }
+}
+
+TEST_P(TEST_SWITCH_KEY, rotate_and_relin) {
+  VALUE_LIST* vec = Alloc_value_list(DCMPLX_TYPE, _degree / 2);
+  Sample_random_complex_vector(Get_dcmplx_values(vec), _degree / 2);
+  Run_test_rotate_mul(vec, 1);
+  Run_test_rotate_mul(vec, 5);
+  Run_test_rotate_mul(vec, 2);
+  Free_value_list(vec);
+}
+
+INSTANTIATE_TEST_SUITE_P(swk_mode, TEST_SWITCH_KEY,
+                         ::testing::Values(SWK_FULL, SWK_LAZY, SWK_TRANSIENT));
@@ -27,8 +27,10 @@
 // the code below only available for linux
 #ifdef __linux__
 
+#include <errno.h>
 #include <fcntl.h>
 #include <linux/io_uring.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -90,28 +92,47 @@ struct IO_URING_CTX {
     void*                _cq_ptr;
     size_t               _cq_size;
   } _cq_ring;
+  bool _fixed_buf;  // registered buffer is usable in this ring
 };
 
 // internal settings
-#define IO_QUEUE_DEPTH 1
+#define IO_QUEUE_DEPTH 64
+#define MAX_IO_RING    64
 
-// internal global status
+// internal global status. Each thread submits to and reaps from its own
+// ring, so that threads reading blocks don't serialize on one ring. Rings
+// are taken from Io_ring when a thread does its first prefetch, Io_gen
+// invalidates rings cached by threads when library is finalized
 static bool                Lib_init;
-static struct IO_URING_CTX Io_ctx;
-
-bool Block_io_init(bool sync_read) {
-  IS_TRUE(Lib_init == false, "library already initialized");
-  Lib_init = true;
-
-  if (sync_read) {
-    // no need to set up io_uring for sync read
-    return true;
+static struct IO_URING_CTX Io_ring[MAX_IO_RING];
+static uint32_t            Io_ring_count;
+static uint32_t            Io_gen;
+static pthread_mutex_t     Io_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct iovec        Io_fixed_buf;  // buffer registered to all rings
+
+static _Thread_local struct IO_URING_CTX* Thr_ring;
+static _Thread_local uint32_t             Thr_gen;
+
+// register fixed buffer to ring, ring still works without it
+static void Register_fixed_buf(struct IO_URING_CTX* ctx) {
+  ctx->_fixed_buf = false;
+  if (Io_fixed_buf.iov_base == NULL) {
+    return;
+  }
+  int ret = io_uring_register(ctx->_ring_fd, IORING_REGISTER_BUFFERS,
+                              &Io_fixed_buf, 1);
+  if (ret < 0) {
+    perror("Warning: buffer io_uring_register()");
+    return;
   }
+  ctx->_fixed_buf = true;
+}
 
+static bool Setup_ring(struct IO_URING_CTX* ctx) {
   struct io_uring_params io_param;
   memset(&io_param, 0, sizeof(io_param));
-  Io_ctx._ring_fd = io_uring_setup(IO_QUEUE_DEPTH, &io_param);
-  if (Io_ctx._ring_fd < 0) {
+  ctx->_ring_fd = io_uring_setup(IO_QUEUE_DEPTH, &io_param);
+  if (ctx->_ring_fd < 0) {
     perror("Fatal: io_uring_setup()");
     return false;
   }
@@ -127,124 +148,163 @@ bool Block_io_init(bool sync_read) {
   }
   void* sq_ptr =
       mmap(0, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
-           Io_ctx._ring_fd, IORING_OFF_SQ_RING);
+           ctx->_ring_fd, IORING_OFF_SQ_RING);
   if (sq_ptr == MAP_FAILED) {
     perror("Fatal: sq_ring mmap()");
-    close(Io_ctx._ring_fd);
+    close(ctx->_ring_fd);
     return false;
   }
-  Io_ctx._sq_ring._sq_ptr  = sq_ptr;
-  Io_ctx._sq_ring._sq_size = sq_size;
+  ctx->_sq_ring._sq_ptr  = sq_ptr;
+  ctx->_sq_ring._sq_size = sq_size;
   void* cq_ptr;
   if (io_param.features & IORING_FEAT_SINGLE_MMAP) {
-    cq_ptr                  = sq_ptr;
-    Io_ctx._cq_ring._cq_ptr = MAP_FAILED;
+    cq_ptr                = sq_ptr;
+    ctx->_cq_ring._cq_ptr = MAP_FAILED;
   } else {
     // map cq_ptr with second mmap() call
     cq_ptr = mmap(0, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
-                  Io_ctx._ring_fd, IORING_OFF_CQ_RING);
+                  ctx->_ring_fd, IORING_OFF_CQ_RING);
     if (cq_ptr == MAP_FAILED) {
       perror("Fatal: cq_ring mmap()");
       munmap(sq_ptr, sq_size);
-      close(Io_ctx._ring_fd);
+      close(ctx->_ring_fd);
       return false;
     }
-    Io_ctx._cq_ring._cq_ptr  = cq_ptr;
-    Io_ctx._cq_ring._cq_size = cq_size;
+    ctx->_cq_ring._cq_ptr  = cq_ptr;
+    ctx->_cq_ring._cq_size = cq_size;
   }
 
   // map submision queue entry
   size_t sqes_size = io_param.sq_entries * sizeof(struct io_uring_sqe);
   void*  sqes =
       mmap(0, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
-           Io_ctx._ring_fd, IORING_OFF_SQES);
+           ctx->_ring_fd, IORING_OFF_SQES);
   if (sqes == MAP_FAILED) {
     perror("Fatal: sqes mmap()");
-    if (cq_ptr != MAP_FAILED) {
+    if (cq_ptr != sq_ptr) {
       munmap(cq_ptr, cq_size);
     }
     munmap(sq_ptr, sq_size);
-    close(Io_ctx._ring_fd);
+    close(ctx->_ring_fd);
     return false;
   }
-  Io_ctx._sq_ring._sqes      = sqes;
-  Io_ctx._sq_ring._sqes_size = sqes_size;
+  ctx->_sq_ring._sqes      = sqes;
+  ctx->_sq_ring._sqes_size = sqes_size;
 
   // save fields into sq_ring
-  Io_ctx._sq_ring._head         = sq_ptr + io_param.sq_off.head;
-  Io_ctx._sq_ring._tail         = sq_ptr + io_param.sq_off.tail;
-  Io_ctx._sq_ring._ring_mask    = sq_ptr + io_param.sq_off.ring_mask;
-  Io_ctx._sq_ring._ring_entries = sq_ptr + io_param.sq_off.ring_entries;
-  Io_ctx._sq_ring._flags        = sq_ptr + io_param.sq_off.flags;
-  Io_ctx._sq_ring._array        = sq_ptr + io_param.sq_off.array;
+  ctx->_sq_ring._head         = sq_ptr + io_param.sq_off.head;
+  ctx->_sq_ring._tail         = sq_ptr + io_param.sq_off.tail;
+  ctx->_sq_ring._ring_mask    = sq_ptr + io_param.sq_off.ring_mask;
+  ctx->_sq_ring._ring_entries = sq_ptr + io_param.sq_off.ring_entries;
+  ctx->_sq_ring._flags        = sq_ptr + io_param.sq_off.flags;
+  ctx->_sq_ring._array        = sq_ptr + io_param.sq_off.array;
 
   // save fields into cring
-  Io_ctx._cq_ring._head         = cq_ptr + io_param.cq_off.head;
-  Io_ctx._cq_ring._tail         = cq_ptr + io_param.cq_off.tail;
-  Io_ctx._cq_ring._ring_mask    = cq_ptr + io_param.cq_off.ring_mask;
-  Io_ctx._cq_ring._ring_entries = cq_ptr + io_param.cq_off.ring_entries;
-  Io_ctx._cq_ring._cqes         = cq_ptr + io_param.cq_off.cqes;
+  ctx->_cq_ring._head         = cq_ptr + io_param.cq_off.head;
+  ctx->_cq_ring._tail         = cq_ptr + io_param.cq_off.tail;
+  ctx->_cq_ring._ring_mask    = cq_ptr + io_param.cq_off.ring_mask;
+  ctx->_cq_ring._ring_entries = cq_ptr + io_param.cq_off.ring_entries;
+  ctx->_cq_ring._cqes         = cq_ptr + io_param.cq_off.cqes;
 
+  Register_fixed_buf(ctx);
   return true;
 }
 
+static void Teardown_ring(struct IO_URING_CTX* ctx) {
+  // munmap sqe array
+  munmap(ctx->_sq_ring._sqes, ctx->_sq_ring._sqes_size);
+  // munmap sq_ptr
+  munmap(ctx->_sq_ring._sq_ptr, ctx->_sq_ring._sq_size);
+  // munmap cq_ptr
+  if (ctx->_cq_ring._cq_ptr != MAP_FAILED) {
+    munmap(ctx->_cq_ring._cq_ptr, ctx->_cq_ring._cq_size);
+  }
+  if (ctx->_fixed_buf) {
+    io_uring_register(ctx->_ring_fd, IORING_UNREGISTER_BUFFERS, NULL, 0);
+  }
+  close(ctx->_ring_fd);
+}
+
+// ring of current thread, set up on first use
+static struct IO_URING_CTX* Thread_ring() {
+  if (Thr_ring != NULL && Thr_gen == Io_gen) {
+    return Thr_ring;
+  }
+  struct IO_URING_CTX* ctx = NULL;
+  pthread_mutex_lock(&Io_lock);
+  if (Io_ring_count < MAX_IO_RING && Setup_ring(&Io_ring[Io_ring_count])) {
+    ctx = &Io_ring[Io_ring_count++];
+  }
+  pthread_mutex_unlock(&Io_lock);
+  IS_TRUE(ctx != NULL, "failed to set up io_uring for thread");
+  Thr_ring = ctx;
+  Thr_gen  = Io_gen;
+  return ctx;
+}
+
+bool Block_io_init(bool sync_read) {
+  IS_TRUE(Lib_init == false, "library already initialized");
+  Lib_init = true;
+
+  if (sync_read) {
+    // no need to set up io_uring for sync read
+    return true;
+  }
+
+  // set up ring of the initializing thread to check io_uring is supported
+  return Thread_ring() != NULL;
+}
+
 void Block_io_fini(bool sync_read) {
   IS_TRUE(Lib_init == true, "library not initialized");
   Lib_init = false;
 
-  if (sync_read) {
-    return;
+  pthread_mutex_lock(&Io_lock);
+  for (uint32_t i = 0; i < Io_ring_count; ++i) {
+    Teardown_ring(&Io_ring[i]);
   }
+  Io_ring_count         = 0;
+  Io_fixed_buf.iov_base = NULL;
+  Io_fixed_buf.iov_len  = 0;
+  ++Io_gen;
+  pthread_mutex_unlock(&Io_lock);
+}
 
-  // munmap sqe array
-  if (Io_ctx._sq_ring._sqes != MAP_FAILED) {
-    munmap(Io_ctx._sq_ring._sqes, Io_ctx._sq_ring._sqes_size);
-    Io_ctx._sq_ring._sqes = MAP_FAILED;
-  }
-  // munmap sq_ptr
-  if (Io_ctx._sq_ring._sq_ptr != MAP_FAILED) {
-    munmap(Io_ctx._sq_ring._sq_ptr, Io_ctx._sq_ring._sq_size);
-    Io_ctx._sq_ring._sq_ptr = MAP_FAILED;
-  }
-  // munmap cq_ptr
-  if (Io_ctx._cq_ring._cq_ptr != MAP_FAILED) {
-    munmap(Io_ctx._cq_ring._cq_ptr, Io_ctx._cq_ring._cq_size);
-    Io_ctx._cq_ring._cq_ptr = MAP_FAILED;
-  }
-  if (Io_ctx._ring_fd != -1) {
-    io_uring_register(Io_ctx._ring_fd, IORING_UNREGISTER_FILES, NULL, 0);
-    io_uring_register(Io_ctx._ring_fd, IORING_UNREGISTER_BUFFERS, NULL, 0);
-    close(Io_ctx._ring_fd);
-    Io_ctx._ring_fd = -1;
+bool Block_io_register_buffer(void* base, size_t size) {
+  IS_TRUE(Lib_init == true, "library not initialized");
+  bool ret = true;
+  pthread_mutex_lock(&Io_lock);
+  Io_fixed_buf.iov_base = base;
+  Io_fixed_buf.iov_len  = size;
+  for (uint32_t i = 0; i < Io_ring_count; ++i) {
+    if (Io_ring[i]._fixed_buf) {
+      io_uring_register(Io_ring[i]._ring_fd, IORING_UNREGISTER_BUFFERS, NULL,
+                        0);
+    }
+    Register_fixed_buf(&Io_ring[i]);
+    ret = ret && Io_ring[i]._fixed_buf;
   }
+  pthread_mutex_unlock(&Io_lock);
+  return ret;
 }
 
-int Block_io_open(const char* fname, bool sync_read) {
+int Block_io_open(const char* fname, bool sync_read, bool direct_io) {
   // check if library is initialized
   if (Lib_init <= 0) {
     FMT_ASSERT(false, "Fatal: io not initialized.\n");
     return -1;
   }
-  IS_TRUE(Io_ctx._ring_fd != -1, "io_uring fd invalid.\n");
 
-  // open the file for read
-  int fd = open(fname, O_RDONLY | __O_NOATIME);
+  // open the file for read, O_DIRECT bypasses page cache
+  int flags = O_RDONLY | __O_NOATIME;
+  if (direct_io) {
+    flags |= __O_DIRECT;
+  }
+  int fd = open(fname, flags);
   if (fd == -1) {
     perror("Fatal: data open()");
     return -1;
   }
-
-  if (sync_read) {
-    return fd;
-  }
-
-  // register fd to ring_fd
-  int ret = io_uring_register(Io_ctx._ring_fd, IORING_REGISTER_FILES, &fd, 1);
-  if (ret < 0) {
-    perror("Fatal: file io_uring_register()");
-    close(fd);
-    return -1;
-  }
   return fd;
 }
 
@@ -253,74 +313,104 @@ void Block_io_close(int fd) { close(fd); }
 bool Block_io_prefetch(int fd, uint64_t ofst, BLOCK_INFO* blk) {
   RTLIB_TM_START(RTM_IO_SUBMIT, rtm);
   IS_TRUE(blk->_blk_sts == BLK_INVALID, "block state is not invalid");
+  struct IO_URING_CTX* ctx = Thread_ring();
   // find a valid slot in submission queue
-  unsigned head         = *Io_ctx._sq_ring._head;
-  unsigned tail         = *Io_ctx._sq_ring._tail;
-  unsigned ring_entries = *Io_ctx._sq_ring._ring_entries;
+  unsigned head         = *ctx->_sq_ring._head;
+  unsigned tail         = *ctx->_sq_ring._tail;
+  unsigned ring_entries = *ctx->_sq_ring._ring_entries;
   unsigned next_tail    = tail + 1;
   read_barrier();
   if (next_tail - head > ring_entries) {
     IS_TRUE(false, "Fixme: no available slot in sq");
     return false;
   }
-  unsigned index                = tail & *Io_ctx._sq_ring._ring_mask;
-  Io_ctx._sq_ring._array[index] = index;
-  tail                          = next_tail;
-  if (*Io_ctx._sq_ring._tail != tail) {
-    *Io_ctx._sq_ring._tail = tail;
-    write_barrier();
+  unsigned index = tail & *ctx->_sq_ring._ring_mask;
+
+  // fill submission queue entry. Buffer in registered buffer is read with
+  // READ_FIXED, which saves mapping the pages on each read
+  struct io_uring_sqe* sqe = &ctx->_sq_ring._sqes[index];
+  char*                buf = (char*)blk->_iovec.iov_base;
+  char*                fixed_base = (char*)Io_fixed_buf.iov_base;
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->fd  = fd;
+  sqe->off = ofst;
+  if (ctx->_fixed_buf && buf >= fixed_base &&
+      buf + blk->_iovec.iov_len <= fixed_base + Io_fixed_buf.iov_len) {
+    sqe->opcode    = IORING_OP_READ_FIXED;
+    sqe->addr      = (unsigned long)buf;
+    sqe->len       = blk->_iovec.iov_len;
+    sqe->buf_index = 0;
+  } else {
+    sqe->opcode = IORING_OP_READV;
+    sqe->addr   = (unsigned long)&blk->_iovec;
+    sqe->len    = 1;
   }
+  sqe->user_data = (unsigned long)blk;
+  blk->_blk_sts  = BLK_PREFETCHING;
 
-  // fill submission queue entry and submit
-  struct io_uring_sqe* sqe = &Io_ctx._sq_ring._sqes[index];
-  sqe->opcode              = IORING_OP_READV;
-  sqe->fd                  = fd;
-  sqe->flags               = 0;
-  sqe->off                 = ofst;
-  sqe->addr                = (unsigned long)&blk->_iovec;
-  sqe->len                 = 1;
-  sqe->buf_index           = 0;
-  sqe->user_data           = (unsigned long)blk;
-  int ret = io_uring_enter(Io_ctx._ring_fd, 1, 1, IORING_ENTER_GETEVENTS);
+  // publish the entry and submit without waiting for completion
+  ctx->_sq_ring._array[index] = index;
+  write_barrier();
+  *ctx->_sq_ring._tail = next_tail;
+  write_barrier();
+  int ret = io_uring_enter(ctx->_ring_fd, 1, 0, 0);
   if (ret < 0) {
     perror("Fatal: io_uring_enter()");
+    blk->_blk_sts = BLK_INVALID;
     return false;
   }
-  blk->_blk_sts = BLK_PREFETCHING;
   RTLIB_TM_END(RTM_IO_SUBMIT, rtm);
   return true;
 }
 
-bool Block_io_read(int fd, uint64_t ofst, BLOCK_INFO* blk) {
-  RTLIB_TM_START(RTM_IO_COMPLETE, rtm);
-  // check if complete queue is empty
-  unsigned             head = *Io_ctx._cq_ring._head;
-  struct io_uring_cqe* cqe;
-  do {
+// mark blocks of completed reads in ring ready, return false on read error
+static bool Reap_completion(struct IO_URING_CTX* ctx) {
+  unsigned head = *ctx->_cq_ring._head;
+  bool     ok   = true;
+  while (true) {
     read_barrier();
-    if (head == *Io_ctx._cq_ring._tail) {
-      IS_TRUE(false, "Fixme: nothing to read");
-      return false;
+    if (head == *ctx->_cq_ring._tail) {
+      break;
     }
-
     // process complete queue entry
-    unsigned index = head & *Io_ctx._cq_ring._ring_mask;
-    cqe            = &Io_ctx._cq_ring._cqes[index];
+    unsigned             index  = head & *ctx->_cq_ring._ring_mask;
+    struct io_uring_cqe* cqe    = &ctx->_cq_ring._cqes[index];
+    BLOCK_INFO*          cq_blk = (BLOCK_INFO*)cqe->user_data;
+    IS_TRUE(cq_blk->_blk_sts == BLK_PREFETCHING, "not in prefetching state");
     if (cqe->res < 0) {
       fprintf(stderr, "Fatal: cqes %s\n", strerror(-cqe->res));
-      IS_TRUE(false, "Fixme: async read error");
-      return false;
+      cq_blk->_blk_sts = BLK_INVALID;
+      ok               = false;
+    } else {
+      cq_blk->_blk_sts = BLK_READY;
     }
-    BLOCK_INFO* cq_blk = (BLOCK_INFO*)cqe->user_data;
-    IS_TRUE(cq_blk->_blk_sts == BLK_PREFETCHING, "not in prefetching state");
-    cq_blk->_blk_sts = BLK_READY;
     head++;
-  } while (cqe->user_data != (unsigned long)blk);
-
-  *Io_ctx._cq_ring._head = head;
+  }
+  *ctx->_cq_ring._head = head;
   write_barrier();
+  return ok;
+}
+
+bool Block_io_read(int fd, uint64_t ofst, BLOCK_INFO* blk) {
+  RTLIB_TM_START(RTM_IO_COMPLETE, rtm);
+  struct IO_URING_CTX* ctx = Thread_ring();
+  // reads complete out of order, wait until the one of blk is done
+  while (blk->_blk_sts == BLK_PREFETCHING) {
+    if (!Reap_completion(ctx)) {
+      IS_TRUE(false, "Fixme: async read error");
+      return false;
+    }
+    if (blk->_blk_sts != BLK_PREFETCHING) {
+      break;
+    }
+    int ret = io_uring_enter(ctx->_ring_fd, 0, 1, IORING_ENTER_GETEVENTS);
+    if (ret < 0 && errno != EINTR) {
+      perror("Fatal: io_uring_enter()");
+      return false;
+    }
+  }
   RTLIB_TM_END(RTM_IO_COMPLETE, rtm);
-  return true;
+  return blk->_blk_sts == BLK_READY;
 }
 
 #endif  // __linux__
@@ -9,29 +9,95 @@
 #include "common/pt_mgr.h"
 
 #include <math.h>
+#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "common/error.h"
 #include "common/rt_api.h"
 #include "common/rt_data_file.h"
 #include "common/rt_env.h"
+#include "common/rt_stat.h"
 #include "common/rtlib_timing.h"
 #include "fhe/core/rt_data_def.h"
 #include "fhe/core/rt_encode_api.h"
 
+// plaintext entry kept in a slot of PT_MGR
+typedef struct PT_SLOT {
+  uint32_t _next_use;  // schedule position where entry is requested next
+  void*    _plain;     // plaintext cast from buffer, NULL if not cast yet
+} PT_SLOT;
+
+// state of message encoded ahead by worker
+typedef enum {
+  JOB_FREE,     // job is not used
+  JOB_PENDING,  // waiting for a worker
+  JOB_RUNNING,  // being encoded by a worker
+  JOB_DONE,     // encoded into _buf
+} JOB_STS;
+
+// message requested at schedule position _pos and encoded ahead. Encoded
+// plaintext is used only if Pt_from_msg requests it with the same length,
+// scale and level
+typedef struct PT_JOB {
+  struct PLAINTEXT_BUFFER* _buf;
+  uint64_t                 _len;
+  uint32_t                 _index;
+  uint32_t                 _scale;
+  uint32_t                 _level;
+  uint32_t                 _pos;
+  JOB_STS                  _sts;
+} PT_JOB;
+
+// pool of workers encoding messages ahead, all fields except _worker are
+// protected by _lock
+typedef struct PT_ENCODER {
+  pthread_t*      _worker;
+  PT_JOB*         _job;
+  pthread_mutex_t _lock;
+  pthread_cond_t  _job_cv;   // signaled when a job is pending or on stop
+  pthread_cond_t  _done_cv;  // signaled when a job is done
+  uint32_t        _worker_count;
+  uint32_t        _job_count;
+  uint32_t*       _scale;       // scale and level each index in schedule is
+  uint32_t*       _level;       // last requested with, NO_LEVEL if not yet
+  uint32_t        _last_scale;  // scale and level of last request, taken for
+  uint32_t        _last_level;  // index not requested yet
+  bool            _stop;
+} PT_ENCODER;
+
 typedef struct PT_MGR {
-  struct RT_DATA_FILE* _file;
-  char*                _pt_buf;
-  BLOCK_INFO*          _pt_entry;
-  uint64_t             _pt_size;
-  uint32_t             _ent_invalid;
-  uint32_t             _ent_count;
-  uint32_t             _prefetch_count;
-  bool                 _sync_read;
+  struct RT_DATA_FILE*           _file;
+  char*                          _pt_buf;
+  BLOCK_INFO*                    _pt_entry;
+  PT_SLOT*                       _slot;
+  PT_ENCODER*                    _encoder;
+  const struct DATA_SCHED_ENTRY* _sched;
+  uint32_t*                      _first_pos;  // first position of each index
+  uint32_t*                      _find_pos;   // where search of index resumes
+  uint64_t                       _pt_size;
+  uint64_t                       _num_hit;
+  uint64_t                       _num_stall;
+  uint32_t                       _sched_count;
+  uint32_t                       _idx_count;  // max index in schedule + 1
+  uint32_t                       _sched_pos;  // position of next Pt_get
+  uint32_t                       _pf_pos;     // position of next prefetch
+  uint32_t                       _cur_slot;   // slot of last Pt_get
+  uint32_t                       _ent_count;
+  uint32_t                       _prefetch_count;
+  bool                           _sync_read;
 } PT_MGR;
 
 static PT_MGR Pt_mgr;
 
+#define NO_SLOT  ((uint32_t)-1)
+#define NO_LEVEL ((uint32_t)-1)
+
+static void Init_schedule();
+static void Prefetch_schedule();
+static void Start_encoder(uint32_t worker_count, uint32_t job_count);
+static void Stop_encoder();
+
 bool Pt_mgr_init(const char* fname) {
   // Check environment
   const char* pt_env = getenv(ENV_PT_ENTRY_COUNT);
@@ -40,107 +106,280 @@ bool Pt_mgr_init(const char* fname) {
     pt_count = 8;
   }
   const char* pf_env = getenv(ENV_PT_PREFETCH_COUNT);
-  uint32_t    pf_count;
+  int         pf_count;
   if (pf_env == NULL || (pf_count = atoi(pf_env)) < 0) {
     pf_count = 2;
   }
+  const char* et_env = getenv(ENV_PT_ENCODE_THREAD);
+  int         et_count;
+  if (et_env == NULL || (et_count = atoi(et_env)) < 0) {
+    et_count = 0;
+  }
+  const char* ea_env = getenv(ENV_PT_ENCODE_AHEAD);
+  uint32_t    ea_count;
+  if (ea_env == NULL || (ea_count = atoi(ea_env)) == 0) {
+    ea_count = 4;
+  }
   bool        sync_read = false;
   const char* sr_env    = getenv(ENV_RT_DATA_ASYNC_READ);
   if (sr_env == NULL || atoi(sr_env) != 1) {
     sync_read = true;
   }
+  const char* dio_env   = getenv(ENV_RT_DATA_DIRECT_IO);
+  bool        direct_io = (dio_env != NULL && atoi(dio_env) == 1);
+  const char* fb_env    = getenv(ENV_RT_DATA_FIXED_BUF);
+  bool        fixed_buf = (fb_env != NULL && atoi(fb_env) == 1);
   // Initialize block io
   if (Block_io_init(sync_read) == false) {
     return false;
   }
 
   Pt_mgr._sync_read = sync_read;
-  Pt_mgr._file      = Rt_data_open(fname, sync_read);
+  Pt_mgr._file      = Rt_data_open(fname, sync_read, direct_io);
   if (Pt_mgr._file == NULL) {
     return false;
   }
+  Pt_mgr._pt_entry  = NULL;
+  Pt_mgr._encoder   = NULL;
+  Pt_mgr._sched     = Rt_data_schedule(Pt_mgr._file, &Pt_mgr._sched_count);
+  Pt_mgr._sched_pos = 0;
+  Pt_mgr._pf_pos    = 0;
+  Pt_mgr._num_hit   = 0;
+  Pt_mgr._num_stall = 0;
+  Init_schedule();
 
   if (Rt_data_is_plaintext(Pt_mgr._file)) {
     // setup a fixed length buffer and recycle it for plaintext
     // TODO: use mmap to allocate memory on large page
     uint64_t pt_size = Max_plain_buffer_length();
-    // align to DATA_FILE_PAGE_SIZE
+    // align to DATA_FILE_PAGE_SIZE, as required by direct I/O
     pt_size =
         (pt_size + DATA_FILE_PAGE_SIZE - 1) & (~(DATA_FILE_PAGE_SIZE - 1));
-    Pt_mgr._pt_buf = (char*)malloc(pt_size * pt_count);
-    IS_TRUE(Pt_mgr._pt_buf != NULL, "failed to malloc PT_BUF");
+    int ret = posix_memalign((void**)&Pt_mgr._pt_buf, DATA_FILE_PAGE_SIZE,
+                             pt_size * pt_count);
+    IS_TRUE(ret == 0, "failed to malloc PT_BUF");
+    if (fixed_buf && !sync_read) {
+      Block_io_register_buffer(Pt_mgr._pt_buf, pt_size * pt_count);
+    }
 
     Pt_mgr._pt_entry = (BLOCK_INFO*)malloc(sizeof(BLOCK_INFO) * pt_count);
     IS_TRUE(Pt_mgr._pt_entry != NULL, "failed to malloc BLOCK_INFO");
+    Pt_mgr._slot = (PT_SLOT*)malloc(sizeof(PT_SLOT) * pt_count);
+    IS_TRUE(Pt_mgr._slot != NULL, "failed to malloc PT_SLOT");
     for (uint32_t i = 0; i < pt_count; ++i) {
       Pt_mgr._pt_entry[i]._blk_idx        = (uint32_t)-1;
       Pt_mgr._pt_entry[i]._blk_sts        = BLK_INVALID;
       Pt_mgr._pt_entry[i]._mem_next       = i + 1;
       Pt_mgr._pt_entry[i]._iovec.iov_base = Pt_mgr._pt_buf + i * pt_size;
       Pt_mgr._pt_entry[i]._iovec.iov_len  = pt_size;
+      Pt_mgr._slot[i]._next_use           = DATA_SCHED_NONE;
+      Pt_mgr._slot[i]._plain              = NULL;
     }
 
-    Pt_mgr._pt_size     = pt_size;
-    Pt_mgr._ent_invalid = 0;
-    Pt_mgr._ent_count   = pt_count;
+    Pt_mgr._pt_size   = pt_size;
+    Pt_mgr._ent_count = pt_count;
+    Pt_mgr._cur_slot  = NO_SLOT;
 
     // do some prefetch
     Pt_mgr._prefetch_count = pf_count;
-    for (uint32_t i = 0; i < pf_count; ++i) {
-      Pt_prefetch(i);
-    }
+    Prefetch_schedule();
   } else {
     // create a large buffer to contain all message
     uint64_t msg_sz = Rt_data_size(Pt_mgr._file);
     Pt_mgr._pt_buf  = (char*)malloc(msg_sz);
     Pt_mgr._pt_size = msg_sz;
     Rt_data_fill(Pt_mgr._file, Pt_mgr._pt_buf, msg_sz);
+    if (et_count > 0 && Pt_mgr._sched_count > 0) {
+      Start_encoder(et_count, ea_count);
+    }
   }
 
   return true;
 }
 
 void Pt_mgr_fini() {
+  if (Pt_mgr._encoder) {
+    Stop_encoder();
+  }
   Rt_data_close(Pt_mgr._file);
   free(Pt_mgr._pt_buf);
+  free(Pt_mgr._first_pos);
+  free(Pt_mgr._find_pos);
   if (Pt_mgr._pt_entry) {
     free(Pt_mgr._pt_entry);
+    free(Pt_mgr._slot);
   }
   Block_io_fini(Pt_mgr._sync_read);
 }
 
-static inline uint32_t Get_slot(uint32_t pt_idx) {
-  // so far, using direct mapping
-  return pt_idx % Pt_mgr._ent_count;
+void Pt_mgr_stat(uint64_t* hit, uint64_t* stall) {
+  *hit   = Pt_mgr._num_hit;
+  *stall = Pt_mgr._num_stall;
+}
+
+// slot holding or reading entry pt_idx, NO_SLOT if it's not in memory
+static inline uint32_t Find_slot(uint32_t pt_idx) {
+  for (uint32_t i = 0; i < Pt_mgr._ent_count; ++i) {
+    if (Pt_mgr._pt_entry[i]._blk_sts != BLK_INVALID &&
+        Pt_mgr._pt_entry[i]._blk_idx == pt_idx) {
+      return i;
+    }
+  }
+  return NO_SLOT;
+}
+
+// schedule position where entry in slot is requested next. Entry whose next
+// use is skipped because execution left the schedule is not used any more
+static inline uint32_t Next_use(uint32_t slot) {
+  uint32_t next = Pt_mgr._slot[slot]._next_use;
+  return next < Pt_mgr._sched_pos ? DATA_SCHED_NONE : next;
+}
+
+// slot to hold entry requested at schedule position pos. A free slot is
+// taken first, otherwise the entry requested farthest in the future is
+// evicted (Belady's MIN), but only if it's requested after pos. Entry
+// returned by last Pt_get is still in use and never evicted
+static uint32_t Victim_slot(uint32_t pos) {
+  uint32_t victim = NO_SLOT;
+  uint32_t far    = pos;
+  for (uint32_t i = 0; i < Pt_mgr._ent_count; ++i) {
+    if (i == Pt_mgr._cur_slot) {
+      continue;
+    }
+    if (Pt_mgr._pt_entry[i]._blk_sts == BLK_INVALID) {
+      return i;
+    }
+    uint32_t next = Next_use(i);
+    if (next >= far) {
+      far    = next;
+      victim = i;
+    }
+  }
+  return victim;
+}
+
+// start reading entry pt_idx into slot
+static void Load_slot(uint32_t slot, uint32_t pt_idx) {
+  BLOCK_INFO* blk = &Pt_mgr._pt_entry[slot];
+  if (blk->_blk_sts == BLK_PREFETCHING) {
+    // buffer can't be reused until pending read is done
+    Rt_data_read(Pt_mgr._file, blk->_blk_idx, blk, Pt_mgr._sync_read);
+  }
+  blk->_blk_idx       = pt_idx;
+  blk->_blk_sts       = BLK_INVALID;
+  blk->_iovec.iov_len = Pt_mgr._pt_size;
+  Pt_mgr._slot[slot]._plain = NULL;
+  bool ret = Rt_data_prefetch(Pt_mgr._file, pt_idx, blk, Pt_mgr._sync_read);
+  IS_TRUE(ret == true, "prefetch error");
+}
+
+// keep entries requested in next _prefetch_count positions of schedule in
+// memory or being read
+static void Prefetch_schedule() {
+  uint32_t end = Pt_mgr._sched_pos + Pt_mgr._prefetch_count;
+  if (end > Pt_mgr._sched_count) {
+    end = Pt_mgr._sched_count;
+  }
+  if (Pt_mgr._pf_pos < Pt_mgr._sched_pos) {
+    Pt_mgr._pf_pos = Pt_mgr._sched_pos;
+  }
+  for (; Pt_mgr._pf_pos < end; ++Pt_mgr._pf_pos) {
+    uint32_t pt_idx = Pt_mgr._sched[Pt_mgr._pf_pos]._index;
+    uint32_t slot   = Find_slot(pt_idx);
+    if (slot == NO_SLOT) {
+      slot = Victim_slot(Pt_mgr._pf_pos);
+      if (slot == NO_SLOT) {
+        // entries in memory are all requested earlier, retry on next Pt_get
+        break;
+      }
+      Load_slot(slot, pt_idx);
+      Pt_mgr._slot[slot]._next_use = Pt_mgr._pf_pos;
+    } else if (Next_use(slot) > Pt_mgr._pf_pos) {
+      Pt_mgr._slot[slot]._next_use = Pt_mgr._pf_pos;
+    }
+  }
+}
+
+// record the first position of each index in schedule. Later positions of
+// the same index are chained by _next_use
+static void Init_schedule() {
+  uint32_t cnt      = Pt_mgr._sched_count;
+  Pt_mgr._idx_count = 0;
+  for (uint32_t i = 0; i < cnt; ++i) {
+    if (Pt_mgr._sched[i]._index >= Pt_mgr._idx_count) {
+      Pt_mgr._idx_count = Pt_mgr._sched[i]._index + 1;
+    }
+  }
+  size_t size       = sizeof(uint32_t) * Pt_mgr._idx_count;
+  Pt_mgr._first_pos = (uint32_t*)malloc(size);
+  Pt_mgr._find_pos  = (uint32_t*)malloc(size);
+  IS_TRUE(Pt_mgr._idx_count == 0 ||
+              (Pt_mgr._first_pos != NULL && Pt_mgr._find_pos != NULL),
+          "failed to malloc schedule positions");
+  for (uint32_t i = 0; i < Pt_mgr._idx_count; ++i) {
+    Pt_mgr._first_pos[i] = DATA_SCHED_NONE;
+  }
+  for (uint32_t i = cnt; i > 0; --i) {
+    Pt_mgr._first_pos[Pt_mgr._sched[i - 1]._index] = i - 1;
+  }
+  memcpy(Pt_mgr._find_pos, Pt_mgr._first_pos, size);
+}
+
+// move schedule to the position after request of pt_idx and return the
+// position. Execution leaves the schedule if the compiler doesn't know trip
+// count of a loop, and restarts it when graph is run again, so the request
+// is searched forward and then from the beginning. Search follows positions
+// of pt_idx from where its last search stopped, which walks each chain once
+// until the schedule restarts. Return DATA_SCHED_NONE if pt_idx is not in
+// schedule
+static uint32_t Advance_schedule(uint32_t pt_idx) {
+  if (pt_idx >= Pt_mgr._idx_count) {
+    return DATA_SCHED_NONE;
+  }
+  uint32_t pos = Pt_mgr._find_pos[pt_idx];
+  while (pos < Pt_mgr._sched_pos) {
+    pos = Pt_mgr._sched[pos]._next_use;
+  }
+  if (pos == DATA_SCHED_NONE) {
+    pos = Pt_mgr._first_pos[pt_idx];
+    if (pos == DATA_SCHED_NONE) {
+      return DATA_SCHED_NONE;
+    }
+    // schedule restarts, previous prefetch and search positions are obsolete
+    memcpy(Pt_mgr._find_pos, Pt_mgr._first_pos,
+           sizeof(uint32_t) * Pt_mgr._idx_count);
+    Pt_mgr._pf_pos = 0;
+  }
+  Pt_mgr._find_pos[pt_idx] = pos;
+  // encode workers read it in Sched_dist without lock
+  __atomic_store_n(&Pt_mgr._sched_pos, pos + 1, __ATOMIC_RELAXED);
+  return pos;
 }
 
 void Pt_prefetch(uint32_t pt_idx) {
-  uint32_t slot                   = Get_slot(pt_idx);
-  Pt_mgr._pt_entry[slot]._blk_sts = BLK_INVALID;
-  IS_TRUE(Pt_mgr._pt_entry[slot]._blk_sts == BLK_INVALID,
-          "BLOCK_INFO state is not invalid");
-  Pt_mgr._pt_entry[slot]._blk_idx       = pt_idx;
-  Pt_mgr._pt_entry[slot]._iovec.iov_len = Pt_mgr._pt_size;
-  Rt_data_prefetch(Pt_mgr._file, pt_idx, &Pt_mgr._pt_entry[slot],
-                   Pt_mgr._sync_read);
+  if (Find_slot(pt_idx) != NO_SLOT) {
+    return;
+  }
+  uint32_t slot = Victim_slot(Pt_mgr._sched_pos);
+  if (slot != NO_SLOT) {
+    Load_slot(slot, pt_idx);
+    Pt_mgr._slot[slot]._next_use = Pt_mgr._sched_pos;
+  }
 }
 
 void* Pt_get(uint32_t pt_idx, size_t len, uint32_t scale, uint32_t level) {
   RTLIB_TM_START(RTM_PT_GET, rtm);
-  uint32_t slot = Get_slot(pt_idx);
-  if (Pt_mgr._prefetch_count == 0) {
-    Pt_mgr._pt_entry[slot]._blk_idx       = pt_idx;
-    Pt_mgr._pt_entry[slot]._blk_sts       = BLK_INVALID;
-    Pt_mgr._pt_entry[slot]._iovec.iov_len = Pt_mgr._pt_size;
-  }
-  IS_TRUE(Pt_mgr._pt_entry[slot]._blk_idx == (uint32_t)-1 ||
-              Pt_mgr._pt_entry[slot]._blk_idx == pt_idx,
-          "BLOCK_INFO pt_idx mismatch");
-  if (Pt_mgr._pt_entry[slot]._blk_sts == BLK_INVALID) {
-    Pt_mgr._pt_entry[slot]._blk_idx = pt_idx;
-    bool ret = Rt_data_prefetch(Pt_mgr._file, pt_idx, &Pt_mgr._pt_entry[slot],
-                                Pt_mgr._sync_read);
-    IS_TRUE(ret == true, "prefetch error");
+  uint32_t pos  = Advance_schedule(pt_idx);
+  uint32_t slot = Find_slot(pt_idx);
+  bool     hit  = (slot != NO_SLOT);
+  if (slot == NO_SLOT) {
+    // not prefetched, wait for reading it on demand
+    slot = Victim_slot(Pt_mgr._sched_pos);
+    if (slot == NO_SLOT) {
+      // only one entry in memory
+      slot = Pt_mgr._cur_slot;
+    }
+    Load_slot(slot, pt_idx);
   }
   if (Pt_mgr._pt_entry[slot]._blk_sts == BLK_PREFETCHING) {
     bool ret = Rt_data_read(Pt_mgr._file, pt_idx, &Pt_mgr._pt_entry[slot],
@@ -149,11 +388,23 @@ void* Pt_get(uint32_t pt_idx, size_t len, uint32_t scale, uint32_t level) {
   }
   IS_TRUE(Pt_mgr._pt_entry[slot]._blk_sts == BLK_READY,
           "block state is not ready");
-  if (Pt_mgr._prefetch_count > 0) {
-    Pt_prefetch(pt_idx + Pt_mgr._prefetch_count);
+  if (hit) {
+    ++Pt_mgr._num_hit;
+    Rt_stat_count(RTS_PT_HIT, 1);
+  } else {
+    ++Pt_mgr._num_stall;
+    Rt_stat_count(RTS_PT_STALL, 1);
   }
-  void* pt =
-      (void*)Cast_buffer_to_plain(Pt_mgr._pt_entry[slot]._iovec.iov_base);
+  Pt_mgr._slot[slot]._next_use =
+      (pos != DATA_SCHED_NONE) ? Pt_mgr._sched[pos]._next_use : DATA_SCHED_NONE;
+  // plaintext is cast in place, entry requested again is returned as it is
+  void* pt = Pt_mgr._slot[slot]._plain;
+  if (pt == NULL) {
+    pt = Cast_buffer_to_plain(Pt_mgr._pt_entry[slot]._iovec.iov_base);
+    Pt_mgr._slot[slot]._plain = pt;
+  }
+  Pt_mgr._cur_slot = slot;
+  Prefetch_schedule();
   RTLIB_TM_END(RTM_PT_GET, rtm);
   return pt;
 }
@@ -164,42 +415,257 @@ void* Pt_get_validate(float* buf, uint32_t index, size_t len, uint32_t scale,
 }
 
 void Pt_free(uint32_t pt_idx) {
-  uint32_t slot = Get_slot(pt_idx);
-  IS_TRUE(Pt_mgr._pt_entry[slot]._blk_sts == BLK_READY,
+  uint32_t slot = Find_slot(pt_idx);
+  IS_TRUE(slot != NO_SLOT && Pt_mgr._pt_entry[slot]._blk_sts == BLK_READY,
           "BLOCK_INFO state is not ready");
-  Pt_mgr._pt_entry[slot]._blk_idx  = (uint32_t)-1;
-  Pt_mgr._pt_entry[slot]._blk_sts  = BLK_INVALID;
-  Pt_mgr._pt_entry[slot]._mem_next = Pt_mgr._ent_invalid;
-  Pt_mgr._ent_invalid              = slot;
-  if (Pt_mgr._prefetch_count > 0) {
-    Pt_prefetch(pt_idx + Pt_mgr._prefetch_count);
+  Pt_mgr._pt_entry[slot]._blk_idx = (uint32_t)-1;
+  Pt_mgr._pt_entry[slot]._blk_sts = BLK_INVALID;
+  if (Pt_mgr._cur_slot == slot) {
+    Pt_mgr._cur_slot = NO_SLOT;
   }
+  Prefetch_schedule();
 }
 
 extern void Encode_plain_from_float(void* plain, float* input, size_t len,
                                     uint32_t sc_degree, uint32_t level);
 
-void Pt_from_msg(void* pt, uint32_t index, size_t len, uint32_t scale,
-                 uint32_t level) {
-  IS_TRUE(!Rt_data_is_plaintext(Pt_mgr._file), "bad entry type");
+// message of entry index in memory
+static inline float* Msg_data(uint32_t index, size_t len) {
   uint64_t ofst =
       Rt_data_entry_offset(Pt_mgr._file, index, len * sizeof(float));
   IS_TRUE(ofst + len * sizeof(float) <= Pt_mgr._pt_size,
           "entry offset too large");
-  float* data = (float*)&Pt_mgr._pt_buf[ofst];
-  Encode_plain_from_float(pt, data, len, scale, level);
+  return (float*)&Pt_mgr._pt_buf[ofst];
+}
+
+// distance from schedule position of next request to pos, wrapping around
+// the end of schedule. A stale position only changes which job an encode
+// worker picks first
+static inline uint32_t Sched_dist(uint32_t pos) {
+  uint32_t cur = __atomic_load_n(&Pt_mgr._sched_pos, __ATOMIC_RELAXED) %
+                 Pt_mgr._sched_count;
+  return (pos >= cur) ? pos - cur : pos + Pt_mgr._sched_count - cur;
+}
+
+// pending job requested nearest in schedule, NULL if there is none
+static PT_JOB* Pending_job(PT_ENCODER* enc) {
+  PT_JOB*  job  = NULL;
+  uint32_t near = DATA_SCHED_NONE;
+  for (uint32_t i = 0; i < enc->_job_count; ++i) {
+    if (enc->_job[i]._sts == JOB_PENDING &&
+        Sched_dist(enc->_job[i]._pos) < near) {
+      job  = &enc->_job[i];
+      near = Sched_dist(job->_pos);
+    }
+  }
+  return job;
+}
+
+static void* Encode_worker(void* arg) {
+  PT_ENCODER* enc = (PT_ENCODER*)arg;
+  pthread_mutex_lock(&enc->_lock);
+  while (true) {
+    PT_JOB* job;
+    while (!enc->_stop && (job = Pending_job(enc)) == NULL) {
+      pthread_cond_wait(&enc->_job_cv, &enc->_lock);
+    }
+    if (enc->_stop) {
+      break;
+    }
+    job->_sts    = JOB_RUNNING;
+    float*   msg = Msg_data(job->_index, job->_len);
+    uint64_t len = job->_len;
+    uint32_t sc  = job->_scale;
+    uint32_t lv  = job->_level;
+    pthread_mutex_unlock(&enc->_lock);
+    struct PLAINTEXT_BUFFER* buf = Encode_plain_buffer(msg, len, sc, lv);
+    pthread_mutex_lock(&enc->_lock);
+    job->_buf = buf;
+    job->_sts = JOB_DONE;
+    pthread_cond_broadcast(&enc->_done_cv);
+  }
+  pthread_mutex_unlock(&enc->_lock);
+  return NULL;
+}
+
+static void Start_encoder(uint32_t worker_count, uint32_t job_count) {
+  PT_ENCODER* enc = (PT_ENCODER*)malloc(sizeof(PT_ENCODER));
+  IS_TRUE(enc != NULL, "failed to malloc PT_ENCODER");
+  enc->_worker = (pthread_t*)malloc(sizeof(pthread_t) * worker_count);
+  enc->_job    = (PT_JOB*)malloc(sizeof(PT_JOB) * job_count);
+  enc->_scale  = (uint32_t*)malloc(sizeof(uint32_t) * Pt_mgr._idx_count);
+  enc->_level  = (uint32_t*)malloc(sizeof(uint32_t) * Pt_mgr._idx_count);
+  IS_TRUE(enc->_worker != NULL && enc->_job != NULL && enc->_scale != NULL &&
+              enc->_level != NULL,
+          "failed to malloc PT_ENCODER workers");
+  for (uint32_t i = 0; i < Pt_mgr._idx_count; ++i) {
+    enc->_level[i] = NO_LEVEL;
+  }
+  for (uint32_t i = 0; i < job_count; ++i) {
+    enc->_job[i]._buf = NULL;
+    enc->_job[i]._sts = JOB_FREE;
+  }
+  pthread_mutex_init(&enc->_lock, NULL);
+  pthread_cond_init(&enc->_job_cv, NULL);
+  pthread_cond_init(&enc->_done_cv, NULL);
+  enc->_job_count    = job_count;
+  enc->_last_scale   = 0;
+  enc->_last_level   = 0;
+  enc->_stop         = false;
+  enc->_worker_count = 0;
+  for (uint32_t i = 0; i < worker_count; ++i) {
+    if (pthread_create(&enc->_worker[i], NULL, Encode_worker, enc) != 0) {
+      break;
+    }
+    ++enc->_worker_count;
+  }
+  Pt_mgr._encoder = enc;
+}
+
+static void Stop_encoder() {
+  PT_ENCODER* enc = Pt_mgr._encoder;
+  pthread_mutex_lock(&enc->_lock);
+  enc->_stop = true;
+  pthread_cond_broadcast(&enc->_job_cv);
+  pthread_mutex_unlock(&enc->_lock);
+  for (uint32_t i = 0; i < enc->_worker_count; ++i) {
+    pthread_join(enc->_worker[i], NULL);
+  }
+  for (uint32_t i = 0; i < enc->_job_count; ++i) {
+    Free_plain_buffer(enc->_job[i]._buf);
+  }
+  pthread_mutex_destroy(&enc->_lock);
+  pthread_cond_destroy(&enc->_job_cv);
+  pthread_cond_destroy(&enc->_done_cv);
+  free(enc->_worker);
+  free(enc->_job);
+  free(enc->_scale);
+  free(enc->_level);
+  free(enc);
+  Pt_mgr._encoder = NULL;
+}
+
+// queue messages requested in next _job_count positions of schedule which
+// are not queued yet, and drop jobs out of this window. Message is encoded
+// with scale and level its index was last requested with, or those of last
+// request if the index isn't requested yet. Called with lock
+static void Queue_schedule(PT_ENCODER* enc) {
+  uint32_t ahead = enc->_job_count;
+  if (ahead > Pt_mgr._sched_count) {
+    ahead = Pt_mgr._sched_count;
+  }
+  for (uint32_t i = 0; i < enc->_job_count; ++i) {
+    PT_JOB* job = &enc->_job[i];
+    if ((job->_sts == JOB_PENDING || job->_sts == JOB_DONE) &&
+        Sched_dist(job->_pos) >= ahead) {
+      Free_plain_buffer(job->_buf);
+      job->_buf = NULL;
+      job->_sts = JOB_FREE;
+    }
+  }
+  uint32_t free_job = 0;
+  for (uint32_t k = 0; k < ahead; ++k) {
+    uint32_t pos   = (Pt_mgr._sched_pos + k) % Pt_mgr._sched_count;
+    uint32_t index = Pt_mgr._sched[pos]._index;
+    bool     found = false;
+    for (uint32_t i = 0; i < enc->_job_count && !found; ++i) {
+      found = (enc->_job[i]._sts != JOB_FREE && enc->_job[i]._index == index);
+    }
+    if (found) {
+      continue;
+    }
+    while (free_job < enc->_job_count &&
+           enc->_job[free_job]._sts != JOB_FREE) {
+      ++free_job;
+    }
+    if (free_job == enc->_job_count) {
+      break;
+    }
+    PT_JOB* job = &enc->_job[free_job];
+    job->_index = index;
+    job->_len   = Rt_data_entry_size(Pt_mgr._file, index) / sizeof(float);
+    if (enc->_level[index] != NO_LEVEL) {
+      job->_scale = enc->_scale[index];
+      job->_level = enc->_level[index];
+    } else {
+      job->_scale = enc->_last_scale;
+      job->_level = enc->_last_level;
+    }
+    job->_pos   = pos;
+    job->_sts   = JOB_PENDING;
+    pthread_cond_signal(&enc->_job_cv);
+  }
+}
+
+// take plaintext of message index encoded ahead with the same length, scale
+// and level, wait for it if it's being encoded. Return NULL if there is
+// none, and then the message is encoded on demand
+static struct PLAINTEXT_BUFFER* Take_encoded(uint32_t index, size_t len,
+                                             uint32_t scale, uint32_t level) {
+  PT_ENCODER* enc = Pt_mgr._encoder;
+  pthread_mutex_lock(&enc->_lock);
+  Advance_schedule(index);
+  struct PLAINTEXT_BUFFER* buf = NULL;
+  for (uint32_t i = 0; i < enc->_job_count; ++i) {
+    PT_JOB* job = &enc->_job[i];
+    if (job->_sts == JOB_FREE || job->_index != index || job->_len != len ||
+        job->_scale != scale || job->_level != level) {
+      continue;
+    }
+    while (job->_sts == JOB_RUNNING) {
+      pthread_cond_wait(&enc->_done_cv, &enc->_lock);
+    }
+    // pending job is not started yet, encode it on demand instead
+    buf       = job->_buf;
+    job->_buf = NULL;
+    job->_sts = JOB_FREE;
+    break;
+  }
+  if (index < Pt_mgr._idx_count) {
+    enc->_scale[index] = scale;
+    enc->_level[index] = level;
+  }
+  enc->_last_scale = scale;
+  enc->_last_level = level;
+  Queue_schedule(enc);
+  pthread_mutex_unlock(&enc->_lock);
+  return buf;
+}
+
+// encode message of entry index into pt. Plaintext encoded by worker is
+// copied, which is the same as encoding it on demand
+static void Encode_msg(void* pt, uint32_t index, float* data, size_t len,
+                       uint32_t scale, uint32_t level) {
+  struct PLAINTEXT_BUFFER* buf = NULL;
+  if (Pt_mgr._encoder) {
+    buf = Take_encoded(index, len, scale, level);
+  }
+  if (buf != NULL) {
+    Copy_plain_from_buffer(pt, buf);
+    Free_plain_buffer(buf);
+    ++Pt_mgr._num_hit;
+    Rt_stat_count(RTS_PT_HIT, 1);
+  } else {
+    Encode_plain_from_float(pt, data, len, scale, level);
+    ++Pt_mgr._num_stall;
+    Rt_stat_count(RTS_PT_STALL, 1);
+  }
+}
+
+void Pt_from_msg(void* pt, uint32_t index, size_t len, uint32_t scale,
+                 uint32_t level) {
+  IS_TRUE(!Rt_data_is_plaintext(Pt_mgr._file), "bad entry type");
+  Encode_msg(pt, index, Msg_data(index, len), len, scale, level);
 }
 
 void Pt_from_msg_validate(void* pt, float* buf, uint32_t index, size_t len,
                           uint32_t scale, uint32_t level) {
   IS_TRUE(!Rt_data_is_plaintext(Pt_mgr._file), "bad entry type");
-  uint64_t ofst =
-      Rt_data_entry_offset(Pt_mgr._file, index, len * sizeof(float));
-  float* data = (float*)&Pt_mgr._pt_buf[ofst];
+  float* data = Msg_data(index, len);
   for (uint32_t i = 0; i < len; ++i) {
     FMT_ASSERT(fabs(buf[i] - data[i]) < 0.000001,
                "Pt_from_msg_validate failed. index=%d, i=%d: %f != %f.", index,
                i, buf[i], data[i]);
   }
-  Encode_plain_from_float(pt, data, len, scale, level);
+  Encode_msg(pt, index, data, len, scale, level);
 }
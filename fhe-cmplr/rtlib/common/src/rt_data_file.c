@@ -18,26 +18,35 @@
 #include "fhe/core/rt_data_def.h"
 
 struct RT_DATA_FILE {
-  struct DATA_FILE_HDR   _hdr;
-  struct DATA_LUT_ENTRY* _lut;
-  int                    _fd;
+  struct DATA_FILE_HDR     _hdr;
+  struct DATA_LUT_ENTRY*   _lut;
+  struct DATA_SCHED_ENTRY* _sched;
+  int                      _fd;
+  int                      _ent_fd;     // fd to read plaintext entries
+  bool                     _direct_io;  // _ent_fd is opened with O_DIRECT
 };
 
-struct RT_DATA_FILE* Rt_data_open(const char* fname, bool sync_read) {
+struct RT_DATA_FILE* Rt_data_open(const char* fname, bool sync_read,
+                                  bool direct_io) {
   struct RT_DATA_FILE* file =
       (struct RT_DATA_FILE*)malloc(sizeof(struct RT_DATA_FILE));
   IS_TRUE(file != NULL, "failed to malloc memory for RT_DATA_FILE");
-  file->_fd = Block_io_open(fname, sync_read);
+  file->_fd = Block_io_open(fname, sync_read, false);
   if (file->_fd == -1) {
     IS_TRUE(file->_fd != -1, "failed to open rt data file");
     free(file);
     return NULL;
   }
+  // released by Rt_data_close if file is not read completely
+  file->_lut       = NULL;
+  file->_sched     = NULL;
+  file->_ent_fd    = file->_fd;
+  file->_direct_io = false;
   ssize_t ret = pread(file->_fd, &file->_hdr, sizeof(struct DATA_FILE_HDR), 0);
   if (ret != sizeof(struct DATA_FILE_HDR)) {
     IS_TRUE(ret == sizeof(struct DATA_FILE_HDR),
             "failed to read rt data file header");
-    free(file);
+    Rt_data_close(file);
     return NULL;
   }
   uint64_t lut_size = sizeof(struct DATA_LUT_ENTRY) * file->_hdr._ent_count;
@@ -46,36 +55,81 @@ struct RT_DATA_FILE* Rt_data_open(const char* fname, bool sync_read) {
   ret = pread(file->_fd, file->_lut, lut_size, file->_hdr._lut_ofst);
   if (ret != lut_size) {
     IS_TRUE(ret == lut_size, "failed to read rt data file lookup table");
-    free(file);
+    Rt_data_close(file);
     return NULL;
   }
+  if (file->_hdr._sched_count == 0 && file->_hdr._ent_count > 0) {
+    // file without schedule is taken as requesting entries in index order
+    file->_sched = (struct DATA_SCHED_ENTRY*)malloc(
+        sizeof(struct DATA_SCHED_ENTRY) * file->_hdr._ent_count);
+    IS_TRUE(file->_sched != NULL, "failed to malloc memory for schedule");
+    for (uint64_t i = 0; i < file->_hdr._ent_count; ++i) {
+      file->_sched[i]._index    = i;
+      file->_sched[i]._next_use = DATA_SCHED_NONE;
+    }
+    file->_hdr._sched_count = file->_hdr._ent_count;
+  } else if (file->_hdr._sched_count > 0) {
+    uint64_t sched_size =
+        sizeof(struct DATA_SCHED_ENTRY) * file->_hdr._sched_count;
+    file->_sched = (struct DATA_SCHED_ENTRY*)malloc(sched_size);
+    IS_TRUE(file->_sched != NULL, "failed to malloc memory for schedule");
+    ret = pread(file->_fd, file->_sched, sched_size, file->_hdr._sched_ofst);
+    if (ret != sched_size) {
+      IS_TRUE(ret == sched_size, "failed to read rt data file schedule");
+      Rt_data_close(file);
+      return NULL;
+    }
+  }
+  // header, LUT and messages are read with _fd, only plaintext entries,
+  // which are aligned to page, are read bypassing page cache
+  if (direct_io && file->_hdr._ent_type == DE_PLAINTEXT) {
+    int fd = Block_io_open(fname, sync_read, true);
+    if (fd != -1) {
+      file->_ent_fd    = fd;
+      file->_direct_io = true;
+    }
+  }
   return file;
 }
 
 void Rt_data_close(struct RT_DATA_FILE* file) {
+  if (file->_ent_fd != file->_fd) {
+    Block_io_close(file->_ent_fd);
+  }
   Block_io_close(file->_fd);
   free(file->_lut);
+  free(file->_sched);
   free(file);
 }
 
+// size to read for entry, which is rounded up to page for direct I/O
+static inline uint64_t Read_size(struct RT_DATA_FILE*   file,
+                                 struct DATA_LUT_ENTRY* lut) {
+  if (!file->_direct_io) {
+    return lut->_size;
+  }
+  return (lut->_size + DATA_FILE_PAGE_SIZE - 1) & ~(DATA_FILE_PAGE_SIZE - 1);
+}
+
 bool Rt_data_prefetch(struct RT_DATA_FILE* file, uint32_t index,
                       BLOCK_INFO* blk, bool sync_read) {
   IS_TRUE(file->_hdr._ent_type == DE_PLAINTEXT, "bad entry type");
   if (index >= file->_hdr._ent_count) return true;
   IS_TRUE(index < file->_hdr._ent_count, "index out of entry range");
-  struct DATA_LUT_ENTRY* lut = &(file->_lut[index]);
-  IS_TRUE(blk->_iovec.iov_len >= lut->_size, "buffer too small");
+  struct DATA_LUT_ENTRY* lut  = &(file->_lut[index]);
+  uint64_t               size = Read_size(file, lut);
+  IS_TRUE(blk->_iovec.iov_len >= size, "buffer too small");
   IS_TRUE(blk->_blk_idx == index, "block index mismatch");
   if (sync_read) {
     blk->_blk_sts = BLK_PREFETCHING;
     ssize_t ret =
-        pread(file->_fd, blk->_iovec.iov_base, lut->_size, lut->_ent_ofst);
-    IS_TRUE(ret == lut->_size, "failed to read rt data entry");
+        pread(file->_ent_fd, blk->_iovec.iov_base, size, lut->_ent_ofst);
+    IS_TRUE(ret >= lut->_size, "failed to read rt data entry");
     blk->_blk_sts = BLK_READY;
-    return (ret == lut->_size);
+    return (ret >= lut->_size);
   } else {
-    blk->_iovec.iov_len = lut->_size;
-    return Block_io_prefetch(file->_fd, lut->_ent_ofst, blk);
+    blk->_iovec.iov_len = size;
+    return Block_io_prefetch(file->_ent_fd, lut->_ent_ofst, blk);
   }
 }
 
@@ -90,11 +144,12 @@ void* Rt_data_read(struct RT_DATA_FILE* file, uint32_t index, BLOCK_INFO* blk,
     return NULL;
   } else {
     IS_TRUE(index < file->_hdr._ent_count, "index out of entry range");
-    struct DATA_LUT_ENTRY* lut = &(file->_lut[index]);
-    IS_TRUE(blk->_iovec.iov_len >= lut->_size, "buffer too small");
+    struct DATA_LUT_ENTRY* lut  = &(file->_lut[index]);
+    uint64_t               size = Read_size(file, lut);
+    IS_TRUE(blk->_iovec.iov_len >= size, "buffer too small");
     IS_TRUE(blk->_blk_idx == index, "block index mismatch");
-    blk->_iovec.iov_len = lut->_size;
-    bool ret            = Block_io_read(file->_fd, lut->_ent_ofst, blk);
+    blk->_iovec.iov_len = size;
+    bool ret            = Block_io_read(file->_ent_fd, lut->_ent_ofst, blk);
     IS_TRUE(ret == true, "failed to read block");
     return blk->_iovec.iov_base;
   }
@@ -115,6 +170,17 @@ uint64_t Rt_data_size(struct RT_DATA_FILE* file) {
   return file->_hdr._lut_ofst - DATA_FILE_PAGE_SIZE;
 }
 
+const struct DATA_SCHED_ENTRY* Rt_data_schedule(struct RT_DATA_FILE* file,
+                                                uint32_t*            count) {
+  *count = file->_hdr._sched_count;
+  return file->_sched;
+}
+
+uint64_t Rt_data_entry_size(struct RT_DATA_FILE* file, uint32_t index) {
+  IS_TRUE(index < file->_hdr._ent_count, "index out of entry range");
+  return file->_lut[index]._size;
+}
+
 uint64_t Rt_data_entry_offset(struct RT_DATA_FILE* file, uint32_t index,
                               uint64_t size) {
   IS_TRUE(file->_hdr._ent_type != DE_PLAINTEXT, "bad entry type");
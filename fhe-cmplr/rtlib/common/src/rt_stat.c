@@ -8,21 +8,212 @@
 
 #include "common/rt_stat.h"
 
+#include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#include "common/error.h"
+#include "common/rt_env.h"
+
+//! max nested level of spans on one thread
+#define RT_STAT_MAX_DEPTH 64
+
+//! initial number of span events in thread buffer
+#define RT_STAT_INIT_EVENT 1024
+
+//! an open span
 typedef struct {
-  clock_t _time_stamp;
-} TM_STAT;
+  const char* _msg;
+  uint32_t    _file;
+  uint32_t    _line;
+  uint64_t    _start;          // wall clock in nsec
+  uint64_t    _cnt[RTS_LAST];  // counters when span starts
+} TM_SPAN;
+
+//! a closed span
+typedef struct {
+  const char* _msg;
+  uint32_t    _file;
+  uint32_t    _line;
+  uint32_t    _depth;
+  uint64_t    _start;          // wall clock in nsec
+  uint64_t    _dur;            // duration in nsec
+  uint64_t    _cnt[RTS_LAST];  // counters increased in span
+} TM_EVENT;
+
+//! per-thread span stack, closed spans and counters
+typedef struct TM_BUF {
+  struct TM_BUF* _next;
+  uint32_t       _tid;
+  uint32_t       _depth;
+  TM_SPAN        _span[RT_STAT_MAX_DEPTH];
+  TM_EVENT*      _event;
+  size_t         _num_event;
+  size_t         _max_event;
+  uint64_t       _cnt[RTS_LAST];  // only written by owning thread
+} TM_BUF;
+
+static TM_BUF* Tm_buf;
+#pragma omp threadprivate(Tm_buf)
+
+static TM_BUF*  Tm_buf_list;
+static uint32_t Tm_buf_count;
+
+static inline uint64_t Wall_clock_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static TM_BUF* Thread_buf() {
+  if (Tm_buf != NULL) {
+    return Tm_buf;
+  }
+  TM_BUF* buf = (TM_BUF*)calloc(1, sizeof(TM_BUF));
+  IS_TRUE(buf != NULL, "out of memory");
+  buf->_max_event = RT_STAT_INIT_EVENT;
+  buf->_event     = (TM_EVENT*)malloc(buf->_max_event * sizeof(TM_EVENT));
+  IS_TRUE(buf->_event != NULL, "out of memory");
+#pragma omp critical(rt_stat)
+  {
+    buf->_tid   = Tm_buf_count++;
+    buf->_next  = Tm_buf_list;
+    Tm_buf_list = buf;
+  }
+  Tm_buf = buf;
+  return buf;
+}
+
+void Rt_stat_count(RT_STAT_COUNTER id, uint64_t val) {
+  // no locked add on the hot path: only the owning thread writes _cnt, the
+  // relaxed store is a plain store that Sum_counter may read concurrently
+  TM_BUF* buf = Thread_buf();
+  __atomic_store_n(&buf->_cnt[id],
+                   __atomic_load_n(&buf->_cnt[id], __ATOMIC_RELAXED) + val,
+                   __ATOMIC_RELAXED);
+}
+
+//! sum counters of all threads, called when a span opens or closes
+static void Sum_counter(uint64_t* cnt) {
+  memset(cnt, 0, RTS_LAST * sizeof(uint64_t));
+#pragma omp critical(rt_stat)
+  {
+    for (TM_BUF* buf = Tm_buf_list; buf != NULL; buf = buf->_next) {
+      for (uint32_t i = 0; i < RTS_LAST; ++i) {
+        cnt[i] += __atomic_load_n(&buf->_cnt[i], __ATOMIC_RELAXED);
+      }
+    }
+  }
+}
 
-static TM_STAT Tm_stat;
-#pragma omp threadprivate(Tm_stat)
+void Tm_start(const char* msg) { Tm_start_at(msg, 0, 0); }
 
-void Tm_start(const char* msg) { Tm_stat._time_stamp = clock(); }
+void Tm_start_at(const char* msg, uint32_t file, uint32_t line) {
+  TM_BUF* buf = Thread_buf();
+  IS_TRUE(buf->_depth < RT_STAT_MAX_DEPTH, "too many nested Tm_start");
+  TM_SPAN* span = &buf->_span[buf->_depth++];
+  span->_msg    = msg;
+  span->_file   = file;
+  span->_line   = line;
+  Sum_counter(span->_cnt);
+  span->_start = Wall_clock_ns();
+}
 
 void Tm_taken(const char* msg) {
-  clock_t cur_stamp = clock();
-  fprintf(stdout, "[RT_STAT] %s takes %.3f seconds.\n", msg,
-          ((double)(cur_stamp - Tm_stat._time_stamp)) / (double)CLOCKS_PER_SEC);
-  Tm_stat._time_stamp = cur_stamp;
+  uint64_t cur_stamp = Wall_clock_ns();
+  TM_BUF*  buf       = Thread_buf();
+  IS_TRUE(buf->_depth > 0, "Tm_taken without Tm_start");
+  if (buf->_depth == 0) {
+    return;
+  }
+  TM_SPAN* span = &buf->_span[--buf->_depth];
+  IS_TRUE(strcmp(span->_msg, msg) == 0, "Tm_taken mismatch with Tm_start");
+
+  if (buf->_num_event == buf->_max_event) {
+    buf->_max_event *= 2;
+    buf->_event =
+        (TM_EVENT*)realloc(buf->_event, buf->_max_event * sizeof(TM_EVENT));
+    IS_TRUE(buf->_event != NULL, "out of memory");
+  }
+  TM_EVENT* event = &buf->_event[buf->_num_event++];
+  event->_msg     = span->_msg;
+  event->_file    = span->_file;
+  event->_line    = span->_line;
+  event->_depth   = buf->_depth;
+  event->_start   = span->_start;
+  event->_dur     = cur_stamp - span->_start;
+  Sum_counter(event->_cnt);
+  for (uint32_t i = 0; i < RTS_LAST; ++i) {
+    event->_cnt[i] -= span->_cnt[i];
+  }
+
+  fprintf(stdout, "[RT_STAT] %*s%s takes %.3f seconds.\n", 2 * buf->_depth,
+          "", msg, (double)event->_dur / 1000000000.0);
+}
+
+static void Print_json_str(FILE* fp, const char* str) {
+  fputc('"', fp);
+  for (; *str != '\0'; ++str) {
+    if (*str == '"' || *str == '\\') {
+      fputc('\\', fp);
+    }
+    fputc(*str, fp);
+  }
+  fputc('"', fp);
+}
+
+static void Print_trace_event(FILE* fp, const TM_BUF* buf, uint64_t base) {
+  static const char* cnt_name[RTS_LAST] = {
+      "ntt", "key_switch", "alloc_bytes", "pt_hit", "pt_stall"};
+  for (size_t i = 0; i < buf->_num_event; ++i) {
+    const TM_EVENT* event = &buf->_event[i];
+    fprintf(fp, "    {\"name\": ");
+    Print_json_str(fp, event->_msg);
+    fprintf(fp,
+            ", \"cat\": \"layer\", \"ph\": \"X\", \"pid\": 0, \"tid\": %u, "
+            "\"ts\": %.3f, \"dur\": %.3f, \"args\": {\"spos\": \"%u:%u\", "
+            "\"depth\": %u",
+            buf->_tid, (double)(event->_start - base) / 1000.0,
+            (double)event->_dur / 1000.0, event->_file, event->_line,
+            event->_depth);
+    for (uint32_t j = 0; j < RTS_LAST; ++j) {
+      fprintf(fp, ", \"%s\": %lu", cnt_name[j], event->_cnt[j]);
+    }
+    fprintf(fp, "}},\n");
+  }
+}
+
+void Report_rt_stat() {
+  const char* fname = getenv(ENV_RT_STAT_TRACE_OUTPUT);
+  if (fname != NULL && Tm_buf_list != NULL) {
+    FILE* fp = fopen(fname, "w");
+    if (fp != NULL) {
+      // timestamps are relative to the earliest span
+      uint64_t base = UINT64_MAX;
+      for (TM_BUF* buf = Tm_buf_list; buf != NULL; buf = buf->_next) {
+        for (size_t i = 0; i < buf->_num_event; ++i) {
+          if (buf->_event[i]._start < base) base = buf->_event[i]._start;
+        }
+      }
+      fprintf(fp, "{\n  \"displayTimeUnit\": \"ms\",\n  \"traceEvents\": [\n");
+      for (TM_BUF* buf = Tm_buf_list; buf != NULL; buf = buf->_next) {
+        Print_trace_event(fp, buf, base);
+      }
+      // metadata event ends the list so that no trailing comma is left
+      fprintf(fp,
+              "    {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, "
+              "\"args\": {\"name\": \"fhe rtlib\"}}\n  ]\n}\n");
+      fclose(fp);
+    }
+  }
+
+  // drop spans for next context. buffers are kept because they are still
+  // referred by threadprivate Tm_buf of their threads
+  for (TM_BUF* buf = Tm_buf_list; buf != NULL; buf = buf->_next) {
+    buf->_depth     = 0;
+    buf->_num_event = 0;
+    memset(buf->_cnt, 0, sizeof(buf->_cnt));
+  }
 }
@@ -21,8 +21,9 @@ static uint64_t Rtlib_timing[RTM_LAST];
 static uint64_t Rtlib_count[RTM_LAST];
 
 void Append_rtlib_timing(RTLIB_TIMING_ID id, uint64_t nsec) {
-  Rtlib_timing[id] += nsec;
-  Rtlib_count[id]++;
+  // plaintext is also encoded on PT_MGR worker threads
+  __atomic_fetch_add(&Rtlib_timing[id], nsec, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&Rtlib_count[id], 1, __ATOMIC_RELAXED);
 }
 
 void Report_rtlib_timing() {
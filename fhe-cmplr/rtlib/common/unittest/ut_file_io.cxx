@@ -37,7 +37,7 @@ TEST(FHERT_COMMON, FILE_IO) {
     EXPECT_EQ(posix_memalign((void**)&blk._iovec.iov_base, 4096, 4096), 0);
     blk._iovec.iov_len = 32;
     blk._blk_sts       = BLK_INVALID;
-    int fd             = Block_io_open(data_name, sync_read);
+    int fd             = Block_io_open(data_name, sync_read, false);
     EXPECT_GE(fd, 0);
     char buf_ref[32];
     for (int i = 0; i < NUM_OF_ENTRY; ++i) {
@@ -59,4 +59,51 @@ TEST(FHERT_COMMON, FILE_IO) {
   unlink(data_name);
 }
 
+TEST(FHERT_COMMON, FILE_IO_ASYNC) {
+  const char* data_name = "/tmp/fhefio_async_test.bin";
+  {
+    int fd = open(data_name, O_CREAT | O_WRONLY, 0666);
+    EXPECT_GE(fd, 0);
+    char buf[4096];
+    for (int i = 0; i < NUM_OF_ENTRY; ++i) {
+      memset(buf, 'a' + i, 4096);
+      ssize_t sz = write(fd, buf, 4096);
+      EXPECT_EQ(sz, 4096);
+    }
+    close(fd);
+  }
+  {
+    bool sync_read = false;
+    bool ret       = Block_io_init(sync_read);
+    EXPECT_TRUE(ret);
+    char* mem;
+    EXPECT_EQ(posix_memalign((void**)&mem, 4096, 4096 * NUM_OF_ENTRY), 0);
+    // blocks in registered buffer are read with O_DIRECT
+    Block_io_register_buffer(mem, 4096 * NUM_OF_ENTRY);
+    int fd = Block_io_open(data_name, sync_read, true);
+    EXPECT_GE(fd, 0);
+    BLOCK_INFO blk[NUM_OF_ENTRY];
+    for (int i = 0; i < NUM_OF_ENTRY; ++i) {
+      blk[i]._iovec.iov_base = mem + i * 4096;
+      blk[i]._iovec.iov_len  = 4096;
+      blk[i]._blk_sts        = BLK_INVALID;
+      ret                    = Block_io_prefetch(fd, i * 4096, &blk[i]);
+      EXPECT_TRUE(ret);
+    }
+    // reads are waited for in reverse order of submission
+    char buf_ref[4096];
+    for (int i = NUM_OF_ENTRY - 1; i >= 0; --i) {
+      ret = Block_io_read(fd, i * 4096, &blk[i]);
+      EXPECT_TRUE(ret);
+      EXPECT_EQ(blk[i]._blk_sts, BLK_READY);
+      memset(buf_ref, 'a' + i, 4096);
+      EXPECT_EQ(memcmp(blk[i]._iovec.iov_base, buf_ref, 4096), 0);
+    }
+    free(mem);
+    Block_io_close(fd);
+    Block_io_fini(sync_read);
+  }
+  unlink(data_name);
+}
+
 }  // namespace
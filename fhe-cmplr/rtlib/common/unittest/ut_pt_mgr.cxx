@@ -6,8 +6,11 @@
 //
 //=============================================================================
 
+#include <algorithm>
+
 #include "common/pt_mgr.h"
 #include "common/rt_data_file.h"
+#include "common/rt_env.h"
 #include "fhe/core/rt_data_writer.h"
 #include "fhe/core/rt_encode_api.h"
 #include "gtest/gtest.h"
@@ -40,7 +43,7 @@ TEST(FHERT_COMMON, RT_DATA_FILE) {
     BLOCK_INFO blk;
     blk._iovec.iov_base    = (char*)malloc(16);
     blk._iovec.iov_len     = 16;
-    struct RT_DATA_FILE* f = Rt_data_open(data_name, sync_read);
+    struct RT_DATA_FILE* f = Rt_data_open(data_name, sync_read, false);
     EXPECT_TRUE(f != NULL);
     for (uint32_t i = 0; i < NUM_OF_ENTRY; ++i) {
       blk._blk_idx = i;
@@ -104,4 +107,192 @@ TEST(FHERT_COMMON, PT_MGR) {
   unlink(data_name);
 }
 
+TEST(FHERT_COMMON, PT_MGR_SCHEDULE) {
+  const char* data_name  = "/tmp/fhept_sched_test.bin";
+  const char* data_uuid  = "XXXXXXXX-XXXX-XXXX-XXXX-XXXXXXXXXXXX";
+  const char* model_name = "dummy.onnx";
+  Prepare_encode_context(4096, 0, 8, 53, 50);
+  // conv-like access: 8 weights revisited for each output channel, followed
+  // by bias of the channel. 9 live entries don't fit in 8 slots
+  std::vector<uint32_t> seq;
+  for (uint32_t oc = 0; oc < 4; ++oc) {
+    for (uint32_t w = 0; w < 8; ++w) {
+      seq.push_back(w);
+    }
+    seq.push_back(8 + oc);
+  }
+  PLAINTEXT_BUFFER* pt_buf[12];
+  {
+    fhe::core::RT_DATA_WRITER writter(data_name, fhe::core::DE_PLAINTEXT,
+                                      model_name, data_uuid);
+    char                      ent_name[32];
+    float                     msg_buf[128];
+    for (uint32_t i = 0; i < 12; ++i) {
+      for (uint32_t j = 0; j < 128; j++) {
+        msg_buf[j] = (float)i;
+      }
+      snprintf(ent_name, 32, "ent_%d", i);
+      pt_buf[i] = Encode_plain_buffer(msg_buf, 128, 1, 0);
+      writter.Append_pt(ent_name, (const char*)pt_buf[i],
+                        Plain_buffer_length(pt_buf[i]));
+    }
+    writter.Set_schedule(seq);
+  }
+  {
+    setenv(ENV_PT_ENTRY_COUNT, "8", 1);
+    setenv(ENV_PT_PREFETCH_COUNT, "2", 1);
+    bool ret = Pt_mgr_init(data_name);
+    EXPECT_TRUE(ret);
+    for (uint32_t i = 0; i < seq.size(); ++i) {
+      void*                    pt = Pt_get(seq[i], 128, 1, 0);
+      struct PLAINTEXT_BUFFER* pb =
+          (struct PLAINTEXT_BUFFER*)((char*)pt -
+                                     sizeof(struct PLAINTEXT_BUFFER));
+      EXPECT_TRUE(Compare_plain_buffer(pb, pt_buf[seq[i]]));
+    }
+    uint64_t hit, stall;
+    Pt_mgr_stat(&hit, &stall);
+    EXPECT_EQ(hit + stall, seq.size());
+    // entries are all prefetched before they are requested
+    EXPECT_EQ(stall, 0);
+    Pt_mgr_fini();
+    unsetenv(ENV_PT_ENTRY_COUNT);
+    unsetenv(ENV_PT_PREFETCH_COUNT);
+  }
+  for (uint32_t i = 0; i < 12; ++i) {
+    Free_plain_buffer(pt_buf[i]);
+  }
+  Finalize_encode_context();
+  unlink(data_name);
+}
+
+TEST(FHERT_COMMON, PT_MGR_OFF_SCHEDULE) {
+  const char* data_name  = "/tmp/fhept_off_sched_test.bin";
+  const char* data_uuid  = "XXXXXXXX-XXXX-XXXX-XXXX-XXXXXXXXXXXX";
+  const char* model_name = "dummy.onnx";
+  Prepare_encode_context(4096, 0, 8, 53, 50);
+  std::vector<uint32_t> seq;
+  for (uint32_t oc = 0; oc < 4; ++oc) {
+    for (uint32_t w = 0; w < 8; ++w) {
+      seq.push_back(w);
+    }
+    seq.push_back(8 + oc);
+  }
+  // schedule is truncated in the second output channel, entries 10 and 11
+  // are not in it
+  std::vector<uint32_t> sched(seq.begin(), seq.begin() + 12);
+  PLAINTEXT_BUFFER*     pt_buf[12];
+  {
+    fhe::core::RT_DATA_WRITER writter(data_name, fhe::core::DE_PLAINTEXT,
+                                      model_name, data_uuid);
+    char                      ent_name[32];
+    float                     msg_buf[128];
+    for (uint32_t i = 0; i < 12; ++i) {
+      for (uint32_t j = 0; j < 128; j++) {
+        msg_buf[j] = (float)i;
+      }
+      snprintf(ent_name, 32, "ent_%d", i);
+      pt_buf[i] = Encode_plain_buffer(msg_buf, 128, 1, 0);
+      writter.Append_pt(ent_name, (const char*)pt_buf[i],
+                        Plain_buffer_length(pt_buf[i]));
+    }
+    writter.Set_schedule(sched);
+  }
+  {
+    setenv(ENV_PT_ENTRY_COUNT, "4", 1);
+    setenv(ENV_PT_PREFETCH_COUNT, "2", 1);
+    bool ret = Pt_mgr_init(data_name);
+    EXPECT_TRUE(ret);
+    // graph is run twice, schedule restarts at the second run
+    for (uint32_t run = 0; run < 2; ++run) {
+      for (uint32_t i = 0; i < seq.size(); ++i) {
+        void*                    pt = Pt_get(seq[i], 128, 1, 0);
+        struct PLAINTEXT_BUFFER* pb =
+            (struct PLAINTEXT_BUFFER*)((char*)pt -
+                                       sizeof(struct PLAINTEXT_BUFFER));
+        EXPECT_TRUE(Compare_plain_buffer(pb, pt_buf[seq[i]]));
+      }
+    }
+    uint64_t hit, stall;
+    Pt_mgr_stat(&hit, &stall);
+    EXPECT_EQ(hit + stall, 2 * seq.size());
+    Pt_mgr_fini();
+    unsetenv(ENV_PT_ENTRY_COUNT);
+    unsetenv(ENV_PT_PREFETCH_COUNT);
+  }
+  for (uint32_t i = 0; i < 12; ++i) {
+    Free_plain_buffer(pt_buf[i]);
+  }
+  Finalize_encode_context();
+  unlink(data_name);
+}
+
+TEST(FHERT_COMMON, PT_MGR_ENCODE_AHEAD) {
+  const char* data_name  = "/tmp/fhept_msg_test.bin";
+  const char* data_uuid  = "XXXXXXXX-XXXX-XXXX-XXXX-XXXXXXXXXXXX";
+  const char* model_name = "dummy.onnx";
+  Prepare_encode_context(4096, 0, 8, 53, 50);
+  std::vector<uint32_t> seq;
+  for (uint32_t oc = 0; oc < 4; ++oc) {
+    for (uint32_t w = 0; w < 8; ++w) {
+      seq.push_back(w);
+    }
+    seq.push_back(8 + oc);
+  }
+  // bias is requested with another scale and level than weights. Plaintext
+  // encoded on demand is taken as reference
+  auto              scale = [](uint32_t i) { return i < 8 ? 1 : 2; };
+  auto              level = [](uint32_t i) { return i < 8 ? 0 : 3; };
+  PLAINTEXT_BUFFER* pt_buf[12];
+  {
+    fhe::core::RT_DATA_WRITER writter(data_name, fhe::core::DE_MSG_F32,
+                                      model_name, data_uuid);
+    char                      ent_name[32];
+    float                     msg_buf[128];
+    for (uint32_t i = 0; i < 12; ++i) {
+      for (uint32_t j = 0; j < 128; j++) {
+        msg_buf[j] = (float)i + j / 128.0;
+      }
+      snprintf(ent_name, 32, "ent_%d", i);
+      pt_buf[i] = Encode_plain_buffer(msg_buf, 128, scale(i), level(i));
+      writter.Append(ent_name, msg_buf, 128);
+    }
+    writter.Set_schedule(seq);
+  }
+  {
+    setenv(ENV_PT_ENCODE_THREAD, "2", 1);
+    setenv(ENV_PT_ENCODE_AHEAD, "3", 1);
+    bool ret = Pt_mgr_init(data_name);
+    EXPECT_TRUE(ret);
+    // plaintext in buffer of another entry with the same size is overwritten
+    // in place. Graph is run twice, bias is encoded ahead at its own scale
+    // and level once it's requested
+    uint64_t len = std::max(Plain_buffer_length(pt_buf[0]),
+                            Plain_buffer_length(pt_buf[8]));
+    PLAINTEXT_BUFFER* pb = (PLAINTEXT_BUFFER*)malloc(len);
+    for (uint32_t run = 0; run < 2; ++run) {
+      for (uint32_t i = 0; i < seq.size(); ++i) {
+        uint32_t idx = seq[i];
+        memcpy(pb, pt_buf[idx < 8 ? (idx + 1) % 8 : 8 + (idx + 1) % 4],
+               Plain_buffer_length(pt_buf[idx]));
+        Pt_from_msg(Cast_buffer_to_plain(pb), idx, 128, scale(idx),
+                    level(idx));
+        EXPECT_TRUE(Compare_plain_buffer(pb, pt_buf[idx]));
+      }
+    }
+    free(pb);
+    uint64_t hit, stall;
+    Pt_mgr_stat(&hit, &stall);
+    EXPECT_EQ(hit + stall, 2 * seq.size());
+    Pt_mgr_fini();
+    unsetenv(ENV_PT_ENCODE_THREAD);
+    unsetenv(ENV_PT_ENCODE_AHEAD);
+  }
+  for (uint32_t i = 0; i < 12; ++i) {
+    Free_plain_buffer(pt_buf[i]);
+  }
+  Finalize_encode_context();
+  unlink(data_name);
+}
+
 }  // namespace
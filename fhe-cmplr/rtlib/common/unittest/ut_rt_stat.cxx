@@ -0,0 +1,51 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "common/rt_env.h"
+#include "common/rt_stat.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+// counters bumped on helper threads are attributed to the span open on the
+// calling thread, and only the increments inside the span are reported
+TEST(FHERT_COMMON, RT_STAT_COUNTER) {
+  const char* trace = "/tmp/fhert_stat_test.json";
+  setenv(ENV_RT_STAT_TRACE_OUTPUT, trace, 1);
+
+  Rt_stat_count(RTS_NTT, 100);
+  Tm_start("outer");
+  std::vector<std::thread> workers;
+  for (int i = 0; i < 4; ++i) {
+    workers.emplace_back([]() {
+      Rt_stat_count(RTS_NTT, 2);
+      Rt_stat_count(RTS_KEY_SWITCH, 1);
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  Rt_stat_count(RTS_KEY_SWITCH, 1);
+  Tm_taken("outer");
+  Report_rt_stat();
+  unsetenv(ENV_RT_STAT_TRACE_OUTPUT);
+
+  std::ifstream     ifs(trace);
+  std::stringstream json;
+  json << ifs.rdbuf();
+  EXPECT_NE(json.str().find("\"ntt\": 8,"), std::string::npos) << json.str();
+  EXPECT_NE(json.str().find("\"key_switch\": 5,"), std::string::npos);
+  remove(trace);
+}
+
+}  // namespace
@@ -41,8 +41,13 @@ bool Block_io_init(bool async);
 //! @brief finalize block I/O context
 void Block_io_fini(bool sync_read);
 
-//! @brief open a file for I/O
-int Block_io_open(const char* fname, bool sync_read);
+//! @brief register buffer to read blocks into with fewer page mappings,
+//! return false if it's not supported and blocks are read as usual
+bool Block_io_register_buffer(void* base, size_t size);
+
+//! @brief open a file for I/O. With direct_io, page cache is bypassed and
+//! file offset, buffer address and size must be aligned to 4KB
+int Block_io_open(const char* fname, bool sync_read, bool direct_io);
 
 //! @brief close a file
 void Block_io_close(int fd);
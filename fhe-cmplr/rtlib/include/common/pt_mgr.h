@@ -24,6 +24,10 @@ bool Pt_mgr_init(const char* fname);
 //! @brief finalize plaintext manager
 void Pt_mgr_fini();
 
+//! @brief get number of Pt_get with plaintext prefetched (hit) and with
+//! plaintext read on demand (stall) since Pt_mgr_init
+void Pt_mgr_stat(uint64_t* hit, uint64_t* stall);
+
 //! @brief prefetch plaintext from disk to memory
 void Pt_prefetch(uint32_t index);
 
@@ -21,8 +21,12 @@ extern "C" {
 #endif
 
 struct RT_DATA_FILE;
+struct DATA_SCHED_ENTRY;
 
-struct RT_DATA_FILE* Rt_data_open(const char* fname, bool sync_read);
+//! @brief open runtime data file. With direct_io, plaintext entries are read
+//! bypassing page cache if the file system supports it
+struct RT_DATA_FILE* Rt_data_open(const char* fname, bool sync_read,
+                                  bool direct_io);
 void                 Rt_data_close(struct RT_DATA_FILE* file);
 
 bool  Rt_data_prefetch(struct RT_DATA_FILE* file, uint32_t index,
@@ -36,6 +40,14 @@ bool Rt_data_is_plaintext(struct RT_DATA_FILE* file);
 
 uint64_t Rt_data_size(struct RT_DATA_FILE* file);
 
+//! @brief get access schedule of entries and number of entries in it.
+//! Entries are taken as requested in index order if the file has no schedule
+const struct DATA_SCHED_ENTRY* Rt_data_schedule(struct RT_DATA_FILE* file,
+                                                uint32_t*            count);
+
+//! @brief get size of entry in bytes
+uint64_t Rt_data_entry_size(struct RT_DATA_FILE* file, uint32_t index);
+
 uint64_t Rt_data_entry_offset(struct RT_DATA_FILE* file, uint32_t index,
                               uint64_t size);
 
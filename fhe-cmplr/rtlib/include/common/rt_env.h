@@ -16,6 +16,10 @@
 //! RTLIB_TIMING_OUTPUT=string: stdout, stderr or file name. default: NULL
 #define ENV_RTLIB_TIMING_OUTPUT "RTLIB_TIMING_OUTPUT"
 
+//! environment variable to control runtime profiler output
+//! RT_STAT_TRACE_OUTPUT=string: file of Chrome trace_event JSON. default: NULL
+#define ENV_RT_STAT_TRACE_OUTPUT "RT_STAT_TRACE_OUTPUT"
+
 //! environment variable to control trace file name
 //! RTLIB_TRACE_FILE=string: stdout, stderr or file name. default: fhe_trace.t
 #define ENV_RTLIB_TRACE_FILE "RTLIB_TRACE_FILE"
@@ -23,12 +27,29 @@
 //! environment variable to control plaintext manager (PT_MGR)
 //! PT_ENTRY_COUNT=int: number of pt kept in memory. default: 8
 #define ENV_PT_ENTRY_COUNT "PT_ENTRY_COUNT"
-//! PT_PREFETCH_COUNT: number of pt for prefetching. default: 2
+//! PT_PREFETCH_COUNT: number of pt requested next in access schedule for
+//! prefetching. default: 2
 #define ENV_PT_PREFETCH_COUNT "PT_PREFETCH_COUNT"
+//! PT_ENCODE_THREAD=int: number of threads encoding messages requested next
+//! in access schedule, 0 to encode on demand. default: 0
+#define ENV_PT_ENCODE_THREAD "PT_ENCODE_THREAD"
+//! PT_ENCODE_AHEAD=int: number of messages requested next in access schedule
+//! for encoding ahead, which bounds memory of encoded plaintexts. default: 4
+#define ENV_PT_ENCODE_AHEAD "PT_ENCODE_AHEAD"
+
+//! environment variable to control plaintext cache of constant data
+//! PT_CACHE_SIZE=int: megabytes of cached plaintexts, least recently used
+//! ones are evicted beyond it, 0 to disable. default: 1024
+#define ENV_PT_CACHE_SIZE "PT_CACHE_SIZE"
 
 //! environment variable to control rt data file reader (RT_DATA_FILE)
 //! RT_DATA_ASYNC_READ=0|1: use asynchronous read. default: 0
 #define ENV_RT_DATA_ASYNC_READ "RT_DATA_ASYNC_READ"
+//! RT_DATA_DIRECT_IO=0|1: read plaintext bypassing page cache. default: 0
+#define ENV_RT_DATA_DIRECT_IO "RT_DATA_DIRECT_IO"
+//! RT_DATA_FIXED_BUF=0|1: register plaintext buffer to io_uring for
+//! asynchronous read. default: 0
+#define ENV_RT_DATA_FIXED_BUF "RT_DATA_FIXED_BUF"
 
 //! environment variable to control using even polynomial
 //! in mod_reduce of bootstrapping
@@ -39,4 +60,9 @@
 
 //! environment variable to control clear imaginary part at the end of bootstrap
 #define ENV_BOOTSTRAP_CLEAR_IMAG "RT_BTS_CLEAR_IMAG"
+
+//! environment variable to control how uniform halves of switch keys are
+//! held, 0: kept, 1: expanded from seed at first use, 2: expanded from seed
+//! at each use. Default is 0
+#define ENV_RT_SWK_COMPRESS "RT_SWK_COMPRESS"
 #endif  // RTLIB_COMMON_RT_ENV_H
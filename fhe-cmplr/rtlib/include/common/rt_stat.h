@@ -10,18 +10,46 @@
 #define RTLIB_COMMON_RT_STAT_H
 
 //! @brief rt_stat.h
-//! runtime statistics
+//! runtime statistics. Tm_start/Tm_taken inserted by the compiler around
+//! layers open and close nested wall-clock spans. Spans are kept in per-thread
+//! buffers and exported as Chrome trace_event JSON by Report_rt_stat() if
+//! environment variable RT_STAT_TRACE_OUTPUT is set.
+
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-//! @brief start a time/memory statistics
+//! @brief counters recorded for each span
+typedef enum {
+  RTS_NTT,          //!< number of NTT and INTT
+  RTS_KEY_SWITCH,   //!< number of key switching
+  RTS_ALLOC_BYTES,  //!< bytes allocated for polynomial data
+  RTS_PT_HIT,       //!< number of Pt_get with plaintext prefetched
+  RTS_PT_STALL,     //!< number of Pt_get reading plaintext on demand
+  RTS_LAST
+} RT_STAT_COUNTER;
+
+//! @brief start a nested time statistics for msg
 void Tm_start(const char* msg);
 
-//! @brief end current time/memory statistics
+//! @brief start a nested time statistics for layer msg at source line
+//! file:line
+void Tm_start_at(const char* msg, uint32_t file, uint32_t line);
+
+//! @brief end the innermost time statistics started by Tm_start(msg)
 void Tm_taken(const char* msg);
 
+//! @brief add val to counter id. Counters are accumulated per thread without
+//! atomic read-modify-write and summed over all threads when a span opens or
+//! closes, so that work done by helper threads is still attributed to the
+//! span open on the calling thread
+void Rt_stat_count(RT_STAT_COUNTER id, uint64_t val);
+
+//! @brief write all spans as Chrome trace_event JSON and drop them
+void Report_rt_stat();
+
 #ifdef __cplusplus
 }
 #endif
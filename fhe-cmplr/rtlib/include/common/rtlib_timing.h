@@ -42,6 +42,7 @@ extern "C" {
   DECL_RTM(RTM_MAIN_GRAPH, 0)       \
   /* coefficient operation */       \
   DECL_RTM(RTM_HW_ADD, 1)           \
+  DECL_RTM(RTM_HW_SUB, 1)           \
   DECL_RTM(RTM_HW_MUL, 1)           \
   DECL_RTM(RTM_HW_ROT, 1)           \
   /* polynomial operation */        \
@@ -62,12 +63,14 @@ extern "C" {
   DECL_RTM(RTM_BS_SETUP, 2)         \
   DECL_RTM(RTM_BS_KEYGEN, 2)        \
   DECL_RTM(RTM_BS_EVAL, 2)          \
+  DECL_RTM(RTM_BS_MOD_RAISE, 3)     \
   DECL_RTM(RTM_BS_PARTIAL_SUM, 3)   \
   DECL_RTM(RTM_BS_COEFF_TO_SLOT, 3) \
   DECL_RTM(RTM_BS_APPROX_MOD, 3)    \
   DECL_RTM(RTM_BS_SLOT_TO_COEFF, 3) \
   /* plaintext encoding */          \
   DECL_RTM(RTM_PT_ENCODE, 1)        \
+  DECL_RTM(RTM_PT_CACHE, 1)         \
   /* plaintext manager */           \
   DECL_RTM(RTM_PT_GET, 1)
 
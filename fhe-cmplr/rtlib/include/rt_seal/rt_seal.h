@@ -35,6 +35,13 @@ inline void Encode_plain_from_float(PLAIN plain, float* input, size_t len,
   Seal_encode_from_float(plain, input, len, sc_degree, level);
 }
 
+//! @brief encode constant float array into plaintext, not cached
+inline void Encode_plain_from_float_cached(PLAIN plain, float* input,
+                                           size_t len, uint32_t sc_degree,
+                                           uint32_t level) {
+  Encode_plain_from_float(plain, input, len, sc_degree, level);
+}
+
 // HE Operations
 inline CIPHER Add_ciph(CIPHER res, CIPHER op1, CIPHER op2) {
   Seal_add_ciph(res, op1, op2);
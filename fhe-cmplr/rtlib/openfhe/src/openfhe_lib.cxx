@@ -12,6 +12,7 @@
 #include "common/error.h"
 #include "common/io_api.h"
 #include "common/rt_api.h"
+#include "common/rt_stat.h"
 #include "rt_openfhe/openfhe_api.h"
 
 class OPENFHE_CONTEXT {
@@ -170,6 +171,7 @@ void Prepare_context() {
 
 void Finalize_context() {
   OPENFHE_CONTEXT::Fini_context();
+  Report_rt_stat();
   Io_fini();
 }
 
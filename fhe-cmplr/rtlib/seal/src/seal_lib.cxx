@@ -12,6 +12,7 @@
 #include "common/error.h"
 #include "common/io_api.h"
 #include "common/rt_api.h"
+#include "common/rt_stat.h"
 #include "rt_seal/seal_api.h"
 
 class SEAL_CONTEXT {
@@ -217,6 +218,7 @@ void Prepare_context() {
 
 void Finalize_context() {
   SEAL_CONTEXT::Fini_context();
+  Report_rt_stat();
   Io_fini();
 }
 
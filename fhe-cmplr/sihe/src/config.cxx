@@ -29,6 +29,8 @@ static OPTION_DESC Sihe_option[] = {
                          &Sihe_config._relu_mul_depth,                                                                                      air::util::K_INT64,  0, V_EQUAL},
     {"relu_base_poly_type",      "relu_basis",  "Base polynomial type of relu",
                          &Sihe_config._relu_base_type,                                                                                      air::util::K_INT64,  0, V_EQUAL},
+    {"gvn",                      "gvn",         "Run GVN and DCE on SIHE IR",
+                         &Sihe_config._gvn,                                                                                                 air::util::K_NONE,   0, V_NONE },
 };
 
 static OPTION_DESC_HANDLE Sihe_option_handle = {
@@ -57,6 +59,7 @@ void SIHE_CONFIG::Print(std::ostream& os) const {
   os << "Value rangle of ReLU: " << Relu_value_range_msg() << std::endl;
   os << "Multiplication depth of ReLU: " << Relu_mul_depth() << std::endl;
   os << "Base polynomial type of ReLU: " << Relu_base_type() << std::endl;
+  os << "Run GVN and DCE: " << Gvn() << std::endl;
 }
 
 double SIHE_CONFIG::Relu_value_range(const char* name) const {
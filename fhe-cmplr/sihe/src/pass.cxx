@@ -11,6 +11,7 @@
 #include <iostream>
 
 #include "fhe/driver/fhe_cmplr.h"
+#include "fhe/opt/opt_driver.h"
 #include "fhe/sihe/sihe_gen.h"
 
 namespace fhe {
@@ -35,6 +36,10 @@ R_CODE SIHE_PASS::Run() {
   air::base::GLOB_SCOPE* glob =
       Sihe_driver(Get_driver()->Glob_scope(), &Get_driver()->Lower_ctx(),
                   Get_driver()->Context(), Config());
+  if (Config().Gvn()) {
+    opt::Opt_driver(glob, &Get_driver()->Lower_ctx(), Get_driver()->Context(),
+                    Config(), opt::OPT_LEVEL::SIHE);
+  }
   Get_driver()->Update_glob_scope(glob);
   return R_CODE::NORMAL;
 }
@@ -17,6 +17,7 @@
 #include "fhe/core/scheme_info_config.h"
 #include "fhe/sihe/tensor2sihe_impl.h"
 #include "fhe/sihe/vector2sihe_ctx.h"
+#include "nn/vector/batch_pack.h"
 
 namespace fhe {
 namespace sihe {
@@ -66,9 +67,27 @@ FUNC_SCOPE& VECTOR2SIHE_LOWER::Lower_vec_func(FUNC_SCOPE* vec_func_scope) {
   AIR_ASSERT(retv.Node() != air::base::Null_ptr && retv.Node()->Is_entry());
   sihe_func_scope->Set_entry_stmt(retv.Node()->Stmt());
 
-  // 4. update poly_degree N with max msg length
+  // 4. update poly_degree N with max msg length. A packed batch occupies
+  //    batch * batch_block slots.
+  NODE_PTR       idname    = node->Child(0);
+  uint32_t       input_dim = 0, output_dim = 0;
+  const int64_t* batch     = idname->Attr<int64_t>(nn::vector::ATTR_BATCH);
+  const int64_t* block =
+      idname->Attr<int64_t>(nn::vector::ATTR_BATCH_BLOCK);
+  const int64_t* input =
+      idname->Attr<int64_t>(nn::vector::ATTR_BATCH_INPUT, &input_dim);
+  const int64_t* output =
+      idname->Attr<int64_t>(nn::vector::ATTR_BATCH_OUTPUT, &output_dim);
+  if (batch != nullptr && block != nullptr) {
+    AIR_ASSERT(input != nullptr && output != nullptr);
+    trav_ctx.Update_max_msg_len((*batch) * (*block));
+    Lower_ctx()->Set_batch_layout(
+        *block, std::vector<int64_t>(input, input + input_dim),
+        std::vector<int64_t>(output, output + output_dim));
+  }
   uint32_t max_msg_len = trav_ctx.Get_max_msg_len();
   uint32_t poly_deg    = core::CTX_PARAM::Get_poly_degree_of_msg(max_msg_len);
+  Lower_ctx()->Get_ctx_param().Update_min_poly_degree(poly_deg);
 
   uint32_t old_poly_deg = Lower_ctx()->Get_ctx_param().Get_poly_degree();
   if (poly_deg > old_poly_deg) {
@@ -123,7 +142,8 @@ NODE_PTR VECTOR2SIHE_IMPL::Lower_bin_arith_node(VECTOR2SIHE_CTX& ctx,
                                                 NODE_PTR node, OPCODE sihe_op,
                                                 NODE_PTR op0, NODE_PTR op1) {
   CMPLR_ASSERT(node->Operator() == nn::vector::ADD ||
-                   node->Operator() == nn::vector::MUL,
+                   node->Operator() == nn::vector::MUL ||
+                   node->Operator() == nn::vector::SUB,
                "only support add/mul/sub");
   TYPE_PTR rtype = node->Rtype();
   AIR_ASSERT(rtype->Is_array());
@@ -135,9 +155,11 @@ NODE_PTR VECTOR2SIHE_IMPL::Lower_bin_arith_node(VECTOR2SIHE_CTX& ctx,
   CMPLR_ASSERT(op0->Container() == cont, "opnd 0 must be from new container");
   CMPLR_ASSERT(op1->Container() == cont, "opnd 1 must be from new container");
 
-  // canonicalize binary node: set cipher type child as child0
+  // canonicalize binary node: set cipher type child as child0. sub is not
+  // commutative, its minuend must already be ciphertext
   TYPE_ID cipher_type_id = ctx.Lower_ctx().Get_cipher_type_id();
-  if (op0->Rtype_id() != cipher_type_id) {
+  if (op0->Rtype_id() != cipher_type_id &&
+      node->Operator() != nn::vector::SUB) {
     std::swap(op0, op1);
   }
   CMPLR_ASSERT(cipher_type_id == op0->Rtype_id(), "child0 must be ciphertext");
@@ -37,6 +37,10 @@ enum OPCODE : uint32_t {
 #include "opcode_def.inc"
 #undef DEF_OPCODE
 
+//! @brief int attr of RELU: operand spans this many times the value range
+//! set for the relu name, e.g. 2 for a - b of two values in that range
+static constexpr const char* ATTR_VR_SCALE = "vr_scale";
+
 bool Register_nn();
 
 }  // namespace core
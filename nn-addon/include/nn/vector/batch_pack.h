@@ -0,0 +1,82 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef NN_VECTOR_BATCH_PACK_H
+#define NN_VECTOR_BATCH_PACK_H
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "nn/vector/tensor2vector_ctx.h"
+
+namespace nn {
+namespace vector {
+
+//! Attributes set on the IDNAME node of the batched formal (formal 0) of a
+//! batch-packed vector function. VECTOR2SIHE reads them to size the message
+//! and records the layout in fhe::core::LOWER_CTX, which is used by POLY2C
+//! to emit the encode/decode scheme for the runtime.
+//! batch: number of images packed into one vector
+//! batch_block: slot distance between two adjacent images
+//! batch_input/batch_output: shape of the input/output tensor, dim[0] is batch
+static constexpr const char* ATTR_BATCH        = "batch";
+static constexpr const char* ATTR_BATCH_BLOCK  = "batch_block";
+static constexpr const char* ATTR_BATCH_INPUT  = "batch_input";
+static constexpr const char* ATTR_BATCH_OUTPUT = "batch_output";
+
+//! Max number of slots available for a packed vector. Same limit as the one
+//! assumed by conv/gemm lowering (N max is 65536).
+static constexpr int64_t MAX_BATCH_SLOTS = 32768;
+
+//! @brief Pack a batch of images into one vector (blocked layout).
+//! Tensor2vector lowers conv/gemm/pool per image. After that, image b lives in
+//! slots [b*block, b*block+extent) of the vector, where block is the power of
+//! two covering the largest per-image vector extent plus the largest roll
+//! amount, so that rolls never move valid data of one image into the valid
+//! range of another. Every float constant operand (weights, bias, masks) is
+//! tiled to all blocks, and constant slices are widened accordingly. Nothing
+//! is changed for batch=1.
+class BATCH_PACK {
+public:
+  BATCH_PACK(TENSOR2VECTOR_CTX& ctx) : _ctx(ctx), _cntr(ctx.Container()) {}
+
+  void Run();
+
+private:
+  // collect constant row length, max vector extent and max roll amount
+  void Collect(NODE_PTR node);
+
+  // replace constant operands with the tiled ones
+  NODE_PTR Pack(NODE_PTR node);
+
+  // create tiled constant for cst with rows of row_len elements
+  CONSTANT_PTR Tile_const(CONSTANT_PTR cst, int64_t row_len,
+                          const SPOS& spos);
+
+  bool Is_vector_const(NODE_PTR node) const;
+  void Record_row_len(CONSTANT_PTR cst, int64_t row_len);
+
+  TENSOR2VECTOR_CTX& _ctx;
+  CONTAINER*         _cntr;
+  int64_t            _batch   = 1;
+  int64_t            _block   = 0;
+  int64_t            _extent  = 0;
+  int64_t            _max_rot = 0;
+  // operand length and roll amount of each roll
+  std::vector<std::pair<int64_t, int64_t>> _rolls;
+  // constant id -> row length
+  std::unordered_map<uint32_t, int64_t> _row_len;
+  // constant id -> tiled constant
+  std::unordered_map<uint32_t, CONSTANT_PTR> _tiled;
+};
+
+}  // namespace vector
+}  // namespace nn
+
+#endif  // NN_VECTOR_BATCH_PACK_H
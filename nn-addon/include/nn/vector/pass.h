@@ -34,6 +34,11 @@ public:
 
   const char* Name() const { return "VECTOR"; }
 
+  //! @brief Vector IR, including weights reshaped by im2col and diagonal
+  //! packing, only depends on input model and options, cache it with
+  //! -ir_cache
+  bool Is_cacheable() const { return true; }
+
 private:
   air::driver::DRIVER* _driver;
   vector::VECTOR_CTX   _ctx;
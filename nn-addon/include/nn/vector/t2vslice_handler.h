@@ -39,7 +39,6 @@ public:
     int64_t batch = 0, channel_in = 0, input_height = 0, input_width = 0;
     Get_array_nchw(orig_input->Rtype(), batch, channel_in, input_height,
                    input_width);
-    AIR_ASSERT_MSG(batch == 1, "Conv only supports batch=1");
 
     NODE_PTR weight_node = new_node->Child(1);
     int64_t  channel_out = 0, channel_in_kernel = 0, kernel_height = 0,
@@ -63,6 +62,8 @@ public:
     // strided_slice
     if (!ctx.Improve_ss_insert()) {
       if ((pads.size() > 0) && (pads[0] == 0)) {
+        AIR_ASSERT_MSG(batch == 1,
+                       "Conv with strided_slice only supports batch=1");
         int                  padsize   = (kernel_height - 1) / 2;
         int                  slicesize = input_height - 2 * padsize;
         std::vector<int64_t> start_indiex{padsize, padsize};
@@ -74,6 +75,8 @@ public:
         return RETV(strided_slice_node);
       } else if (((pads.size() > 0) && (pads[0] == 1)) &&
                  ((strides.size() > 0) && (strides[0] == 2))) {
+        AIR_ASSERT_MSG(batch == 1,
+                       "Conv with strided_slice only supports batch=1");
         std::vector<int64_t> start_indiex{0, 0};
         std::vector<int64_t> slice_size{input_height, input_width};
         std::vector<int64_t> stride_size{2, 2};
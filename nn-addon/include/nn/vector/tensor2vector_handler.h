@@ -10,6 +10,7 @@
 #define NN_VECTOR_TENSOR2VECTOR_HANDLER_H
 
 #include "air/base/transform_util.h"
+#include "air/util/mem_util.h"
 #include "nn/core/null_handler.h"
 #include "nn/vector/tensor2vector_ctx.h"
 #include "nn/vector/tensor2vector_util.h"
@@ -26,7 +27,7 @@ public:
   template <typename RETV, typename VISITOR>
   RETV Handle_add(VISITOR* visitor, air::base::NODE_PTR node) {
     TENSOR2VECTOR_CTX& ctx = visitor->Context();
-    TIMING_UTIL        timing(ctx, node->Spos(), "Tensor::add", false);
+    TIMING_UTIL        timing(ctx, node, "Tensor::add", false);
     TENSOR2VECTOR_UTIL vgen(ctx);
     NODE_PTR           new_ld0 = visitor->template Visit<RETV>(node->Child(0));
     NODE_PTR           new_ld1 = visitor->template Visit<RETV>(node->Child(1));
@@ -37,7 +38,7 @@ public:
   template <typename RETV, typename VISITOR>
   RETV Handle_mul(VISITOR* visitor, air::base::NODE_PTR node) {
     TENSOR2VECTOR_CTX& ctx = visitor->Context();
-    TIMING_UTIL        timing(ctx, node->Spos(), "Tensor::mul", false);
+    TIMING_UTIL        timing(ctx, node, "Tensor::mul", false);
     TENSOR2VECTOR_UTIL vgen(ctx);
     NODE_PTR           new_ld0 = visitor->template Visit<RETV>(node->Child(0));
     NODE_PTR           new_ld1 = visitor->template Visit<RETV>(node->Child(1));
@@ -56,7 +57,7 @@ public:
   template <typename RETV, typename VISITOR>
   RETV Handle_flatten(VISITOR* visitor, air::base::NODE_PTR node) {
     TENSOR2VECTOR_CTX& ctx = visitor->Context();
-    TIMING_UTIL        timing(ctx, node->Spos(), "Tensor::flatten", false);
+    TIMING_UTIL        timing(ctx, node, "Tensor::flatten", false);
     CONTAINER*         cntr = ctx.Container();
     TENSOR2VECTOR_UTIL vgen(ctx);
     GLOB_SCOPE*        gscope     = cntr->Glob_scope();
@@ -65,12 +66,13 @@ public:
     NODE_PTR           new_op0    = visitor->template Visit<RETV>(orig_input);
     // TODO: handle flatten axis. Now flatten to [1,x].
     // Only set load. Other op rtype is conistent.
+    // Batch dim is not flattened, images are packed later by BATCH_PACK.
     std::vector<int64_t> shape = orig_input->Rtype()->Cast_to_arr()->Shape();
     if ((orig_input->Opcode() ==
          air::base::OPCODE(air::core::CORE, air::core::OPCODE::LD)) &&
         (shape.size() > 1)) {
       int64_t size = 1;
-      for (auto s : shape) size *= s;
+      for (size_t i = 1; i < shape.size(); i++) size *= shape[i];
       ctx.Trace(TF_LOWER, "WARN: flatten new_input ", shape.size(),
                 " is not 1D! \n");
       ctx.Trace_cmd(TF_LOWER, Trace_node, new_op0);
@@ -93,7 +95,7 @@ public:
     if (ctx.Improve_ss_insert()) {
       ctx.Incr_num_op_ca_t2vsh();
     }
-    TIMING_UTIL        timing(ctx, node->Spos(), "Tensor::conv", false);
+    TIMING_UTIL        timing(ctx, node, "Tensor::conv", false);
     CONTAINER*         cntr = ctx.Container();
     TENSOR2VECTOR_UTIL vgen(ctx);
     GLOB_SCOPE*        gscope   = cntr->Glob_scope();
@@ -108,9 +110,10 @@ public:
     int64_t output_height = input_height;
     int64_t output_width  = input_width;
 
+    // Lower conv for one image. For batch > 1, images are packed into one
+    // vector and weight/bias/masks are tiled to all images by BATCH_PACK.
     ctx.Trace(TF_LOWER, "conv orig_input shape: [", batch, ", ", channel_in,
               ", ", input_height, ", ", input_width, "]\n");
-    AIR_ASSERT_MSG(batch == 1, "Conv only supports batch=1");
 
     NODE_PTR weight_node = node->Child(1);
     int64_t  channel_out = 0, channel_in_kernel = 0, kernel_height = 0,
@@ -185,14 +188,6 @@ public:
       ctx.Trace(TF_LOWER, "padding weight.size()=", weight.size(), "\n");
     }
 
-    FPMAT conv1_im2col_kernel(
-        channel_in * kernel_height * kernel_width,
-        FPVEC(channel_out * input_height * input_width, 0.0));
-    std::vector<int> ra(kernel_height * kernel_width, 0);
-    Get_im2col_kernel(weight, channel_in, input_height, input_width,
-                      channel_out, kernel_height, kernel_width, 1, stride, ra,
-                      conv1_im2col_kernel);
-
     std::vector<int> real_strides = Get_attr_int(node, "strides");
     AIR_ASSERT_MSG(real_strides.size() == 2, "conv stride size only support 2");
     AIR_ASSERT_MSG(real_strides[0] == real_strides[1],
@@ -201,48 +196,63 @@ public:
     AIR_ASSERT_MSG(real_pads.size() == 4, "conv padding size only support 4");
     ctx.Trace(TF_LOWER, "conv stride is ", real_strides[0], "\n");
     ctx.Trace(TF_LOWER, "conv padding is ", real_pads[0], "\n");
-    if ((real_strides[0] > 1) && (real_pads[0] != 0)) {
-      Masking_padding_stride_data_in_mat(
-          channel_in * kernel_height * kernel_width, input_height, input_width,
-          channel_out, real_pads[0], real_strides[0], conv1_im2col_kernel);
-    } else if (real_pads[0] == 0) {
-      Masking_no_padding_stride_data_in_mat(
-          channel_in * kernel_height * kernel_width, input_height, input_width,
-          kernel_height, kernel_width, channel_out, real_pads[0],
-          real_strides[0], conv1_im2col_kernel);
-    }
-
-    if ((channel_out >= channel_in) && ctx.Conv_fast()) {
-      for (int i = 1; i < channel_in; i++) {
-        for (int j = 0; j < kernel_size; j++) {
-          rotate(conv1_im2col_kernel[i * kernel_size + j].begin(),
-                 conv1_im2col_kernel[i * kernel_size + j].begin() +
-                     conv1_im2col_kernel[i * kernel_size + j].size() -
-                     i * input_height * input_width,
-                 conv1_im2col_kernel[i * kernel_size + j].end());
-        }
-      }
-    }
 
-    FPVEC weight_im2col_vec;
-    for (int i = 0; i < channel_in * kernel_height * kernel_width; i++)
-      for (int j = 0; j < channel_out * input_height * input_width; j++)
-        weight_im2col_vec.push_back(conv1_im2col_kernel[i][j]);
-
-    // New weight_im2col_const
-    int64_t weight_im2col_size = channel_in * kernel_height * kernel_width *
-                                 channel_out * input_height * input_width;
-    std::vector<int64_t> weight_im2col_shape{
-        channel_in * kernel_height * kernel_width,
-        channel_out * input_height * input_width};
-    std::string weight_im2col_str =
+    uint64_t rss_kb = 0, peak_kb = 0;
+    air::util::Proc_mem_usage(rss_kb, peak_kb);
+    ctx.Trace(TF_LOWER, "conv im2col begin: rss=", rss_kb, "KB, peak_rss=",
+              peak_kb, "KB\n");
+
+    // New weight_im2col_const [channel_in*kh*kw, channel_out*h*w]. The
+    // const is created zero-initialized and filled row by row in place, so
+    // no dense im2col matrix or flattened copy is built in compiler memory.
+    int64_t weight_im2col_rows = channel_in * kernel_height * kernel_width;
+    int64_t weight_im2col_cols = channel_out * input_height * input_width;
+    int64_t weight_im2col_size = weight_im2col_rows * weight_im2col_cols;
+    std::vector<int64_t> weight_im2col_shape{weight_im2col_rows,
+                                             weight_im2col_cols};
+    std::string          weight_im2col_str =
         New_array_name("weight_im2col_float", weight_im2col_shape);
     CONSTANT_PTR weight_im2col_const = New_array_const(
         gscope, weight_im2col_str.c_str(), weight_im2col_size,
         weight_node->Rtype()->Cast_to_arr()->Elem_type(), weight_im2col_shape,
-        (void*)weight_im2col_vec.data(), spos);
+        nullptr, spos);
+    // no constant is allocated in gscope until all rows are filled
+    float* weight_im2col_ptr = weight_im2col_const->Array_mutable_ptr<float>();
+
+    std::vector<int> ra(kernel_height * kernel_width, 0);
+    Get_im2col_ra(input_height, kernel_height, kernel_width, ra);
+    FPVEC row(weight_im2col_cols, 0.0);
+    for (int64_t i = 0; i < weight_im2col_rows; i++) {
+      Get_im2col_kernel_row(weight, channel_in, input_height, input_width,
+                            channel_out, kernel_height, kernel_width, 1,
+                            stride, ra, i, row);
+      if ((real_strides[0] > 1) && (real_pads[0] != 0)) {
+        Masking_padding_stride_data_in_vec(input_height, input_width,
+                                           channel_out, real_pads[0],
+                                           real_strides[0], row);
+      } else if (real_pads[0] == 0) {
+        Masking_no_padding_stride_data_in_vec(
+            input_height, input_width, channel_out, real_pads[0],
+            real_strides[0], kernel_height, kernel_width, row);
+      }
+      // rows of input channel ci are rotated by ci*h*w for conv_fast
+      int64_t ci = i / kernel_size;
+      if ((channel_out >= channel_in) && ctx.Conv_fast() && (ci > 0)) {
+        rotate(row.begin(),
+               row.begin() + row.size() - ci * input_height * input_width,
+               row.end());
+      }
+      std::copy(row.begin(), row.end(),
+                weight_im2col_ptr + i * weight_im2col_cols);
+    }
     NODE_PTR new_weight = cntr->New_ldc(weight_im2col_const, spos);
 
+    air::util::Proc_mem_usage(rss_kb, peak_kb);
+    ctx.Trace(TF_LOWER, "conv im2col end: const=",
+              weight_im2col_size * sizeof(float), "B, row=",
+              weight_im2col_cols * sizeof(float), "B, rss=", rss_kb,
+              "KB, peak_rss=", peak_kb, "KB\n");
+
     // Expand bias const: TODO: add has broadcast, to sihe?
     NODE_PTR     bias_node = node->Child(2);
     const float* bias_ptr  = bias_node->Const()->Array_ptr<float>();
@@ -287,7 +297,7 @@ public:
   template <typename RETV, typename VISITOR>
   RETV Handle_gemm(VISITOR* visitor, air::base::NODE_PTR node) {
     TENSOR2VECTOR_CTX& ctx = visitor->Context();
-    TIMING_UTIL        timing(ctx, node->Spos(), "Tensor::gemm", false);
+    TIMING_UTIL        timing(ctx, node, "Tensor::gemm", false);
     CONTAINER*         cntr = ctx.Container();
     TENSOR2VECTOR_UTIL vgen(ctx);
     // TODO: pad for shape consistence.
@@ -321,62 +331,20 @@ public:
     }
 
     // Assuming GEMM:: transB = 1
+    if (ctx.Gemm_fast()) {
+      NODE_PTR new_bias = visitor->template Visit<RETV>(node->Child(2));
+      return vgen.New_gemm_metakernel_fast(new_ld0, op1_mat, new_bias, spos);
+    }
+
     // transpose_diag(op1_const)
     FPVEC diag_vec;
     int   padw;
     for (padw = width; padw <= height * width; padw++) {
       if (padw % height == 0) break;
     }
-
-    int64_t old_height = height;
-    if (ctx.Gemm_fast()) {
-      AIR_ASSERT_MSG(((height & (height - 1)) == 0) &&
-                         (((height / width) & (height / width - 1)) == 0),
-                     "TODO: gemm_fast only supports height=%d=2^n now. "
-                     "Example: 8x4, 2048x1024",
-                     height);
-      if (old_height > width) {
-        padw   = height;
-        height = width;
-      } else {
-        padw = width;
-      }
-    }
-
-    int h1 = 0, h2 = 0;
-    Get_block_size(height, h1, h2);
-    ctx.Trace(TF_LOWER, "Handle_gemm Get_block_size: height=", height,
-              ", h1=", h1, ", h2=", h2, "\n");
-
-    if (ctx.Gemm_fast()) {
-      // weight tiling
-      for (int i = 0; i < height; i++) {
-        FPVEC diag;
-        if (old_height > width) {
-          FPMAT slice_weight0(op1_mat.begin(), op1_mat.begin() + height);
-          diag = Transpose_diagonal(slice_weight0, i, height);
-          rotate(diag.begin(), diag.begin() + diag.size() - (i / h1) * h1,
-                 diag.end());
-          for (size_t slice = 1; slice < old_height / height; slice++) {
-            FPMAT slice_weight(op1_mat.begin() + height * slice,
-                               op1_mat.begin() + height * (slice + 1));
-            FPVEC diag2 = Transpose_diagonal(slice_weight, i, height);
-            rotate(diag2.begin(), diag2.begin() + diag2.size() - (i / h1) * h1,
-                   diag2.end());
-            diag = diag + diag2;
-          }
-        } else {
-          diag = Transpose_diagonal(op1_mat, i, padw);
-          rotate(diag.begin(), diag.begin() + diag.size() - (i / h1) * h1,
-                 diag.end());
-        }
-        diag_vec = diag_vec + diag;
-      }
-    } else {
-      for (int i = 0; i < height; i++) {
-        FPVEC diag = Transpose_diagonal(op1_mat, i, padw);
-        diag_vec   = diag_vec + diag;
-      }
+    for (int i = 0; i < height; i++) {
+      FPVEC diag = Transpose_diagonal(op1_mat, i, padw);
+      diag_vec   = diag_vec + diag;
     }
     AIR_ASSERT_MSG(diag_vec.size() == padw * height,
                    "operand1_diag size != height*padw  %d != %d*%d",
@@ -392,12 +360,8 @@ public:
     NODE_PTR new_weight = cntr->New_ldc(diag_const, spos);
     NODE_PTR new_bias   = visitor->template Visit<RETV>(node->Child(2));
 
-    NODE_PTR new_node;
-    if (ctx.Gemm_fast()) {
-      new_node = vgen.New_gemm_metakernel_fast(new_ld0, new_weight, new_bias,
-                                               spos, old_height > width);
-    } else
-      new_node = vgen.New_gemm_metakernel(new_ld0, new_weight, new_bias, spos);
+    NODE_PTR new_node =
+        vgen.New_gemm_metakernel(new_ld0, new_weight, new_bias, spos);
     return new_node;
   }
 
@@ -407,7 +371,7 @@ public:
     if (ctx.Improve_ss_insert()) {
       ctx.Incr_num_op_ca_t2vsh();
     }
-    TIMING_UTIL        timing(ctx, node->Spos(), "Tensor::avg_pool", false);
+    TIMING_UTIL        timing(ctx, node, "Tensor::avg_pool", false);
     CONTAINER*         cntr = ctx.Container();
     TENSOR2VECTOR_UTIL vgen(ctx);
     // TODO: pad for shape consistence.
@@ -499,13 +463,45 @@ public:
 
   template <typename RETV, typename VISITOR>
   RETV Handle_max_pool(VISITOR* visitor, air::base::NODE_PTR node) {
-    return Handle_average_pool<RETV, VISITOR>(visitor, node);
+    TENSOR2VECTOR_CTX& ctx = visitor->Context();
+    if (ctx.Improve_ss_insert()) {
+      ctx.Incr_num_op_ca_t2vsh();
+    }
+    TIMING_UTIL        timing(ctx, node, "Tensor::max_pool", false);
+    TENSOR2VECTOR_UTIL vgen(ctx);
+    AIR_ASSERT_MSG(node->Num_child() == 1,
+                   "max pool operator only support 1 child");
+    NODE_PTR input = visitor->template Visit<RETV>(node->Child(0));
+    SPOS     spos  = node->Spos();
+
+    AIR_ASSERT_MSG(input->Rtype()->Is_array(), "operand is not an array type");
+    std::vector<int64_t> op_shape = input->Rtype()->Cast_to_arr()->Shape();
+    AIR_ASSERT_MSG(op_shape.size() == 4, "input shape should be 4");
+
+    std::vector<int> kernel_shape = Get_attr_int(node, "kernel_shape");
+    std::vector<int> strides      = Get_attr_int(node, "strides");
+    uint32_t         num_pad      = 0;
+    const int*       pads         = node->Attr<int>("pads", &num_pad);
+    for (uint32_t i = 0; i < num_pad; i++) {
+      AIR_ASSERT_MSG(pads[i] == 0, "max pool only support pads=0");
+    }
+    // valid results are extracted by the strided slice inserted by T2VSLICE,
+    // which only handles non-overlapping windows and gives wrong results for
+    // stride 4
+    AIR_ASSERT_MSG(kernel_shape.size() == 2 && kernel_shape == strides &&
+                       strides[0] == 2 && strides[1] == 2,
+                   "max pool only support stride and ks equals 2!");
+
+    const char* name = node->Attr("name");
+    return vgen.New_max_pool_metakernel(input, kernel_shape[0],
+                                        kernel_shape[1], op_shape[3],
+                                        name ? name : "max_pool", spos);
   }
 
   template <typename RETV, typename VISITOR>
   RETV Handle_global_average_pool(VISITOR* visitor, air::base::NODE_PTR node) {
     TENSOR2VECTOR_CTX& ctx = visitor->Context();
-    TIMING_UTIL timing(ctx, node->Spos(), "Tensor::global_avg_pool", false);
+    TIMING_UTIL timing(ctx, node, "Tensor::global_avg_pool", false);
     CONTAINER*  cntr = ctx.Container();
     TENSOR2VECTOR_UTIL vgen(ctx);
 
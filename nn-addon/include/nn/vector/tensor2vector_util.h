@@ -15,10 +15,26 @@
 #include "air/base/st.h"
 #include "nn/vector/tensor2vector_ctx.h"
 #include "nn/vector/vector_gen.h"
+#include "nn/vector/vector_utils.h"
+
+class TEST_WEIGHT_ROWS;
 
 namespace nn {
 namespace vector {
 
+//! @brief Rows of a 2D weight [num_grp*grp_size, row_len] left after
+//! compile-time sparse elimination. Rows are grouped as (group, member), like
+//! (channel_in, kernel) of im2col weight. Groups and members whose rows are
+//! all zero are dropped, and duplicate rows are stored once.
+struct WEIGHT_ROWS {
+  std::vector<int> _grp;           // kept groups
+  std::vector<int> _mbr;           // kept members
+  std::vector<int> _row_map;       // kept (grp, mbr) -> row of _weight
+  CONSTANT_PTR     _weight;        // unique rows, one zero row if needed
+  int64_t          _num_zero = 0;  // all-zero rows not stored
+  int64_t          _num_dup  = 0;  // duplicate rows not stored
+};
+
 class TENSOR2VECTOR_UTIL : public VECTOR_GEN {
 public:
   TENSOR2VECTOR_UTIL(TENSOR2VECTOR_CTX& ctx)
@@ -26,8 +42,8 @@ public:
 
   NODE_PTR New_gemm_metakernel(NODE_PTR op0, NODE_PTR op1, NODE_PTR op2,
                                const SPOS& spos);
-  NODE_PTR New_gemm_metakernel_fast(NODE_PTR op0, NODE_PTR op1, NODE_PTR op2,
-                                    const SPOS& spos, bool tiling);
+  NODE_PTR New_gemm_metakernel_fast(NODE_PTR input, const FPMAT& weight,
+                                    NODE_PTR bias, const SPOS& spos);
   NODE_PTR New_conv_metakernel(NODE_PTR input, NODE_PTR weight, NODE_PTR bias,
                                std::vector<int> ra, int channel_in,
                                int channel_out, int output_height,
@@ -39,6 +55,13 @@ public:
                                     int output_width, int output_height,
                                     int kernel_hw, const SPOS& spos);
 
+  //! max of each kh x kw window, result at window's top-left element.
+  //! max(a, b) = b + relu(a - b), relu is lowered to polynomial later.
+  //! name: prefix of relu names, their -SIHE:relu_vr is the input range and
+  //! is doubled for a - b by ATTR_VR_SCALE
+  NODE_PTR New_max_pool_metakernel(NODE_PTR input, int kh, int kw, int w,
+                                   const char* name, const SPOS& spos);
+
   //! use this function to extract valid data, to make valid data together
   //! till now used after conv(add pad to keep output same) and average pool
   //! ih/iw: actually input height and width
@@ -64,6 +87,13 @@ public:
                                  const SPOS& spos);
 
 private:
+  friend class ::TEST_WEIGHT_ROWS;
+
+  //! drop zero rows and merge duplicate rows of weight, return false if no
+  //! row can be eliminated
+  bool Compact_weight_rows(NODE_PTR weight, int64_t num_grp, int64_t grp_size,
+                           WEIGHT_ROWS& rows, const SPOS& spos);
+
   ADDR_DATUM_PTR Roll_valid_to_start(ADDR_DATUM_PTR input_var,
                                      ARRAY_TYPE_PTR ty_arr, int64_t ih,
                                      int64_t iw, int64_t padsize,
@@ -87,6 +117,15 @@ private:
                                  int64_t ss_w, int64_t ks, int64_t stride,
                                  const SPOS& spos);
 
+  //! report rotations, multiplies and weight bytes eliminated for a layer
+  void Trace_sparse_weight(const char* kernel, const WEIGHT_ROWS& rows,
+                           int64_t num_rows, int64_t row_len, int64_t rot,
+                           int64_t mul);
+
+  //! new ild of int array const: vals[idx]
+  NODE_PTR New_ild_int_const(const char* name, const std::vector<int>& vals,
+                             NODE_PTR idx, const SPOS& spos);
+
   NODE_PTR Gen_dup_input_node(NODE_PTR input_node, int64_t dup_num,
                               int input_len, const SPOS& spos);
   void Gen_dup_input_stmt(NODE_PTR input_node, int64_t dup_num, int input_len,
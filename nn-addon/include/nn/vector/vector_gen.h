@@ -41,6 +41,10 @@ public:
   air::base::NODE_PTR New_mul(air::base::NODE_PTR op0, air::base::NODE_PTR op1,
                               const air::base::SPOS& spos);
 
+  //! @brief New SUB node, op0 - op1
+  air::base::NODE_PTR New_sub(air::base::NODE_PTR op0, air::base::NODE_PTR op1,
+                              const air::base::SPOS& spos);
+
   //! @brief New a slice node which extracts a sub-array from the input array
   //! @param op0 is input ND array
   //! @param op1 is start_indices array
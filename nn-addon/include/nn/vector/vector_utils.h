@@ -94,6 +94,28 @@ FPVEC operator+(FPVEC const& x, FPVEC const& y);
  */
 FPVEC Transpose_diagonal(FPMAT A, size_t position, size_t padw);
 
+//! @brief Compute roll amount of each kernel element for im2col conv
+//! @param h: input height
+//! @param kh: conv kernel height
+//! @param kw: conv kernel width
+//! @param ra: output roll amounts, size kh*kw
+void Get_im2col_ra(int h, int kh, int kw, std::vector<int>& ra);
+
+//! @brief Compute one row of im2col kernel [c_in*kh*kw, c_out*h*w] without
+//! materializing the whole matrix. ra must be computed by Get_im2col_ra.
+//! @param row: row index in [0, c_in*kh*kw)
+//! @param row_vec: output row, size c_out*h*w
+void Get_im2col_kernel_row(const FPVEC& weight, int c_in, int h, int w,
+                           int c_out, int kh, int kw, int padding, int stride,
+                           const std::vector<int>& ra, int row, FPVEC& row_vec);
+
+//! @brief Find all-zero and duplicate rows of 2D float array const
+//! [rows, row_len], so that they need no plaintext multiply or storage.
+//! @param row_map: output, size rows. -1 for an all-zero row, otherwise the
+//! index of the first row holding the same data
+//! @return number of unique non-zero rows
+int64_t Get_uniq_rows(CONSTANT_PTR cst, std::vector<int64_t>& row_map);
+
 // Record the location of im2col
 void Get_im2col_kernel(FPVEC& weight, int c_in, int h, int w, int c_out, int kh,
                        int kw, int padding, int stride, std::vector<int>& ra,
@@ -175,6 +197,12 @@ void Masking_no_padding_stride_data_in_vec(int h, int w, int channel,
 //! calculate average value and clear zero mask
 FPVEC Get_avg_value_mask(int c_in, int h, int w, int ks);
 
+//! @brief Roll amounts of the tournament tree which computes the max over a
+//! kh x kw window: max(x, roll(x, r)) for each r, columns first. The window
+//! covered doubles each round (the last round overlaps), so there are
+//! ceil(log2(kw)) + ceil(log2(kh)) rounds.
+std::vector<int> Get_max_pool_rolls(int kh, int kw, int w);
+
 //! calculate global average value and clear zero mask
 FPVEC Get_global_avg_value_mask(int c_in, int h, int w);
 
@@ -0,0 +1,210 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "nn/vector/batch_pack.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "air/core/opcode.h"
+#include "nn/vector/vector_gen.h"
+#include "nn/vector/vector_opcode.h"
+
+namespace nn {
+namespace vector {
+
+using namespace air::base;
+
+void BATCH_PACK::Run() {
+  FUNC_SCOPE* fscope = _cntr->Parent_func_scope();
+  NODE_PTR    entry  = _cntr->Entry_node();
+  if (entry->Num_child() < 2) return;
+
+  // batch size is the first dim of the first formal: [N, C, H, W]
+  TYPE_PTR formal_type = fscope->Formal(0)->Type();
+  if (!formal_type->Is_array()) return;
+  std::vector<int64_t> formal_shape = formal_type->Cast_to_arr()->Shape();
+  if (formal_shape.size() < 2 || formal_shape[0] <= 1) return;
+
+  _batch = formal_shape[0];
+  AIR_ASSERT_MSG(!_ctx.Rt_validate(),
+                 "runtime validate does not support batch=%d", (int)_batch);
+  _extent = formal_type->Cast_to_arr()->Elem_count() / _batch;
+
+  // 1. per-image extent: constant rows and local vectors
+  Collect(entry->Body_blk());
+  for (VAR_ITER it = fscope->Begin_var(); it != fscope->End_var(); ++it) {
+    TYPE_PTR type = (*it)->Type();
+    // array of vectors, like input_roll[i]
+    while (type->Is_array() && type->Cast_to_arr()->Elem_type()->Is_array()) {
+      type = type->Cast_to_arr()->Elem_type();
+    }
+    if (type->Is_array() && type->Cast_to_arr()->Elem_type()->Is_float()) {
+      _extent = std::max(_extent, (int64_t)type->Cast_to_arr()->Elem_count());
+    }
+  }
+
+  // 2. block covers extent and any roll, so images never overlap
+  _block = 1;
+  while (_block < _extent + _max_rot) _block <<= 1;
+  int64_t slots = _batch * _block;
+  // per-image lowering doesn't depend on rotation wrap-around as the slot
+  // count is selected later. Packed, data rolled out of an image vector
+  // must land in the zero gap of its own block, not in the next image.
+  for (const std::pair<int64_t, int64_t>& roll : _rolls) {
+    AIR_ASSERT_MSG(roll.first + roll.second <= _block,
+                   "roll %d of %d elements crosses batch block %d",
+                   (int)roll.second, (int)roll.first, (int)_block);
+  }
+  _ctx.Trace(TF_LOWER, "batch pack: batch=", _batch, ", extent=", _extent,
+             ", max_roll=", _max_rot, ", block=", _block, ", slots=", slots,
+             "\n");
+  AIR_ASSERT_MSG(slots <= MAX_BATCH_SLOTS,
+                 "batch=%d needs %d slots (block=%d) > %d", (int)_batch,
+                 (int)slots, (int)_block, (int)MAX_BATCH_SLOTS);
+
+  // 3. tile constant operands to all images
+  Pack(entry->Body_blk());
+
+  // 4. record layout for SIHE (msg length) and POLY2C (enc/dec scheme)
+  std::vector<int64_t> output_shape{_batch};
+  SIGNATURE_TYPE_PTR   sig =
+      fscope->Owning_func()->Entry_point()->Type()->Cast_to_sig();
+  for (PARAM_ITER it = sig->Begin_param(); it != sig->End_param(); ++it) {
+    if ((*it)->Is_ret() && (*it)->Type()->Is_array()) {
+      output_shape = (*it)->Type()->Cast_to_arr()->Shape();
+    }
+  }
+  NODE_PTR idname = entry->Child(0);
+  idname->Set_attr(ATTR_BATCH, &_batch, 1);
+  idname->Set_attr(ATTR_BATCH_BLOCK, &_block, 1);
+  idname->Set_attr(ATTR_BATCH_INPUT, formal_shape.data(), formal_shape.size());
+  idname->Set_attr(ATTR_BATCH_OUTPUT, output_shape.data(),
+                   output_shape.size());
+}
+
+bool BATCH_PACK::Is_vector_const(NODE_PTR node) const {
+  return node->Opcode() == air::core::OPC_LDC && node->Rtype()->Is_array() &&
+         node->Rtype()->Cast_to_arr()->Elem_type()->Is_float();
+}
+
+void BATCH_PACK::Record_row_len(CONSTANT_PTR cst, int64_t row_len) {
+  auto res = _row_len.insert({cst->Id().Value(), row_len});
+  AIR_ASSERT_MSG(res.first->second == row_len,
+                 "constant used with different row length %d != %d",
+                 (int)res.first->second, (int)row_len);
+  _extent = std::max(_extent, row_len);
+}
+
+void BATCH_PACK::Collect(NODE_PTR node) {
+  if (node->Is_block()) {
+    for (STMT_PTR stmt = node->Begin_stmt(); stmt != node->End_stmt();
+         stmt          = stmt->Next()) {
+      Collect(stmt->Node());
+    }
+    return;
+  }
+  if (node->Opcode() == OPC_SLICE && Is_vector_const(node->Child(0))) {
+    Record_row_len(node->Child(0)->Const(), node->Child(2)->Intconst());
+    Collect(node->Child(1));
+    return;
+  }
+  if (Is_vector_const(node)) {
+    Record_row_len(node->Const(), node->Rtype()->Cast_to_arr()->Elem_count());
+    return;
+  }
+  if (node->Opcode() == OPC_ROLL) {
+    uint32_t   count = 0;
+    const int* nums  = node->Attr<int>("nums", &count);
+    AIR_ASSERT_MSG(nums != nullptr, "roll without nums attribute");
+    // per-image length of rolled vector, dim[0] of a tensor is batch
+    TYPE_PTR type = node->Child(0)->Rtype();
+    int64_t  len  = 1;
+    if (type->Is_array()) {
+      std::vector<int64_t> shape = type->Cast_to_arr()->Shape();
+      len = type->Cast_to_arr()->Elem_count();
+      if (shape.size() > 1 && shape[0] == _batch) len /= _batch;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+      _max_rot = std::max(_max_rot, (int64_t)std::abs(nums[i]));
+      _rolls.push_back({len, std::abs(nums[i])});
+    }
+  }
+  for (uint32_t i = 0; i < node->Num_child(); ++i) {
+    Collect(node->Child(i));
+  }
+}
+
+NODE_PTR BATCH_PACK::Pack(NODE_PTR node) {
+  if (node->Is_block()) {
+    for (STMT_PTR stmt = node->Begin_stmt(); stmt != node->End_stmt();
+         stmt          = stmt->Next()) {
+      Pack(stmt->Node());
+    }
+    return node;
+  }
+  SPOS spos = node->Spos();
+  if (node->Opcode() == OPC_SLICE && Is_vector_const(node->Child(0))) {
+    NODE_PTR     cst_node = node->Child(0);
+    CONSTANT_PTR tiled =
+        Tile_const(cst_node->Const(), node->Child(2)->Intconst(), spos);
+    NODE_PTR     size  = _cntr->New_intconst(node->Child(2)->Rtype(),
+                                             _batch * _block, spos);
+    return VECTOR_GEN(_cntr).New_slice(_cntr->New_ldc(tiled, spos),
+                                       Pack(node->Child(1)), size, spos);
+  }
+  if (Is_vector_const(node)) {
+    CONSTANT_PTR tiled = Tile_const(
+        node->Const(), node->Rtype()->Cast_to_arr()->Elem_count(), spos);
+    return _cntr->New_ldc(tiled, spos);
+  }
+  for (uint32_t i = 0; i < node->Num_child(); ++i) {
+    NODE_PTR child     = node->Child(i);
+    NODE_PTR new_child = Pack(child);
+    if (new_child->Id() != child->Id()) {
+      node->Set_child(i, new_child);
+    }
+  }
+  return node;
+}
+
+CONSTANT_PTR BATCH_PACK::Tile_const(CONSTANT_PTR cst, int64_t row_len,
+                                    const SPOS& spos) {
+  auto it = _tiled.find(cst->Id().Value());
+  if (it != _tiled.end()) return it->second;
+
+  GLOB_SCOPE*    gscope = _cntr->Glob_scope();
+  ARRAY_TYPE_PTR type   = cst->Type()->Cast_to_arr();
+  int64_t        rows   = type->Elem_count() / row_len;
+  int64_t        slots  = _batch * _block;
+  AIR_ASSERT(rows * row_len == (int64_t)type->Elem_count());
+  std::vector<int64_t> shape{slots};
+  if (type->Shape().size() > 1) {
+    shape.insert(shape.begin(), rows);
+  }
+
+  // image b of row r is at [r*slots + b*block, r*slots + b*block + row_len)
+  TYPE_PTR     etype = type->Elem_type();
+  size_t       esz   = etype->Cast_to_prim()->Byte_size();
+  std::string  name  = std::string("batch_") + type->Name()->Char_str();
+  CONSTANT_PTR tiled = New_array_const(gscope, name, rows * slots, etype,
+                                       shape, nullptr, spos);
+  char*        dst   = tiled->Array_mutable_buffer();
+  const char*  src   = cst->Array_buffer();
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t b = 0; b < _batch; ++b) {
+      memcpy(dst + (r * slots + b * _block) * esz, src + r * row_len * esz,
+             row_len * esz);
+    }
+  }
+  _tiled.insert({cst->Id().Value(), tiled});
+  return tiled;
+}
+
+}  // namespace vector
+}  // namespace nn
@@ -8,7 +8,10 @@
 
 #include "nn/vector/tensor2vector_util.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <unordered_map>
 
 #include "air/core/opcode.h"
 #include "nn/core/opcode.h"
@@ -64,6 +67,103 @@ ADDR_DATUM_PTR TENSOR2VECTOR_UTIL::Gen_store_zero_to_var_stmt(
   return Gen_store_zero_to_var_stmt(var_name, arr_type, spos);
 }
 
+bool TENSOR2VECTOR_UTIL::Compact_weight_rows(NODE_PTR weight, int64_t num_grp,
+                                             int64_t      grp_size,
+                                             WEIGHT_ROWS& rows,
+                                             const SPOS&  spos) {
+  CONSTANT_PTR         cst   = weight->Const();
+  ARRAY_TYPE_PTR       type  = cst->Type()->Cast_to_arr();
+  std::vector<int64_t> shape = type->Shape();
+  AIR_ASSERT_MSG(shape.size() == 2 && shape[0] == num_grp * grp_size,
+                 "weight rows %d != %d*%d", (int)shape[0], (int)num_grp,
+                 (int)grp_size);
+  int64_t row_len = shape[1];
+
+  std::vector<int64_t> row_map;
+  Get_uniq_rows(cst, row_map);
+  std::vector<bool> grp_nz(num_grp, false);
+  std::vector<bool> mbr_nz(grp_size, false);
+  for (int64_t r = 0; r < shape[0]; r++) {
+    if (row_map[r] < 0) continue;
+    grp_nz[r / grp_size] = true;
+    mbr_nz[r % grp_size] = true;
+  }
+  rows._grp.clear();
+  rows._mbr.clear();
+  rows._row_map.clear();
+  for (int64_t g = 0; g < num_grp; g++) {
+    if (grp_nz[g]) rows._grp.push_back(g);
+  }
+  for (int64_t m = 0; m < grp_size; m++) {
+    if (mbr_nz[m]) rows._mbr.push_back(m);
+  }
+
+  // kept rows -> unique rows, -1 stands for the zero row
+  std::vector<int64_t>             uniq;
+  std::unordered_map<int64_t, int> uniq_idx;
+  for (int g : rows._grp) {
+    for (int m : rows._mbr) {
+      int64_t u  = row_map[g * grp_size + m];
+      auto    it = uniq_idx.find(u);
+      if (it == uniq_idx.end()) {
+        it = uniq_idx.insert({u, (int)uniq.size()}).first;
+        uniq.push_back(u);
+      }
+      rows._row_map.push_back(it->second);
+    }
+  }
+  int64_t num_zero =
+      std::count(row_map.begin(), row_map.end(), (int64_t)-1) -
+      std::count(uniq.begin(), uniq.end(), (int64_t)-1);
+  rows._num_zero = num_zero;
+  rows._num_dup  = shape[0] - uniq.size() - num_zero;
+  if (rows._grp.empty() || (int64_t)uniq.size() == shape[0]) {
+    return false;
+  }
+
+  std::vector<int64_t> uniq_shape{(int64_t)uniq.size(), row_len};
+  TYPE_PTR             etype  = type->Elem_type();
+  size_t               row_sz = row_len * etype->Cast_to_prim()->Byte_size();
+  rows._weight = New_array_const(_cntr->Glob_scope(), "weight_uniq",
+                                 _ctx.Get_num_vloop(), uniq.size() * row_len,
+                                 etype, uniq_shape, nullptr, spos);
+  char*       dst = rows._weight->Array_mutable_buffer();
+  const char* src = cst->Array_buffer();
+  for (size_t i = 0; i < uniq.size(); i++) {
+    if (uniq[i] >= 0) memcpy(dst + i * row_sz, src + uniq[i] * row_sz, row_sz);
+  }
+  return true;
+}
+
+void TENSOR2VECTOR_UTIL::Trace_sparse_weight(const char*        kernel,
+                                             const WEIGHT_ROWS& rows,
+                                             int64_t num_rows, int64_t row_len,
+                                             int64_t rot, int64_t mul) {
+  _ctx.Trace(TF_LOWER, "sparse weight ", kernel, "_n", _ctx.Get_num_vloop(),
+             ": rows=", num_rows, ", zero_rows=", rows._num_zero,
+             ", dup_rows=", rows._num_dup, ", eliminated rot=", rot,
+             ", mul=", mul, ", weight_bytes=",
+             (rows._num_zero + rows._num_dup) * row_len * sizeof(float), "\n");
+}
+
+NODE_PTR TENSOR2VECTOR_UTIL::New_ild_int_const(const char*             name,
+                                               const std::vector<int>& vals,
+                                               NODE_PTR idx, const SPOS& spos) {
+  GLOB_SCOPE*          gscope   = _cntr->Glob_scope();
+  CONST_TYPE_PTR       s32_type = gscope->Prim_type(PRIMITIVE_TYPE::INT_S32);
+  std::vector<int64_t> shape(1, vals.size());
+  TYPE_PTR     type = New_array_type(gscope, name, _ctx.Get_num_vloop(),
+                                     s32_type, shape, spos);
+  CONSTANT_PTR cst =
+      gscope->New_const(CONSTANT_KIND::ARRAY, type, (void*)vals.data(),
+                        sizeof(int) * vals.size());
+  _ctx.Trace_cmd(TF_LOWER, Trace_int_array, cst, name);
+  NODE_PTR array = _cntr->New_array(
+      _cntr->New_ldca(cst, POINTER_KIND::FLAT32, spos), 1, spos);
+  _cntr->Set_array_idx(array, 0, idx);
+  return _cntr->New_ild(array, spos);
+}
+
 NODE_PTR TENSOR2VECTOR_UTIL::Gen_dup_input_node(NODE_PTR input_node,
                                                 int64_t dup_num, int input_len,
                                                 const SPOS& spos) {
@@ -220,8 +320,42 @@ NODE_PTR TENSOR2VECTOR_UTIL::New_conv_metakernel(
   Gen_dup_input_stmt(input, dup_num, channel_in * output_height * output_width,
                      input_dup_var, spos);
 
+  // Drop kernel elements and input channels whose weight rows are all zero.
+  // input_dup is rolled by the distance to the next kept channel instead of
+  // h*w, so that skipped channels are never visited.
+  int              chw = output_height * output_width;
+  WEIGHT_ROWS      rows;
+  bool             sparse = Compact_weight_rows(weight, channel_in, kernel_hw,
+                                                rows, spos);
+  std::vector<int> cin_delta{chw};
+  if (sparse) {
+    std::vector<int> ra_used;
+    for (int m : rows._mbr) ra_used.push_back(ra[m]);
+    int64_t num_mul = ra_used.size() * rows._grp.size();
+    Trace_sparse_weight("conv", rows, channel_in * kernel_hw, weight_shape[1],
+                        channel_in * kernel_hw + channel_in -
+                            (num_mul + rows._grp.size()),
+                        channel_in * kernel_hw - num_mul);
+    ra        = ra_used;
+    kernel_hw = ra.size();
+    weight    = _cntr->New_ldc(rows._weight, spos);
+    cin_delta.clear();
+    for (size_t i = 1; i < rows._grp.size(); i++) {
+      cin_delta.push_back((rows._grp[i] - rows._grp[i - 1]) * chw);
+    }
+    cin_delta.push_back(chw);
+    if (rows._grp[0] > 0) {
+      std::vector<int> nums{rows._grp[0] * chw};
+      NODE_PTR         pre_roll =
+          New_roll(_cntr->New_ld(input_dup_var, spos),
+                   _cntr->New_intconst(s32_type, nums[0], spos), nums, spos);
+      _ctx.Prepend(_cntr->New_st(pre_roll, input_dup_var, spos));
+    }
+  }
+
   // Generate two-level LoopNest: level1 for channel_in, level2 for kernel_size
-  STMT_PTR  loop1_stmt = New_loop("index_cin", 0, channel_in, spos);
+  int       num_cin    = sparse ? rows._grp.size() : channel_in;
+  STMT_PTR  loop1_stmt = New_loop("index_cin", 0, num_cin, spos);
   STMT_LIST body1_sl =
       STMT_LIST::Enclosing_list(loop1_stmt->Node()->Child(3)->End_stmt());
 
@@ -262,6 +396,10 @@ NODE_PTR TENSOR2VECTOR_UTIL::New_conv_metakernel(
           air::core::OPCODE::MUL, _cntr->New_ld(loop1_stmt->Node()->Iv(), spos),
           _cntr->New_intconst(s32_type, kernel_hw, spos), spos),
       spos);
+  if (sparse) {
+    slice_index_node =
+        New_ild_int_const("row_map_int", rows._row_map, slice_index_node, spos);
+  }
 
   NODE_PTR weight_slice =
       New_slice(weight, slice_index_node,
@@ -276,12 +414,14 @@ NODE_PTR TENSOR2VECTOR_UTIL::New_conv_metakernel(
 
   body2_sl.Append(vadd_store);
 
-  // roll input h*w for each iteration
-  std::vector<int> vroll_cin_nums{output_height * output_width};
-  NODE_PTR         vroll_cin_node = New_roll(
-      _cntr->New_ld(input_dup_var, spos),
-      _cntr->New_intconst(s32_type, output_height * output_width, spos),
-      vroll_cin_nums, spos);
+  // roll input h*w (or to next kept channel) for each iteration
+  NODE_PTR cin_roll_num =
+      sparse ? New_ild_int_const("cin_delta_int", cin_delta,
+                                 _cntr->New_ld(loop1_stmt->Node()->Iv(), spos),
+                                 spos)
+             : _cntr->New_intconst(s32_type, chw, spos);
+  NODE_PTR vroll_cin_node = New_roll(_cntr->New_ld(input_dup_var, spos),
+                                     cin_roll_num, cin_delta, spos);
   STMT_PTR vroll_cin_st = _cntr->New_st(vroll_cin_node, input_dup_var, spos);
 
   body1_sl.Append(loop2_stmt);
@@ -362,6 +502,30 @@ NODE_PTR TENSOR2VECTOR_UTIL::New_conv_metakernel_fast(
   Gen_dup_input_stmt(input, dup_num, channel_in * output_height * output_width,
                      input_dup_var, spos);
 
+  // Drop kernel elements and input channels whose weight rows are all zero
+  // (padded channel, masked by stride/padding). From here on ra/kernel_hw
+  // only cover kept kernel elements and cin_ra holds kept channels' rolls.
+  WEIGHT_ROWS      rows;
+  bool             sparse = Compact_weight_rows(weight, channel_in, kernel_hw,
+                                                rows, spos);
+  std::vector<int> cin_ra;
+  for (int i = 0; i < channel_in; i++) {
+    if (!sparse || std::count(rows._grp.begin(), rows._grp.end(), i)) {
+      cin_ra.push_back(i * output_height * output_width);
+    }
+  }
+  if (sparse) {
+    std::vector<int> ra_used;
+    for (int m : rows._mbr) ra_used.push_back(ra[m]);
+    Trace_sparse_weight(
+        "conv", rows, channel_in * kernel_hw, weight_shape[1],
+        (kernel_hw + channel_in) - (ra_used.size() + cin_ra.size()),
+        channel_in * kernel_hw - ra_used.size() * cin_ra.size());
+    ra        = ra_used;
+    kernel_hw = ra.size();
+    weight    = _cntr->New_ldc(rows._weight, spos);
+  }
+
   // Generate roll loop
   // loop i 0:ra.size: input_roll[i] = roll(input_dup, ra[i]);
   STMT_PTR  loop_roll_stmt = New_loop("index_khw1", 0, kernel_hw, spos);
@@ -405,7 +569,7 @@ NODE_PTR TENSOR2VECTOR_UTIL::New_conv_metakernel_fast(
   _ctx.Prepend(loop_roll_stmt);
 
   // Generate two-level LoopNest: level1 for channel_in, level2 for kernel_size
-  STMT_PTR  loop1_stmt = New_loop("index_cin", 0, channel_in, spos);
+  STMT_PTR  loop1_stmt = New_loop("index_cin", 0, cin_ra.size(), spos);
   STMT_LIST body1_sl =
       STMT_LIST::Enclosing_list(loop1_stmt->Node()->Child(3)->End_stmt());
 
@@ -425,6 +589,11 @@ NODE_PTR TENSOR2VECTOR_UTIL::New_conv_metakernel_fast(
           air::core::OPCODE::MUL, _cntr->New_ld(loop1_stmt->Node()->Iv(), spos),
           _cntr->New_intconst(s32_type, kernel_hw, spos), spos),
       spos);
+  if (sparse) {
+    // kept rows are mapped to unique rows of the compacted weight
+    slice_index_node =
+        New_ild_int_const("row_map_int", rows._row_map, slice_index_node, spos);
+  }
 
   NODE_PTR weight_slice =
       New_slice(weight, slice_index_node,
@@ -457,16 +626,18 @@ NODE_PTR TENSOR2VECTOR_UTIL::New_conv_metakernel_fast(
         Gen_dup_input_node(_cntr->New_ld(result_cin_var, spos), 2,
                            channel_out * output_height * output_width, spos);
   }
-  std::vector<int> roll_num_left;
-  for (int i = 0; i < channel_in; i++)
-    roll_num_left.push_back(i * output_height * output_width);
-  NODE_PTR cin_roll_node2 = New_roll(
-      cin_add_node,
-      _cntr->New_bin_arith(
-          air::core::OPCODE::MUL, _cntr->New_ld(loop1_stmt->Node()->Iv(), spos),
-          _cntr->New_intconst(s32_type, output_height * output_width, spos),
-          spos),
-      roll_num_left, spos);
+  NODE_PTR cin_ra_node;
+  if (sparse) {
+    cin_ra_node = New_ild_int_const(
+        "cin_ra_int", cin_ra, _cntr->New_ld(loop1_stmt->Node()->Iv(), spos),
+        spos);
+  } else {
+    cin_ra_node = _cntr->New_bin_arith(
+        air::core::OPCODE::MUL, _cntr->New_ld(loop1_stmt->Node()->Iv(), spos),
+        _cntr->New_intconst(s32_type, output_height * output_width, spos),
+        spos);
+  }
+  NODE_PTR cin_roll_node2 = New_roll(cin_add_node, cin_ra_node, cin_ra, spos);
   NODE_PTR cin_add_node2 =
       New_add(_cntr->New_ld(result_var, spos), cin_roll_node2, spos);
   STMT_PTR cin_add_st = _cntr->New_st(cin_add_node2, result_var, spos);
@@ -492,18 +663,28 @@ NODE_PTR TENSOR2VECTOR_UTIL::New_conv_metakernel_fast(
 }
 
 /**
- * @brief Generate gemm metakernel which can be templated into conv2d and gemm
- * in Tensor IR.
- * TODO: params for template; metakernel as a funciton.
+ * @brief Generate gemm metakernel with baby-step giant-step (BSGS) diagonal
+ * method for weight of any shape.
+ *
+ * y = W * x, W is height x width. nd = min(height, width) extended diagonals
+ * of len elements are used, with input x replicated by period:
+ *  - height <= width: period = len = padw (multiple of height >= width),
+ *    output is the sum of padw/height blocks of height elements.
+ *  - height > width: period = width, len = height.
+ * diag_i[j] = W[j % height][(j + i) % period], 0 if the column is padding.
+ * Diagonal i = g*h1 + b is pre-shifted by g*h1 to get
+ *   tmp = sum_g roll(sum_b diag'_i * roll(input_rep, b), g*h1)
+ * The vector is long enough that valid data never wraps around, so the
+ * result does not depend on the number of slots. All-zero diagonals are
+ * skipped, and so are baby/giant steps only used by them.
  *
- * @param weight_diag is ldc const weight after rotating
+ * @param weight is the gemm weight (height x width)
  * @param bias is ldc const bias
  */
-NODE_PTR TENSOR2VECTOR_UTIL::New_gemm_metakernel_fast(NODE_PTR    input,
-                                                      NODE_PTR    weight_diag,
-                                                      NODE_PTR    bias,
-                                                      const SPOS& spos,
-                                                      bool        tiling) {
+NODE_PTR TENSOR2VECTOR_UTIL::New_gemm_metakernel_fast(NODE_PTR     input,
+                                                      const FPMAT& weight,
+                                                      NODE_PTR     bias,
+                                                      const SPOS&  spos) {
   _ctx.Incr_num_vloop();
   GLOB_SCOPE* gscope = _cntr->Glob_scope();
   FUNC_SCOPE* fscope = _cntr->Parent_func_scope();
@@ -511,261 +692,256 @@ NODE_PTR TENSOR2VECTOR_UTIL::New_gemm_metakernel_fast(NODE_PTR    input,
   // Get and check input type
   ARRAY_TYPE_PTR       input_type  = input->Rtype()->Cast_to_arr();
   std::vector<int64_t> input_shape = input_type->Shape();
-  AIR_ASSERT_MSG(((input_shape.size() == 2) && (input_shape[0] == 1)) ||
-                     (input_shape.size() == 1),
+  // dim[0] of 2D input is batch, each image is lowered as 1D vector
+  AIR_ASSERT_MSG((input_shape.size() == 2) || (input_shape.size() == 1),
                  "input: shape=%d dim[0]=%d. 2D input GEMM is work in progress",
                  input_shape.size(), input_shape[0]);
 
-  // Get and check weight_diag type
-  ARRAY_TYPE_PTR       weight_diag_type  = weight_diag->Rtype()->Cast_to_arr();
-  std::vector<int64_t> weight_diag_shape = weight_diag_type->Shape();
-  AIR_ASSERT_MSG(weight_diag_shape.size() == 2,
-                 "weight_diag_type dim is not 2");
-  int64_t              height = weight_diag_shape[0];
-  int64_t              width  = weight_diag_shape[1];
-  std::vector<int64_t> shape(1, width);
-
-  _ctx.Trace(TF_LOWER, "New_gemm_metakernel_fast input shape: ",
-             (input_shape.size() == 2) ? input_shape[1] : input_shape[0],
-             ", weight_diag shape: ", height, "x", width, ", tiling:", tiling,
-             "\n");
-  _ctx.Trace_cmd(TF_LOWER, Trace_float_array, weight_diag->Const(),
-                 "gemm weight_diag_fast");
-
-  TYPE_PTR vtype = New_array_type(gscope, "gemm_width", _ctx.Get_num_vloop(),
+  int64_t height = weight.size();
+  int64_t width  = weight[0].size();
+
+  // 1. layout of diagonals and replicated input
+  int64_t num_diag, len, period, num_block;
+  if (height <= width) {
+    period    = (width + height - 1) / height * height;
+    len       = period;
+    num_diag  = height;
+    num_block = period / height;
+  } else {
+    period    = width;
+    len       = height;
+    num_diag  = width;
+    num_block = 1;
+  }
+  int64_t num_copy = 1;
+  while (num_copy * period < len + num_diag) num_copy <<= 1;
+  int64_t vlen = num_copy * period;
+  int     h1   = (int)ceil(sqrt(num_diag));
+  int     h2   = (num_diag + h1 - 1) / h1;
+  AIR_ASSERT_MSG(vlen <= 32768,
+                 "gemm %dx%d needs vector length %d > 32768, current FHE "
+                 "implement's N max is 65536",
+                 (int)height, (int)width, (int)vlen);
+
+  // 2. non-zero diagonals, diagonal g*h1+b is shifted by g*h1
+  FPVEC                            diag_vec;
+  std::vector<int>                 baby_slot;  // input_roll index of diag
+  std::vector<int>                 baby_ra;    // used baby steps
+  std::vector<int>                 baby_map(h1, -1);
+  std::vector<std::pair<int, int>> giant;  // (g, num of non-zero diag)
+  int                              num_zero = 0;
+  for (int g = 0; g < h2; g++) {
+    int num_nz = 0;
+    for (int b = 0; b < h1 && g * h1 + b < num_diag; b++) {
+      int   i = g * h1 + b;
+      FPVEC diag(vlen, 0.0);
+      bool  is_zero = true;
+      for (int64_t j = 0; j < len; j++) {
+        int64_t col = (j + i) % period;
+        if (col >= width || weight[j % height][col] == 0.0) continue;
+        diag[j + g * h1] = weight[j % height][col];
+        is_zero          = false;
+      }
+      if (is_zero) {
+        num_zero++;
+        continue;
+      }
+      if (baby_map[b] < 0) {
+        baby_map[b] = baby_ra.size();
+        baby_ra.push_back(b);
+      }
+      baby_slot.push_back(baby_map[b]);
+      diag_vec.insert(diag_vec.end(), diag.begin(), diag.end());
+      num_nz++;
+    }
+    if (num_nz > 0) giant.push_back(std::make_pair(g, num_nz));
+  }
+
+  int num_block_add = (int)ceil(log2(num_block));
+  int num_rep_roll  = (int)log2(num_copy);
+  int num_baby_roll = baby_ra.size() - (baby_map[0] >= 0 ? 1 : 0);
+  int num_giant_roll =
+      giant.size() - ((!giant.empty() && giant[0].first == 0) ? 1 : 0);
+  _ctx.Trace(TF_LOWER, "New_gemm_metakernel_fast weight: ", height, "x",
+             width, ", period=", period, ", len=", len, ", vlen=", vlen,
+             ", h1=", h1, ", h2=", h2, "\n");
+  _ctx.Trace(TF_LOWER, "gemm bsgs: diag=", num_diag,
+             ", nonzero_diag=", baby_slot.size(), ", zero_diag=", num_zero,
+             ", rotations: replicate=", num_rep_roll,
+             ", baby=", num_baby_roll, ", giant=", num_giant_roll,
+             ", block_add=", num_block_add, ", total=",
+             num_rep_roll + num_baby_roll + num_giant_roll + num_block_add,
+             ", pt_mul=", baby_slot.size(), "\n");
+
+  CONST_TYPE_PTR       s32_type = gscope->Prim_type(PRIMITIVE_TYPE::INT_S32);
+  std::vector<int64_t> shape(1, vlen);
+  TYPE_PTR vtype = New_array_type(gscope, "gemm_bsgs", _ctx.Get_num_vloop(),
                                   input_type->Elem_type(), shape, spos);
 
   // VECTOR tmp_result = 0
   ADDR_DATUM_PTR tmp_result =
       Gen_store_zero_to_var_stmt("tmp_result_n", vtype, spos);
 
-  std::string    tmp_block_str = (std::string("tmp_block_result_n") +
-                               std::to_string(_ctx.Get_num_vloop()));
-  ADDR_DATUM_PTR tmp_block_result =
-      fscope->New_var(vtype, tmp_block_str.c_str(), spos);
-
-  std::string dup_str =
-      (std::string("input_dup_n") + std::to_string(_ctx.Get_num_vloop()));
-  ADDR_DATUM_PTR input_dup_var = fscope->New_var(vtype, dup_str.c_str(), spos);
-
-  CONST_TYPE_PTR s32_type = gscope->Prim_type(PRIMITIVE_TYPE::INT_S32);
-
-  // input_dup = input + roll(input, -width). fast: height is width
-  NODE_PTR input_dup    = input;
-  NODE_PTR add_dup_node = input;
-
-  // TODO: will change to use log version Gen_dup_input_node later.
-  if (tiling) {
-    _ctx.Trace(TF_LOWER, "Input replication: num=", width / height, "\n");
-    for (int i = 1; i <= (int)log2(width / height); i++) {
-      std::vector<int> roll_num{-(1 << (i - 1)) * (int)height};
-      NODE_PTR         tmp_roll_node = New_roll(
-          input_dup,
-          _cntr->New_intconst(s32_type, -(1 << (i - 1)) * height, spos),
-          roll_num, spos);
-      add_dup_node = New_add(input_dup, tmp_roll_node, spos);
-      add_dup_node->Set_rtype(vtype);
-      input_dup = add_dup_node;
+  if (!giant.empty()) {
+    // 3. input_rep = input; input_rep += roll(input_rep, -k*period)
+    std::string rep_str =
+        std::string("input_rep_n") + std::to_string(_ctx.Get_num_vloop());
+    ADDR_DATUM_PTR input_rep_var =
+        fscope->New_var(vtype, rep_str.c_str(), spos);
+    _ctx.Prepend(_cntr->New_st(input, input_rep_var, spos));
+    for (int64_t k = 1; k < num_copy; k <<= 1) {
+      std::vector<int> roll_num{(int)(-k * period)};
+      NODE_PTR         roll_node = New_roll(
+          _cntr->New_ld(input_rep_var, spos),
+          _cntr->New_intconst(s32_type, -k * period, spos), roll_num, spos);
+      NODE_PTR add_node =
+          New_add(_cntr->New_ld(input_rep_var, spos), roll_node, spos);
+      _ctx.Prepend(_cntr->New_st(add_node, input_rep_var, spos));
     }
-  }
-
-  STMT_PTR input_dup_stmt = _cntr->New_st(add_dup_node, input_dup_var, spos);
-  _ctx.Prepend(input_dup_stmt);
-
-  // height = h1*h2, h1 for block size.
-  int h1 = 0, h2 = 0;
-  Get_block_size(height, h1, h2);
-  _ctx.Trace(TF_LOWER, "Get_block_size: h1=", h1, ", h2=", h2, "\n");
-
-  // loop i 0:h1: input_roll[i] = roll(input_dup, i);
-  STMT_PTR  loop_roll_stmt = New_loop("index_h1", 0, h1, spos);
-  STMT_LIST body_roll_sl =
-      STMT_LIST::Enclosing_list(loop_roll_stmt->Node()->Child(3)->End_stmt());
-
-  // Build input_roll[i] with array of array: [[vector0],[vector1]...]
-  std::vector<int64_t> ra_shape(1, h1);
-
-  TYPE_PTR input_vvtype =
-      New_array_type(gscope, "type_input_roll_vv_n", _ctx.Get_num_vloop(),
-                     vtype, ra_shape, spos);
-  std::string input_roll_str =
-      (std::string("input_roll_n") + std::to_string(_ctx.Get_num_vloop()));
-  ADDR_DATUM_PTR input_roll_var =
-      fscope->New_var(input_vvtype, input_roll_str.c_str(), spos);
-
-  NODE_PTR input_array = _cntr->New_array(
-      _cntr->New_lda(input_roll_var, POINTER_KIND::FLAT32, spos), 1, spos);
-  _cntr->Set_array_idx(input_array, 0,
-                       _cntr->New_ld(loop_roll_stmt->Node()->Iv(), spos));
-
-  // input_roll[i] = ROLL(input_dup, ra[i])
-  std::vector<int> ra;
-  for (int i = 0; i < h1; i++) ra.push_back(i);
-  NODE_PTR pre_roll_node =
-      New_roll(_cntr->New_ld(input_dup_var, spos),
-               _cntr->New_ld(loop_roll_stmt->Node()->Iv(), spos), ra, spos);
-  STMT_PTR pre_roll_st = _cntr->New_ist(input_array, pre_roll_node, spos);
-  body_roll_sl.Append(pre_roll_st);
-  _ctx.Prepend(loop_roll_stmt);
-
-  // Generate a loop-nest(h2-h1) for GEMM.
-  STMT_PTR  loop_stmt_h2 = New_loop("index_nest_h2", 0, h2, spos);
-  STMT_LIST body_sl_h2 =
-      STMT_LIST::Enclosing_list(loop_stmt_h2->Node()->Child(3)->End_stmt());
-
-  STMT_PTR  loop_stmt_h1 = New_loop("index_nest_h1", 0, h1, spos);
-  STMT_LIST body_sl_h1 =
-      STMT_LIST::Enclosing_list(loop_stmt_h1->Node()->Child(3)->End_stmt());
-
-  // tmp_block_result = 0
-  NODE_PTR vzero_block_node = _cntr->New_zero(vtype, spos);
-  STMT_PTR st0_block_stmt =
-      _cntr->New_st(vzero_block_node, tmp_block_result, spos);
-  body_sl_h2.Append(st0_block_stmt);
-
-  // tmp_block_result += input_roll[i1] * weight_diag[i2*h1+i1]
-  NODE_PTR slice_index_node = _cntr->New_bin_arith(
-      air::core::OPCODE::ADD, _cntr->New_ld(loop_stmt_h1->Node()->Iv(), spos),
-      _cntr->New_bin_arith(air::core::OPCODE::MUL,
-                           _cntr->New_ld(loop_stmt_h2->Node()->Iv(), spos),
-                           _cntr->New_intconst(s32_type, h1, spos), spos),
-      spos);
-
-  NODE_PTR weight_slice =
-      New_slice(weight_diag, slice_index_node,
-                _cntr->New_intconst(s32_type, width, spos), spos);
 
-  NODE_PTR input_array2 = _cntr->New_array(
-      _cntr->New_lda(input_roll_var, POINTER_KIND::FLAT32, spos), 1, spos);
-  _cntr->Set_array_idx(input_array2, 0,
-                       _cntr->New_ld(loop_stmt_h1->Node()->Iv(), spos));
-  NODE_PTR ild_input = _cntr->New_ild(input_array2, spos);
+    // 4. baby steps: input_roll[k] = roll(input_rep, baby_ra[k])
+    std::vector<int64_t> baby_shape(1, baby_ra.size());
+    TYPE_PTR input_vvtype = New_array_type(gscope, "type_input_roll_vv_n",
+                                           _ctx.Get_num_vloop(), vtype,
+                                           baby_shape, spos);
+    std::string input_roll_str =
+        std::string("input_roll_n") + std::to_string(_ctx.Get_num_vloop());
+    ADDR_DATUM_PTR input_roll_var =
+        fscope->New_var(input_vvtype, input_roll_str.c_str(), spos);
+
+    STMT_PTR  loop_baby_stmt = New_loop("index_baby", 0, baby_ra.size(), spos);
+    STMT_LIST body_baby_sl   = STMT_LIST::Enclosing_list(
+        loop_baby_stmt->Node()->Child(3)->End_stmt());
+    TYPE_PTR     ra_type  = New_array_type(gscope, "baby_ra_int",
+                                           _ctx.Get_num_vloop(), s32_type,
+                                           baby_shape, spos);
+    CONSTANT_PTR ra_const = gscope->New_const(
+        CONSTANT_KIND::ARRAY, ra_type, (void*)(baby_ra.data()),
+        sizeof(int) * baby_ra.size());
+    NODE_PTR ra_array = _cntr->New_array(
+        _cntr->New_ldca(ra_const, POINTER_KIND::FLAT32, spos), 1, spos);
+    _cntr->Set_array_idx(ra_array, 0,
+                         _cntr->New_ld(loop_baby_stmt->Node()->Iv(), spos));
+    NODE_PTR input_array = _cntr->New_array(
+        _cntr->New_lda(input_roll_var, POINTER_KIND::FLAT32, spos), 1, spos);
+    _cntr->Set_array_idx(input_array, 0,
+                         _cntr->New_ld(loop_baby_stmt->Node()->Iv(), spos));
+    NODE_PTR baby_roll_node = New_roll(_cntr->New_ld(input_rep_var, spos),
+                                       _cntr->New_ild(ra_array, spos), baby_ra,
+                                       spos);
+    body_baby_sl.Append(_cntr->New_ist(input_array, baby_roll_node, spos));
+    _ctx.Prepend(loop_baby_stmt);
+
+    // 5. giant steps:
+    //    tmp_block = sum_k input_roll[slot[ofst+k]] * weight_diag[ofst+k]
+    //    tmp_result += roll(tmp_block, g*h1)
+    std::vector<int64_t> diag_shape{(int64_t)baby_slot.size(), vlen};
+    CONSTANT_PTR         diag_const = New_array_const(
+        gscope, "weight_diag", _ctx.Get_num_vloop(), diag_vec.size(),
+        input_type->Elem_type(), diag_shape, (void*)diag_vec.data(), spos);
+    NODE_PTR weight_diag = _cntr->New_ldc(diag_const, spos);
+    _ctx.Trace_cmd(TF_LOWER, Trace_float_array, diag_const,
+                   "gemm weight_diag_fast");
+
+    // duplicated diagonals share one row of weight_diag
+    WEIGHT_ROWS rows;
+    bool        dedup =
+        Compact_weight_rows(weight_diag, 1, baby_slot.size(), rows, spos);
+    if (dedup) weight_diag = _cntr->New_ldc(rows._weight, spos);
+    rows._num_zero = num_zero;
+    if (dedup || num_zero > 0) {
+      Trace_sparse_weight("gemm", rows, num_diag, vlen,
+                          (h1 - baby_ra.size()) + (h2 - giant.size()),
+                          num_zero);
+    }
 
-  NODE_PTR vmul_node = New_mul(ild_input, weight_slice, spos);
-  NODE_PTR vadd_node =
-      New_add(_cntr->New_ld(tmp_block_result, spos), vmul_node, spos);
-  STMT_PTR vadd_store = _cntr->New_st(vadd_node, tmp_block_result, spos);
-
-  body_sl_h1.Append(vadd_store);
-
-  // merge block: tmp_result += roll(tmp_block_result, i2*h1)
-  STMT_PTR vadd_store2;
-  if (tiling) {
-    // mask1 and mask2: size h2
-    int64_t old_height = width;
-
-    FPVEC mask1_vec, mask2_vec;
-    for (int k = 0; k < h2; k++) {
-      FPVEC mask1(width, 0.0);
-      FPVEC mask2(width, 1.0);
-      for (size_t i = 0; i < width / height; i++) {
-        for (size_t j = 0; j < height; j++) {
-          if (j < (size_t)k * h1) {
-            mask1[i * height + j] = 1.0;
-            mask2[i * height + j] = 0.0;
-          }
-        }
+    std::vector<int64_t> slot_shape(1, baby_slot.size());
+    TYPE_PTR     slot_type  = New_array_type(gscope, "baby_slot_int",
+                                             _ctx.Get_num_vloop(), s32_type,
+                                             slot_shape, spos);
+    CONSTANT_PTR slot_const = gscope->New_const(
+        CONSTANT_KIND::ARRAY, slot_type, (void*)(baby_slot.data()),
+        sizeof(int) * baby_slot.size());
+
+    std::string    tmp_block_str = (std::string("tmp_block_result_n") +
+                                 std::to_string(_ctx.Get_num_vloop()));
+    ADDR_DATUM_PTR tmp_block_result =
+        fscope->New_var(vtype, tmp_block_str.c_str(), spos);
+
+    int ofst = 0;
+    for (auto& step : giant) {
+      int g      = step.first;
+      int num_nz = step.second;
+
+      // tmp_block_result = 0
+      _ctx.Prepend(_cntr->New_st(_cntr->New_zero(vtype, spos),
+                                 tmp_block_result, spos));
+
+      std::string loop_str  = std::string("index_giant") + std::to_string(g);
+      STMT_PTR    loop_stmt = New_loop(loop_str.c_str(), 0, num_nz, spos);
+      STMT_LIST   body_sl   = STMT_LIST::Enclosing_list(
+          loop_stmt->Node()->Child(3)->End_stmt());
+      NODE_PTR diag_idx = _cntr->New_bin_arith(
+          air::core::OPCODE::ADD, _cntr->New_ld(loop_stmt->Node()->Iv(), spos),
+          _cntr->New_intconst(s32_type, ofst, spos), spos);
+      NODE_PTR slot_array = _cntr->New_array(
+          _cntr->New_ldca(slot_const, POINTER_KIND::FLAT32, spos), 1, spos);
+      _cntr->Set_array_idx(slot_array, 0, diag_idx);
+      NODE_PTR input_array2 = _cntr->New_array(
+          _cntr->New_lda(input_roll_var, POINTER_KIND::FLAT32, spos), 1, spos);
+      _cntr->Set_array_idx(input_array2, 0, _cntr->New_ild(slot_array, spos));
+      NODE_PTR row_idx = _cntr->Clone_node_tree(diag_idx);
+      if (dedup) {
+        row_idx = New_ild_int_const("row_map_int", rows._row_map, row_idx,
+                                    spos);
+      }
+      NODE_PTR weight_slice = New_slice(
+          weight_diag, row_idx, _cntr->New_intconst(s32_type, vlen, spos),
+          spos);
+      NODE_PTR vmul_node =
+          New_mul(_cntr->New_ild(input_array2, spos), weight_slice, spos);
+      NODE_PTR vadd_node =
+          New_add(_cntr->New_ld(tmp_block_result, spos), vmul_node, spos);
+      body_sl.Append(_cntr->New_st(vadd_node, tmp_block_result, spos));
+      _ctx.Prepend(loop_stmt);
+
+      NODE_PTR block_node = _cntr->New_ld(tmp_block_result, spos);
+      if (g > 0) {
+        std::vector<int> roll_num{g * h1};
+        block_node = New_roll(block_node,
+                              _cntr->New_intconst(s32_type, g * h1, spos),
+                              roll_num, spos);
       }
-      mask1_vec = mask1_vec + mask1;
-      mask2_vec = mask2_vec + mask2;
+      NODE_PTR vadd_node2 =
+          New_add(_cntr->New_ld(tmp_result, spos), block_node, spos);
+      _ctx.Prepend(_cntr->New_st(vadd_node2, tmp_result, spos));
+      ofst += num_nz;
     }
 
-    std::vector<int64_t> mask_shape{h2, width};
-    CONSTANT_PTR         mask1_const =
-        New_array_const(gscope, "mask1", h2 * width, input_type->Elem_type(),
-                        mask_shape, (void*)mask1_vec.data(), spos);
-
-    NODE_PTR mask1_slice =
-        New_slice(_cntr->New_ldc(mask1_const, spos),
-                  _cntr->New_ld(loop_stmt_h2->Node()->Iv(), spos),
-                  _cntr->New_intconst(s32_type, width, spos), spos);
-
-    CONSTANT_PTR mask2_const =
-        New_array_const(gscope, "mask2", h2 * width, input_type->Elem_type(),
-                        mask_shape, (void*)mask2_vec.data(), spos);
-
-    NODE_PTR mask2_slice =
-        New_slice(_cntr->New_ldc(mask2_const, spos),
-                  _cntr->New_ld(loop_stmt_h2->Node()->Iv(), spos),
-                  _cntr->New_intconst(s32_type, width, spos), spos);
-
-    NODE_PTR block_mask_node1 =
-        New_mul(_cntr->New_ld(tmp_block_result, spos), mask1_slice, spos);
-    std::vector<int> roll_num_left1;
-    for (int i = 0; i < h2; i++) roll_num_left1.push_back(i * h1 - height);
-    // k*h1-h
-    NODE_PTR block_roll_node1 =
-        New_roll(block_mask_node1,
-                 _cntr->New_bin_arith(
-                     air::core::OPCODE::SUB,
-                     _cntr->New_bin_arith(
-                         air::core::OPCODE::MUL,
-                         _cntr->New_ld(loop_stmt_h2->Node()->Iv(), spos),
-                         _cntr->New_intconst(s32_type, h1, spos), spos),
-                     _cntr->New_intconst(s32_type, height, spos), spos),
-                 roll_num_left1, spos);
-
-    NODE_PTR block_mask_node2 =
-        New_mul(_cntr->New_ld(tmp_block_result, spos), mask2_slice, spos);
-    std::vector<int> roll_num_left2;
-    for (int i = 0; i < h2; i++) roll_num_left2.push_back(i * h1);
-    // k*h1
-    NODE_PTR block_roll_node2 = New_roll(
-        block_mask_node2,
-        _cntr->New_bin_arith(air::core::OPCODE::MUL,
-                             _cntr->New_ld(loop_stmt_h2->Node()->Iv(), spos),
-                             _cntr->New_intconst(s32_type, h1, spos), spos),
-        roll_num_left2, spos);
-
-    NODE_PTR vadd_node2 =
-        New_add(_cntr->New_ld(tmp_result, spos),
-                New_add(block_roll_node1, block_roll_node2, spos), spos);
-    vadd_store2 = _cntr->New_st(vadd_node2, tmp_result, spos);
-  } else {
-    std::vector<int> roll_num_left;
-    for (int i = 0; i < h2; i++) roll_num_left.push_back(i * h1);
-    NODE_PTR block_roll_node = New_roll(
-        _cntr->New_ld(tmp_block_result, spos),
-        _cntr->New_bin_arith(air::core::OPCODE::MUL,
-                             _cntr->New_ld(loop_stmt_h2->Node()->Iv(), spos),
-                             _cntr->New_intconst(s32_type, h1, spos), spos),
-        roll_num_left, spos);
-    NODE_PTR vadd_node2 =
-        New_add(_cntr->New_ld(tmp_result, spos), block_roll_node, spos);
-    vadd_store2 = _cntr->New_st(vadd_node2, tmp_result, spos);
-  }
-
-  body_sl_h2.Append(loop_stmt_h1);
-  body_sl_h2.Append(vadd_store2);
-  _ctx.Prepend(loop_stmt_h2);
-
-  if (!tiling) {
-    _ctx.Trace(TF_LOWER,
-               "tiling=0: block add=", (int)ceil(log2(width / height)), "\n");
-    // Generate a loop for block add.
-    STMT_PTR loop_blockadd_stmt =
-        New_loop("index_add", 0, (int)ceil(log2(width / height)), spos);
-    STMT_LIST body_blockadd_sl = STMT_LIST::Enclosing_list(
-        loop_blockadd_stmt->Node()->Child(3)->End_stmt());
-    // input_roll = ROLL(tmp_result, (1<<iv)*height)
-    NODE_PTR shl_node = _cntr->New_bin_arith(
-        air::base::OPCODE(air::core::CORE, air::core::OPCODE::SHL),
-        _cntr->New_intconst(s32_type, 1, spos),
-        _cntr->New_ld(loop_blockadd_stmt->Node()->Iv(), spos), spos);
-    NODE_PTR mul_node =
-        _cntr->New_bin_arith(air::core::OPCODE::MUL, shl_node,
-                             _cntr->New_intconst(s32_type, height, spos), spos);
-    std::vector<int> roll_num_block;
-    for (int i = 0; i < log2(width / height); i++) {
-      roll_num_block.push_back((1U << i) * height);
+    // 6. sum blocks of height: tmp_result += roll(tmp_result, (1<<i)*height)
+    if (num_block_add > 0) {
+      STMT_PTR  loop_blockadd_stmt = New_loop("index_add", 0, num_block_add,
+                                              spos);
+      STMT_LIST body_blockadd_sl   = STMT_LIST::Enclosing_list(
+          loop_blockadd_stmt->Node()->Child(3)->End_stmt());
+      NODE_PTR shl_node = _cntr->New_bin_arith(
+          air::base::OPCODE(air::core::CORE, air::core::OPCODE::SHL),
+          _cntr->New_intconst(s32_type, 1, spos),
+          _cntr->New_ld(loop_blockadd_stmt->Node()->Iv(), spos), spos);
+      NODE_PTR mul_node = _cntr->New_bin_arith(
+          air::core::OPCODE::MUL, shl_node,
+          _cntr->New_intconst(s32_type, height, spos), spos);
+      std::vector<int> roll_num_block;
+      for (int i = 0; i < num_block_add; i++) {
+        roll_num_block.push_back((1U << i) * height);
+      }
+      NODE_PTR vroll_result_node = New_roll(_cntr->New_ld(tmp_result, spos),
+                                            mul_node, roll_num_block, spos);
+      NODE_PTR vadd1_node =
+          New_add(_cntr->New_ld(tmp_result, spos), vroll_result_node, spos);
+      body_blockadd_sl.Append(_cntr->New_st(vadd1_node, tmp_result, spos));
+      _ctx.Prepend(loop_blockadd_stmt);
     }
-    NODE_PTR vroll_result_node = New_roll(_cntr->New_ld(tmp_result, spos),
-                                          mul_node, roll_num_block, spos);
-    NODE_PTR vadd1_node =
-        New_add(_cntr->New_ld(tmp_result, spos), vroll_result_node, spos);
-    STMT_PTR vadd1_store = _cntr->New_st(vadd1_node, tmp_result, spos);
-    body_blockadd_sl.Append(vadd1_store);
-    _ctx.Prepend(loop_blockadd_stmt);
   }
 
   // +C
@@ -774,8 +950,7 @@ NODE_PTR TENSOR2VECTOR_UTIL::New_gemm_metakernel_fast(NODE_PTR    input,
   _ctx.Prepend(vaddc_stmt);
 
   // TODO: clean 0. suggest in FHE IR Level together with roll.
-  Gen_clear_data_stmt(tmp_result, tiling ? width : height,
-                      input_type->Elem_type(), spos);
+  Gen_clear_data_stmt(tmp_result, height, input_type->Elem_type(), spos);
 
   NODE_PTR ld_result = _cntr->New_ld(tmp_result, spos);
 
@@ -802,8 +977,8 @@ NODE_PTR TENSOR2VECTOR_UTIL::New_gemm_metakernel(NODE_PTR op0, NODE_PTR op1,
   ARRAY_TYPE_PTR op0_ty_arr = op0->Rtype()->Cast_to_arr();
 
   std::vector<int64_t> op0_shape = op0_ty_arr->Shape();
-  AIR_ASSERT_MSG(((op0_shape.size() == 2) && (op0_shape[0] == 1)) ||
-                     (op0_shape.size() == 1),
+  // dim[0] of 2D op0 is batch, each image is lowered as 1D vector
+  AIR_ASSERT_MSG((op0_shape.size() == 2) || (op0_shape.size() == 1),
                  "op0: shape=%d dim[0]=%d. 2D is work in progress",
                  op0_shape.size(), op0_shape[0]);
 
@@ -840,22 +1015,41 @@ NODE_PTR TENSOR2VECTOR_UTIL::New_gemm_metakernel(NODE_PTR op0, NODE_PTR op1,
   // input_dup = input + roll(input, -width).
   Gen_dup_input_stmt(op0, 2, (int)width, input_dup_var, spos);
 
+  // Only loop over non-zero diagonals, duplicated ones share one row.
+  WEIGHT_ROWS      rows;
+  bool             sparse = Compact_weight_rows(op1, 1, height, rows, spos);
+  std::vector<int> roll_num_height;
+  for (int i = 0; i < height; i++) {
+    if (!sparse || std::count(rows._mbr.begin(), rows._mbr.end(), i)) {
+      roll_num_height.push_back(i);
+    }
+  }
+  if (sparse) {
+    Trace_sparse_weight("gemm", rows, height, width,
+                        height - roll_num_height.size(),
+                        height - roll_num_height.size());
+    op1 = _cntr->New_ldc(rows._weight, spos);
+  }
+
   // Generate a blocked loop for GEMM.
-  STMT_PTR loop_stmt = New_loop("index_gemm", 0, height, spos);
+  STMT_PTR loop_stmt = New_loop("index_gemm", 0, roll_num_height.size(), spos);
 
   STMT_LIST body_sl =
       STMT_LIST::Enclosing_list(loop_stmt->Node()->Child(3)->End_stmt());
 
   // input_roll = ROLL(input_dup, i)
-  std::vector<int> roll_num_height;
-  for (int i = 0; i < height; i++) roll_num_height.push_back(i);
-  NODE_PTR vroll_node = New_roll(_cntr->New_ld(input_dup_var, spos),
-                                 _cntr->New_ld(loop_stmt->Node()->Iv(), spos),
+  NODE_PTR roll_idx  = _cntr->New_ld(loop_stmt->Node()->Iv(), spos);
+  NODE_PTR slice_idx = _cntr->New_ld(loop_stmt->Node()->Iv(), spos);
+  if (sparse) {
+    roll_idx  = New_ild_int_const("diag_int", roll_num_height, roll_idx, spos);
+    slice_idx = New_ild_int_const("row_map_int", rows._row_map, slice_idx,
+                                  spos);
+  }
+  NODE_PTR vroll_node = New_roll(_cntr->New_ld(input_dup_var, spos), roll_idx,
                                  roll_num_height, spos);
 
-  NODE_PTR op1_slice =
-      New_slice(op1, _cntr->New_ld(loop_stmt->Node()->Iv(), spos),
-                _cntr->New_intconst(s32_type, width, spos), spos);
+  NODE_PTR op1_slice = New_slice(
+      op1, slice_idx, _cntr->New_intconst(s32_type, width, spos), spos);
   NODE_PTR vmul_node = New_mul(vroll_node, op1_slice, spos);
 
   NODE_PTR vadd_node =
@@ -1109,6 +1303,60 @@ ADDR_DATUM_PTR TENSOR2VECTOR_UTIL::Roll_valid_to_start(ADDR_DATUM_PTR input_var,
   return roll_result_var;
 }
 
+NODE_PTR TENSOR2VECTOR_UTIL::New_max_pool_metakernel(NODE_PTR input, int kh,
+                                                     int kw, int w,
+                                                     const char* name,
+                                                     const SPOS& spos) {
+  _ctx.Incr_num_vloop();
+  GLOB_SCOPE*    gscope   = _cntr->Glob_scope();
+  FUNC_SCOPE*    fscope   = _cntr->Parent_func_scope();
+  CONST_TYPE_PTR s32_type = gscope->Prim_type(PRIMITIVE_TYPE::INT_S32);
+  ARRAY_TYPE_PTR ty_arr   = input->Rtype()->Cast_to_arr();
+
+  std::vector<int> rolls = Get_max_pool_rolls(kh, kw, w);
+  _ctx.Trace(TF_LOWER, "max pool ", name, ": kernel=", kh, "x", kw,
+             ", rounds=", rolls.size(), "\n");
+
+  // each round writes new variables: level of max drops after every relu,
+  // a ciphertext variable can not be re-assigned at a different level
+  NODE_PTR max_node = input;
+  for (size_t i = 0; i < rolls.size(); i++) {
+    std::string    suffix   = std::to_string(_ctx.Get_num_vloop()) + "_" +
+                         std::to_string(i);
+    std::string    max_str  = std::string("tmp_max_n") + suffix;
+    std::string    roll_str = std::string("tmp_max_roll_n") + suffix;
+    std::string    diff_str = std::string("tmp_max_diff_n") + suffix;
+    ADDR_DATUM_PTR max_var  = fscope->New_var(ty_arr, max_str.c_str(), spos);
+    ADDR_DATUM_PTR roll_var = fscope->New_var(ty_arr, roll_str.c_str(), spos);
+    ADDR_DATUM_PTR diff_var = fscope->New_var(ty_arr, diff_str.c_str(), spos);
+    _ctx.Prepend(_cntr->New_st(max_node, max_var, spos));
+
+    // tmp_max_roll = roll(tmp_max, r)
+    std::vector<int> roll_num{rolls[i]};
+    NODE_PTR         roll_node = New_roll(
+        _cntr->New_ld(max_var, spos),
+        _cntr->New_intconst(s32_type, rolls[i], spos), roll_num, spos);
+    _ctx.Prepend(_cntr->New_st(roll_node, roll_var, spos));
+
+    // tmp_max_diff = tmp_max - tmp_max_roll
+    NODE_PTR diff_node = New_sub(_cntr->New_ld(max_var, spos),
+                                 _cntr->New_ld(roll_var, spos), spos);
+    _ctx.Prepend(_cntr->New_st(diff_node, diff_var, spos));
+
+    // max = tmp_max_roll + relu(tmp_max_diff)
+    std::string relu_name = std::string(name) + "_max" + std::to_string(i);
+    NODE_PTR    relu_node = _cntr->New_una_arith(
+        air::base::OPCODE(nn::core::NN, nn::core::OPCODE::RELU),
+        _cntr->New_ld(diff_var, spos), spos);
+    relu_node->Set_attr("name", relu_name.c_str());
+    // a and b are both in the input range, a - b spans twice of it
+    int vr_scale = 2;
+    relu_node->Set_attr(nn::core::ATTR_VR_SCALE, &vr_scale, 1);
+    max_node = New_add(_cntr->New_ld(roll_var, spos), relu_node, spos);
+  }
+  return max_node;
+}
+
 NODE_PTR TENSOR2VECTOR_UTIL::New_extract_valid_data(
     NODE_PTR input, int64_t channel, int64_t padsize, int64_t ih, int64_t iw,
     int64_t ss_h, int64_t ss_w, int64_t ks, int64_t stride,
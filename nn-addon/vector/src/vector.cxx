@@ -11,6 +11,7 @@
 #include "air/base/visitor.h"
 #include "air/core/handler.h"
 #include "nn/core/handler.h"
+#include "nn/vector/batch_pack.h"
 #include "nn/vector/core_handler.h"
 #include "nn/vector/core_preg_handler.h"
 #include "nn/vector/t2vslice_handler.h"
@@ -93,6 +94,10 @@ GLOB_SCOPE* Vector_driver(GLOB_SCOPE* glob, VECTOR_CTX& ctx,
     NODE_PTR retv = trav.Visit<NODE_PTR>(body);
     AIR_ASSERT(retv != air::base::Null_ptr && retv->Is_entry());
     new_func->Set_entry_stmt(retv->Stmt());
+
+    // Pack images of batch>1 into one vector
+    BATCH_PACK batch_pack(trav_ctx);
+    batch_pack.Run();
   }
   return new_glob;
 }
@@ -150,5 +150,12 @@ NODE_PTR VECTOR_GEN::New_mul(NODE_PTR op0, NODE_PTR op1, const SPOS& spos) {
   return vmul_node;
 }
 
+NODE_PTR VECTOR_GEN::New_sub(NODE_PTR op0, NODE_PTR op1, const SPOS& spos) {
+  NODE_PTR vsub_node = _cntr->New_bin_arith(
+      OPCODE(nn::vector::VECTOR, nn::vector::VECTOR_OPCODE::SUB), op0, op1,
+      spos);
+  return vsub_node;
+}
+
 }  // namespace vector
 }  // namespace nn
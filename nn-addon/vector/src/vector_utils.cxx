@@ -8,6 +8,11 @@
 
 #include "nn/vector/vector_utils.h"
 
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
 namespace nn {
 namespace vector {
 
@@ -158,42 +163,8 @@ FPVEC Transpose_diagonal(FPMAT A, size_t position, size_t padw) {
   return diag;
 }
 
-// Record the location of im2col
-void Get_im2col_kernel(FPVEC& weight, int c_in, int h, int w, int c_out, int kh,
-                       int kw, int padding, int stride, std::vector<int>& ra,
-                       FPMAT& conv1_im2col_kernel) {
-  FPMAT conv1_im2col_index(c_in * kh * kw, FPVEC(h * w, 0.0));
-  int   oh, ow;
-  if (padding) {
-    oh = h;
-    ow = w;
-  } else {
-    oh = h - kh + 1;
-    ow = w - kw + 1;
-  }
+void Get_im2col_ra(int h, int kh, int kw, std::vector<int>& ra) {
   int padsize = (kh - 1) / 2;
-
-  // 1-compute im2col_index[c_in*kh*kw][oh*ow]
-  int k = kh;  // assume kh = kw
-  // row: c_in*kh*kw, column: oh*ow
-  for (int hi = 0; hi < oh; hi++) {
-    for (int wi = 0; wi < ow; wi++) {
-      for (int ci = 0; ci < c_in; ci++) {
-        for (int khi = 0; khi < k; khi++) {
-          for (int kwi = 0; kwi < k; kwi++) {
-            if (((hi + khi) < padsize) || ((wi + kwi) < padsize) ||
-                ((hi + khi) >= (oh + padsize)) ||
-                ((wi + kwi) >= (ow + padsize)))
-              conv1_im2col_index[ci * k * k + khi * k + kwi][hi * ow + wi] = 0;
-            else
-              conv1_im2col_index[ci * k * k + khi * k + kwi][hi * ow + wi] = 1;
-          }
-        }
-      }
-    }
-  }
-
-  // 2-ra
   // first align [0,0]
   ra[0]           = -1 * (h * padsize + padsize);
   ra[kh * kw - 1] = h * padsize + padsize;
@@ -213,25 +184,101 @@ void Get_im2col_kernel(FPVEC& weight, int c_in, int h, int w, int c_out, int kh,
     ra[i - 1] = ra[i] - 1;
     if ((kh > 3) && (i % kh == 0)) ra[i - 1] -= (h - kh);
   }
+}
+
+void Get_im2col_kernel_row(const FPVEC& weight, int c_in, int h, int w,
+                           int c_out, int kh, int kw, int padding, int stride,
+                           const std::vector<int>& ra, int row,
+                           FPVEC& row_vec) {
+  AIR_ASSERT_MSG(row_vec.size() == (size_t)c_out * h * w,
+                 "im2col row size %d != c_out*h*w", row_vec.size());
+  int oh, ow;
+  if (padding) {
+    oh = h;
+    ow = w;
+  } else {
+    oh = h - kh + 1;
+    ow = w - kw + 1;
+  }
+  int padsize  = (kh - 1) / 2;
+  int k        = kh;  // assume kh = kw
+  int rows     = c_in * kh * kw;
+  int ra_shift = ra[row % (kh * kw)];
 
   for (int c1 = 0; c1 < c_out; c1++) {
-    // compute im2col_kernel according to the c_out: [c_in*kh*kw, c_out*h*w]
-    for (int i = 0; i < c_in * kh * kw; i++) {
-      for (int j = 0; j < h * w; j++) {
-        conv1_im2col_kernel[i][j + c1 * (h * w)] =
-            conv1_im2col_index[(i + c1 * (kh * kw)) % (c_in * kh * kw)][j] *
-            weight[c1 * (c_in * kh * kw) +
-                   (i + c1 * (kh * kw)) % (c_in * kh * kw)];
-        if (stride > 1) {
-          if ((ra[i % (kh * kw)] > 0) &&
-              (j >= h * w - stride * ra[i % (kh * kw)]))  // left
-            conv1_im2col_kernel[i][j + c1 * (h * w)] = 0;
-          if ((ra[i % (kh * kw)] < 0) &&
-              (j < -1 * stride * ra[i % (kh * kw)]))  // right
-            conv1_im2col_kernel[i][j + c1 * (h * w)] = 0;
-        }
+    // kernel element (khi, kwi) of im2col row r
+    int   r   = (row + c1 * (kh * kw)) % rows;
+    int   khi = (r % (k * k)) / k;
+    int   kwi = r % k;
+    float wv  = weight[c1 * rows + r];
+    for (int j = 0; j < h * w; j++) {
+      // im2col_index is 1 if (hi + khi, wi + kwi) hits input data, 0 for
+      // padding and for columns beyond oh*ow
+      float index = 0.0;
+      if (j < oh * ow) {
+        int hi = j / ow;
+        int wi = j % ow;
+        if (((hi + khi) >= padsize) && ((wi + kwi) >= padsize) &&
+            ((hi + khi) < (oh + padsize)) && ((wi + kwi) < (ow + padsize)))
+          index = 1.0;
+      }
+      float val = index * wv;
+      if (stride > 1) {
+        if ((ra_shift > 0) && (j >= h * w - stride * ra_shift))  // left
+          val = 0;
+        if ((ra_shift < 0) && (j < -1 * stride * ra_shift))  // right
+          val = 0;
+      }
+      row_vec[j + c1 * (h * w)] = val;
+    }
+  }
+}
+
+int64_t Get_uniq_rows(CONSTANT_PTR cst, std::vector<int64_t>& row_map) {
+  std::vector<int64_t> shape = cst->Type()->Cast_to_arr()->Shape();
+  AIR_ASSERT_MSG(shape.size() == 2, "const dim %d is not 2", shape.size());
+  int64_t      rows    = shape[0];
+  int64_t      row_len = shape[1];
+  const float* cptr    = cst->Array_ptr<float>();
+  size_t       row_sz  = row_len * sizeof(float);
+
+  // hash of row data -> rows with that hash
+  std::unordered_map<size_t, std::vector<int64_t>> uniq;
+  int64_t                                          num_uniq = 0;
+  row_map.assign(rows, -1);
+  for (int64_t i = 0; i < rows; i++) {
+    const float* row = cptr + i * row_len;
+    if (std::all_of(row, row + row_len, [](float v) { return v == 0.0; })) {
+      continue;
+    }
+    size_t hash = std::hash<std::string_view>()(
+        std::string_view((const char*)row, row_sz));
+    std::vector<int64_t>& same = uniq[hash];
+    for (int64_t j : same) {
+      if (memcmp(cptr + j * row_len, row, row_sz) == 0) {
+        row_map[i] = j;
+        break;
       }
     }
+    if (row_map[i] < 0) {
+      row_map[i] = i;
+      same.push_back(i);
+      num_uniq++;
+    }
+  }
+  return num_uniq;
+}
+
+// Record the location of im2col
+void Get_im2col_kernel(FPVEC& weight, int c_in, int h, int w, int c_out, int kh,
+                       int kw, int padding, int stride, std::vector<int>& ra,
+                       FPMAT& conv1_im2col_kernel) {
+  Get_im2col_ra(h, kh, kw, ra);
+
+  // compute im2col_kernel according to the c_out: [c_in*kh*kw, c_out*h*w]
+  for (int i = 0; i < c_in * kh * kw; i++) {
+    Get_im2col_kernel_row(weight, c_in, h, w, c_out, kh, kw, padding, stride,
+                          ra, i, conv1_im2col_kernel[i]);
   }
 }
 
@@ -340,6 +387,17 @@ FPVEC Get_avg_value_mask(int c_in, int h, int w, int ks) {
   return avg_value_mask;
 }
 
+std::vector<int> Get_max_pool_rolls(int kh, int kw, int w) {
+  std::vector<int> rolls;
+  for (int cur = 1; cur < kw; cur *= 2) {
+    rolls.push_back(std::min(cur, kw - cur));
+  }
+  for (int cur = 1; cur < kh; cur *= 2) {
+    rolls.push_back(std::min(cur, kh - cur) * w);
+  }
+  return rolls;
+}
+
 FPVEC Get_global_avg_value_mask(int c_in, int h, int w) {
   bool  channel_begin = true;
   FPVEC avg_value_mask(c_in * h * w, 0.0);
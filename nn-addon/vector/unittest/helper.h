@@ -0,0 +1,266 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#ifndef NN_VECTOR_UNITTEST_HELPER_H
+#define NN_VECTOR_UNITTEST_HELPER_H
+
+#include <unordered_map>
+#include <vector>
+
+#include "air/base/container.h"
+#include "air/base/meta_info.h"
+#include "air/base/st.h"
+#include "air/core/opcode.h"
+#include "gtest/gtest.h"
+#include "nn/core/opcode.h"
+#include "nn/vector/vector_ctx.h"
+#include "nn/vector/vector_gen.h"
+#include "nn/vector/vector_opcode.h"
+#include "nn/vector/vector_utils.h"
+
+namespace nn {
+namespace vector {
+
+//! @brief Evaluate VECTOR IR on plain floats. Every vector value occupies
+//! slots elements, shorter constants are zero padded and ROLL(x, k) rotates
+//! left modulo slots like the ciphertext rotation it is lowered to.
+class VEC_EVAL {
+public:
+  VEC_EVAL(FUNC_SCOPE* func, int64_t slots) : _func(func), _slots(slots) {}
+
+  //! @brief Run function with formal 0 set to input, return value of RETV
+  FPVEC Run(const FPVEC& input) {
+    AIR_ASSERT((int64_t)input.size() <= _slots);
+    VAL in;
+    in._vec = input;
+    in._vec.resize(_slots, 0.0);
+    _mem[_func->Formal(0)->Id().Value()] = {in};
+    Exec(_func->Container().Entry_node()->Body_blk());
+    return _retv._vec;
+  }
+
+private:
+  struct VAL {
+    int64_t _int = 0;
+    FPVEC   _vec;  // empty for integer
+  };
+
+  void Exec(NODE_PTR node) {
+    if (node->Is_block()) {
+      for (STMT_PTR stmt = node->Begin_stmt(); stmt != node->End_stmt();
+           stmt          = stmt->Next()) {
+        Exec(stmt->Node());
+      }
+      return;
+    }
+    if (node->Opcode() == air::core::OPC_DO_LOOP) {
+      uint32_t iv = node->Iv()->Id().Value();
+      _mem[iv]    = {Eval(node->Child(0))};
+      while (Eval(node->Child(1))._int != 0) {
+        Exec(node->Child(3));
+        _mem[iv] = {Eval(node->Child(2))};
+      }
+    } else if (node->Opcode() == air::core::OPC_ST) {
+      _mem[node->Addr_datum()->Id().Value()] = {Eval(node->Child(0))};
+    } else if (node->Opcode() == air::core::OPC_STP) {
+      _preg[node->Preg_id().Value()] = Eval(node->Child(0));
+    } else if (node->Opcode() == air::core::OPC_IST) {
+      VAL val               = Eval(node->Child(1));
+      Elem(node->Child(0)) = val;
+    } else if (node->Opcode() == air::core::OPC_RETV) {
+      _retv = Eval(node->Child(0));
+    } else {
+      AIR_ASSERT_MSG(node->Opcode() == air::core::OPC_PRAGMA ||
+                         node->Opcode() == air::core::OPC_TM_START ||
+                         node->Opcode() == air::core::OPC_TM_TAKEN,
+                     "unsupported stmt %s", node->Name());
+    }
+  }
+
+  // element of ARRAY(LDA var, idx)
+  VAL& Elem(NODE_PTR array) {
+    AIR_ASSERT(array->Opcode() == air::core::OPC_ARRAY &&
+               array->Child(0)->Opcode() == air::core::OPC_LDA);
+    int64_t           idx = Eval(array->Child(1))._int;
+    std::vector<VAL>& mem = _mem[array->Child(0)->Addr_datum()->Id().Value()];
+    if ((int64_t)mem.size() <= idx) mem.resize(idx + 1);
+    return mem[idx];
+  }
+
+  VAL Vec(const float* data, int64_t len) {
+    AIR_ASSERT(len <= _slots);
+    VAL res;
+    res._vec.assign(data, data + len);
+    res._vec.resize(_slots, 0.0);
+    return res;
+  }
+
+  VAL Int(int64_t val) {
+    VAL res;
+    res._int = val;
+    return res;
+  }
+
+  template <typename OP>
+  VAL Elementwise(NODE_PTR node, OP op) {
+    VAL a = Eval(node->Child(0));
+    VAL b = Eval(node->Child(1));
+    if (a._vec.empty() && b._vec.empty()) return Int(op(a._int, b._int));
+    AIR_ASSERT(a._vec.size() == b._vec.size());
+    for (int64_t i = 0; i < _slots; ++i) a._vec[i] = op(a._vec[i], b._vec[i]);
+    return a;
+  }
+
+  VAL Eval(NODE_PTR node) {
+    air::base::OPCODE opc = node->Opcode();
+    if (opc == air::core::OPC_INTCONST) return Int((int64_t)node->Intconst());
+    if (opc == air::core::OPC_LD) {
+      return _mem[node->Addr_datum()->Id().Value()].at(0);
+    }
+    if (opc == air::core::OPC_LDP) return _preg.at(node->Preg_id().Value());
+    if (opc == air::core::OPC_LDC) {
+      CONSTANT_PTR cst = node->Const();
+      return Vec(cst->Array_ptr<float>(),
+                 cst->Array_byte_len() / sizeof(float));
+    }
+    if (opc == air::core::OPC_ZERO) {
+      return node->Rtype()->Is_array() ? Vec(nullptr, 0) : Int(0);
+    }
+    if (opc == air::core::OPC_ILD) {
+      NODE_PTR array = node->Child(0);
+      AIR_ASSERT(array->Opcode() == air::core::OPC_ARRAY);
+      if (array->Child(0)->Opcode() == air::core::OPC_LDCA) {
+        CONSTANT_PTR cst = array->Child(0)->Const();
+        return Int(cst->Array_elem<int32_t>(Eval(array->Child(1))._int));
+      }
+      return Elem(array);
+    }
+    if (opc == air::core::OPC_ADD || opc == OPC_ADD) {
+      return Elementwise(node, [](auto a, auto b) { return a + b; });
+    }
+    if (opc == air::core::OPC_SUB || opc == OPC_SUB) {
+      return Elementwise(node, [](auto a, auto b) { return a - b; });
+    }
+    if (opc == air::core::OPC_MUL || opc == OPC_MUL) {
+      return Elementwise(node, [](auto a, auto b) { return a * b; });
+    }
+    if (opc == air::core::OPC_SHL) {
+      return Int(Eval(node->Child(0))._int << Eval(node->Child(1))._int);
+    }
+    if (opc == air::core::OPC_LT) {
+      return Int(Eval(node->Child(0))._int < Eval(node->Child(1))._int);
+    }
+    if (opc == air::core::OPC_LE) {
+      return Int(Eval(node->Child(0))._int <= Eval(node->Child(1))._int);
+    }
+    if (opc == air::base::OPCODE(nn::core::NN, nn::core::OPCODE::RELU)) {
+      VAL a = Eval(node->Child(0));
+      for (float& v : a._vec) v = v > 0 ? v : 0;
+      return a;
+    }
+    if (opc == OPC_ROLL) {
+      VAL     a = Eval(node->Child(0));
+      int64_t k = Eval(node->Child(1))._int % _slots;
+      if (k < 0) k += _slots;
+      std::rotate(a._vec.begin(), a._vec.begin() + k, a._vec.end());
+      return a;
+    }
+    if (opc == OPC_SLICE) {
+      AIR_ASSERT(node->Child(0)->Opcode() == air::core::OPC_LDC);
+      CONSTANT_PTR cst  = node->Child(0)->Const();
+      int64_t      idx  = Eval(node->Child(1))._int;
+      int64_t      size = Eval(node->Child(2))._int;
+      AIR_ASSERT((idx + 1) * size * sizeof(float) <= cst->Array_byte_len());
+      return Vec(cst->Array_ptr<float>() + idx * size, size);
+    }
+    if (opc == OPC_RESHAPE) return Eval(node->Child(0));
+    AIR_ASSERT_MSG(false, "unsupported expr %s", node->Name());
+    return VAL();
+  }
+
+  FUNC_SCOPE*                                    _func;
+  int64_t                                        _slots;
+  std::unordered_map<uint32_t, std::vector<VAL>> _mem;
+  std::unordered_map<uint32_t, VAL>              _preg;
+  VAL                                            _retv;
+};
+
+//! @brief Fixture to build a tensor function of one NN operator, lower it
+//! to VECTOR IR and evaluate the result
+class T2V_TEST : public ::testing::Test {
+protected:
+  void SetUp() override {
+    META_INFO::Remove_all();
+    air::core::Register_core();
+    nn::core::Register_nn();
+    Register_vector_domain();
+    _glob                      = GLOB_SCOPE::Get();
+    _spos                      = _glob->Unknown_simple_spos();
+    _config._ref_validate      = false;
+    _config._improve_ss_insert = false;
+  }
+
+  void TearDown() override { META_INFO::Remove_all(); }
+
+  //! @brief Begin function main_graph(input of in_shape) of out_shape
+  void Begin_func(const std::vector<int64_t>& in_shape,
+                  const std::vector<int64_t>& out_shape) {
+    TYPE_PTR f32 = _glob->Prim_type(PRIMITIVE_TYPE::FLOAT_32);
+    TYPE_PTR in_type =
+        New_array_type(_glob, "input_float", f32, in_shape, _spos);
+    _out_type = New_array_type(_glob, "output_float", f32, out_shape, _spos);
+    STR_PTR  name = _glob->New_str("main_graph");
+    FUNC_PTR func = _glob->New_func(name, _spos);
+    func->Set_parent(_glob->Comp_env_id());
+    SIGNATURE_TYPE_PTR sig = _glob->New_sig_type();
+    _glob->New_ret_param(_out_type, sig);
+    _glob->New_param(_glob->New_str("input"), in_type, sig, _spos);
+    sig->Set_complete();
+    _glob->New_entry_point(sig, func, name, _spos);
+    _func = &_glob->New_func_scope(func);
+    _cntr = &_func->Container();
+    _cntr->New_func_entry(_spos);
+  }
+
+  NODE_PTR Ld_input() { return _cntr->New_ld(_func->Formal(0), _spos); }
+
+  NODE_PTR Ldc(const FPVEC& data, const std::vector<int64_t>& shape) {
+    CONSTANT_PTR cst = New_array_const(
+        _glob, "cst", data.size(), _glob->Prim_type(PRIMITIVE_TYPE::FLOAT_32),
+        shape, (void*)data.data(), _spos);
+    return _cntr->New_ldc(cst, _spos);
+  }
+
+  //! @brief Store op to result and return it
+  void End_func(NODE_PTR op) {
+    ADDR_DATUM_PTR res =
+        _func->New_var(_out_type, _glob->New_str("result"), _spos);
+    STMT_LIST sl = _cntr->Stmt_list();
+    sl.Append(_cntr->New_st(op, res, _spos));
+    sl.Append(_cntr->New_retv(_cntr->New_ld(res, _spos), _spos));
+  }
+
+  //! @brief Lower tensor function to VECTOR IR
+  FUNC_SCOPE* Lower() {
+    GLOB_SCOPE* vec_glob = Vector_driver(_glob, _ctx, nullptr, _config);
+    return &vec_glob->Open_func_scope(_func->Id());
+  }
+
+  GLOB_SCOPE*   _glob = nullptr;
+  FUNC_SCOPE*   _func = nullptr;
+  CONTAINER*    _cntr = nullptr;
+  TYPE_PTR      _out_type;
+  SPOS          _spos;
+  VECTOR_CTX    _ctx;
+  VECTOR_CONFIG _config;
+};
+
+}  // namespace vector
+}  // namespace nn
+
+#endif  // NN_VECTOR_UNITTEST_HELPER_H
@@ -0,0 +1,148 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "helper.h"
+#include "nn/vector/batch_pack.h"
+
+using namespace nn::vector;
+
+class TEST_BATCH_PACK : public T2V_TEST {
+protected:
+  // block of the batched formal set by BATCH_PACK, 0 if not packed
+  int64_t Block(FUNC_SCOPE* func, int64_t batch) {
+    NODE_PTR       idname = func->Container().Entry_node()->Child(0);
+    const int64_t* num    = idname->Attr<int64_t>(ATTR_BATCH);
+    const int64_t* block  = idname->Attr<int64_t>(ATTR_BATCH_BLOCK);
+    if (num == nullptr || block == nullptr) return 0;
+    EXPECT_EQ(*num, batch);
+    return *block;
+  }
+};
+
+TEST_F(TEST_BATCH_PACK, gemm_batch2) {
+  const int batch = 2, height = 10, width = 16;
+  FPVEC     w(height * width), b(height), x(batch * width);
+  for (size_t i = 0; i < w.size(); i++) w[i] = (int)(i * 7 % 11) - 5;
+  for (size_t i = 0; i < b.size(); i++) b[i] = 0.5 * i;
+  for (size_t i = 0; i < x.size(); i++) x[i] = (int)(i * 5 % 9) - 4;
+
+  Begin_func({batch, width}, {batch, height});
+  End_func(_cntr->New_tern_arith(
+      air::base::OPCODE(nn::core::NN, nn::core::OPCODE::GEMM), Ld_input(),
+      Ldc(w, {height, width}), Ldc(b, {height}), _spos));
+  _config._gemm_fast = true;
+  FUNC_SCOPE* vfunc  = Lower();
+
+  // 16 columns are replicated to 40 slots with a roll of 20
+  int64_t block = Block(vfunc, batch);
+  ASSERT_GE(block, 40 + 20);
+  ASSERT_EQ(block & (block - 1), 0);
+
+  // image n is at [n*block, n*block+width)
+  FPVEC packed(batch * block, 0.0);
+  for (int n = 0; n < batch; n++) {
+    std::copy(x.begin() + n * width, x.begin() + (n + 1) * width,
+              packed.begin() + n * block);
+  }
+  FPVEC res = VEC_EVAL(vfunc, batch * block).Run(packed);
+  for (int n = 0; n < batch; n++) {
+    for (int i = 0; i < block; i++) {
+      float expect = 0.0;
+      if (i < height) {
+        expect = b[i];
+        for (int j = 0; j < width; j++) {
+          expect += w[i * width + j] * x[n * width + j];
+        }
+      }
+      EXPECT_FLOAT_EQ(res[n * block + i], expect)
+          << "image " << n << " slot " << i;
+    }
+  }
+}
+
+TEST_F(TEST_BATCH_PACK, conv_batch2) {
+  const int batch = 2, ci = 2, co = 2, hw = 4, ks = 3, img = ci * hw * hw;
+  FPVEC     w(co * ci * ks * ks), b(co), x(batch * img);
+  for (size_t i = 0; i < w.size(); i++) w[i] = (int)(i * 7 % 11) - 5;
+  for (size_t i = 0; i < b.size(); i++) b[i] = 0.5 * (i + 1);
+  for (size_t i = 0; i < x.size(); i++) x[i] = (int)(i * 5 % 9) - 4;
+
+  Begin_func({batch, ci, hw, hw}, {batch, co, hw, hw});
+  NODE_PTR conv = _cntr->New_tern_arith(
+      air::base::OPCODE(nn::core::NN, nn::core::OPCODE::CONV), Ld_input(),
+      Ldc(w, {co, ci, ks, ks}), Ldc(b, {co}), _spos);
+  int strides[] = {1, 1};
+  int pads[]    = {1, 1, 1, 1};
+  conv->Set_attr("strides", strides, 2);
+  conv->Set_attr("pads", pads, 4);
+  End_func(conv);
+  FUNC_SCOPE* vfunc = Lower();
+
+  int64_t block = Block(vfunc, batch);
+  ASSERT_GE(block, img);
+  ASSERT_EQ(block & (block - 1), 0);
+
+  // image n is at [n*block, n*block+img)
+  FPVEC packed(batch * block, 0.0);
+  for (int n = 0; n < batch; n++) {
+    std::copy(x.begin() + n * img, x.begin() + (n + 1) * img,
+              packed.begin() + n * block);
+  }
+  FPVEC res = VEC_EVAL(vfunc, batch * block).Run(packed);
+  for (int n = 0; n < batch; n++) {
+    for (int o = 0; o < co; o++) {
+      for (int i = 0; i < hw; i++) {
+        for (int j = 0; j < hw; j++) {
+          float expect = b[o];
+          for (int c = 0; c < ci; c++) {
+            for (int ki = 0; ki < ks; ki++) {
+              for (int kj = 0; kj < ks; kj++) {
+                int r = i + ki - 1, s = j + kj - 1;
+                if (r < 0 || r >= hw || s < 0 || s >= hw) continue;
+                expect += w[((o * ci + c) * ks + ki) * ks + kj] *
+                          x[n * img + (c * hw + r) * hw + s];
+              }
+            }
+          }
+          int idx = (o * hw + i) * hw + j;
+          EXPECT_FLOAT_EQ(res[n * block + idx], expect)
+              << "image " << n << " channel " << o << " (" << i << ", " << j
+              << ")";
+        }
+      }
+    }
+  }
+}
+
+TEST_F(TEST_BATCH_PACK, conv_batch2_no_pad) {
+  // build the function in the child only, the glob scope is shared by tests
+  auto lower = [this]() {
+    FPVEC w(1 * 1 * 3 * 3, 1.0), b(1, 0.0);
+    Begin_func({2, 1, 6, 6}, {2, 1, 4, 4});
+    NODE_PTR conv = _cntr->New_tern_arith(
+        air::base::OPCODE(nn::core::NN, nn::core::OPCODE::CONV), Ld_input(),
+        Ldc(w, {1, 1, 3, 3}), Ldc(b, {1}), _spos);
+    int strides[] = {1, 1};
+    int pads[]    = {0, 0, 0, 0};
+    conv->Set_attr("strides", strides, 2);
+    conv->Set_attr("pads", pads, 4);
+    End_func(conv);
+    Lower();
+  };
+  EXPECT_DEATH(lower(), "Conv with strided_slice only supports batch=1");
+}
+
+TEST_F(TEST_BATCH_PACK, gemm_batch1) {
+  FPVEC w(4 * 8, 1.0), b(4, 0.0);
+  Begin_func({1, 8}, {1, 4});
+  End_func(_cntr->New_tern_arith(
+      air::base::OPCODE(nn::core::NN, nn::core::OPCODE::GEMM), Ld_input(),
+      Ldc(w, {4, 8}), Ldc(b, {4}), _spos));
+  _config._gemm_fast = true;
+  EXPECT_EQ(Block(Lower(), 1), 0);
+}
@@ -0,0 +1,62 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "helper.h"
+
+using namespace nn::vector;
+
+class TEST_GEMM : public T2V_TEST {
+protected:
+  // lower y = W * x + b with gemm_fast and check y against reference
+  void Check_gemm(int height, int width, int zero_col) {
+    FPVEC w(height * width), b(height), x(width);
+    for (int i = 0; i < height * width; i++) {
+      w[i] = (i % width == zero_col) ? 0.0 : (int)(i * 7 % 13) - 6;
+    }
+    for (int i = 0; i < height; i++) b[i] = 0.25 * i;
+    for (int i = 0; i < width; i++) x[i] = (int)(i * 5 % 9) - 4;
+
+    Begin_func({1, width}, {1, height});
+    End_func(_cntr->New_tern_arith(
+        air::base::OPCODE(nn::core::NN, nn::core::OPCODE::GEMM), Ld_input(),
+        Ldc(w, {height, width}), Ldc(b, {height}), _spos));
+    _config._gemm_fast = true;
+    FUNC_SCOPE* vfunc  = Lower();
+
+    const int64_t slots = 1024;
+    FPVEC         res   = VEC_EVAL(vfunc, slots).Run(x);
+    for (int i = 0; i < slots; i++) {
+      float expect = 0.0;
+      if (i < height) {
+        expect = b[i];
+        for (int j = 0; j < width; j++) expect += w[i * width + j] * x[j];
+      }
+      EXPECT_FLOAT_EQ(res[i], expect)
+          << height << "x" << width << " gemm slot " << i;
+    }
+  }
+};
+
+TEST_F(TEST_GEMM, wide) { Check_gemm(6, 20, -1); }
+
+TEST_F(TEST_GEMM, tall) { Check_gemm(20, 6, -1); }
+
+TEST_F(TEST_GEMM, square) { Check_gemm(8, 8, -1); }
+
+TEST_F(TEST_GEMM, zero_column) { Check_gemm(10, 16, 3); }
+
+TEST_F(TEST_GEMM, too_long) {
+  // x replicated to 2*40000 slots
+  FPVEC w(40000, 1.0), b(1, 0.0);
+  Begin_func({1, 40000}, {1, 1});
+  End_func(_cntr->New_tern_arith(
+      air::base::OPCODE(nn::core::NN, nn::core::OPCODE::GEMM), Ld_input(),
+      Ldc(w, {1, 40000}), Ldc(b, {1}), _spos));
+  _config._gemm_fast = true;
+  EXPECT_DEATH(Lower(), "needs vector length 80000 > 32768");
+}
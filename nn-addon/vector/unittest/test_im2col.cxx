@@ -0,0 +1,120 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "gtest/gtest.h"
+#include "nn/vector/vector_utils.h"
+
+using namespace air::base;
+using namespace nn::vector;
+
+namespace {
+
+// Dense im2col kernel as built before Get_im2col_kernel_row, kept as the
+// reference: materialize the full index matrix, then the weight matrix.
+void Ref_im2col_kernel(const FPVEC& weight, int c_in, int h, int w, int c_out,
+                       int kh, int kw, int padding, int stride,
+                       std::vector<int>& ra, FPMAT& kernel) {
+  FPMAT index(c_in * kh * kw, FPVEC(h * w, 0.0));
+  int   oh = padding ? h : h - kh + 1;
+  int   ow = padding ? w : w - kw + 1;
+  int   padsize = (kh - 1) / 2;
+  int   k       = kh;
+  for (int hi = 0; hi < oh; hi++) {
+    for (int wi = 0; wi < ow; wi++) {
+      for (int ci = 0; ci < c_in; ci++) {
+        for (int khi = 0; khi < k; khi++) {
+          for (int kwi = 0; kwi < k; kwi++) {
+            index[ci * k * k + khi * k + kwi][hi * ow + wi] =
+                ((hi + khi) < padsize) || ((wi + kwi) < padsize) ||
+                        ((hi + khi) >= (oh + padsize)) ||
+                        ((wi + kwi) >= (ow + padsize))
+                    ? 0
+                    : 1;
+          }
+        }
+      }
+    }
+  }
+  Get_im2col_ra(h, kh, kw, ra);
+  int rows = c_in * kh * kw;
+  for (int c1 = 0; c1 < c_out; c1++) {
+    for (int i = 0; i < rows; i++) {
+      int r = (i + c1 * (kh * kw)) % rows;
+      for (int j = 0; j < h * w; j++) {
+        float val = index[r][j] * weight[c1 * rows + r];
+        int   ra_shift = ra[i % (kh * kw)];
+        if (stride > 1) {
+          if ((ra_shift > 0) && (j >= h * w - stride * ra_shift)) val = 0;
+          if ((ra_shift < 0) && (j < -1 * stride * ra_shift)) val = 0;
+        }
+        kernel[i][j + c1 * (h * w)] = val;
+      }
+    }
+  }
+}
+
+void Check_rows(int c_in, int h, int w, int c_out, int k, int padding,
+                int stride) {
+  FPVEC weight(c_out * c_in * k * k);
+  for (size_t i = 0; i < weight.size(); i++) weight[i] = 0.5 + i;
+
+  std::vector<int> ref_ra(k * k, 0);
+  FPMAT ref(c_in * k * k, FPVEC(c_out * h * w, 0.0));
+  Ref_im2col_kernel(weight, c_in, h, w, c_out, k, k, padding, stride, ref_ra,
+                    ref);
+
+  std::vector<int> ra(k * k, 0);
+  Get_im2col_ra(h, k, k, ra);
+  EXPECT_EQ(ra, ref_ra);
+  FPVEC row(c_out * h * w, -1.0);
+  for (int i = 0; i < c_in * k * k; i++) {
+    Get_im2col_kernel_row(weight, c_in, h, w, c_out, k, k, padding, stride, ra,
+                          i, row);
+    EXPECT_EQ(row, ref[i]) << "row " << i << " of c_in=" << c_in
+                           << " h=" << h << " c_out=" << c_out << " k=" << k
+                           << " padding=" << padding << " stride=" << stride;
+  }
+
+  // dense wrapper produces the same matrix
+  FPMAT dense(c_in * k * k, FPVEC(c_out * h * w, 0.0));
+  Get_im2col_kernel(weight, c_in, h, w, c_out, k, k, padding, stride, ra,
+                    dense);
+  EXPECT_EQ(dense, ref);
+}
+
+}  // namespace
+
+TEST(VECTOR_UTILS, im2col_kernel_row) {
+  Check_rows(2, 4, 4, 3, 3, 1, 1);
+  Check_rows(3, 8, 8, 2, 3, 1, 2);
+  Check_rows(2, 6, 6, 2, 3, 0, 1);
+  Check_rows(2, 8, 8, 4, 5, 1, 1);
+  Check_rows(4, 4, 4, 2, 1, 0, 1);
+}
+
+TEST(VECTOR_UTILS, array_const_interned) {
+  GLOB_SCOPE*          glob  = GLOB_SCOPE::Get();
+  SPOS                 spos  = glob->Unknown_simple_spos();
+  TYPE_PTR             etype = glob->Prim_type(PRIMITIVE_TYPE::FLOAT_32);
+  std::vector<int64_t> shape{2, 4};
+  float                mask[8] = {1.0, 0.0, 0.0, 1.0, 1.0, 0.0, 0.0, 1.0};
+
+  // each call creates its own array type, equal masks share one constant
+  CONSTANT_PTR cst0 =
+      New_array_const(glob, "intern_mask", 8, etype, shape, mask, spos);
+  CONSTANT_PTR cst1 =
+      New_array_const(glob, "intern_mask", 8, etype, shape, mask, spos);
+  EXPECT_NE(cst0->Type_id(), New_array_type(glob, "intern_mask", etype, shape,
+                                            spos)->Id());
+  EXPECT_EQ(cst0->Id(), cst1->Id());
+
+  mask[7] = 0.0;
+  CONSTANT_PTR cst2 =
+      New_array_const(glob, "intern_mask", 8, etype, shape, mask, spos);
+  EXPECT_NE(cst0->Id(), cst2->Id());
+}
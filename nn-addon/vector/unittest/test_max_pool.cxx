@@ -0,0 +1,79 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "helper.h"
+
+using namespace nn::vector;
+
+class TEST_MAX_POOL : public T2V_TEST {
+protected:
+  NODE_PTR New_max_pool(int ks) {
+    NODE_PTR node = _cntr->New_una_arith(
+        air::base::OPCODE(nn::core::NN, nn::core::OPCODE::MAX_POOL),
+        Ld_input(), _spos);
+    int kernel_shape[] = {ks, ks};
+    node->Set_attr("kernel_shape", kernel_shape, 2);
+    node->Set_attr("strides", kernel_shape, 2);
+    node->Set_attr("name", "pool");
+    return node;
+  }
+
+  int Count_op(NODE_PTR node, air::base::OPCODE opc) {
+    int cnt = (node->Opcode() == opc) ? 1 : 0;
+    if (node->Is_block()) {
+      for (STMT_PTR stmt = node->Begin_stmt(); stmt != node->End_stmt();
+           stmt          = stmt->Next()) {
+        cnt += Count_op(stmt->Node(), opc);
+      }
+      return cnt;
+    }
+    for (uint32_t i = 0; i < node->Num_child(); i++) {
+      cnt += Count_op(node->Child(i), opc);
+    }
+    return cnt;
+  }
+};
+
+TEST_F(TEST_MAX_POOL, pool_2x2) {
+  const int C = 2, S = 8, K = 2, OS = S / K;
+  FPVEC     x(C * S * S);
+  for (int i = 0; i < C * S * S; i++) x[i] = (int)(i * 37 % 29) - 14;
+
+  Begin_func({1, C, S, S}, {1, C, OS, OS});
+  End_func(New_max_pool(K));
+  FUNC_SCOPE* vfunc = Lower();
+
+  // one round along w and one along h, a - b of each round is a VECTOR SUB
+  std::vector<int> rolls = Get_max_pool_rolls(K, K, S);
+  EXPECT_EQ(rolls, std::vector<int>({1, S}));
+  EXPECT_EQ(Count_op(vfunc->Container().Entry_node(), OPC_SUB), 2);
+
+  const int64_t slots = 1024;
+  FPVEC         res   = VEC_EVAL(vfunc, slots).Run(x);
+  for (int c = 0; c < C; c++) {
+    for (int i = 0; i < OS; i++) {
+      for (int j = 0; j < OS; j++) {
+        float expect = x[(c * S + i * K) * S + j * K];
+        for (int a = 0; a < K; a++) {
+          for (int b = 0; b < K; b++) {
+            expect = std::max(expect, x[(c * S + i * K + a) * S + j * K + b]);
+          }
+        }
+        int idx = (c * OS + i) * OS + j;
+        EXPECT_FLOAT_EQ(res[idx], expect) << "channel " << c << " (" << i
+                                          << ", " << j << ")";
+      }
+    }
+  }
+}
+
+TEST_F(TEST_MAX_POOL, stride_4) {
+  Begin_func({1, 1, 8, 8}, {1, 1, 2, 2});
+  End_func(New_max_pool(4));
+  EXPECT_DEATH(Lower(), "max pool only support stride and ks equals 2");
+}
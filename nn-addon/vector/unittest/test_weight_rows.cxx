@@ -0,0 +1,96 @@
+//-*-c++-*-
+//=============================================================================
+//
+// Copyright (c) XXXX-XXXX
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//=============================================================================
+
+#include "helper.h"
+#include "nn/vector/tensor2vector_util.h"
+
+using namespace nn::vector;
+
+class TEST_WEIGHT_ROWS : public T2V_TEST {
+protected:
+  static constexpr int NUM_GRP  = 3;
+  static constexpr int GRP_SIZE = 4;
+  static constexpr int ROW_LEN  = 5;
+
+  // weight [NUM_GRP*GRP_SIZE, ROW_LEN]: group 1 and member 2 are all zero,
+  // row (0, 1) is zero, row (2, 3) duplicates row (0, 0) and row (2, 1)
+  // duplicates row (0, 3)
+  void SetUp() override {
+    T2V_TEST::SetUp();
+    _weight.assign(NUM_GRP * GRP_SIZE * ROW_LEN, 0.0);
+    for (int g = 0; g < NUM_GRP; g++) {
+      for (int m = 0; m < GRP_SIZE; m++) {
+        if (g == 1 || m == 2 || (g == 0 && m == 1)) continue;
+        for (int j = 0; j < ROW_LEN; j++) Row(g, m)[j] = g * 100 + m * 10 + j;
+      }
+    }
+    std::copy(Row(0, 0), Row(0, 0) + ROW_LEN, Row(2, 3));
+    std::copy(Row(0, 3), Row(0, 3) + ROW_LEN, Row(2, 1));
+    Begin_func({1, ROW_LEN}, {1, ROW_LEN});
+  }
+
+  // Compact_weight_rows is private, only the fixture is a friend
+  bool Compact(NODE_PTR weight, int64_t num_grp, WEIGHT_ROWS& rows) {
+    TENSOR2VECTOR_CTX  t2v_ctx(_cntr, _ctx, nullptr, _config);
+    TENSOR2VECTOR_UTIL util(t2v_ctx);
+    return util.Compact_weight_rows(weight, num_grp, GRP_SIZE, rows, _spos);
+  }
+
+  float* Row(int g, int m) {
+    return _weight.data() + (g * GRP_SIZE + m) * ROW_LEN;
+  }
+
+  FPVEC _weight;
+};
+
+TEST_F(TEST_WEIGHT_ROWS, uniq_rows) {
+  NODE_PTR             ldc = Ldc(_weight, {NUM_GRP * GRP_SIZE, ROW_LEN});
+  std::vector<int64_t> row_map;
+  EXPECT_EQ(Get_uniq_rows(ldc->Const(), row_map), 3);
+  std::vector<int64_t> expect{0,  -1, -1, 3,  -1, -1,
+                              -1, -1, 8,  3,  -1, 0};
+  EXPECT_EQ(row_map, expect);
+}
+
+TEST_F(TEST_WEIGHT_ROWS, compact) {
+  NODE_PTR    ldc = Ldc(_weight, {NUM_GRP * GRP_SIZE, ROW_LEN});
+  WEIGHT_ROWS rows;
+  ASSERT_TRUE(Compact(ldc, NUM_GRP, rows));
+
+  EXPECT_EQ(rows._grp, std::vector<int>({0, 2}));
+  EXPECT_EQ(rows._mbr, std::vector<int>({0, 1, 3}));
+  // 3 unique rows plus a zero row for (0, 1)
+  std::vector<int64_t> shape = rows._weight->Type()->Cast_to_arr()->Shape();
+  EXPECT_EQ(shape, std::vector<int64_t>({4, ROW_LEN}));
+  EXPECT_EQ(rows._num_zero, 6);
+  EXPECT_EQ(rows._num_dup, 2);
+
+  // every kept (grp, mbr) reads its own data from the compacted weight
+  const float* uniq = rows._weight->Array_ptr<float>();
+  ASSERT_EQ(rows._row_map.size(), rows._grp.size() * rows._mbr.size());
+  for (size_t gi = 0; gi < rows._grp.size(); gi++) {
+    for (size_t mi = 0; mi < rows._mbr.size(); mi++) {
+      int          u   = rows._row_map[gi * rows._mbr.size() + mi];
+      const float* row = Row(rows._grp[gi], rows._mbr[mi]);
+      for (int j = 0; j < ROW_LEN; j++) {
+        EXPECT_EQ(uniq[u * ROW_LEN + j], row[j])
+            << "row (" << rows._grp[gi] << ", " << rows._mbr[mi] << ")";
+      }
+    }
+  }
+}
+
+TEST_F(TEST_WEIGHT_ROWS, dense) {
+  FPVEC weight(GRP_SIZE * ROW_LEN);
+  for (size_t i = 0; i < weight.size(); i++) weight[i] = i + 1;
+  NODE_PTR    ldc = Ldc(weight, {GRP_SIZE, ROW_LEN});
+  WEIGHT_ROWS rows;
+  EXPECT_FALSE(Compact(ldc, 1, rows));
+  EXPECT_EQ(rows._num_zero, 0);
+  EXPECT_EQ(rows._num_dup, 0);
+}